@@ -24,6 +24,8 @@ check_cxx_source_compiles("
     HAVE_NR_PROCESS_VM_READV)
 
 check_library_exists(compression compression_encode_buffer "" HAVE_LIBCOMPRESSION)
+check_library_exists(z compress2 "" HAVE_LIBZ)
+check_library_exists(lz4 LZ4_compress_default "" HAVE_LIBLZ4)
 
 # These checks exist in LLVM's configuration, so I want to match the LLVM names
 # so that the check isn't duplicated, but we translate them into the LLDB names
@@ -20,6 +20,7 @@
 #include "lldb/Breakpoint/BreakpointOptions.h"
 #include "lldb/Breakpoint/StoppointLocation.h"
 #include "lldb/Core/Address.h"
+#include "lldb/Utility/AgentExpression.h"
 #include "lldb/Utility/UserID.h"
 #include "lldb/lldb-private.h"
 
@@ -177,6 +178,28 @@ public:
 
   bool ConditionSaysStop(ExecutionContext &exe_ctx, Status &error);
 
+  //------------------------------------------------------------------
+  /// Compile the condition of this location to an agent expression
+  /// which the debug server can evaluate in its place.
+  ///
+  /// @param[out] condition
+  ///    The compiled condition.
+  ///
+  /// @return
+  ///    \b true if the location stops exactly when \a condition is
+  ///    true, \b false if it has no condition, the condition doesn't
+  ///    compile, or hits must reach the debugger for the ignore count
+  ///    or a synchronous callback.
+  //------------------------------------------------------------------
+  bool GetAgentCondition(AgentExpression &condition);
+
+  //------------------------------------------------------------------
+  /// Tell the process that the condition or the ignore count of this
+  /// location changed, so that it can update the conditions it handed
+  /// to the debug server.
+  //------------------------------------------------------------------
+  void UpdateBreakpointSiteConditions();
+
   //------------------------------------------------------------------
   /// Set the valid thread to be checked when the breakpoint is hit.
   ///
@@ -431,6 +454,11 @@ private:
                                 /// multiple processes.
   size_t m_condition_hash; ///< For testing whether the condition source code
                            ///changed.
+  AgentExpression m_agent_condition; ///< The condition compiled for the
+                                     ///debug server, empty if it can't be.
+  size_t m_agent_condition_hash; ///< The hash of the condition source code
+                                 ///m_agent_condition was compiled from.
+  bool m_agent_condition_is_valid;
 
   void SetShouldResolveIndirectFunctions(bool do_resolve) {
     m_should_resolve_indirect_functions = do_resolve;
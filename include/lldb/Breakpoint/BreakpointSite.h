@@ -21,6 +21,7 @@
 // Project includes
 #include "lldb/Breakpoint/BreakpointLocationCollection.h"
 #include "lldb/Breakpoint/StoppointLocation.h"
+#include "lldb/Utility/AgentExpression.h"
 #include "lldb/Utility/UserID.h"
 #include "lldb/lldb-forward.h"
 
@@ -196,6 +197,17 @@ public:
   //------------------------------------------------------------------
   bool ValidForThisThread(Thread *thread);
 
+  //------------------------------------------------------------------
+  /// Get the conditions of all the owners of this site compiled for the
+  /// debug server, which only needs to report the hits where one of
+  /// them is true.
+  ///
+  /// @return
+  ///     \b false, with \a conditions empty, if any owner has to see
+  ///     every hit.
+  //------------------------------------------------------------------
+  bool GetAgentConditions(std::vector<AgentExpression> &conditions);
+
   //------------------------------------------------------------------
   /// Print a description of this breakpoint site to the stream \a s.
   /// GetDescription tells you about the breakpoint site's owners.
@@ -61,6 +61,12 @@ public:
 
   void Append(const Entry &e) { m_map.push_back(e); }
 
+  // Append all the entries of \a rhs, the map must be sorted again before
+  // doing any searches by name.
+  void Append(const UniqueCStringMap &rhs) {
+    m_map.insert(m_map.end(), rhs.m_map.begin(), rhs.m_map.end());
+  }
+
   void Clear() { m_map.clear(); }
 
   //------------------------------------------------------------------
@@ -225,6 +231,18 @@ public:
   //------------------------------------------------------------------
   void Sort() { std::sort(m_map.begin(), m_map.end()); }
 
+  //------------------------------------------------------------------
+  // Sort the entries that were appended after the first "num_sorted"
+  // entries, which must already be sorted, and merge them into place.
+  // This is cheaper than Sort() when adding a few entries to a large
+  // map.
+  //------------------------------------------------------------------
+  void SortAppended(size_t num_sorted) {
+    iterator middle = m_map.begin() + std::min(num_sorted, m_map.size());
+    std::sort(middle, m_map.end());
+    std::inplace_merge(m_map.begin(), middle, m_map.end());
+  }
+
   //------------------------------------------------------------------
   // Since we are using a vector to contain our items it will always
   // double its memory consumption as things are added to the vector,
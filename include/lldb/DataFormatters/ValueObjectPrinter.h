@@ -120,6 +120,9 @@ protected:
 
   lldb::ValueObjectSP GenerateChild(ValueObject *synth_valobj, size_t idx);
 
+  void PrefetchChildPointees(ValueObject *synth_valobj, size_t begin,
+                             size_t end);
+
   void PrintChild(lldb::ValueObjectSP child_sp,
                   const DumpValueObjectOptions::PointerDepth &curr_ptr_depth);
 
@@ -0,0 +1,97 @@
+//===-- AgentExpressionCompiler.h -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_AgentExpressionCompiler_h_
+#define liblldb_AgentExpressionCompiler_h_
+
+#include "lldb/Core/Address.h"
+#include "lldb/Utility/AgentExpression.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/lldb-private.h"
+#include "llvm/ADT/StringRef.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class AgentExpressionCompiler AgentExpressionCompiler.h
+/// "lldb/Expression/AgentExpressionCompiler.h"
+/// @brief Compiles simple breakpoint conditions to agent expressions.
+///
+/// Only a C subset is understood: integer literals, registers named as
+/// $name, integer, enumeration and pointer variables which live in a
+/// register, at a fixed address or relative to a register or the frame
+/// base, and the integer unary, binary and comparison operators. Any
+/// other condition fails to compile and is left to the expression
+/// parser, which evaluates it after each stop.
+//----------------------------------------------------------------------
+class AgentExpressionCompiler {
+public:
+  //------------------------------------------------------------------
+  /// @param[in] address
+  ///     The address of the breakpoint, which decides the variables in
+  ///     scope.
+  ///
+  /// @param[in] reg_ctx
+  ///     A register context of the process, used to map register names
+  ///     and DWARF register numbers to the debug server's numbers.
+  //------------------------------------------------------------------
+  AgentExpressionCompiler(Target &target, const Address &address,
+                          RegisterContext &reg_ctx);
+
+  Status Compile(llvm::StringRef condition, AgentExpression &expr);
+
+private:
+  // The C type of a value on the stack, which is kept sign or zero
+  // extended from its width to 64 bits.
+  struct ValueType {
+    uint8_t bits;
+    bool is_signed;
+  };
+
+  Status ParseBinary(int min_precedence, ValueType &type);
+
+  Status ParseUnary(ValueType &type);
+
+  Status ParsePrimary(ValueType &type);
+
+  Status ParseNumber(ValueType &type);
+
+  Status ParseRegister(ValueType &type);
+
+  Status ParseVariable(ValueType &type);
+
+  Status AppendVariableLocation(Variable &variable, bool &in_register);
+
+  Status AppendDWARFRegister(lldb::RegisterKind kind, uint32_t reg_num);
+
+  void AppendBinaryOperator(llvm::StringRef op, ValueType lhs, ValueType rhs,
+                            ValueType &type);
+
+  static bool NeedsConversion(ValueType from, ValueType to);
+
+  void AppendNormalize(ValueType type);
+
+  llvm::StringRef PeekOperator() const;
+
+  void SkipSpaces();
+
+  Target &m_target;
+  Address m_address;
+  RegisterContext &m_reg_ctx;
+  // The target's int, long and long long.
+  ValueType m_int;
+  ValueType m_long;
+  ValueType m_long_long;
+  llvm::StringRef m_text;
+  AgentExpression m_expr;
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_AgentExpressionCompiler_h_
@@ -26,4 +26,8 @@
 
 #cmakedefine HAVE_LIBCOMPRESSION
 
+#cmakedefine HAVE_LIBZ ${HAVE_LIBZ}
+
+#cmakedefine HAVE_LIBLZ4
+
 #endif // #ifndef LLDB_HOST_CONFIG_H
@@ -30,6 +30,8 @@ struct ResumeAction {
                          // eStateRunning, and eStateStepping.
   int signal; // When resuming this thread, resume it with this signal if this
               // value is > 0
+  lldb::addr_t step_range_start; // When stepping, keep stepping while the PC
+  lldb::addr_t step_range_end;   // is in [start, end). Empty if start >= end.
 };
 
 //------------------------------------------------------------------
@@ -83,9 +83,9 @@ template <> struct TaskPool::RunTaskImpl<> {
   static void Run() {}
 };
 
-// Run 'func' on every value from begin .. end-1.  Each worker will grab
-// 'batch_size' numbers at a time to work on, so for very fast functions, batch
-// should be large enough to avoid too much cache line contention.
+// Run 'func' on every value from begin .. end-1, on the calling thread and the
+// workers of the task pool.  Unlike the tasks above, 'func' may itself call
+// TaskMapOverInt() and wait for it.
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func);
 
@@ -10,8 +10,11 @@
 #ifndef liblldb_NativeBreakpoint_h_
 #define liblldb_NativeBreakpoint_h_
 
+#include "lldb/Utility/AgentExpression.h"
 #include "lldb/lldb-types.h"
 
+#include <vector>
+
 namespace lldb_private {
 class NativeBreakpointList;
 
@@ -34,6 +37,17 @@ public:
 
   virtual bool IsSoftwareBreakpoint() const = 0;
 
+  // The breakpoint is only reported when one of the conditions is true, or
+  // when any of them fails to evaluate. It is always reported when there
+  // are none.
+  const std::vector<AgentExpression> &GetConditions() const {
+    return m_conditions;
+  }
+
+  void SetConditions(std::vector<AgentExpression> conditions) {
+    m_conditions = std::move(conditions);
+  }
+
 protected:
   const lldb::addr_t m_addr;
   int32_t m_ref_count;
@@ -44,6 +58,7 @@ protected:
 
 private:
   bool m_enabled;
+  std::vector<AgentExpression> m_conditions;
 
   // -----------------------------------------------------------
   // interface for NativeBreakpointList
@@ -12,6 +12,7 @@
 
 #include "lldb/Host/Host.h"
 #include "lldb/Host/MainLoop.h"
+#include "lldb/Utility/AgentExpression.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/TraceOptions.h"
 #include "lldb/lldb-private-forward.h"
@@ -21,6 +22,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include <string>
 #include <vector>
 
 #include "NativeBreakpointList.h"
@@ -67,6 +69,32 @@ public:
 
   virtual Status Kill() = 0;
 
+  //------------------------------------------------------------------
+  /// Switch between all-stop and non-stop mode.
+  ///
+  /// In non-stop mode a thread that stops is reported on its own with
+  /// NativeDelegate::ThreadStopped() while the other threads keep
+  /// running, resume actions only apply to threads that are stopped,
+  /// and an eStateStopped action stops a running thread.
+  ///
+  /// The default implementation only supports all-stop mode.
+  ///
+  /// @return
+  ///     Returns an error object.
+  //------------------------------------------------------------------
+  virtual Status SetNonStopMode(bool enable);
+
+  bool GetNonStopMode() const { return m_non_stop_mode; }
+
+  //------------------------------------------------------------------
+  /// Whether a stepping resume action with a step range keeps the
+  /// thread stepping until it leaves that range, instead of stopping
+  /// after one instruction.
+  ///
+  /// The default implementation ignores step ranges.
+  //------------------------------------------------------------------
+  virtual bool SupportsRangeStepping() const { return false; }
+
   //------------------------------------------------------------------
   // Tells a process not to stop the inferior on given signals
   // and just reinject them back.
@@ -114,6 +142,23 @@ public:
 
   virtual Status DisableBreakpoint(lldb::addr_t addr);
 
+  //------------------------------------------------------------------
+  /// Replace the conditions of the software breakpoint at \a addr.
+  //------------------------------------------------------------------
+  Status SetBreakpointConditions(lldb::addr_t addr,
+                                 std::vector<AgentExpression> conditions);
+
+  //------------------------------------------------------------------
+  /// Evaluate the conditions of the software breakpoint at \a addr in
+  /// the context of \a thread, which stopped there.
+  ///
+  /// @return
+  ///     False if the breakpoint has conditions and all of them
+  ///     evaluated to zero, true otherwise.
+  //------------------------------------------------------------------
+  bool ShouldReportBreakpointHit(NativeThreadProtocol &thread,
+                                 lldb::addr_t addr);
+
   //----------------------------------------------------------------------
   // Hardware Breakpoint functions
   //----------------------------------------------------------------------
@@ -202,6 +247,9 @@ public:
                                      lldb::StateType state) = 0;
 
     virtual void DidExec(NativeProcessProtocol *process) = 0;
+
+    virtual void ThreadStopped(NativeProcessProtocol *process,
+                               lldb::tid_t tid) = 0;
   };
 
   //------------------------------------------------------------------
@@ -244,6 +292,24 @@ public:
   virtual Status GetFileLoadAddress(const llvm::StringRef &file_name,
                                     lldb::addr_t &load_addr) = 0;
 
+  struct SVR4LibraryInfo {
+    std::string name;
+    lldb::addr_t link_map;
+    lldb::addr_t base_addr;
+    lldb::addr_t ld_addr;
+  };
+
+  //------------------------------------------------------------------
+  /// Walk the dynamic linker's list of link_map entries.
+  ///
+  /// @return
+  ///     The shared libraries in the order the dynamic linker keeps
+  ///     them, without the main executable, or an error if the process
+  ///     doesn't support this or the list can't be read.
+  //------------------------------------------------------------------
+  virtual llvm::Expected<std::vector<SVR4LibraryInfo>>
+  GetLoadedSVR4Libraries();
+
   class Factory {
   public:
     virtual ~Factory();
@@ -417,6 +483,7 @@ protected:
   HardwareBreakpointMap m_hw_breakpoints_map;
   int m_terminal_fd;
   uint32_t m_stop_id = 0;
+  bool m_non_stop_mode = false;
 
   // Set of signal numbers that LLDB directly injects back to inferior
   // without stopping it.
@@ -461,6 +528,11 @@ protected:
   // -----------------------------------------------------------
   void NotifyDidExec();
 
+  // -----------------------------------------------------------
+  /// Notify the delegate that a thread stopped in non-stop mode.
+  // -----------------------------------------------------------
+  void NotifyThreadStopped(lldb::tid_t tid);
+
   NativeThreadProtocolSP GetThreadByIDUnlocked(lldb::tid_t tid);
 
   // -----------------------------------------------------------
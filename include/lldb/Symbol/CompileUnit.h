@@ -248,6 +248,18 @@ public:
   //------------------------------------------------------------------
   LineTable *GetLineTable();
 
+  //------------------------------------------------------------------
+  /// Get the line table for the compile unit without parsing it.
+  ///
+  /// Lets SymbolFile plug-ins answer a single address lookup without
+  /// parsing a line table that nobody asked for yet.
+  ///
+  /// @return
+  ///     The line table object pointer, or NULL if the line table
+  ///     hasn't been parsed yet.
+  //------------------------------------------------------------------
+  LineTable *GetLineTableIfParsed() const { return m_line_table_ap.get(); }
+
   DebugMacros *GetDebugMacros();
 
   //------------------------------------------------------------------
@@ -125,6 +125,18 @@ private:
 
   void GetFDEIndex();
 
+  // Read the binary search table of .eh_frame_hdr, which lets FDEs be
+  // found without scanning all of .eh_frame. Leaves
+  // m_eh_frame_hdr_fde_count zero if there is no usable table.
+  void GetEHFrameHdr();
+
+  bool GetFDEEntryFromEHFrameHdr(lldb::addr_t file_addr,
+                                 FDEEntryMap::Entry &fde_entry);
+
+  // Read the address range of the FDE at fde_offset.
+  bool GetFDEEntryAtOffset(dw_offset_t fde_offset,
+                           FDEEntryMap::Entry &fde_entry);
+
   bool FDEToUnwindPlan(uint32_t offset, Address startaddr,
                        UnwindPlan &unwind_plan);
 
@@ -145,14 +157,25 @@ private:
   lldb::SectionSP m_section_sp;
   Flags m_flags = 0;
   cie_map_t m_cie_map;
+  std::mutex m_cie_map_mutex;
 
   DataExtractor m_cfi_data;
   bool m_cfi_data_initialized = false; // only copy the section into the DE once
+  std::mutex m_cfi_data_mutex;
 
   FDEEntryMap m_fde_index;
   bool m_fde_index_initialized = false; // only scan the section for FDEs once
   std::mutex m_fde_index_mutex; // and isolate the thread that does it
 
+  DataExtractor m_eh_frame_hdr_data;
+  bool m_eh_frame_hdr_initialized = false;
+  lldb::addr_t m_eh_frame_hdr_addr = LLDB_INVALID_ADDRESS;
+  lldb::offset_t m_eh_frame_hdr_table_offset = 0;
+  uint32_t m_eh_frame_hdr_fde_count = 0;
+  uint8_t m_eh_frame_hdr_table_enc = 0;
+  uint8_t m_eh_frame_hdr_entry_size = 0; // of each half of a table entry
+  bool m_clear_address_zeroth_bit = false;
+
   Type m_type;
 
   CIESP
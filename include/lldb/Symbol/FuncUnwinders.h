@@ -7,6 +7,7 @@
 #include "lldb/Core/AddressRange.h"
 #include "lldb/Core/AddressRange.h"
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Utility/ConstString.h"
 
 namespace lldb_private {
 
@@ -115,6 +116,16 @@ public:
 
   lldb::UnwindPlanSP GetArchDefaultAtFuncEntryUnwindPlan(Thread &thread);
 
+  // The unwinder picks an UnwindPlan for a frame in the middle of the stack
+  // -- one stopped at a call site, above a normal frame -- by going through
+  // the plans above in order.  It records the plan it settled on here, with
+  // the function or symbol name it was picked for, so that unwinding other
+  // threads through this function can reuse the choice.
+  lldb::UnwindPlanSP GetResolvedUnwindPlan(ConstString &function_name);
+
+  void SetResolvedUnwindPlan(const lldb::UnwindPlanSP &unwind_plan_sp,
+                             ConstString function_name);
+
 private:
   lldb::UnwindAssemblySP GetUnwindAssemblyProfiler(Target &target);
 
@@ -145,6 +156,9 @@ private:
   lldb::UnwindPlanSP m_unwind_plan_arch_default_sp;
   lldb::UnwindPlanSP m_unwind_plan_arch_default_at_func_entry_sp;
 
+  lldb::UnwindPlanSP m_unwind_plan_resolved_sp;
+  ConstString m_resolved_function_name;
+
   // Fetching the UnwindPlans can be expensive - if we've already attempted
   // to get one & failed, don't try again.
   bool m_tried_unwind_plan_assembly : 1, m_tried_unwind_plan_eh_frame : 1,
@@ -150,6 +150,9 @@ protected:
   typedef RangeDataVector<lldb::addr_t, lldb::addr_t, uint32_t>
       FileRangeToIndexMap;
   void InitNameIndexes();
+  // Add the demangled names of the symbols in m_lazily_demangled to
+  // m_name_to_index.
+  void InitDemangledNameIndexes();
   void InitAddressIndexes();
 
   ObjectFile *m_objfile;
@@ -159,6 +162,9 @@ protected:
   UniqueCStringMap<uint32_t> m_basename_to_index;
   UniqueCStringMap<uint32_t> m_method_to_index;
   UniqueCStringMap<uint32_t> m_selector_to_index;
+  // C++ functions whose names were indexed without demangling them, see
+  // InitNameIndexes().
+  IndexCollection m_lazily_demangled;
   mutable std::recursive_mutex
       m_mutex; // Provide thread safety for this symbol table
   bool m_file_addr_to_index_computed : 1, m_name_indexes_computed : 1;
@@ -36,6 +36,12 @@ public:
   lldb::FuncUnwindersSP GetFuncUnwindersContainingAddress(const Address &addr,
                                                           SymbolContext &sc);
 
+  // Return the FuncUnwinders for addr if one was created already, without
+  // the symbol lookups needed to make a new one.  This is for the unwinder's
+  // fast path, which only reuses what an earlier unwind worked out.
+  lldb::FuncUnwindersSP
+  GetExistingFuncUnwindersContainingAddress(const Address &addr);
+
   bool GetAllowAssemblyEmulationUnwindPlans();
 
   // Normally when we create a new FuncUnwinders object we track it in this
@@ -66,6 +72,8 @@ private:
   typedef collection::iterator iterator;
   typedef collection::const_iterator const_iterator;
 
+  iterator FindFuncUnwinders(const Address &addr, iterator &insert_pos);
+
   ObjectFile &m_object_file;
   collection m_unwinds;
 
@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -21,8 +22,81 @@
 // Project includes
 #include "lldb/Core/RangeMap.h"
 #include "lldb/lldb-private.h"
+#include "llvm/ADT/ArrayRef.h"
 
 namespace lldb_private {
+//----------------------------------------------------------------------
+// Fixed size cache lines keyed by their address. The lines are carved out
+// of slabs, which are kept for reuse when the table is cleared, and are
+// found through an open addressing hash table with linear probing.
+//----------------------------------------------------------------------
+class MemoryCacheLineTable {
+public:
+  MemoryCacheLineTable(uint32_t line_byte_size);
+
+  ~MemoryCacheLineTable();
+
+  // Remove all lines. The slabs are freed only if the line size changes.
+  void Clear(uint32_t line_byte_size);
+
+  void Clear() { Clear(m_line_byte_size); }
+
+  // Return the bytes of the line at line_addr, or nullptr if it isn't in
+  // the table. byte_size is less than the line size for lines that could
+  // only be read in part.
+  const uint8_t *Find(lldb::addr_t line_addr, uint32_t &byte_size) const;
+
+  bool Contains(lldb::addr_t line_addr) const {
+    return FindSlot(line_addr) != UINT32_MAX;
+  }
+
+  // Add or replace the line at line_addr with the first byte_size bytes of
+  // src, which may be no more than the line size.
+  void Insert(lldb::addr_t line_addr, const uint8_t *src, uint32_t byte_size);
+
+  bool Erase(lldb::addr_t line_addr);
+
+  // Remove the lines that intersect [addr, addr + size) and return how many
+  // there were.
+  size_t Erase(lldb::addr_t addr, lldb::addr_t size);
+
+  size_t GetSize() const { return m_num_lines; }
+
+  bool IsEmpty() const { return m_num_lines == 0; }
+
+  uint32_t GetLineByteSize() const { return m_line_byte_size; }
+
+protected:
+  struct Slot {
+    lldb::addr_t line_addr; // LLDB_INVALID_ADDRESS for empty slots
+    uint32_t line_idx;      // The index of the line's bytes in the slabs
+    uint32_t byte_size;
+  };
+
+  enum { kLinesPerSlab = 64 };
+
+  uint32_t GetHomeSlot(lldb::addr_t line_addr) const;
+
+  uint32_t FindSlot(lldb::addr_t line_addr) const;
+
+  uint8_t *GetLineBytes(uint32_t line_idx) const;
+
+  uint32_t AllocateLine();
+
+  void Grow();
+
+  std::vector<Slot> m_slots; // A power of two in size, at most 3/4 full
+  uint32_t m_hash_shift;
+  std::vector<std::unique_ptr<uint8_t[]>> m_slabs;
+  std::vector<uint32_t> m_free_lines;
+  uint32_t m_num_allocated_lines; // Lines handed out from the slabs
+  uint32_t m_num_lines;
+  uint32_t m_line_byte_size;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(MemoryCacheLineTable);
+};
+
 //----------------------------------------------------------------------
 // A class to track memory that was read from a live process between
 // runs.
@@ -36,12 +110,36 @@ public:
 
   ~MemoryCache();
 
+  struct Stats {
+    // Reads are counted per cache line, except for reads that fit in an L1
+    // chunk or are too large to cache.
+    uint64_t read_only_hits = 0; // Lines found in the read-only cache
+    uint64_t hits = 0;           // Lines or chunks found in the L1 or L2 cache
+    uint64_t misses = 0;         // Lines or chunks read from the process
+    uint64_t read_ahead_lines = 0; // Lines read before they were asked for
+    uint64_t read_only_lines = 0;
+    uint64_t read_only_invalidations = 0;
+  };
+
+  // Clear the memory that was read since the process last stopped. Cache
+  // lines of loaded sections that aren't writable survive this, see
+  // ClearReadOnly(). Other read-only memory may be remapped while the
+  // process runs, so its lines are cleared too.
   void Clear(bool clear_invalid_ranges = false);
 
+  // Clear the cache lines of read-only memory, and forget which regions
+  // are read-only. This must be done when modules are unloaded or the
+  // process execs, as the mappings change.
+  void ClearReadOnly();
+
   void Flush(lldb::addr_t addr, size_t size);
 
   size_t Read(lldb::addr_t addr, void *dst, size_t dst_len, Status &error);
 
+  // Read the cache lines that contain each of the addresses that aren't
+  // cached yet, with a single request if the process supports it.
+  void Prefetch(llvm::ArrayRef<lldb::addr_t> addrs);
+
   uint32_t GetMemoryCacheLineSize() const { return m_L2_cache_line_byte_size; }
 
   void AddInvalidRange(lldb::addr_t base_addr, lldb::addr_t byte_size);
@@ -54,29 +152,77 @@ public:
   void AddL1CacheData(lldb::addr_t addr,
                       const lldb::DataBufferSP &data_buffer_sp);
 
+  Stats GetStats() const;
+
 protected:
   typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
   typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
   typedef Range<lldb::addr_t, lldb::addr_t> AddrRange;
+  // Address ranges whose permissions are known, mapped to whether they
+  // are read-only.
+  typedef RangeDataVector<lldb::addr_t, lldb::addr_t, bool> RegionPermissions;
+
+  // Read the line at line_addr from the process into the cache, along with
+  // the lines after it if the reads look sequential. The lock is dropped
+  // while the process is read so that other threads can use the cache in
+  // the meantime. The lines are left in buf, the first one line_byte_size
+  // bytes long. Returns false if nothing could be read.
+  bool ReadCacheLines(lldb::addr_t line_addr,
+                      std::unique_lock<std::mutex> &lock,
+                      std::vector<uint8_t> &buf, uint32_t &line_byte_size,
+                      Status &error);
+
+  // Add a cache line read from the process to the read-only cache if its
+  // memory can't be written, or to the L2 cache otherwise.
+  void AddCacheLine(lldb::addr_t line_addr, const uint8_t *src,
+                    uint32_t byte_size);
+
+  // Returns true if [addr, addr + size) is known to be read-only.
+  bool IsReadOnly(lldb::addr_t addr, lldb::addr_t size);
+
+  const RegionPermissions::Entry *FindRegionPermissions(lldb::addr_t addr);
+
+  // Find out whether the memory at addr can be written, from the loaded
+  // sections or by asking the process. Called without the lock held, as
+  // that may take a round trip to a debug server.
+  bool GetRegionPermissions(lldb::addr_t addr, RegionPermissions::Entry &region,
+                            bool &from_section);
+
+  void AddRegionPermissions(const RegionPermissions::Entry &region,
+                            bool from_section);
+
   //------------------------------------------------------------------
   // Classes that inherit from MemoryCache can see and modify these
   //------------------------------------------------------------------
-  std::recursive_mutex m_mutex;
+  mutable std::mutex m_mutex;
   BlockMap m_L1_cache; // A first level memory cache whose chunk sizes vary that
                        // will be used only if the memory read fits entirely in
                        // a chunk
-  BlockMap m_L2_cache; // A memory cache of fixed size chinks
-                       // (m_L2_cache_line_byte_size bytes in size each)
+  MemoryCacheLineTable m_L2_cache; // A memory cache of fixed size chunks
+                                   // (m_L2_cache_line_byte_size bytes each)
+  MemoryCacheLineTable m_read_only_cache; // L2 sized cache lines of memory
+                                          // that isn't writable, which are
+                                          // kept while the process runs
+  RegionPermissions m_region_permissions; // Loaded sections
+  RegionPermissions m_process_regions; // Regions the process reported, which
+                                       // are forgotten when it resumes
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  uint32_t m_max_read_ahead_lines;
+  // The line a sequential read would miss next, and how many lines to read
+  // when it does.
+  lldb::addr_t m_next_sequential_line_addr;
+  uint32_t m_read_ahead_lines;
+  // Bumped whenever cached memory is dropped, so that data read from the
+  // process without holding m_mutex isn't cached if it may be stale.
+  uint32_t m_generation;
+  Stats m_stats;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(MemoryCache);
 };
 
-    
-
 class AllocatedBlock {
 public:
   AllocatedBlock(lldb::addr_t addr, uint32_t byte_size, uint32_t permissions,
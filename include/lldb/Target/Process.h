@@ -73,6 +73,8 @@ public:
 
   uint64_t GetMemoryCacheLineSize() const;
 
+  uint64_t GetMemoryCacheReadAhead() const;
+
   Args GetExtraStartupCommands() const;
 
   void SetExtraStartupCommands(const Args &args);
@@ -99,6 +101,8 @@ public:
 
   bool GetWarningsOptimization() const;
 
+  bool GetParallelUnwind() const;
+
 protected:
   static void OptionValueChangedCallback(void *baton,
                                          OptionValue *option_value);
@@ -1283,6 +1287,15 @@ public:
   //------------------------------------------------------------------
   virtual void DidResume() {}
 
+  //------------------------------------------------------------------
+  /// Check if the process plug-in can keep a thread stepping while its
+  /// PC stays in an address range, reporting a single stop when it
+  /// leaves the range.
+  ///
+  /// @see ThreadPlan::GetSteppingRange()
+  //------------------------------------------------------------------
+  virtual bool SupportsRangeStepping() { return false; }
+
   //------------------------------------------------------------------
   /// Called before halting to a process.
   ///
@@ -1519,6 +1532,11 @@ public:
   //------------------------------------------------------------------
   virtual void ModulesDidLoad(ModuleList &module_list);
 
+  //------------------------------------------------------------------
+  // Notify this process class that modules got unloaded.
+  //------------------------------------------------------------------
+  void ModulesDidUnload(ModuleList &module_list);
+
   //------------------------------------------------------------------
   /// Retrieve the list of shared libraries that are loaded for this process
   /// This method is used on pre-macOS 10.12, pre-iOS 10, pre-tvOS 10,
@@ -1708,6 +1726,38 @@ public:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  typedef Range<lldb::addr_t, lldb::addr_t> MemoryRange;
+
+  //------------------------------------------------------------------
+  /// Actually do the reading of several ranges of memory from a
+  /// process with a single request.
+  ///
+  /// Subclasses whose memory reads each cost a round trip should
+  /// override this function. Reads of a range that stop short, or
+  /// fail, don't fail the other ranges.
+  ///
+  /// @param[in] ranges
+  ///     The ranges of memory to read.
+  ///
+  /// @param[out] buf
+  ///     A byte buffer that is at least as large as all of the \a
+  ///     ranges together, that will receive the bytes of each range
+  ///     back to back. A range occupies its full size in \a buf
+  ///     even if it can only be read in part.
+  ///
+  /// @param[out] bytes_read
+  ///     The number of bytes that were actually read for each range.
+  ///
+  /// @return
+  ///     False if this process can't read several ranges at once, in
+  ///     which case callers should read each range with ReadMemory.
+  //------------------------------------------------------------------
+  virtual bool DoReadMemoryRanges(llvm::ArrayRef<MemoryRange> ranges,
+                                  uint8_t *buf,
+                                  std::vector<size_t> &bytes_read) {
+    return false;
+  }
+
   //------------------------------------------------------------------
   /// Read of memory from a process.
   ///
@@ -1790,6 +1840,25 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  bool ReadMemoryRangesFromInferior(llvm::ArrayRef<MemoryRange> ranges,
+                                    uint8_t *buf,
+                                    std::vector<size_t> &bytes_read);
+
+  //------------------------------------------------------------------
+  /// Bring the memory around each of \a addrs into the memory cache.
+  ///
+  /// Callers that are about to read small pieces of memory from many
+  /// unrelated addresses, like the pointees of the children of a
+  /// value, can use this so that the reads are all answered with a
+  /// single request. It does nothing if the memory cache is disabled
+  /// or the process can't read several ranges at once.
+  //------------------------------------------------------------------
+  void PrefetchMemory(llvm::ArrayRef<lldb::addr_t> addrs);
+
+  MemoryCache::Stats GetMemoryCacheStats() const {
+    return m_memory_cache.GetStats();
+  }
+
   //------------------------------------------------------------------
   /// Reads an unsigned integer of the specified byte size from
   /// process memory.
@@ -2317,6 +2386,12 @@ public:
     return error;
   }
 
+  //------------------------------------------------------------------
+  /// Called when the conditions or the owners of \a bp_site change,
+  /// for processes which hand the conditions to a debug server.
+  //------------------------------------------------------------------
+  virtual void UpdateBreakpointSiteConditions(BreakpointSite *bp_site) {}
+
   // This is implemented completely using the lldb::Process API. Subclasses
   // don't need to implement this function unless the standard flow of
   // read existing opcode, write breakpoint opcode, verify breakpoint opcode
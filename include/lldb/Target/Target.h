@@ -184,6 +184,8 @@ public:
 
   void SetNonStopModeEnabled(bool b);
 
+  bool GetBreakpointConditionsInTarget() const;
+
   bool GetDisplayRuntimeSupportValues() const;
 
   void SetDisplayRuntimeSupportValues(bool b);
@@ -433,6 +433,18 @@ public:
   virtual lldb::StackFrameSP
   GetFrameWithConcreteFrameIndex(uint32_t unwind_idx);
 
+  //------------------------------------------------------------------
+  /// Unwind the concrete frames of this thread ahead of building its
+  /// stack frames.
+  ///
+  /// This only uses the thread's own unwinder, so that several threads
+  /// can be unwound at once, see ThreadList::UnwindAllThreads().
+  ///
+  /// @param[in] num_frames
+  ///     How many frames to unwind, or UINT32_MAX for all of them.
+  //------------------------------------------------------------------
+  void UnwindConcreteFrames(uint32_t num_frames = UINT32_MAX);
+
   bool DecrementCurrentInlinedDepth() {
     return GetStackFrameList()->DecrementCurrentInlinedDepth();
   }
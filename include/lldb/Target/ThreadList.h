@@ -131,6 +131,18 @@ public:
 
   void DiscardThreadPlans();
 
+  //------------------------------------------------------------------
+  /// Unwind the concrete frames of all threads in parallel, so that
+  /// showing all of their stacks afterwards doesn't wait on each unwind
+  /// in turn. Does nothing unless the process is stopped and its
+  /// "parallel-unwind" setting is on.
+  ///
+  /// @param[in] num_frames
+  ///     How many frames of each thread to unwind, or UINT32_MAX for
+  ///     all of them.
+  //------------------------------------------------------------------
+  void UnwindAllThreads(uint32_t num_frames = UINT32_MAX);
+
   uint32_t GetStopID() const;
 
   void SetStopID(uint32_t stop_id);
@@ -493,6 +493,18 @@ public:
 
   virtual bool IsPlanStale() { return false; }
 
+  //------------------------------------------------------------------
+  /// When this plan single steps the thread, get the range of load
+  /// addresses [\a start, \a end) the thread may keep stepping through
+  /// without the plan being consulted after each instruction.
+  ///
+  /// @return
+  ///     \b true if the plan has such a range, \b false otherwise.
+  //------------------------------------------------------------------
+  virtual bool GetSteppingRange(lldb::addr_t &start, lldb::addr_t &end) {
+    return false;
+  }
+
   bool PlanSucceeded() { return m_plan_succeeded; }
 
   virtual bool IsBasePlan() { return false; }
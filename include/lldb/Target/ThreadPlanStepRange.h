@@ -42,6 +42,7 @@ public:
   bool MischiefManaged() override;
   void DidPush() override;
   bool IsPlanStale() override;
+  bool GetSteppingRange(lldb::addr_t &start, lldb::addr_t &end) override;
 
   void AddRange(const AddressRange &new_range);
 
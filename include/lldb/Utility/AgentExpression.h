@@ -0,0 +1,144 @@
+//===-- AgentExpression.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_AgentExpression_h_
+#define liblldb_AgentExpression_h_
+
+#include "lldb/Utility/Status.h"
+#include "lldb/lldb-types.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint8_t, uint64_t
+
+#include <vector>
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class AgentExpression AgentExpression.h
+/// "lldb/Utility/AgentExpression.h"
+/// @brief A program in the bytecode of GDB agent expressions.
+///
+/// The debugger compiles simple breakpoint conditions to this bytecode
+/// and sends them to the debug server along with the breakpoint, which
+/// runs them every time the breakpoint is hit and only reports the
+/// stop if one of them is true.
+///
+/// Only the opcodes needed for integer conditions are supported; the
+/// tracing, floating point and variable opcodes make Evaluate() fail.
+//----------------------------------------------------------------------
+class AgentExpression {
+public:
+  enum Opcode : uint8_t {
+    eOpAdd = 0x02,
+    eOpSub = 0x03,
+    eOpMul = 0x04,
+    eOpDivSigned = 0x05,
+    eOpDivUnsigned = 0x06,
+    eOpRemSigned = 0x07,
+    eOpRemUnsigned = 0x08,
+    eOpLsh = 0x09,
+    eOpRshSigned = 0x0a,
+    eOpRshUnsigned = 0x0b,
+    eOpLogNot = 0x0e,
+    eOpBitAnd = 0x0f,
+    eOpBitOr = 0x10,
+    eOpBitXor = 0x11,
+    eOpBitNot = 0x12,
+    eOpEqual = 0x13,
+    eOpLessSigned = 0x14,
+    eOpLessUnsigned = 0x15,
+    eOpExt = 0x16,
+    eOpRef8 = 0x17,
+    eOpRef16 = 0x18,
+    eOpRef32 = 0x19,
+    eOpRef64 = 0x1a,
+    eOpIfGoto = 0x20,
+    eOpGoto = 0x21,
+    eOpConst8 = 0x22,
+    eOpConst16 = 0x23,
+    eOpConst32 = 0x24,
+    eOpConst64 = 0x25,
+    eOpReg = 0x26,
+    eOpEnd = 0x27,
+    eOpDup = 0x28,
+    eOpPop = 0x29,
+    eOpZeroExt = 0x2a,
+    eOpSwap = 0x2b
+  };
+
+  typedef llvm::function_ref<bool(uint32_t reg_num, uint64_t &value)>
+      ReadRegisterCallback;
+
+  typedef llvm::function_ref<bool(lldb::addr_t addr, void *buf, size_t size)>
+      ReadMemoryCallback;
+
+  AgentExpression() = default;
+
+  explicit AgentExpression(llvm::ArrayRef<uint8_t> bytecode)
+      : m_bytecode(bytecode.begin(), bytecode.end()) {}
+
+  const std::vector<uint8_t> &GetBytecode() const { return m_bytecode; }
+
+  bool IsEmpty() const { return m_bytecode.empty(); }
+
+  void Clear() { m_bytecode.clear(); }
+
+  bool operator==(const AgentExpression &rhs) const {
+    return m_bytecode == rhs.m_bytecode;
+  }
+
+  bool operator!=(const AgentExpression &rhs) const { return !(*this == rhs); }
+
+  //------------------------------------------------------------------
+  /// Append an opcode without operands.
+  //------------------------------------------------------------------
+  void AppendOpcode(Opcode opcode) { m_bytecode.push_back(opcode); }
+
+  //------------------------------------------------------------------
+  /// Append the shortest const opcode that pushes \a value.
+  //------------------------------------------------------------------
+  void AppendConstant(uint64_t value);
+
+  //------------------------------------------------------------------
+  /// Append a reg opcode that pushes register \a reg_num, numbered
+  /// the way the debug server numbers its registers.
+  //------------------------------------------------------------------
+  void AppendRegister(uint32_t reg_num);
+
+  //------------------------------------------------------------------
+  /// Append an ext or zero_ext opcode that extends the low \a bits of
+  /// the top of the stack to 64 bits.
+  //------------------------------------------------------------------
+  void AppendExtend(uint8_t bits, bool is_signed);
+
+  //------------------------------------------------------------------
+  /// Run the bytecode until its end opcode.
+  ///
+  /// @param[out] result
+  ///     The value on top of the stack at the end opcode.
+  ///
+  /// @return
+  ///     An error if the bytecode is malformed, uses an unsupported
+  ///     opcode, divides by zero or fails to read a register or memory.
+  //------------------------------------------------------------------
+  Status Evaluate(ReadRegisterCallback read_register,
+                  ReadMemoryCallback read_memory, uint64_t &result) const;
+
+private:
+  void AppendBigEndian(uint64_t value, size_t size);
+
+  std::vector<uint8_t> m_bytecode;
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_AgentExpression_h_
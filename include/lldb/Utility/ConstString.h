@@ -14,6 +14,7 @@
 #include "llvm/Support/FormatVariadic.h" // for format_provider
 
 #include <stddef.h> // for size_t
+#include <stdint.h> // for uint64_t
 
 namespace lldb_private {
 class Stream;
@@ -466,6 +467,33 @@ public:
   //------------------------------------------------------------------
   static size_t StaticMemorySize();
 
+  //------------------------------------------------------------------
+  /// Statistics about the global string pool.
+  //------------------------------------------------------------------
+  struct Stats {
+    /// The number of unique strings in the pool.
+    uint64_t num_strings = 0;
+    /// The bytes of string data, including the NULL terminators.
+    uint64_t string_bytes = 0;
+    /// The bytes the pool holds for its entries and hash tables.
+    uint64_t memory_size = 0;
+    /// The number of strings that were uniqued.
+    uint64_t num_lookups = 0;
+    /// The number of lookups that found an existing string without
+    /// taking a lock.
+    uint64_t num_lock_free_hits = 0;
+    /// The number of insertions that had to wait for another thread.
+    uint64_t num_lock_contentions = 0;
+  };
+
+  //------------------------------------------------------------------
+  /// Get a snapshot of the global string pool statistics.
+  ///
+  /// The counters are read without stopping other threads, so they
+  /// may be slightly out of sync with each other.
+  //------------------------------------------------------------------
+  static Stats GetStats();
+
 protected:
   //------------------------------------------------------------------
   // Member variables
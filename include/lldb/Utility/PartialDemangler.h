@@ -0,0 +1,142 @@
+//===-- PartialDemangler.h --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_PartialDemangler_h_
+#define liblldb_PartialDemangler_h_
+
+#include "lldb/lldb-defines.h" // for DISALLOW_COPY_AND_ASSIGN
+#include "llvm/ADT/StringRef.h"
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint16_t
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class PartialDemangler PartialDemangler.h
+/// "lldb/Utility/PartialDemangler.h"
+/// @brief Recovers the parts of an Itanium mangled function name that
+/// the symbol table indexes without producing the demangled name.
+///
+/// Only the name of the function is decoded; its parameter types are
+/// skipped. The parts are rendered exactly like the full demangler
+/// renders them, into a fixed size buffer owned by the demangler, so a
+/// single instance can be reused for many names without allocating.
+///
+/// Names that are not understood (operators, local entities, lambdas,
+/// template parameters, ABI tags, expressions and the like) or that do
+/// not fit the buffer make Parse() fail, and the caller is expected to
+/// fall back to the full demangler.
+//----------------------------------------------------------------------
+class PartialDemangler {
+public:
+  PartialDemangler();
+
+  //------------------------------------------------------------------
+  /// Decode the function name in \a mangled_name.
+  ///
+  /// @return
+  ///     True if the name was understood, in which case the accessors
+  ///     below describe it until the next call to Parse().
+  //------------------------------------------------------------------
+  bool Parse(llvm::StringRef mangled_name);
+
+  //------------------------------------------------------------------
+  /// The unqualified name of the function including its template
+  /// arguments, e.g. "push_back" or "get<0ul>".
+  //------------------------------------------------------------------
+  llvm::StringRef GetBasename() const { return GetRange(m_basename); }
+
+  //------------------------------------------------------------------
+  /// The declaration context of the function, e.g.
+  /// "std::vector<int, std::allocator<int> >", or an empty string.
+  //------------------------------------------------------------------
+  llvm::StringRef GetContext() const { return GetRange(m_context); }
+
+  //------------------------------------------------------------------
+  /// The template arguments of the function itself, e.g. "<0ul>", or
+  /// an empty string if it is not a template.
+  //------------------------------------------------------------------
+  llvm::StringRef GetTemplateArguments() const {
+    return GetRange(m_template_args);
+  }
+
+  //------------------------------------------------------------------
+  /// The cv and ref qualifiers of a method, e.g. "const" or
+  /// "const &", or an empty string.
+  //------------------------------------------------------------------
+  llvm::StringRef GetQualifiers() const { return GetRange(m_qualifiers); }
+
+  //------------------------------------------------------------------
+  /// True if the function is a constructor or destructor.
+  //------------------------------------------------------------------
+  bool IsCtorOrDtor() const { return m_is_ctor_or_dtor; }
+
+private:
+  enum { kBufferSize = 4096, kMaxSubstitutions = 128 };
+
+  struct Range {
+    uint16_t begin;
+    uint16_t end;
+  };
+
+  enum Qualifier {
+    eQualifierConst = 1u << 0,
+    eQualifierVolatile = 1u << 1,
+    eQualifierRestrict = 1u << 2,
+    eQualifierLValueRef = 1u << 3,
+    eQualifierRValueRef = 1u << 4
+  };
+
+  llvm::StringRef GetRange(Range range) const {
+    return llvm::StringRef(m_buffer + range.begin, range.end - range.begin);
+  }
+
+  bool Consume(char c);
+  bool Consume(llvm::StringRef prefix);
+  bool Append(llvm::StringRef text);
+  bool AppendRange(Range range);
+  bool AddSubstitution(size_t begin);
+  unsigned ParseCVQualifiers();
+  bool AppendCVQualifiers(unsigned qualifiers);
+  bool ParseNumber(size_t &value);
+  bool ParseSeqID(size_t &index);
+
+  bool ParseEncoding();
+  bool ParseNestedName(bool is_type);
+  bool ParseUnscopedName(bool is_type);
+  bool ParseUnqualifiedName(Range &source_name);
+  bool ParseSourceName(Range &source_name);
+  bool ParseCtorDtorName(Range class_name);
+  bool ParseSubstitution();
+  bool ParseTemplateArgs();
+  bool ParseTemplateArg();
+  bool ParseLiteral();
+  bool ParseType();
+  bool ParseBuiltinType();
+
+  const char *m_pos;
+  const char *m_end;
+  char m_buffer[kBufferSize];
+  size_t m_size;
+  Range m_substitutions[kMaxSubstitutions];
+  size_t m_num_substitutions;
+  Range m_basename;
+  Range m_context;
+  Range m_template_args;
+  Range m_qualifiers;
+  unsigned m_qualifier_flags;
+  bool m_is_ctor_or_dtor;
+
+  DISALLOW_COPY_AND_ASSIGN(PartialDemangler);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_PartialDemangler_h_
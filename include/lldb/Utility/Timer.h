@@ -29,10 +29,19 @@ public:
   public:
     explicit Category(const char *category_name);
 
+    //--------------------------------------------------------------
+    /// Record that \a count items were processed in this category so
+    /// that DumpCategoryTimes() can report a rate next to the time.
+    //--------------------------------------------------------------
+    void AddItems(uint64_t count) {
+      m_items.fetch_add(count, std::memory_order_relaxed);
+    }
+
   private:
     friend class Timer;
     const char *m_name;
     std::atomic<uint64_t> m_nanos;
+    std::atomic<uint64_t> m_items;
     std::atomic<Category *> m_next;
 
     DISALLOW_COPY_AND_ASSIGN(Category);
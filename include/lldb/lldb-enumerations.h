@@ -656,6 +656,8 @@ enum SectionType {
   eSectionTypeGoSymtab,
   eSectionTypeAbsoluteAddress, // Dummy section for symbols with absolute
                                // address
+  eSectionTypeDWARFDebugNames, // DWARF v5 .debug_names
+  eSectionTypeDWARFGdbIndex,   // .gdb_index emitted by gold and lld
   eSectionTypeOther
 };
 
@@ -0,0 +1,100 @@
+"""Test how fast lldb unwinds all the threads of a core file."""
+
+from __future__ import print_function
+
+
+import os
+import sys
+import lldb
+from lldbsuite.test import configuration
+from lldbsuite.test import lldbtest_config
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+
+
+class BacktraceAllThreadsBench(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        # self.stopwatch measures the first unwind of the core, which has to
+        # work out the unwind plans; self.stopwatch2 the unwinds after that.
+        self.stopwatch2 = Stopwatch()
+        # A core with many threads makes this interesting, e.g. one of a
+        # server with thousands of threads; the core in the test suite has
+        # just the one.
+        if "LLDB_BENCH_CORE" in os.environ:
+            self.core = os.environ["LLDB_BENCH_CORE"]
+            self.exe = os.environ.get("LLDB_BENCH_CORE_EXECUTABLE", "")
+        else:
+            core_dir = os.path.join(os.environ["LLDB_TEST"], "functionalities",
+                                    "postmortem", "elf-core")
+            self.core = os.path.join(core_dir, "linux-x86_64.core")
+            self.exe = os.path.join(core_dir, "linux-x86_64.out")
+        self.count = 20
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipIf(oslist=['windows'])
+    def test_backtrace_all_threads(self):
+        """Test unwinding every thread of a core file."""
+        print()
+        num_frames = self.run_backtrace_all_threads_bench(self.count)
+        print("lldb backtrace all threads benchmark (%d frames):" % num_frames)
+        print("first unwind:", self.stopwatch)
+        print("later unwinds:", self.stopwatch2)
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipIf(oslist=['windows'])
+    def test_thread_backtrace_all_command(self):
+        """Test 'thread backtrace all' with and without parallel unwinding."""
+        print()
+        serial = self.run_thread_backtrace_all_bench(self.count, False)
+        parallel = self.run_thread_backtrace_all_bench(self.count, True)
+        print("lldb 'thread backtrace all' benchmark:")
+        print("serial unwind:", serial)
+        print("parallel unwind:", parallel)
+
+    def run_thread_backtrace_all_bench(self, count, parallel):
+        self.runCmd("settings set target.process.parallel-unwind %s" %
+                    ("true" if parallel else "false"))
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear target.process.parallel-unwind"))
+        stopwatch = Stopwatch()
+        for i in range(count):
+            target = self.dbg.CreateTarget(self.exe)
+            self.assertTrue(target, VALID_TARGET)
+            process = target.LoadCore(self.core)
+            self.assertTrue(process, PROCESS_IS_VALID)
+
+            result = lldb.SBCommandReturnObject()
+            with stopwatch:
+                self.dbg.GetCommandInterpreter().HandleCommand(
+                    "thread backtrace all", result)
+            self.assertTrue(result.Succeeded(), result.GetError())
+            self.dbg.DeleteTarget(target)
+        return stopwatch
+
+    def run_backtrace_all_threads_bench(self, count):
+        # Keep the targets until the end so that their modules, and the unwind
+        # plans worked out for them, stay around.
+        targets = []
+        num_frames = 0
+        for i in range(count):
+            target = self.dbg.CreateTarget(self.exe)
+            self.assertTrue(target, VALID_TARGET)
+            targets.append(target)
+            process = target.LoadCore(self.core)
+            self.assertTrue(process, PROCESS_IS_VALID)
+
+            with self.stopwatch if i == 0 else self.stopwatch2:
+                num_frames = 0
+                for thread in process:
+                    num_frames += thread.GetNumFrames()
+            self.assertTrue(num_frames > 0)
+
+        for target in targets:
+            self.dbg.DeleteTarget(target)
+        return num_frames
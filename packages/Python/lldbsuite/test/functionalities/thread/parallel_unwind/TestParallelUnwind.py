@@ -0,0 +1,68 @@
+"""
+Test that 'thread backtrace all' shows the same backtraces whether it unwinds
+the threads in parallel or one after the other.
+"""
+
+from __future__ import print_function
+
+
+import os
+import re
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class ParallelUnwindTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfWindows
+    def test_parallel_unwind(self):
+        """Test unwinding all threads in parallel and serially."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        for text in ["// Set first breakpoint here.",
+                     "// Set second breakpoint here."]:
+            lldbutil.run_break_set_by_file_and_line(
+                self, "main.cpp", line_number("main.cpp", text),
+                num_expected_locations=1)
+
+        process = target.LaunchSimple(
+            None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+        self.assertTrue(process.GetNumThreads() > 8)
+
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear target.process.parallel-unwind"))
+
+        # The waiting threads stay where they are between the two stops, and
+        # a stop throws away the frames the first unwind found.
+        self.runCmd("settings set target.process.parallel-unwind false")
+        serial = self.get_waiting_thread_backtraces()
+        self.runCmd("continue")
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+        self.runCmd("settings set target.process.parallel-unwind true")
+        parallel = self.get_waiting_thread_backtraces()
+
+        self.assertEqual(len(serial), process.GetNumThreads() - 1)
+        self.assertEqual(serial, parallel)
+
+    def get_waiting_thread_backtraces(self):
+        """Return the backtraces of all but the main thread, which moves
+        between the stops, by thread index."""
+        self.runCmd("thread backtrace all")
+        output = self.res.GetOutput()
+        backtraces = {}
+        for backtrace in re.split(r"^[* ] thread #", output, flags=re.M)[1:]:
+            index = int(re.match(r"\d+", backtrace).group(0))
+            if index != 1:
+                backtraces[index] = backtrace
+        for index, backtrace in backtraces.items():
+            self.assertTrue("wait_at_depth" in backtrace, backtrace)
+        return backtraces
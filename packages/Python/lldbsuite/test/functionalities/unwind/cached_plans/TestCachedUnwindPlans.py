@@ -0,0 +1,91 @@
+"""
+Test that unwinding threads again, with the unwind plans the first unwind
+settled on, finds the same frames and registers.
+"""
+
+from __future__ import print_function
+
+
+import os
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class CachedUnwindPlansTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfWindows
+    def test_cold_and_warm_unwind(self):
+        """Test that a cold and a warm unwind of waiting threads agree."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        for text in ["// Set first breakpoint here.",
+                     "// Set second breakpoint here."]:
+            lldbutil.run_break_set_by_file_and_line(
+                self, "main.cpp", line_number("main.cpp", text),
+                num_expected_locations=1)
+
+        process = target.LaunchSimple(
+            None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+
+        # The waiting threads stay where they are between the two stops. The
+        # first stop unwinds them cold, the second with the plans the first
+        # one recorded, which takes the fast path for most frames.
+        cold = self.get_waiting_thread_frames(process)
+        self.runCmd("continue")
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+        warm = self.get_waiting_thread_frames(process)
+
+        self.assertEqual(len(cold), process.GetNumThreads() - 1)
+        self.assertEqual(sorted(cold.keys()), sorted(warm.keys()))
+        for index in cold:
+            self.assertEqual(cold[index], warm[index],
+                             "thread #%d unwinds the same" % index)
+
+    def get_callee_saved_registers(self):
+        arch = self.getArchitecture()
+        if arch == "x86_64":
+            return ["rbx", "r12", "r13", "r14", "r15"]
+        if arch in ["i386", "i686"]:
+            return ["ebx", "esi", "edi"]
+        if arch in ["aarch64", "arm64"]:
+            return ["x%d" % i for i in range(19, 29)]
+        if arch.startswith("arm"):
+            return ["r%d" % i for i in range(4, 11)]
+        return []
+
+    def get_waiting_thread_frames(self, process):
+        """Return the pc, cfa, fp and callee-saved registers of the frames of
+        all but the main thread, which moves between the stops, by thread
+        index."""
+        threads = [thread for thread in process if thread.GetIndexID() != 1]
+
+        # Unwind all the threads before reading any registers, which makes
+        # full register contexts for the frames.
+        frames = {}
+        for thread in threads:
+            frames[thread.GetIndexID()] = [
+                [frame.GetPC(), frame.GetCFA()] for frame in thread]
+            self.assertTrue(
+                any(frame.GetFunctionName() and
+                    "wait_at_depth" in frame.GetFunctionName()
+                    for frame in thread),
+                "thread #%d waits in wait_at_depth" % thread.GetIndexID())
+
+        registers = self.get_callee_saved_registers()
+        for thread in threads:
+            for frame, values in zip(thread, frames[thread.GetIndexID()]):
+                values.append(frame.GetFP())
+                for name in registers:
+                    value = frame.FindRegister(name)
+                    values.append(value.GetValue() if value.IsValid()
+                                  else None)
+        return frames
@@ -0,0 +1,59 @@
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int num_threads = 8;
+
+std::mutex mutex;
+std::condition_variable ready_cond;
+std::condition_variable go_cond;
+int num_ready = 0;
+bool go = false;
+
+__attribute__((noinline)) int
+wait_for_go()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    ++num_ready;
+    ready_cond.notify_one();
+    go_cond.wait(lock, [] { return go; });
+    return num_ready;
+}
+
+// Each thread waits a frame further down than the one before it, and each
+// frame keeps a value live across the call.
+__attribute__((noinline)) int
+wait_at_depth(int depth)
+{
+    if (depth == 0)
+        return wait_for_go();
+    int value = depth * 3;
+    int result = wait_at_depth(depth - 1);
+    return result * value + depth;
+}
+
+int main()
+{
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+        threads.push_back(std::thread(wait_at_depth, i + 2));
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready_cond.wait(lock, [] { return num_ready == num_threads; });
+    }
+
+    volatile int stops = 0; // Set first breakpoint here.
+    stops = stops + 1; // Set second breakpoint here.
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        go = true;
+    }
+    go_cond.notify_all();
+    for (auto &t : threads)
+        t.join();
+
+    return stops;
+}
@@ -0,0 +1,111 @@
+from __future__ import print_function
+
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestGdbRemoteConditionalBreakpoints(
+        gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Agent expressions which push a constant and end.
+    ALWAYS_FALSE = "220027"
+    ALWAYS_TRUE = "220127"
+
+    def conditional_breakpoints_are_supported(self):
+        server = self.connect_to_debug_monitor()
+        self.assertIsNotNone(server)
+
+        self.add_no_ack_remote_stream()
+        self.add_qSupported_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        features = self.parse_qSupported_response(context)
+        self.assertEqual(features.get("ConditionalBreakpoints"), "+")
+
+    def get_function_address(self):
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=[
+                "get-code-address-hex:hello",
+                "sleep:1",
+                "call-function:hello"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             {"type": "output_match",
+              "regex": self.maybe_strict_output_regex(
+                  r"code address: 0x([0-9a-fA-F]+)\r\n"),
+              "capture": {1: "function_address"}},
+             "read packet: {}".format(chr(3)),
+             {"direction": "send",
+              "regex": r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);"}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("function_address"))
+        return int(context.get("function_address"), 16)
+
+    def breakpoint_kind(self):
+        if self.getArchitecture() in ["arm", "aarch64"]:
+            return 4
+        return 1
+
+    def false_condition_does_not_stop(self):
+        function_address = self.get_function_address()
+
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $Z0,{0:x},{1};X3,{2}#00".format(
+                function_address, self.breakpoint_kind(), self.ALWAYS_FALSE),
+             "send packet: $OK#00",
+             "read packet: $c#63",
+             # The inferior runs through the breakpoint and exits.
+             "send packet: $W00#00"],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    def true_condition_stops(self):
+        function_address = self.get_function_address()
+
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $Z0,{0:x},{1};X3,{2};X3,{3}#00".format(
+                function_address, self.breakpoint_kind(), self.ALWAYS_FALSE,
+                self.ALWAYS_TRUE),
+             "send packet: $OK#00",
+             "read packet: $c#63",
+             {"direction": "send",
+              "regex": r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);",
+              "capture": {1: "stop_signo"}}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEqual(int(context.get("stop_signo"), 16),
+                         lldbutil.get_signal_number('SIGTRAP'))
+
+    @llgs_test
+    def test_conditional_breakpoints_are_supported_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.conditional_breakpoints_are_supported()
+
+    # Targets that single step in software report every hit.
+    @llgs_test
+    @skipIf(archs=["arm", "mips", "mipsel", "mips64", "mips64el"])
+    def test_false_condition_does_not_stop_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.false_condition_does_not_stop()
+
+    @llgs_test
+    def test_true_condition_stops_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.true_condition_stops()
@@ -2,6 +2,7 @@ from __future__ import print_function
 
 
 import gdbremote_testcase
+import lldbgdbserverutils
 from lldbsuite.test.decorators import *
 from lldbsuite.test.lldbtest import *
 from lldbsuite.test import lldbutil
@@ -12,7 +13,7 @@ class TestGdbRemoteExpeditedRegisters(
 
     mydir = TestBase.compute_mydir(__file__)
 
-    def gather_expedited_registers(self):
+    def gather_stop_notification_key_vals(self):
         # Setup the stub and set the gdb remote command stream.
         procs = self.prep_debug_monitor_and_inferior(inferior_args=["sleep:2"])
         self.test_sequence.add_log_lines([
@@ -30,10 +31,13 @@ class TestGdbRemoteExpeditedRegisters(
         context = self.expect_gdbremote_sequence()
         self.assertIsNotNone(context)
 
-        # Pull out expedited registers.
         key_vals_text = context.get("key_vals_text")
         self.assertIsNotNone(key_vals_text)
+        return key_vals_text
 
+    def gather_expedited_registers(self):
+        # Pull out expedited registers.
+        key_vals_text = self.gather_stop_notification_key_vals()
         expedited_registers = self.extract_registers_from_stop_notification(
             key_vals_text)
         self.assertIsNotNone(expedited_registers)
@@ -157,3 +161,35 @@ class TestGdbRemoteExpeditedRegisters(
         self.build()
         self.set_inferior_startup_launch()
         self.stop_notification_contains_sp_register()
+
+    def stop_notification_contains_stack_memory(self):
+        key_vals_text = self.gather_stop_notification_key_vals()
+        key_vals = self.parse_key_val_dict(key_vals_text)
+        self.assertTrue("memory" in key_vals)
+        memory = key_vals["memory"]
+        if not isinstance(memory, list):
+            memory = [memory]
+        addresses = [int(window.split("=")[0], 0) for window in memory]
+
+        # One of the windows of memory starts at the stack pointer.
+        self.reset_test_sequence()
+        self.add_process_info_collection_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        endian = self.parse_process_info_response(context).get("endian")
+        self.assertIsNotNone(endian)
+
+        reg_infos = self.gather_register_infos()
+        sp_info = self.find_generic_register_with_name(reg_infos, "sp")
+        self.assertIsNotNone(sp_info)
+        sp_value = key_vals.get("{:02x}".format(sp_info["lldb_register_index"]))
+        self.assertIsNotNone(sp_value)
+        sp = lldbgdbserverutils.unpack_register_hex_unsigned(endian, sp_value)
+        self.assertTrue(sp in addresses)
+
+    @llgs_test
+    def test_stop_notification_contains_stack_memory_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.stop_notification_contains_stack_memory()
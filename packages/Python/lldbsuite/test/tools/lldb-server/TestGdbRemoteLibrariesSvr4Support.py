@@ -0,0 +1,53 @@
+from __future__ import print_function
+
+
+import xml.etree.ElementTree as ET
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestGdbRemoteLibrariesSvr4Support(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def libraries_svr4_lists_loaded_libraries(self):
+        # Let the dynamic linker load the libraries before looking at them.
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["sleep:5"])
+        self.add_qSupported_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        features = self.parse_qSupported_response(context)
+        self.assertEqual(features.get("qXfer:libraries-svr4:read"), "+")
+
+        self.reset_test_sequence()
+        self.run_process_then_stop(run_seconds=1)
+
+        # Read the list in small chunks to exercise the offsets.
+        library_list = self.read_binary_data_in_chunks(
+            "qXfer:libraries-svr4:read::", 0x40)
+        root = ET.fromstring(library_list)
+        self.assertEqual(root.tag, "library-list-svr4")
+        # The client would mistake main-lm for the r_debug address.
+        self.assertIsNone(root.get("main-lm"))
+
+        libraries = root.findall("./library")
+        self.assertTrue(len(libraries) > 0)
+        for library in libraries:
+            for attribute in ["name", "lm", "l_addr", "l_ld"]:
+                self.assertIsNotNone(library.get(attribute))
+            self.assertNotEqual(int(library.get("lm"), 16), 0)
+
+        names = [library.get("name") for library in libraries]
+        self.assertTrue(any("libc." in name for name in names), names)
+
+    @llgs_test
+    @skipUnlessPlatform(["linux"])
+    def test_libraries_svr4_lists_loaded_libraries_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.libraries_svr4_lists_loaded_libraries()
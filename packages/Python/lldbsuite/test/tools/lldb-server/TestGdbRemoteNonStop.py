@@ -0,0 +1,60 @@
+from __future__ import print_function
+
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestGdbRemoteNonStop(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def non_stop_is_supported(self):
+        server = self.connect_to_debug_monitor()
+        self.assertIsNotNone(server)
+
+        self.add_no_ack_remote_stream()
+        self.add_qSupported_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        features = self.parse_qSupported_response(context)
+        self.assertEqual(features.get("QNonStop"), "+")
+
+    def stop_is_reported_as_notification(self):
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["sleep:5"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $QNonStop:1#8d",
+             "send packet: $OK#00",
+             # Resuming replies right away, the process keeps running.
+             "read packet: $vCont;c#a8",
+             "send packet: $OK#00",
+             "read packet: $vCont;t#b9",
+             "send packet: $OK#00",
+             # The stop of the only thread arrives as a notification.
+             {"direction": "send",
+              "regex": r"^%Stop:T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);",
+              "capture": {1: "stop_signo", 2: "stop_thread_id"}},
+             # There are no more stops to report.
+             "read packet: $vStopped#55",
+             "send packet: $OK#00"],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("stop_thread_id"))
+
+    @llgs_test
+    def test_non_stop_is_supported_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.non_stop_is_supported()
+
+    @llgs_test
+    def test_stop_is_reported_as_notification_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.stop_is_reported_as_notification()
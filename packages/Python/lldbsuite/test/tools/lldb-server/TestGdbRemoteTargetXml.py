@@ -0,0 +1,56 @@
+from __future__ import print_function
+
+
+import xml.etree.ElementTree as ET
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestGdbRemoteTargetXml(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def target_xml_matches_register_info(self):
+        launch_args = self.install_and_create_launch_args()
+
+        server = self.connect_to_debug_monitor()
+        self.assertIsNotNone(server)
+
+        self.add_no_ack_remote_stream()
+        self.add_verified_launch_packets(launch_args)
+        self.add_qSupported_packets()
+        self.add_register_info_collection_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        features = self.parse_qSupported_response(context)
+        self.assertEqual(features.get("qXfer:features:read"), "+")
+        reg_infos = self.parse_register_info_packets(context)
+        self.assertTrue(len(reg_infos) > 0)
+
+        # Read the description in small chunks to exercise the offsets.
+        target_xml = self.read_binary_data_in_chunks(
+            "qXfer:features:read:target.xml:", 0x80)
+        root = ET.fromstring(target_xml)
+        self.assertEqual(root.tag, "target")
+        regs = root.findall("./feature/reg")
+        self.assertEqual(len(regs), len(reg_infos))
+
+        for reg, reg_info in zip(regs, reg_infos):
+            self.assertEqual(reg.get("name"), reg_info["name"])
+            self.assertEqual(reg.get("bitsize"), reg_info["bitsize"])
+            self.assertEqual(reg.get("offset"), reg_info["offset"])
+            self.assertEqual(reg.get("encoding"), reg_info.get("encoding"))
+            self.assertEqual(reg.get("format"), reg_info.get("format"))
+            self.assertEqual(reg.get("group"), reg_info.get("set"))
+            self.assertEqual(reg.get("generic"), reg_info.get("generic"))
+
+    @llgs_test
+    def test_target_xml_matches_register_info_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.target_xml_matches_register_info()
@@ -39,6 +39,9 @@ class TestGdbRemote_vCont(gdbremote_testcase.GdbRemoteTestCaseBase):
     def vCont_supports_S(self):
         self.vCont_supports_mode("S")
 
+    def vCont_supports_r(self):
+        self.vCont_supports_mode("r")
+
     @debugserver_test
     def test_vCont_supports_c_debugserver(self):
         self.init_debugserver_test()
@@ -87,6 +90,16 @@ class TestGdbRemote_vCont(gdbremote_testcase.GdbRemoteTestCaseBase):
         self.build()
         self.vCont_supports_S()
 
+    # Range stepping needs hardware single stepping, and NetBSD doesn't do it.
+    @llgs_test
+    @skipIf(archs=["arm"])
+    @skipIf(triple='^mips')
+    @skipIf(oslist=["netbsd"])
+    def test_vCont_supports_r_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.vCont_supports_r()
+
     @debugserver_test
     def test_single_step_only_steps_one_instruction_with_Hc_vCont_s_debugserver(
             self):
@@ -145,3 +158,25 @@ class TestGdbRemote_vCont(gdbremote_testcase.GdbRemoteTestCaseBase):
         self.set_inferior_startup_launch()
         self.single_step_only_steps_one_instruction(
             use_Hc_packet=False, step_instruction="vCont;s:{thread}")
+
+    @llgs_test
+    @expectedFailureAndroid(
+        bugnumber="llvm.org/pr24739",
+        archs=[
+            "arm",
+            "aarch64"])
+    @expectedFailureAll(
+        oslist=["linux"],
+        archs=[
+            "arm",
+            "aarch64"],
+        bugnumber="llvm.org/pr24739")
+    @skipIf(triple='^mips')
+    def test_single_step_only_steps_one_instruction_with_empty_vCont_r_llgs(
+            self):
+        # An empty range steps a single instruction, just like 's'.
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.single_step_only_steps_one_instruction(
+            use_Hc_packet=False, step_instruction="vCont;r0,0:{thread}")
@@ -865,6 +865,100 @@ class LldbGdbServerTestCase(gdbremote_testcase.GdbRemoteTestCaseBase, DwarfOpcod
         self.set_inferior_startup_launch()
         self.m_packet_reads_memory()
 
+    def launch_and_stop_with_message(self, message):
+        # Start up the inferior and stop it once it has set its message.
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=[
+                "set-message:%s" %
+                message,
+                "get-data-address-hex:g_message",
+                "sleep:5"])
+
+        self.test_sequence.add_log_lines(
+            [
+                "read packet: $c#63",
+                {"type": "output_match", "regex": self.maybe_strict_output_regex(r"data address: 0x([0-9a-fA-F]+)\r\n"),
+                 "capture": {1: "message_address"}},
+                "read packet: {}".format(chr(3)),
+                {"direction": "send", "regex": r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture": {1: "stop_signo", 2: "stop_thread_id"}}],
+            True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("message_address"))
+        return int(context.get("message_address"), 16)
+
+    def MultiMemRead_reads_several_ranges(self):
+        MEMORY_CONTENTS = "Test contents 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz"
+        message_address = self.launch_and_stop_with_message(MEMORY_CONTENTS)
+
+        # Read two slices of the message and an unreadable range in between.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $MultiMemRead:ranges:{0:x},4,0,8,{1:x},a;#00".format(message_address, message_address + 14),
+             {"direction": "send", "regex": r"^\$([0-9a-fA-F,]+);(.*)#[0-9a-fA-F]{2}$", "capture": {1: "lengths", 2: "contents"}}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        self.assertEqual(context.get("lengths"), "4,0,a")
+        self.assertEqual(context.get("contents"), "Test0123456789")
+
+    @llgs_test
+    def test_MultiMemRead_reads_several_ranges_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.MultiMemRead_reads_several_ranges()
+
+    def MultiMemRead_rejects_oversized_requests(self):
+        message_address = self.launch_and_stop_with_message("Test contents")
+
+        # Lengths that add up to more than a packet, or wrap around, fail the
+        # packet without reading anything.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $MultiMemRead:ranges:{0:x},40000;#00".format(message_address),
+             {"direction": "send", "regex": r"^\$E[0-9a-fA-F]{2}#[0-9a-fA-F]{2}$"},
+             "read packet: $MultiMemRead:ranges:{0:x},4,{0:x},fffffffffffffffe;#00".format(message_address),
+             {"direction": "send", "regex": r"^\$E[0-9a-fA-F]{2}#[0-9a-fA-F]{2}$"}],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    @llgs_test
+    def test_MultiMemRead_rejects_oversized_requests_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.MultiMemRead_rejects_oversized_requests()
+
+    def X_packet_writes_to_memory(self):
+        MEMORY_CONTENTS = "Test contents 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz"
+        message_address = self.launch_and_stop_with_message(MEMORY_CONTENTS)
+
+        # Write bytes that don't need escaping, then read them back with $m.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $X0,0:#00",
+             "send packet: $OK#00",
+             "read packet: $X{0:x},5:hello#00".format(message_address),
+             "send packet: $OK#00",
+             "read packet: $m{0:x},8#00".format(message_address),
+             {"direction": "send", "regex": r"^\$(.+)#[0-9a-fA-F]{2}$", "capture": {1: "read_contents"}}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        self.assertIsNotNone(context.get("read_contents"))
+        self.assertEqual(context.get("read_contents").decode("hex"), "hellocon")
+
+    @llgs_test
+    def test_X_packet_writes_to_memory_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.X_packet_writes_to_memory()
+
     def qMemoryRegionInfo_is_supported(self):
         # Start up the inferior.
         procs = self.prep_debug_monitor_and_inferior()
@@ -935,7 +935,10 @@ class GdbRemoteTestCaseBase(TestBase):
         "qXfer:libraries-svr4:read",
         "qXfer:features:read",
         "qEcho",
-        "QPassSignals"
+        "QPassSignals",
+        "SupportedCompressions",
+        "DefaultCompressionMinSize",
+        "MultiMemRead"
     ]
 
     def parse_qSupported_response(self, context):
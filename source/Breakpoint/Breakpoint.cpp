@@ -313,6 +313,8 @@ void Breakpoint::SetIgnoreCount(uint32_t n) {
     return;
 
   m_options_up->SetIgnoreCount(n);
+  for (size_t i = 0; i < m_locations.GetSize(); ++i)
+    m_locations.GetByIndex(i)->UpdateBreakpointSiteConditions();
   SendBreakpointChangedEvent(eBreakpointEventTypeIgnoreChanged);
 }
 
@@ -420,6 +422,8 @@ const char *Breakpoint::GetQueueName() const {
 
 void Breakpoint::SetCondition(const char *condition) {
   m_options_up->SetCondition(condition);
+  for (size_t i = 0; i < m_locations.GetSize(); ++i)
+    m_locations.GetByIndex(i)->UpdateBreakpointSiteConditions();
   SendBreakpointChangedEvent(eBreakpointEventTypeConditionChanged);
 }
 
@@ -17,6 +17,7 @@
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ValueObject.h"
+#include "lldb/Expression/AgentExpressionCompiler.h"
 #include "lldb/Expression/DiagnosticManager.h"
 #include "lldb/Expression/ExpressionVariable.h"
 #include "lldb/Expression/UserExpression.h"
@@ -40,7 +41,8 @@ BreakpointLocation::BreakpointLocation(break_id_t loc_id, Breakpoint &owner,
                         hardware),
       m_being_created(true), m_should_resolve_indirect_functions(false),
       m_is_reexported(false), m_is_indirect(false), m_address(addr),
-      m_owner(owner), m_options_ap(), m_bp_site_sp(), m_condition_mutex() {
+      m_owner(owner), m_options_ap(), m_bp_site_sp(), m_condition_mutex(),
+      m_agent_condition_hash(0), m_agent_condition_is_valid(false) {
   if (check_for_resolver) {
     Symbol *symbol = m_address.CalculateSymbolContextSymbol();
     if (symbol && symbol->IsIndirect()) {
@@ -223,6 +225,7 @@ void BreakpointLocation::ClearCallback() {
 
 void BreakpointLocation::SetCondition(const char *condition) {
   GetLocationOptions()->SetCondition(condition);
+  UpdateBreakpointSiteConditions();
   SendBreakpointLocationChangedEvent(eBreakpointEventTypeConditionChanged);
 }
 
@@ -346,6 +349,7 @@ uint32_t BreakpointLocation::GetIgnoreCount() {
 
 void BreakpointLocation::SetIgnoreCount(uint32_t n) {
   GetLocationOptions()->SetIgnoreCount(n);
+  UpdateBreakpointSiteConditions();
   SendBreakpointLocationChangedEvent(eBreakpointEventTypeIgnoreChanged);
 }
 
@@ -446,6 +450,63 @@ lldb::BreakpointSiteSP BreakpointLocation::GetBreakpointSite() const {
   return m_bp_site_sp;
 }
 
+bool BreakpointLocation::GetAgentCondition(AgentExpression &condition) {
+  std::lock_guard<std::mutex> guard(m_condition_mutex);
+
+  size_t condition_hash;
+  const char *condition_text = GetConditionText(&condition_hash);
+  if (!condition_text)
+    return false;
+
+  // Hits the debug server skips count neither against the ignore counts nor
+  // run the synchronous callbacks, which come before the condition.
+  if (GetIgnoreCount() != 0 || m_owner.GetIgnoreCount() != 0)
+    return false;
+  const BreakpointOptions *callback_options =
+      GetOptionsSpecifyingKind(BreakpointOptions::eCallback);
+  if (callback_options->HasCallback() &&
+      callback_options->IsCallbackSynchronous())
+    return false;
+
+  if (!m_agent_condition_is_valid || condition_hash != m_agent_condition_hash) {
+    // The register context only maps register names and numbers, so any
+    // thread will do.
+    ProcessSP process_sp = GetTarget().GetProcessSP();
+    ThreadSP thread_sp =
+        process_sp ? process_sp->GetThreadList().GetSelectedThread()
+                   : ThreadSP();
+    RegisterContextSP reg_ctx_sp =
+        thread_sp ? thread_sp->GetRegisterContext() : RegisterContextSP();
+    if (!reg_ctx_sp)
+      return false;
+
+    m_agent_condition.Clear();
+    AgentExpressionCompiler compiler(GetTarget(), m_address, *reg_ctx_sp);
+    Status error = compiler.Compile(condition_text, m_agent_condition);
+    if (error.Fail()) {
+      Log *log =
+          lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_BREAKPOINTS);
+      if (log)
+        log->Printf("Condition \"%s\" is evaluated by the debugger: %s",
+                    condition_text, error.AsCString());
+      m_agent_condition.Clear();
+    }
+    m_agent_condition_hash = condition_hash;
+    m_agent_condition_is_valid = true;
+  }
+
+  condition = m_agent_condition;
+  return !condition.IsEmpty();
+}
+
+void BreakpointLocation::UpdateBreakpointSiteConditions() {
+  if (!m_bp_site_sp)
+    return;
+  ProcessSP process_sp = GetTarget().GetProcessSP();
+  if (process_sp)
+    process_sp->UpdateBreakpointSiteConditions(m_bp_site_sp.get());
+}
+
 bool BreakpointLocation::ResolveBreakpointSite() {
   if (m_bp_site_sp)
     return true;
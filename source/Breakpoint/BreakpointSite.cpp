@@ -131,6 +131,22 @@ size_t BreakpointSite::RemoveOwner(lldb::break_id_t break_id,
   return m_owners.GetSize();
 }
 
+bool BreakpointSite::GetAgentConditions(
+    std::vector<AgentExpression> &conditions) {
+  std::lock_guard<std::recursive_mutex> guard(m_owners_mutex);
+  conditions.clear();
+  const size_t num_owners = m_owners.GetSize();
+  for (size_t i = 0; i < num_owners; ++i) {
+    AgentExpression condition;
+    if (!m_owners.GetByIndex(i)->GetAgentCondition(condition)) {
+      conditions.clear();
+      return false;
+    }
+    conditions.push_back(condition);
+  }
+  return !conditions.empty();
+}
+
 size_t BreakpointSite::GetNumberOfOwners() {
   std::lock_guard<std::recursive_mutex> guard(m_owners_mutex);
   return m_owners.GetSize();
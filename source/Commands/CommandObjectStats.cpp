@@ -0,0 +1,89 @@
+//===-- CommandObjectStats.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CommandObjectStats.h"
+
+// C Includes
+#include <inttypes.h>
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/Stream.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+//-------------------------------------------------------------------------
+// CommandObjectStatsDump
+//-------------------------------------------------------------------------
+
+class CommandObjectStatsDump : public CommandObjectParsed {
+public:
+  CommandObjectStatsDump(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "statistics dump",
+                            "Dump LLDB internal statistics.",
+                            "statistics dump") {}
+
+  ~CommandObjectStatsDump() override = default;
+
+protected:
+  bool DoExecute(Args &args, CommandReturnObject &result) override {
+    if (args.GetArgumentCount() != 0) {
+      result.AppendError("the statistics dump command takes no arguments.");
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+
+    Stream &strm = result.GetOutputStream();
+    const ConstString::Stats stats = ConstString::GetStats();
+    strm.PutCString("String pool:\n");
+    strm.Printf("  strings: %" PRIu64 " (%" PRIu64 " bytes of string data)\n",
+                stats.num_strings, stats.string_bytes);
+    strm.Printf("  memory: %" PRIu64 " bytes\n", stats.memory_size);
+    strm.Printf("  lookups: %" PRIu64 " (%" PRIu64 " found without locking)\n",
+                stats.num_lookups, stats.num_lock_free_hits);
+    strm.Printf("  lock contentions: %" PRIu64 "\n",
+                stats.num_lock_contentions);
+
+    if (Process *process = m_exe_ctx.GetProcessPtr()) {
+      const MemoryCache::Stats cache_stats = process->GetMemoryCacheStats();
+      strm.PutCString("Memory cache:\n");
+      strm.Printf("  hits: %" PRIu64 " (%" PRIu64 " from read-only memory)\n",
+                  cache_stats.hits + cache_stats.read_only_hits,
+                  cache_stats.read_only_hits);
+      strm.Printf("  misses: %" PRIu64 " (%" PRIu64 " lines read ahead)\n",
+                  cache_stats.misses, cache_stats.read_ahead_lines);
+      strm.Printf("  read-only lines: %" PRIu64 " (%" PRIu64
+                  " invalidations)\n",
+                  cache_stats.read_only_lines,
+                  cache_stats.read_only_invalidations);
+    }
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return true;
+  }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectStats
+//-------------------------------------------------------------------------
+
+CommandObjectStats::CommandObjectStats(CommandInterpreter &interpreter)
+    : CommandObjectMultiword(interpreter, "statistics",
+                             "Print statistics about LLDB's internal data "
+                             "structures.",
+                             "statistics <subcommand> [<subcommand-options>]") {
+  LoadSubCommand("dump",
+                 CommandObjectSP(new CommandObjectStatsDump(interpreter)));
+}
+
+CommandObjectStats::~CommandObjectStats() = default;
@@ -112,6 +112,8 @@ public:
 
       for (ThreadSP thread_sp : process->Threads())
         tids.push_back(thread_sp->GetID());
+
+      WillHandleAllThreads(*process);
     } else {
       const size_t num_args = command.GetArgumentCount();
       Process *process = m_exe_ctx.GetProcessPtr();
@@ -203,6 +205,10 @@ protected:
 
   virtual bool HandleOneThread(lldb::tid_t, CommandReturnObject &result) = 0;
 
+  // Called before all of the process's threads are handled, e.g. to do work
+  // for all of them at once.
+  virtual void WillHandleAllThreads(Process &process) {}
+
   bool BucketThread(lldb::tid_t tid, std::set<UniqueStack> &unique_stacks,
                     CommandReturnObject &result) {
     // Grab the corresponding thread for the given thread id.
@@ -361,6 +367,15 @@ protected:
     }
   }
 
+  void WillHandleAllThreads(Process &process) override {
+    // Unwind the threads in parallel up front, so that printing their
+    // backtraces one by one below doesn't wait on each unwind in turn.
+    uint32_t num_frames = UINT32_MAX;
+    if (!m_unique_stacks && m_options.m_count < UINT32_MAX - m_options.m_start)
+      num_frames = m_options.m_start + m_options.m_count;
+    process.GetThreadList().UnwindAllThreads(num_frames);
+  }
+
   bool HandleOneThread(lldb::tid_t tid, CommandReturnObject &result) override {
     ThreadSP thread_sp =
         m_exe_ctx.GetProcessPtr()->GetThreadList().FindThreadByID(tid);
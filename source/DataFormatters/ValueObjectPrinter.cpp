@@ -17,6 +17,7 @@
 #include "lldb/DataFormatters/DataVisualization.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Target/Language.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/Stream.h"
 
@@ -666,6 +667,38 @@ ValueObjectSP ValueObjectPrinter::GenerateChild(ValueObject *synth_valobj,
   }
 }
 
+// Printing the children of a value often goes through the pointers among
+// them, to show the summary of a char* or the members of a pointee. Fetch
+// what the children in [begin, end) point to up front, so that a remote
+// process can answer all of those reads with one request instead of one per
+// child. Children vended by a synthetic child provider are only looked at if
+// they already exist, since making them can be arbitrarily expensive.
+void ValueObjectPrinter::PrefetchChildPointees(ValueObject *synth_valobj,
+                                               size_t begin, size_t end) {
+  if (end - begin < 2)
+    return;
+  ProcessSP process_sp(m_valobj->GetProcessSP());
+  if (!process_sp)
+    return;
+
+  const bool can_create = !synth_valobj->IsSynthetic();
+  std::vector<lldb::addr_t> addrs;
+  for (size_t idx = begin; idx < end; ++idx) {
+    ValueObjectSP child_sp = can_create
+                                 ? GenerateChild(synth_valobj, idx)
+                                 : synth_valobj->GetChildAtIndex(idx, false);
+    if (!child_sp || !child_sp->IsPointerType())
+      continue;
+    AddressType address_type = eAddressTypeInvalid;
+    const lldb::addr_t addr = child_sp->GetPointerValue(&address_type);
+    if (address_type == eAddressTypeLoad && addr != 0 &&
+        addr != LLDB_INVALID_ADDRESS)
+      addrs.push_back(addr);
+  }
+  if (addrs.size() > 1)
+    process_sp->PrefetchMemory(addrs);
+}
+
 void ValueObjectPrinter::PrintChildren(
     bool value_printed, bool summary_printed,
     const DumpValueObjectOptions::PointerDepth &curr_ptr_depth) {
@@ -676,7 +709,15 @@ void ValueObjectPrinter::PrintChildren(
   if (num_children) {
     bool any_children_printed = false;
 
+    // Children are prefetched a chunk at a time, so that no more of them are
+    // made ahead of printing than fit in one chunk.
+    const size_t prefetch_chunk_size = 32;
     for (size_t idx = 0; idx < num_children; ++idx) {
+      if (idx % prefetch_chunk_size == 0)
+        PrefetchChildPointees(
+            synth_m_valobj, idx,
+            std::min(num_children, idx + prefetch_chunk_size));
+
       if (ValueObjectSP child_sp = GenerateChild(synth_m_valobj, idx)) {
         if (!any_children_printed) {
           PrintChildrenPreamble();
@@ -0,0 +1,520 @@
+//===-- AgentExpressionCompiler.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Expression/AgentExpressionCompiler.h"
+
+#include "lldb/Core/Module.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/Expression/DWARFExpression.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/CompilerType.h"
+#include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/TypeSystem.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "llvm/ADT/STLExtras.h"
+
+#include <ctype.h>
+#include <string.h>
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+// Binary operators and their C precedence, the two character operators
+// first so that "&&" isn't taken for "&".
+const struct {
+  const char *op;
+  int precedence;
+} g_binary_operators[] = {
+    {"||", 1}, {"&&", 2}, {"==", 6}, {"!=", 6}, {"<=", 7}, {">=", 7},
+    {"<<", 8}, {">>", 8}, {"|", 3},  {"^", 4},  {"&", 5},  {"<", 7},
+    {">", 7},  {"+", 9},  {"-", 9},  {"*", 10}, {"/", 10}, {"%", 10}};
+
+int GetPrecedence(llvm::StringRef op) {
+  for (const auto &binary_operator : g_binary_operators) {
+    if (op == binary_operator.op)
+      return binary_operator.precedence;
+  }
+  return 0;
+}
+
+bool IsIdentifierChar(char c) { return isalnum(c) || c == '_'; }
+
+// The width of a C basic type on the target, which may be ILP32 or LP64.
+uint8_t GetBasicTypeBits(Target &target, BasicType basic_type,
+                         uint8_t fail_value) {
+  TypeSystem *type_system =
+      target.GetScratchTypeSystemForLanguage(nullptr, eLanguageTypeC);
+  if (!type_system)
+    return fail_value;
+  const uint64_t bits =
+      type_system->GetBasicTypeFromAST(basic_type).GetBitSize(nullptr);
+  if (bits == 0 || bits > 64)
+    return fail_value;
+  return bits;
+}
+} // namespace
+
+AgentExpressionCompiler::AgentExpressionCompiler(Target &target,
+                                                 const Address &address,
+                                                 RegisterContext &reg_ctx)
+    : m_target(target), m_address(address), m_reg_ctx(reg_ctx),
+      m_int{GetBasicTypeBits(target, eBasicTypeInt, 32), true},
+      m_long{GetBasicTypeBits(target, eBasicTypeLong, 64), true},
+      m_long_long{GetBasicTypeBits(target, eBasicTypeLongLong, 64), true} {}
+
+Status AgentExpressionCompiler::Compile(llvm::StringRef condition,
+                                        AgentExpression &expr) {
+  m_text = condition;
+  m_expr.Clear();
+
+  ValueType type;
+  Status error = ParseBinary(1, type);
+  if (error.Fail())
+    return error;
+  SkipSpaces();
+  if (!m_text.empty())
+    return Status("unexpected '%s' in condition", m_text.str().c_str());
+
+  m_expr.AppendOpcode(AgentExpression::eOpEnd);
+  expr = m_expr;
+  return Status();
+}
+
+void AgentExpressionCompiler::SkipSpaces() { m_text = m_text.ltrim(); }
+
+llvm::StringRef AgentExpressionCompiler::PeekOperator() const {
+  for (const auto &binary_operator : g_binary_operators) {
+    if (m_text.startswith(binary_operator.op))
+      return binary_operator.op;
+  }
+  return llvm::StringRef();
+}
+
+Status AgentExpressionCompiler::ParseBinary(int min_precedence,
+                                            ValueType &type) {
+  Status error = ParseUnary(type);
+  while (error.Success()) {
+    SkipSpaces();
+    llvm::StringRef op = PeekOperator();
+    const int precedence = GetPrecedence(op);
+    if (precedence == 0 || precedence < min_precedence)
+      break;
+    m_text = m_text.drop_front(op.size());
+
+    ValueType rhs;
+    error = ParseBinary(precedence + 1, rhs);
+    if (error.Success())
+      AppendBinaryOperator(op, type, rhs, type);
+  }
+  return error;
+}
+
+Status AgentExpressionCompiler::ParseUnary(ValueType &type) {
+  SkipSpaces();
+  const char op = m_text.empty() ? '\0' : m_text.front();
+  if (op != '!' && op != '-' && op != '~' && op != '+')
+    return ParsePrimary(type);
+
+  m_text = m_text.drop_front();
+  Status error = ParseUnary(type);
+  if (error.Fail())
+    return error;
+
+  // Operands narrower than int are promoted to int.
+  if (type.bits < m_int.bits)
+    type = m_int;
+  switch (op) {
+  case '!':
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    type = m_int;
+    break;
+  case '-':
+    m_expr.AppendConstant(0);
+    m_expr.AppendOpcode(AgentExpression::eOpSwap);
+    m_expr.AppendOpcode(AgentExpression::eOpSub);
+    AppendNormalize(type);
+    break;
+  case '~':
+    m_expr.AppendOpcode(AgentExpression::eOpBitNot);
+    AppendNormalize(type);
+    break;
+  }
+  return Status();
+}
+
+Status AgentExpressionCompiler::ParsePrimary(ValueType &type) {
+  SkipSpaces();
+  if (m_text.empty())
+    return Status("condition ends unexpectedly");
+
+  const char c = m_text.front();
+  if (c == '(') {
+    m_text = m_text.drop_front();
+    Status error = ParseBinary(1, type);
+    if (error.Fail())
+      return error;
+    SkipSpaces();
+    if (!m_text.consume_front(")"))
+      return Status("expected ')' in condition");
+    return Status();
+  }
+  if (isdigit(c))
+    return ParseNumber(type);
+  if (c == '$')
+    return ParseRegister(type);
+  if (IsIdentifierChar(c))
+    return ParseVariable(type);
+  return Status("unexpected '%c' in condition", c);
+}
+
+Status AgentExpressionCompiler::ParseNumber(ValueType &type) {
+  const bool is_decimal = !m_text.startswith("0");
+  unsigned long long value;
+  if (m_text.consumeInteger(0, value))
+    return Status("invalid number in condition");
+
+  bool is_unsigned = false;
+  size_t num_longs = 0;
+  while (!m_text.empty() && strchr("uUlL", m_text.front())) {
+    if (tolower(m_text.front()) == 'u')
+      is_unsigned = true;
+    else
+      ++num_longs;
+    m_text = m_text.drop_front();
+  }
+  if (num_longs > 2 ||
+      (!m_text.empty() && IsIdentifierChar(m_text.front())))
+    return Status("invalid number in condition");
+
+  // The first type which holds the value, as in C. Starting from the rank
+  // the suffix asks for, that is the signed type unless there is a 'u'
+  // suffix, then for octal and hexadecimal literals the unsigned one, so
+  // 0xffffffff is an unsigned int where int has 32 bits. Decimal literals
+  // too large for any signed type are unsigned long long, like in clang.
+  const ValueType ranks[] = {m_int, m_long, m_long_long};
+  type = {64, false};
+  for (size_t rank = num_longs; rank < llvm::array_lengthof(ranks); ++rank) {
+    const uint8_t bits = ranks[rank].bits;
+    if (!is_unsigned && value <= (UINT64_MAX >> (65 - bits))) {
+      type = {bits, true};
+      break;
+    }
+    if ((is_unsigned || !is_decimal) && value <= (UINT64_MAX >> (64 - bits))) {
+      type = {bits, false};
+      break;
+    }
+  }
+  m_expr.AppendConstant(value);
+  return Status();
+}
+
+Status AgentExpressionCompiler::ParseRegister(ValueType &type) {
+  m_text = m_text.drop_front();
+  llvm::StringRef name = m_text.take_while(IsIdentifierChar);
+  m_text = m_text.drop_front(name.size());
+
+  const RegisterInfo *reg_info = m_reg_ctx.GetRegisterInfoByName(name);
+  if (!reg_info)
+    return Status("no register named '%s'", name.str().c_str());
+  if ((reg_info->encoding != eEncodingUint &&
+       reg_info->encoding != eEncodingSint) ||
+      reg_info->byte_size > 8)
+    return Status("register '%s' is not an integer register",
+                  name.str().c_str());
+  const uint32_t remote_reg_num = reg_info->kinds[eRegisterKindProcessPlugin];
+  if (remote_reg_num == LLDB_INVALID_REGNUM)
+    return Status("register '%s' has no debug server number",
+                  name.str().c_str());
+
+  m_expr.AppendRegister(remote_reg_num);
+  type = {static_cast<uint8_t>(reg_info->byte_size * 8), false};
+  if (type.bits < m_int.bits)
+    type = m_int;
+  return Status();
+}
+
+Status AgentExpressionCompiler::ParseVariable(ValueType &type) {
+  llvm::StringRef name = m_text.take_while(IsIdentifierChar);
+  m_text = m_text.drop_front(name.size());
+
+  if (name == "true" || name == "false") {
+    m_expr.AppendConstant(name == "true");
+    type = m_int;
+    return Status();
+  }
+
+  // Look for the innermost local variable first, then for a global one in
+  // the same module.
+  ConstString const_name(name);
+  VariableList variables;
+  if (Block *block = m_address.CalculateSymbolContextBlock()) {
+    block->AppendVariables(
+        true, true, true,
+        [&const_name](Variable *variable) {
+          return variable->GetName() == const_name;
+        },
+        &variables);
+  }
+  if (variables.GetSize() == 0) {
+    if (ModuleSP module_sp = m_address.GetModule())
+      module_sp->FindGlobalVariables(const_name, nullptr, true, 1, variables);
+  }
+  VariableSP variable_sp = variables.GetVariableAtIndex(0);
+  if (!variable_sp)
+    return Status("no variable named '%s'", name.str().c_str());
+
+  Type *variable_type = variable_sp->GetType();
+  if (!variable_type)
+    return Status("variable '%s' has no type", name.str().c_str());
+  CompilerType compiler_type = variable_type->GetFullCompilerType();
+  bool is_signed = false;
+  if (!compiler_type.IsIntegerOrEnumerationType(is_signed) &&
+      !compiler_type.IsPointerType())
+    return Status("variable '%s' is not an integer or a pointer",
+                  name.str().c_str());
+  const uint64_t byte_size = compiler_type.GetByteSize(nullptr);
+  if (byte_size != 1 && byte_size != 2 && byte_size != 4 && byte_size != 8)
+    return Status("variable '%s' has an unsupported size", name.str().c_str());
+
+  bool in_register = false;
+  Status error = AppendVariableLocation(*variable_sp, in_register);
+  if (error.Fail())
+    return error;
+
+  if (!in_register) {
+    switch (byte_size) {
+    case 1:
+      m_expr.AppendOpcode(AgentExpression::eOpRef8);
+      break;
+    case 2:
+      m_expr.AppendOpcode(AgentExpression::eOpRef16);
+      break;
+    case 4:
+      m_expr.AppendOpcode(AgentExpression::eOpRef32);
+      break;
+    default:
+      m_expr.AppendOpcode(AgentExpression::eOpRef64);
+      break;
+    }
+  }
+
+  // Memory references zero extend the value, registers hold more bits than
+  // the variable may use.
+  type = {static_cast<uint8_t>(byte_size * 8), is_signed};
+  if (in_register || is_signed)
+    AppendNormalize(type);
+  if (type.bits < m_int.bits)
+    type = m_int;
+  return Status();
+}
+
+Status AgentExpressionCompiler::AppendVariableLocation(Variable &variable,
+                                                       bool &in_register) {
+  const char *name = variable.GetName().AsCString("<anonymous>");
+  DWARFExpression &location = variable.LocationExpression();
+  if (!location.IsValid() || variable.GetLocationIsConstantValueData())
+    return Status("variable '%s' has no location", name);
+  if (location.IsLocationList())
+    return Status("variable '%s' has a location list", name);
+
+  DataExtractor data;
+  location.GetExpressionData(data);
+  const RegisterKind reg_kind =
+      static_cast<RegisterKind>(location.GetRegisterKind());
+  lldb::offset_t offset = 0;
+  const uint8_t op = data.GetU8(&offset);
+  in_register = false;
+
+  Status error;
+  if (op == DW_OP_addr) {
+    const lldb::addr_t file_addr = data.GetAddress(&offset);
+    SymbolContext sc;
+    variable.CalculateSymbolContext(&sc);
+    Address so_addr;
+    lldb::addr_t load_addr = LLDB_INVALID_ADDRESS;
+    if (sc.module_sp && sc.module_sp->ResolveFileAddress(file_addr, so_addr))
+      load_addr = so_addr.GetLoadAddress(&m_target);
+    if (load_addr == LLDB_INVALID_ADDRESS)
+      return Status("variable '%s' is not loaded", name);
+    m_expr.AppendConstant(load_addr);
+  } else if ((op >= DW_OP_reg0 && op <= DW_OP_reg31) || op == DW_OP_regx) {
+    const uint32_t reg_num =
+        op == DW_OP_regx ? data.GetULEB128(&offset) : op - DW_OP_reg0;
+    error = AppendDWARFRegister(reg_kind, reg_num);
+    in_register = true;
+  } else if ((op >= DW_OP_breg0 && op <= DW_OP_breg31) || op == DW_OP_bregx) {
+    const uint32_t reg_num =
+        op == DW_OP_bregx ? data.GetULEB128(&offset) : op - DW_OP_breg0;
+    const int64_t reg_offset = data.GetSLEB128(&offset);
+    error = AppendDWARFRegister(reg_kind, reg_num);
+    m_expr.AppendConstant(reg_offset);
+    m_expr.AppendOpcode(AgentExpression::eOpAdd);
+  } else if (op == DW_OP_fbreg) {
+    const int64_t frame_offset = data.GetSLEB128(&offset);
+
+    // Only frame bases held in a register, or at an offset from one, are
+    // known without unwinding.
+    Function *function = m_address.CalculateSymbolContextFunction();
+    if (!function)
+      return Status("variable '%s' has no function", name);
+    DWARFExpression &frame_base = function->GetFrameBaseExpression();
+    DataExtractor frame_base_data;
+    if (frame_base.IsLocationList() ||
+        !frame_base.GetExpressionData(frame_base_data))
+      return Status("the frame base of '%s' is not supported", name);
+    const RegisterKind frame_base_kind =
+        static_cast<RegisterKind>(frame_base.GetRegisterKind());
+    lldb::offset_t frame_base_offset = 0;
+    const uint8_t frame_base_op = frame_base_data.GetU8(&frame_base_offset);
+    uint32_t reg_num = LLDB_INVALID_REGNUM;
+    int64_t reg_offset = 0;
+    if (frame_base_op >= DW_OP_reg0 && frame_base_op <= DW_OP_reg31) {
+      reg_num = frame_base_op - DW_OP_reg0;
+    } else if (frame_base_op >= DW_OP_breg0 && frame_base_op <= DW_OP_breg31) {
+      reg_num = frame_base_op - DW_OP_breg0;
+      reg_offset = frame_base_data.GetSLEB128(&frame_base_offset);
+    } else if (frame_base_op == DW_OP_regx) {
+      reg_num = frame_base_data.GetULEB128(&frame_base_offset);
+    } else if (frame_base_op == DW_OP_bregx) {
+      reg_num = frame_base_data.GetULEB128(&frame_base_offset);
+      reg_offset = frame_base_data.GetSLEB128(&frame_base_offset);
+    }
+    if (reg_num == LLDB_INVALID_REGNUM ||
+        frame_base_offset != frame_base_data.GetByteSize())
+      return Status("the frame base of '%s' is not supported", name);
+
+    error = AppendDWARFRegister(frame_base_kind, reg_num);
+    m_expr.AppendConstant(reg_offset + frame_offset);
+    m_expr.AppendOpcode(AgentExpression::eOpAdd);
+  } else {
+    return Status("the location of '%s' is not supported", name);
+  }
+
+  if (error.Success() && offset != data.GetByteSize())
+    return Status("the location of '%s' is not supported", name);
+  return error;
+}
+
+Status AgentExpressionCompiler::AppendDWARFRegister(RegisterKind kind,
+                                                    uint32_t reg_num) {
+  const uint32_t lldb_reg_num =
+      m_reg_ctx.ConvertRegisterKindToRegisterNumber(kind, reg_num);
+  const RegisterInfo *reg_info =
+      lldb_reg_num == LLDB_INVALID_REGNUM
+          ? nullptr
+          : m_reg_ctx.GetRegisterInfoAtIndex(lldb_reg_num);
+  if (!reg_info ||
+      reg_info->kinds[eRegisterKindProcessPlugin] == LLDB_INVALID_REGNUM)
+    return Status("register %u has no debug server number", reg_num);
+  m_expr.AppendRegister(reg_info->kinds[eRegisterKindProcessPlugin]);
+  return Status();
+}
+
+void AgentExpressionCompiler::AppendBinaryOperator(llvm::StringRef op,
+                                                   ValueType lhs,
+                                                   ValueType rhs,
+                                                   ValueType &type) {
+  if (op == "||" || op == "&&") {
+    // Both sides are evaluated. A side which fails to evaluate makes the
+    // debug server report the stop, so the result never differs from C.
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    m_expr.AppendOpcode(AgentExpression::eOpSwap);
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    m_expr.AppendOpcode(op == "||" ? AgentExpression::eOpBitOr
+                                   : AgentExpression::eOpBitAnd);
+    type = m_int;
+    return;
+  }
+
+  if (op == "<<" || op == ">>") {
+    // The type of a shift is the type of its left operand.
+    if (op == "<<")
+      m_expr.AppendOpcode(AgentExpression::eOpLsh);
+    else
+      m_expr.AppendOpcode(lhs.is_signed ? AgentExpression::eOpRshSigned
+                                        : AgentExpression::eOpRshUnsigned);
+    type = lhs;
+    AppendNormalize(type);
+    return;
+  }
+
+  // The usual arithmetic conversions for operands of int and long.
+  ValueType common;
+  if (lhs.bits != rhs.bits)
+    common = lhs.bits > rhs.bits ? lhs : rhs;
+  else
+    common = {lhs.bits, lhs.is_signed && rhs.is_signed};
+  if (NeedsConversion(rhs, common))
+    m_expr.AppendExtend(common.bits, false);
+  if (NeedsConversion(lhs, common)) {
+    m_expr.AppendOpcode(AgentExpression::eOpSwap);
+    m_expr.AppendExtend(common.bits, false);
+    m_expr.AppendOpcode(AgentExpression::eOpSwap);
+  }
+
+  type = common;
+  const bool is_signed = common.is_signed;
+  if (op == "+")
+    m_expr.AppendOpcode(AgentExpression::eOpAdd);
+  else if (op == "-")
+    m_expr.AppendOpcode(AgentExpression::eOpSub);
+  else if (op == "*")
+    m_expr.AppendOpcode(AgentExpression::eOpMul);
+  else if (op == "/")
+    m_expr.AppendOpcode(is_signed ? AgentExpression::eOpDivSigned
+                                  : AgentExpression::eOpDivUnsigned);
+  else if (op == "%")
+    m_expr.AppendOpcode(is_signed ? AgentExpression::eOpRemSigned
+                                  : AgentExpression::eOpRemUnsigned);
+  else if (op == "&")
+    m_expr.AppendOpcode(AgentExpression::eOpBitAnd);
+  else if (op == "|")
+    m_expr.AppendOpcode(AgentExpression::eOpBitOr);
+  else if (op == "^")
+    m_expr.AppendOpcode(AgentExpression::eOpBitXor);
+  else {
+    // Comparisons, which all come down to == and <.
+    const AgentExpression::Opcode less = is_signed
+                                             ? AgentExpression::eOpLessSigned
+                                             : AgentExpression::eOpLessUnsigned;
+    if (op == "==" || op == "!=") {
+      m_expr.AppendOpcode(AgentExpression::eOpEqual);
+    } else {
+      if (op == ">" || op == "<=")
+        m_expr.AppendOpcode(AgentExpression::eOpSwap);
+      m_expr.AppendOpcode(less);
+    }
+    if (op == "!=" || op == "<=" || op == ">=")
+      m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    type = m_int;
+    return;
+  }
+  AppendNormalize(type);
+}
+
+bool AgentExpressionCompiler::NeedsConversion(ValueType from, ValueType to) {
+  // Negative values are sign extended to 64 bits, which is also their value
+  // as any wider type and as an unsigned 64-bit type. Only unsigned types
+  // narrower than that differ.
+  return from.is_signed && !to.is_signed && to.bits < 64;
+}
+
+void AgentExpressionCompiler::AppendNormalize(ValueType type) {
+  if (type.bits < 64)
+    m_expr.AppendExtend(type.bits, type.is_signed);
+}
@@ -563,6 +563,11 @@ lldb::SectionType IRExecutionUnit::GetSectionTypeFromSectionName(
           sect_type = lldb::eSectionTypeDWARFDebugMacInfo;
         break;
 
+      case 'n':
+        if (dwarf_name.equals("names"))
+          sect_type = lldb::eSectionTypeDWARFDebugNames;
+        break;
+
       case 'p':
         if (dwarf_name.equals("pubnames"))
           sect_type = lldb::eSectionTypeDWARFDebugPubNames;
@@ -1121,6 +1126,8 @@ bool IRExecutionUnit::CommitOneAllocation(lldb::ProcessSP &process_sp,
   case lldb::eSectionTypeDWARFDebugRanges:
   case lldb::eSectionTypeDWARFDebugStr:
   case lldb::eSectionTypeDWARFDebugStrOffsets:
+  case lldb::eSectionTypeDWARFDebugNames:
+  case lldb::eSectionTypeDWARFGdbIndex:
   case lldb::eSectionTypeDWARFAppleNames:
   case lldb::eSectionTypeDWARFAppleTypes:
   case lldb::eSectionTypeDWARFAppleNamespaces:
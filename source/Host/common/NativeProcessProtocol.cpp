@@ -11,6 +11,7 @@
 
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/ModuleSpec.h"
+#include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/State.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/common/NativeRegisterContext.h"
@@ -47,12 +48,25 @@ lldb_private::Status NativeProcessProtocol::Interrupt() {
 #endif
 }
 
+Status NativeProcessProtocol::SetNonStopMode(bool enable) {
+  if (enable)
+    return Status("non-stop mode is not supported");
+  return Status();
+}
+
 Status NativeProcessProtocol::IgnoreSignals(llvm::ArrayRef<int> signals) {
   m_signals_to_ignore.clear();
   m_signals_to_ignore.insert(signals.begin(), signals.end());
   return Status();
 }
 
+llvm::Expected<std::vector<NativeProcessProtocol::SVR4LibraryInfo>>
+NativeProcessProtocol::GetLoadedSVR4Libraries() {
+  // Default: not implemented.
+  return llvm::make_error<llvm::StringError>("not implemented",
+                                             llvm::inconvertibleErrorCode());
+}
+
 lldb_private::Status
 NativeProcessProtocol::GetMemoryRegionInfo(lldb::addr_t load_addr,
                                            MemoryRegionInfo &range_info) {
@@ -398,6 +412,17 @@ void NativeProcessProtocol::NotifyDidExec() {
   }
 }
 
+void NativeProcessProtocol::NotifyThreadStopped(lldb::tid_t tid) {
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+  if (log)
+    log->Printf("NativeProcessProtocol::%s - thread %" PRIu64 " stopped",
+                __FUNCTION__, tid);
+
+  std::lock_guard<std::recursive_mutex> guard(m_delegates_mutex);
+  for (auto native_delegate : m_delegates)
+    native_delegate->ThreadStopped(this, tid);
+}
+
 Status NativeProcessProtocol::SetSoftwareBreakpoint(lldb::addr_t addr,
                                                     uint32_t size_hint) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
@@ -430,6 +455,66 @@ Status NativeProcessProtocol::DisableBreakpoint(lldb::addr_t addr) {
   return m_breakpoint_list.DisableBreakpoint(addr);
 }
 
+Status NativeProcessProtocol::SetBreakpointConditions(
+    lldb::addr_t addr, std::vector<AgentExpression> conditions) {
+  NativeBreakpointSP breakpoint_sp;
+  Status error = m_breakpoint_list.GetBreakpoint(addr, breakpoint_sp);
+  if (error.Fail())
+    return error;
+  if (!breakpoint_sp->IsSoftwareBreakpoint())
+    return Status("breakpoint at 0x%" PRIx64 " is not a software breakpoint",
+                  addr);
+  breakpoint_sp->SetConditions(std::move(conditions));
+  return Status();
+}
+
+bool NativeProcessProtocol::ShouldReportBreakpointHit(
+    NativeThreadProtocol &thread, lldb::addr_t addr) {
+  NativeBreakpointSP breakpoint_sp;
+  if (m_breakpoint_list.GetBreakpoint(addr, breakpoint_sp).Fail() ||
+      breakpoint_sp->GetConditions().empty())
+    return true;
+
+  NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext();
+  if (!reg_ctx_sp)
+    return true;
+
+  // The expressions number registers the way lldb-server does, by their
+  // index in the register context.
+  auto read_register = [&reg_ctx_sp](uint32_t reg_num, uint64_t &value) {
+    const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoAtIndex(reg_num);
+    RegisterValue reg_value;
+    if (!reg_info || reg_ctx_sp->ReadRegister(reg_info, reg_value).Fail())
+      return false;
+    bool success = false;
+    value = reg_value.GetAsUInt64(0, &success);
+    return success;
+  };
+  auto read_memory = [this](lldb::addr_t addr, void *buf, size_t size) {
+    size_t bytes_read = 0;
+    return ReadMemoryWithoutTrap(addr, buf, size, bytes_read).Success() &&
+           bytes_read == size;
+  };
+
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  for (const AgentExpression &condition : breakpoint_sp->GetConditions()) {
+    uint64_t result = 0;
+    Status error = condition.Evaluate(read_register, read_memory, result);
+    if (error.Fail()) {
+      // Let the client decide by evaluating the condition itself.
+      LLDB_LOG(log, "tid {0} breakpoint at {1:x}: {2}", thread.GetID(), addr,
+               error);
+      return true;
+    }
+    if (result != 0)
+      return true;
+  }
+
+  LLDB_LOG(log, "tid {0} breakpoint at {1:x}: conditions are false",
+           thread.GetID(), addr);
+  return false;
+}
+
 lldb::StateType NativeProcessProtocol::GetState() const {
   std::lock_guard<std::recursive_mutex> guard(m_state_mutex);
   return m_state;
@@ -10,9 +10,11 @@
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Host/ThreadLauncher.h"
 
-#include <cstdint> // for uint32_t
-#include <queue>   // for queue
-#include <thread>  // for thread
+#include <atomic>             // for atomic
+#include <condition_variable> // for condition_variable
+#include <cstdint>            // for uint32_t
+#include <queue>              // for queue
+#include <thread>             // for thread
 
 namespace {
 class TaskPoolImpl {
@@ -36,8 +38,10 @@ private:
 } // end of anonymous namespace
 
 TaskPoolImpl &TaskPoolImpl::GetInstance() {
-  static TaskPoolImpl g_task_pool_impl;
-  return g_task_pool_impl;
+  // Never destroyed, the workers may still be finishing tasks which nobody
+  // waits for at exit, such as the helpers TaskMapOverInt() leaves behind.
+  static TaskPoolImpl *g_task_pool_impl = new TaskPoolImpl();
+  return *g_task_pool_impl;
 }
 
 void TaskPool::AddTaskImpl(std::function<void()> &&task_fn) {
@@ -87,23 +91,50 @@ void TaskPoolImpl::Worker(TaskPoolImpl *pool) {
 
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func) {
-  std::atomic<size_t> idx{begin};
+  if (begin >= end)
+    return;
+
+  // Shared with the helper tasks, which may only start running after this
+  // returned. By then every item is taken, so they never call 'func'.
+  struct State {
+    std::atomic<size_t> idx;
+    size_t num_done = 0;
+    std::mutex mutex;
+    std::condition_variable done_cv;
+  };
+  auto state_sp = std::make_shared<State>();
+  state_sp->idx = begin;
+  const size_t num_items = end - begin;
   size_t num_workers =
-      std::min<size_t>(end, std::thread::hardware_concurrency());
+      std::min<size_t>(num_items, std::thread::hardware_concurrency());
 
-  auto wrapper = [&idx, end, &func]() {
+  auto wrapper = [state_sp, end, func]() {
+    size_t num_done = 0;
     while (true) {
-      size_t i = idx.fetch_add(1);
+      size_t i = state_sp->idx.fetch_add(1);
       if (i >= end)
         break;
       func(i);
+      ++num_done;
     }
+    if (num_done == 0)
+      return;
+    std::lock_guard<std::mutex> guard(state_sp->mutex);
+    state_sp->num_done += num_done;
+    state_sp->done_cv.notify_all();
   };
 
-  std::vector<std::future<void>> futures;
-  futures.reserve(num_workers);
-  for (size_t i = 0; i < num_workers; i++)
-    futures.push_back(TaskPool::AddTask(wrapper));
-  for (size_t i = 0; i < num_workers; i++)
-    futures[i].wait();
+  for (size_t i = 1; i < num_workers; i++)
+    TaskPool::AddTask(wrapper);
+
+  // The calling thread works on the items too, and then only waits for the
+  // items other threads already started. It never waits for a task which is
+  // still queued, so 'func' may call this itself even when every worker is
+  // busy, e.g. when debug info is indexed while threads are being unwound in
+  // parallel. Nor does it run other tasks meanwhile, which might not expect
+  // the locks the caller holds.
+  wrapper();
+  std::unique_lock<std::mutex> lock(state_sp->mutex);
+  state_sp->done_cv.wait(
+      lock, [&state_sp, num_items] { return state_sp->num_done == num_items; });
 }
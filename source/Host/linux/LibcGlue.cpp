@@ -28,4 +28,18 @@ ssize_t process_vm_readv(::pid_t pid, const struct iovec *local_iov,
   return -1;
 #endif
 }
+
+ssize_t process_vm_writev(::pid_t pid, const struct iovec *local_iov,
+                          unsigned long liovcnt,
+                          const struct iovec *remote_iov,
+                          unsigned long riovcnt, unsigned long flags) {
+#if HAVE_NR_PROCESS_VM_READV
+  // Both syscalls were added in the same kernel release.
+  return syscall(__NR_process_vm_writev, pid, local_iov, liovcnt, remote_iov,
+                 riovcnt, flags);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
 #endif
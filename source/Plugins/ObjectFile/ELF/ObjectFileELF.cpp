@@ -1842,12 +1842,14 @@ void ObjectFileELF::CreateSections(SectionList &unified_section_list) {
       static ConstString g_sect_name_dwarf_debug_loc(".debug_loc");
       static ConstString g_sect_name_dwarf_debug_macinfo(".debug_macinfo");
       static ConstString g_sect_name_dwarf_debug_macro(".debug_macro");
+      static ConstString g_sect_name_dwarf_debug_names(".debug_names");
       static ConstString g_sect_name_dwarf_debug_pubnames(".debug_pubnames");
       static ConstString g_sect_name_dwarf_debug_pubtypes(".debug_pubtypes");
       static ConstString g_sect_name_dwarf_debug_ranges(".debug_ranges");
       static ConstString g_sect_name_dwarf_debug_str(".debug_str");
       static ConstString g_sect_name_dwarf_debug_str_offsets(
           ".debug_str_offsets");
+      static ConstString g_sect_name_dwarf_gdb_index(".gdb_index");
       static ConstString g_sect_name_dwarf_debug_abbrev_dwo(
           ".debug_abbrev.dwo");
       static ConstString g_sect_name_dwarf_debug_info_dwo(".debug_info.dwo");
@@ -1919,6 +1921,10 @@ void ObjectFileELF::CreateSections(SectionList &unified_section_list) {
         sect_type = eSectionTypeDWARFDebugMacInfo;
       else if (name == g_sect_name_dwarf_debug_macro)
         sect_type = eSectionTypeDWARFDebugMacro;
+      else if (name == g_sect_name_dwarf_debug_names)
+        sect_type = eSectionTypeDWARFDebugNames;
+      else if (name == g_sect_name_dwarf_gdb_index)
+        sect_type = eSectionTypeDWARFGdbIndex;
       else if (name == g_sect_name_dwarf_debug_pubnames)
         sect_type = eSectionTypeDWARFDebugPubNames;
       else if (name == g_sect_name_dwarf_debug_pubtypes)
@@ -2027,6 +2033,7 @@ void ObjectFileELF::CreateSections(SectionList &unified_section_list) {
           eSectionTypeDWARFDebugMacInfo,  eSectionTypeDWARFDebugPubNames,
           eSectionTypeDWARFDebugPubTypes, eSectionTypeDWARFDebugRanges,
           eSectionTypeDWARFDebugStr,      eSectionTypeDWARFDebugStrOffsets,
+          eSectionTypeDWARFDebugNames,    eSectionTypeDWARFGdbIndex,
           eSectionTypeELFSymbolTable,
       };
       SectionList *elf_section_list = m_sections_ap.get();
@@ -17,6 +17,8 @@
 
 // C++ Includes
 #include <fstream>
+#include <limits>
+#include <map>
 #include <mutex>
 #include <sstream>
 #include <string>
@@ -40,11 +42,16 @@
 #include "lldb/Target/Process.h"
 #include "lldb/Target/ProcessLaunchInfo.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/LLDBAssert.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/StringExtractor.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Support/Errno.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Threading.h"
 
 #include "NativeThreadLinux.h"
@@ -636,6 +643,10 @@ void NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info,
     // Exec clears any pending notifications.
     m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 
+    // The memory file refers to the address space that was just replaced.
+    m_proc_mem_file.Close();
+    m_supports_proc_mem = eLazyBoolCalculate;
+
     // Remove all but the main thread here.  Linux fork creates a new process
     // which only copies the main thread.
     LLDB_LOG(log, "exec received, stop tracking all but main thread");
@@ -653,9 +664,12 @@ void NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info,
     }
 
     m_threads.clear();
+    m_threads_by_id.clear();
+    m_num_threads_known_stopped = 0;
 
     if (main_thread_sp) {
       m_threads.push_back(main_thread_sp);
+      m_threads_by_id[main_thread_sp->GetID()] = main_thread_sp;
       SetCurrentThreadID(main_thread_sp->GetID());
       main_thread_sp->SetStoppedByExec();
     } else {
@@ -803,6 +817,42 @@ void NativeProcessLinux::MonitorTrace(NativeThreadLinux &thread) {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
   LLDB_LOG(log, "received trace event, pid = {0}", thread.GetID());
 
+  // A thread that stepped over a breakpoint whose conditions were false puts
+  // the breakpoint back and lets all the threads carry on, unless another
+  // stop came up meanwhile.
+  if (thread.GetID() == m_condition_step_over.tid &&
+      m_condition_step_over.stepping) {
+    if (!m_condition_step_over.abandoned) {
+      ResumeAfterConditionStepOver();
+      return;
+    }
+    EndConditionStepOver();
+    // An interrupt may have picked this thread, the only one running.
+    if (m_pending_notification_tid == thread.GetID())
+      thread.SetStoppedBySignal(SIGSTOP);
+    else
+      thread.SetStoppedWithNoReason();
+    SignalIfAllThreadsStopped();
+    return;
+  }
+
+  // A thread that is range stepping keeps stepping without reporting the
+  // stop while its PC stays inside the range, unless another thread has
+  // already asked for the process to stop.
+  auto range_it = m_threads_range_stepping.find(thread.GetID());
+  if (range_it != m_threads_range_stepping.end()) {
+    const lldb::addr_t pc = thread.GetRegisterContext()->GetPC();
+    if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID &&
+        pc >= range_it->second.first && pc < range_it->second.second) {
+      Status error = thread.SingleStep(LLDB_INVALID_SIGNAL_NUMBER);
+      if (error.Success())
+        return;
+      LLDB_LOG(log, "tid = {0} range step failed: {1}", thread.GetID(),
+               error);
+    }
+    m_threads_range_stepping.erase(range_it);
+  }
+
   // This thread is currently stopped.
   thread.SetStoppedByTrace();
 
@@ -814,6 +864,10 @@ void NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread) {
       GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
   LLDB_LOG(log, "received breakpoint event, pid = {0}", thread.GetID());
 
+  // Only a thread which was continued may skip the stop, a stepping thread
+  // has to report it.
+  const bool was_running = thread.GetState() == eStateRunning;
+
   // Mark the thread as stopped at breakpoint.
   thread.SetStoppedByBreakpoint();
   Status error = FixupBreakpointPCAsNeeded(thread);
@@ -823,10 +877,126 @@ void NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread) {
   if (m_threads_stepping_with_breakpoint.find(thread.GetID()) !=
       m_threads_stepping_with_breakpoint.end())
     thread.SetStoppedByTrace();
+  else if (was_running && StepOverFalseCondition(thread))
+    return;
 
   StopRunningThreads(thread.GetID());
 }
 
+bool NativeProcessLinux::StepOverFalseCondition(NativeThreadLinux &thread) {
+  // The breakpoint is put back after a hardware single step, so software
+  // single stepping targets report every hit and leave the conditions to the
+  // client. So does non-stop mode, where the other threads aren't held.
+  if (!SupportHardwareSingleStepping() || m_non_stop_mode)
+    return false;
+
+  const lldb::addr_t pc = thread.GetRegisterContext()->GetPC();
+
+  // While the other threads are being stopped for a step over, a thread
+  // whose conditions are false just stops with them. It hits its breakpoint
+  // again once it is resumed.
+  if (m_condition_step_over.tid != LLDB_INVALID_THREAD_ID) {
+    if (m_condition_step_over.abandoned ||
+        ShouldReportBreakpointHit(thread, pc))
+      return false;
+    m_condition_step_over.paused_tids.insert(thread.GetID());
+    thread.SetStoppedWithNoReason();
+    SignalIfAllThreadsStopped();
+    return true;
+  }
+
+  // If another thread is already stopping the process, this one reports its
+  // hit as well.
+  if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID ||
+      ShouldReportBreakpointHit(thread, pc))
+    return false;
+
+  // Threads the client is stepping are left alone, holding them would lose
+  // their step.
+  std::set<lldb::tid_t> paused_tids;
+  for (const auto &thread_sp : m_threads) {
+    const StateType state = thread_sp->GetState();
+    if (state == eStateStepping)
+      return false;
+    if (state == eStateRunning)
+      paused_tids.insert(thread_sp->GetID());
+  }
+
+  // Like gdb, stop all the other threads before removing the breakpoint,
+  // so that none of them can run past it unnoticed. SignalIfAllThreadsStopped()
+  // starts the step once they have.
+  m_condition_step_over.tid = thread.GetID();
+  m_condition_step_over.addr = pc;
+  m_condition_step_over.paused_tids = std::move(paused_tids);
+  m_pending_notification_tid = thread.GetID();
+  m_num_threads_known_stopped = 0;
+  for (lldb::tid_t tid : m_condition_step_over.paused_tids)
+    m_threads_by_id[tid]->RequestStop();
+  SignalIfAllThreadsStopped();
+  return true;
+}
+
+bool NativeProcessLinux::StartConditionStepOver() {
+  NativeThreadLinux &thread = *m_threads_by_id[m_condition_step_over.tid];
+  const lldb::addr_t addr = m_condition_step_over.addr;
+
+  // Execute the original instruction with the breakpoint removed.
+  Status error = DisableBreakpoint(addr);
+  if (error.Success()) {
+    m_condition_step_over.stepping = true;
+    error = thread.SingleStep(LLDB_INVALID_SIGNAL_NUMBER);
+    if (error.Success()) {
+      // The stepping thread isn't stopped anymore.
+      m_num_threads_known_stopped = 0;
+      return true;
+    }
+  }
+  Log *log(
+      GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+  LLDB_LOG(log, "tid = {0} step over breakpoint at {1:x} failed: {2}",
+           thread.GetID(), addr, error);
+  thread.SetStoppedByBreakpoint();
+  return false;
+}
+
+void NativeProcessLinux::ResumeAfterConditionStepOver() {
+  std::vector<lldb::tid_t> tids(m_condition_step_over.paused_tids.begin(),
+                                m_condition_step_over.paused_tids.end());
+  tids.push_back(m_condition_step_over.tid);
+  EndConditionStepOver();
+  m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
+
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_THREAD));
+  for (lldb::tid_t tid : tids) {
+    // Threads may have exited meanwhile.
+    auto it = m_threads_by_id.find(tid);
+    if (it == m_threads_by_id.end())
+      continue;
+    Status error =
+        ResumeThread(*it->second, eStateRunning, LLDB_INVALID_SIGNAL_NUMBER);
+    if (error.Fail())
+      LLDB_LOG(log, "tid = {0} resume after condition failed: {1}", tid,
+               error);
+  }
+}
+
+void NativeProcessLinux::EndConditionStepOver() {
+  const lldb::addr_t addr = m_condition_step_over.addr;
+  const bool stepping = m_condition_step_over.stepping;
+  m_condition_step_over = ConditionStepOver();
+
+  // The client may have removed the breakpoint meanwhile.
+  NativeBreakpointSP breakpoint_sp;
+  if (stepping &&
+      m_breakpoint_list.GetBreakpoint(addr, breakpoint_sp).Success()) {
+    Status error = EnableBreakpoint(addr);
+    if (error.Fail()) {
+      Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+      LLDB_LOG(log, "enable breakpoint at {0:x} failed: {1}", addr, error);
+    }
+  }
+}
+
 void NativeProcessLinux::MonitorWatchpoint(NativeThreadLinux &thread,
                                            uint32_t wp_index) {
   Log *log(
@@ -887,7 +1057,11 @@ void NativeProcessLinux::MonitorSignal(const siginfo_t &info,
       // etc...). However, in the case of an asynchronous Interrupt(), this *is*
       // the real stop reason, so we leave the signal intact if this is the
       // thread that was chosen as the triggering thread.
-      if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID) {
+      if (m_threads_stop_requested.erase(thread.GetID())) {
+        // A non-stop mode request to stop just this thread.
+        thread.SetStoppedWithNoReason();
+        StopRunningThreads(thread.GetID());
+      } else if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID) {
         if (m_pending_notification_tid == thread.GetID())
           thread.SetStoppedBySignal(SIGSTOP, &info);
         else
@@ -1107,6 +1281,11 @@ bool NativeProcessLinux::SupportHardwareSingleStepping() const {
   return true;
 }
 
+bool NativeProcessLinux::SupportsRangeStepping() const {
+  // Resume() only range steps with hardware single steps.
+  return SupportHardwareSingleStepping();
+}
+
 Status NativeProcessLinux::Resume(const ResumeActionList &resume_actions) {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
   LLDB_LOG(log, "pid {0}", GetID());
@@ -1122,6 +1301,9 @@ Status NativeProcessLinux::Resume(const ResumeActionList &resume_actions) {
       if (action == nullptr)
         continue;
 
+      if (m_non_stop_mode && StateIsRunningState(thread_sp->GetState()))
+        continue;
+
       if (action->state == eStateStepping) {
         Status error = SetupSoftwareSingleStepping(
             static_cast<NativeThreadLinux &>(*thread_sp));
@@ -1146,9 +1328,24 @@ Status NativeProcessLinux::Resume(const ResumeActionList &resume_actions) {
     LLDB_LOG(log, "processing resume action state {0} for pid {1} tid {2}",
              action->state, GetID(), thread_sp->GetID());
 
+    // In non-stop mode the actions only apply to the threads that are
+    // stopped, except for requests to stop a running thread.
+    if (m_non_stop_mode && StateIsRunningState(thread_sp->GetState())) {
+      if (action->state == eStateStopped)
+        RequestThreadStop(static_cast<NativeThreadLinux &>(*thread_sp));
+      continue;
+    }
+
     switch (action->state) {
     case eStateRunning:
     case eStateStepping: {
+      // Range stepping is only done with hardware single steps, software
+      // single stepping stops after each instruction.
+      if (action->state == eStateStepping && !software_single_step &&
+          action->step_range_start < action->step_range_end)
+        m_threads_range_stepping[thread_sp->GetID()] = std::make_pair(
+            action->step_range_start, action->step_range_end);
+
       // Run the thread, possibly feeding it the signal.
       const int signo = action->signal;
       ResumeThread(static_cast<NativeThreadLinux &>(*thread_sp), action->state,
@@ -1158,7 +1355,8 @@ Status NativeProcessLinux::Resume(const ResumeActionList &resume_actions) {
 
     case eStateSuspended:
     case eStateStopped:
-      llvm_unreachable("Unexpected state");
+      // The thread is already stopped, leave it that way.
+      break;
 
     default:
       return Status("NativeProcessLinux::%s (): unexpected state %s specified "
@@ -1191,7 +1389,14 @@ Status NativeProcessLinux::Detach() {
     return error;
 
   for (auto thread_sp : m_threads) {
-    Status e = Detach(thread_sp->GetID());
+    // Registers modified since the last stop are only written back on
+    // resume, so do it now.
+    Status e =
+        static_cast<NativeThreadLinux &>(*thread_sp).FlushRegisterSets();
+    if (e.Fail())
+      error = e;
+
+    e = Detach(thread_sp->GetID());
     if (e.Fail())
       error =
           e; // Save the error, but still attempt to detach from other threads.
@@ -1221,6 +1426,15 @@ Status NativeProcessLinux::Interrupt() {
   // the chosen thread that will be the stop-reason thread.
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
 
+  // In non-stop mode each running thread is stopped and reported on its own.
+  if (m_non_stop_mode) {
+    for (const auto &thread_sp : m_threads) {
+      if (StateIsRunningState(thread_sp->GetState()))
+        RequestThreadStop(static_cast<NativeThreadLinux &>(*thread_sp));
+    }
+    return Status();
+  }
+
   NativeThreadProtocolSP running_thread_sp;
   NativeThreadProtocolSP stopped_thread_sp;
 
@@ -1555,11 +1769,255 @@ Status NativeProcessLinux::DeallocateMemory(lldb::addr_t addr) {
   return Status("not implemented");
 }
 
+// Reads a pointer of the inferior, which may be narrower than the pointers
+// of lldb-server itself.
+static Status ReadInferiorPointer(NativeProcessProtocol &process,
+                                  const ArchSpec &arch, lldb::addr_t addr,
+                                  lldb::addr_t &value) {
+  const uint32_t addr_size = arch.GetAddressByteSize();
+  uint8_t buffer[8];
+  if (addr_size == 0 || addr_size > sizeof(buffer))
+    return Status("unsupported address size %" PRIu32, addr_size);
+
+  size_t bytes_read = 0;
+  Status error = process.ReadMemory(addr, buffer, addr_size, bytes_read);
+  if (error.Fail())
+    return error;
+  if (bytes_read != addr_size)
+    return Status("could not read a pointer at 0x%" PRIx64, addr);
+
+  DataExtractor data(buffer, addr_size, arch.GetByteOrder(), addr_size);
+  lldb::offset_t offset = 0;
+  value = data.GetAddress(&offset);
+  return Status();
+}
+
+static Status ReadInferiorCString(NativeProcessProtocol &process,
+                                  lldb::addr_t addr, std::string &str) {
+  str.clear();
+  char buffer[256];
+  while (str.size() < PATH_MAX) {
+    size_t bytes_read = 0;
+    Status error = process.ReadMemory(addr, buffer, sizeof(buffer), bytes_read);
+    if (error.Fail() && bytes_read == 0)
+      return error;
+    if (bytes_read == 0)
+      return Status("could not read a string at 0x%" PRIx64, addr);
+
+    const char *end = static_cast<const char *>(memchr(buffer, 0, bytes_read));
+    if (end) {
+      str.append(buffer, end - buffer);
+      return Status();
+    }
+    str.append(buffer, bytes_read);
+    addr += bytes_read;
+  }
+  return Status("string at 0x%" PRIx64 " is too long", addr);
+}
+
+// The auxiliary vector entries the SVR4 library list support looks at.
+enum {
+  eAuxvNull = 0,
+  eAuxvPhdr = 3,
+  eAuxvPhent = 4,
+  eAuxvPhnum = 5,
+  eAuxvEntry = 9,
+  eAuxvSysinfoEhdr = 33
+};
+
+static std::map<uint64_t, uint64_t> ReadAuxv(NativeProcessProtocol &process,
+                                             const ArchSpec &arch) {
+  std::map<uint64_t, uint64_t> entries;
+  auto auxv_or_error = process.GetAuxvData();
+  if (!auxv_or_error)
+    return entries;
+
+  const uint32_t addr_size = arch.GetAddressByteSize();
+  DataExtractor auxv((*auxv_or_error)->getBufferStart(),
+                     (*auxv_or_error)->getBufferSize(), arch.GetByteOrder(),
+                     addr_size);
+  lldb::offset_t offset = 0;
+  while (auxv.ValidOffsetForDataOfSize(offset, 2 * addr_size)) {
+    const uint64_t type = auxv.GetAddress(&offset);
+    const uint64_t value = auxv.GetAddress(&offset);
+    if (type == eAuxvNull)
+      break;
+    entries[type] = value;
+  }
+  return entries;
+}
+
+// Reads e_entry from the ELF header of the executable the process runs.
+static lldb::addr_t ReadExecutableEntryPoint(lldb::pid_t pid,
+                                             const ArchSpec &arch) {
+  const uint32_t addr_size = arch.GetAddressByteSize();
+  // e_entry follows e_ident, e_type, e_machine and e_version.
+  const uint64_t entry_offset = llvm::ELF::EI_NIDENT + 2 + 2 + 4;
+  auto buffer_or_error = llvm::MemoryBuffer::getFileSlice(
+      llvm::formatv("/proc/{0}/exe", pid).str(), addr_size, entry_offset);
+  if (!buffer_or_error || (*buffer_or_error)->getBufferSize() != addr_size)
+    return LLDB_INVALID_ADDRESS;
+
+  DataExtractor data((*buffer_or_error)->getBufferStart(), addr_size,
+                     arch.GetByteOrder(), addr_size);
+  lldb::offset_t offset = 0;
+  return data.GetAddress(&offset);
+}
+
 lldb::addr_t NativeProcessLinux::GetSharedLibraryInfoAddress() {
-  // punt on this for now
+  // The dynamic linker publishes the address of its r_debug structure in the
+  // DT_DEBUG entry of the executable's dynamic section. The program headers,
+  // and with them the dynamic section, are found through the auxiliary
+  // vector.
+  std::map<uint64_t, uint64_t> auxv = ReadAuxv(*this, m_arch);
+  auto get_auxv = [&auxv](uint64_t type, uint64_t fail_value) {
+    auto pos = auxv.find(type);
+    return pos == auxv.end() ? fail_value : pos->second;
+  };
+
+  const ByteOrder byte_order = m_arch.GetByteOrder();
+  const uint32_t addr_size = m_arch.GetAddressByteSize();
+  const lldb::addr_t phdr_addr = get_auxv(eAuxvPhdr, LLDB_INVALID_ADDRESS);
+  const uint64_t phdr_size = get_auxv(eAuxvPhent, 0);
+  const uint64_t phdr_count = get_auxv(eAuxvPhnum, 0);
+  if (phdr_addr == LLDB_INVALID_ADDRESS || phdr_size == 0 || phdr_count == 0)
+    return LLDB_INVALID_ADDRESS;
+
+  std::vector<uint8_t> phdrs(phdr_size * phdr_count);
+  size_t bytes_read = 0;
+  if (ReadMemory(phdr_addr, phdrs.data(), phdrs.size(), bytes_read).Fail() ||
+      bytes_read != phdrs.size())
+    return LLDB_INVALID_ADDRESS;
+
+  // The load bias of a position independent executable is the difference
+  // between where its program headers are and where they were linked.
+  DataExtractor phdr_data(phdrs.data(), phdrs.size(), byte_order, addr_size);
+  lldb::addr_t load_bias = LLDB_INVALID_ADDRESS;
+  lldb::addr_t dynamic_vaddr = LLDB_INVALID_ADDRESS;
+  uint64_t dynamic_size = 0;
+  for (uint64_t i = 0; i < phdr_count; ++i) {
+    lldb::offset_t offset = i * phdr_size;
+    const uint32_t p_type = phdr_data.GetU32(&offset);
+    if (addr_size == 8)
+      phdr_data.GetU32(&offset); // p_flags
+    phdr_data.GetAddress(&offset); // p_offset
+    const lldb::addr_t p_vaddr = phdr_data.GetAddress(&offset);
+    phdr_data.GetAddress(&offset); // p_paddr
+    phdr_data.GetAddress(&offset); // p_filesz
+    const uint64_t p_memsz = phdr_data.GetAddress(&offset);
+    if (p_type == llvm::ELF::PT_PHDR) {
+      load_bias = phdr_addr - p_vaddr;
+    } else if (p_type == llvm::ELF::PT_DYNAMIC) {
+      dynamic_vaddr = p_vaddr;
+      dynamic_size = p_memsz;
+    }
+  }
+  if (dynamic_vaddr == LLDB_INVALID_ADDRESS)
+    return LLDB_INVALID_ADDRESS;
+
+  // Executables linked without a PT_PHDR header still tell where their entry
+  // point ended up, which gives the same bias.
+  if (load_bias == LLDB_INVALID_ADDRESS) {
+    const lldb::addr_t at_entry = get_auxv(eAuxvEntry, LLDB_INVALID_ADDRESS);
+    const lldb::addr_t e_entry = ReadExecutableEntryPoint(GetID(), m_arch);
+    if (at_entry == LLDB_INVALID_ADDRESS || e_entry == LLDB_INVALID_ADDRESS)
+      return LLDB_INVALID_ADDRESS;
+    load_bias = at_entry - e_entry;
+  }
+
+  std::vector<uint8_t> dynamic(dynamic_size);
+  if (ReadMemory(load_bias + dynamic_vaddr, dynamic.data(), dynamic.size(),
+                 bytes_read)
+          .Fail())
+    return LLDB_INVALID_ADDRESS;
+
+  DataExtractor dynamic_data(dynamic.data(), bytes_read, byte_order,
+                             addr_size);
+  lldb::offset_t offset = 0;
+  while (dynamic_data.ValidOffsetForDataOfSize(offset, 2 * addr_size)) {
+    const uint64_t tag = dynamic_data.GetAddress(&offset);
+    const uint64_t value = dynamic_data.GetAddress(&offset);
+    if (tag == llvm::ELF::DT_NULL)
+      break;
+    // DT_DEBUG stays zero until the dynamic linker has initialized itself.
+    if (tag == llvm::ELF::DT_DEBUG)
+      return value ? value : LLDB_INVALID_ADDRESS;
+  }
   return LLDB_INVALID_ADDRESS;
 }
 
+llvm::Expected<std::vector<NativeProcessProtocol::SVR4LibraryInfo>>
+NativeProcessLinux::GetLoadedSVR4Libraries() {
+  std::vector<SVR4LibraryInfo> libraries;
+
+  // Static executables, and dynamic ones whose dynamic linker hasn't run
+  // yet, have no libraries to report.
+  const lldb::addr_t rendezvous_addr = GetSharedLibraryInfoAddress();
+  if (rendezvous_addr == LLDB_INVALID_ADDRESS)
+    return libraries;
+
+  // struct r_debug { int r_version; struct link_map *r_map; ... }
+  const uint32_t addr_size = m_arch.GetAddressByteSize();
+  lldb::addr_t link_map_addr = 0;
+  Status error = ReadInferiorPointer(*this, m_arch, rendezvous_addr + addr_size,
+                                     link_map_addr);
+  if (error.Fail())
+    return error.ToError();
+
+  // struct link_map { ElfW(Addr) l_addr; char *l_name; ElfW(Dyn) *l_ld;
+  //                   struct link_map *l_next, *l_prev; }
+  // The first entry describes the main executable.
+  //
+  // The vdso has an entry too, but there is no file behind it that the client
+  // could load, so it is left out. Its dynamic section lies in the mapping
+  // that starts at AT_SYSINFO_EHDR.
+  MemoryRegionInfo vdso_region;
+  std::map<uint64_t, uint64_t> auxv = ReadAuxv(*this, m_arch);
+  auto vdso_pos = auxv.find(eAuxvSysinfoEhdr);
+  if (vdso_pos == auxv.end() ||
+      GetMemoryRegionInfo(vdso_pos->second, vdso_region).Fail() ||
+      vdso_region.GetMapped() != MemoryRegionInfo::eYes)
+    vdso_region = MemoryRegionInfo();
+
+  llvm::DenseSet<lldb::addr_t> visited;
+  bool is_main_executable = true;
+  while (link_map_addr != 0) {
+    if (!visited.insert(link_map_addr).second)
+      return llvm::make_error<llvm::StringError>(
+          "link_map list contains a cycle", llvm::inconvertibleErrorCode());
+
+    lldb::addr_t l_addr, l_name, l_ld, l_next;
+    error = ReadInferiorPointer(*this, m_arch, link_map_addr, l_addr);
+    if (error.Success())
+      error = ReadInferiorPointer(*this, m_arch, link_map_addr + addr_size,
+                                  l_name);
+    if (error.Success())
+      error = ReadInferiorPointer(*this, m_arch,
+                                  link_map_addr + 2 * addr_size, l_ld);
+    if (error.Success())
+      error = ReadInferiorPointer(*this, m_arch,
+                                  link_map_addr + 3 * addr_size, l_next);
+    if (error.Fail())
+      return error.ToError();
+
+    if (!is_main_executable && !vdso_region.GetRange().Contains(l_ld)) {
+      SVR4LibraryInfo library;
+      if (l_name != 0) {
+        error = ReadInferiorCString(*this, l_name, library.name);
+        if (error.Fail())
+          return error.ToError();
+      }
+      library.link_map = link_map_addr;
+      library.base_addr = l_addr;
+      library.ld_addr = l_ld;
+      libraries.push_back(std::move(library));
+    }
+    is_main_executable = false;
+    link_map_addr = l_next;
+  }
+  return libraries;
+}
+
 size_t NativeProcessLinux::UpdateThreads() {
   // The NativeProcessLinux monitoring threads are always up to date
   // with respect to thread state and they keep the thread list
@@ -1835,8 +2293,25 @@ NativeProcessLinux::GetCrashReasonForSIGBUS(const siginfo_t *info)
 }
 #endif
 
+// /proc/pid/mem is indexed by off_t, which can't hold the addresses in the
+// upper half of the address space, such as the x86-64 vsyscall page at
+// 0xffffffffff600000. Such ranges fail with EINVAL, as pread and pwrite would.
+static Status CheckProcFileRange(lldb::addr_t addr, size_t size) {
+  const lldb::addr_t max_offset = std::numeric_limits<off_t>::max();
+  if (addr > max_offset || size > max_offset - addr)
+    return Status(EINVAL, eErrorTypePOSIX);
+  return Status();
+}
+
+static bool IsBadProcFileOffset(const Status &error) {
+  return error.GetType() == eErrorTypePOSIX && error.GetError() == EINVAL;
+}
+
 Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
                                       size_t &bytes_read) {
+  unsigned char *dst = static_cast<unsigned char *>(buf);
+  bytes_read = 0;
+
   if (ProcessVmReadvSupported()) {
     // The process_vm_readv path is about 50 times faster than ptrace api. We
     // want to use
@@ -1850,7 +2325,10 @@ Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
     remote_iov.iov_base = reinterpret_cast<void *>(addr);
     remote_iov.iov_len = size;
 
-    bytes_read = process_vm_readv(pid, &local_iov, 1, &remote_iov, 1, 0);
+    const ssize_t result =
+        process_vm_readv(pid, &local_iov, 1, &remote_iov, 1, 0);
+    if (result > 0)
+      bytes_read = result;
     const bool success = bytes_read == size;
 
     Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
@@ -1861,18 +2339,31 @@ Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
 
     if (success)
       return Status();
-    // else the call failed for some reason, let's retry the read using ptrace
-    // api.
-  }
+    // else the read stopped at a page it can't access. Carry on from there
+    // using /proc/pid/mem, which can also read pages the inferior itself
+    // can't.
+  }
+
+  size_t proc_bytes_read = 0;
+  Status error = ReadMemoryFromProcFile(addr + bytes_read, dst + bytes_read,
+                                        size - bytes_read, proc_bytes_read);
+  bytes_read += proc_bytes_read;
+  // If the file could be used the rest of the range is not mapped, and
+  // ptrace won't be able to read it either. Addresses the file can't seek
+  // to are left to ptrace though.
+  if (error.Success() ||
+      (m_supports_proc_mem == eLazyBoolYes && !IsBadProcFileOffset(error)))
+    return error;
 
-  unsigned char *dst = static_cast<unsigned char *>(buf);
   size_t remainder;
   long data;
 
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_MEMORY));
   LLDB_LOG(log, "addr = {0}, buf = {1}, size = {2}", addr, buf, size);
 
-  for (bytes_read = 0; bytes_read < size; bytes_read += remainder) {
+  addr += bytes_read;
+  dst += bytes_read;
+  for (; bytes_read < size; bytes_read += remainder) {
     Status error = NativeProcessLinux::PtraceWrapper(
         PTRACE_PEEKDATA, GetID(), (void *)addr, nullptr, 0, &data);
     if (error.Fail())
@@ -1891,6 +2382,74 @@ Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
   return Status();
 }
 
+File *NativeProcessLinux::GetProcMemoryFile() {
+  if (m_supports_proc_mem == eLazyBoolCalculate) {
+    Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_MEMORY));
+
+    std::string path = llvm::formatv("/proc/{0}/mem", GetID()).str();
+    Status error = m_proc_mem_file.Open(path.c_str(),
+                                        File::eOpenOptionRead |
+                                            File::eOpenOptionWrite |
+                                            File::eOpenOptionCloseOnExec);
+    m_supports_proc_mem = error.Success() ? eLazyBoolYes : eLazyBoolNo;
+    LLDB_LOG(log, "opening {0}: {1}", path, error);
+  }
+  return m_supports_proc_mem == eLazyBoolYes ? &m_proc_mem_file : nullptr;
+}
+
+Status NativeProcessLinux::ReadMemoryFromProcFile(lldb::addr_t addr,
+                                                  void *buf, size_t size,
+                                                  size_t &bytes_read) {
+  bytes_read = 0;
+  File *file = GetProcMemoryFile();
+  if (!file)
+    return Status("/proc/%" PRIu64 "/mem is not available", GetID());
+  Status error = CheckProcFileRange(addr, size);
+  if (error.Fail())
+    return error;
+
+  off_t offset = addr;
+  while (bytes_read < size) {
+    size_t num_bytes = size - bytes_read;
+    error =
+        file->Read(static_cast<uint8_t *>(buf) + bytes_read, num_bytes, offset);
+    if (error.Fail())
+      return error;
+    // A short read stops at an unmapped page, make sure it isn't mapped.
+    if (num_bytes == 0)
+      return Status("could not read memory at 0x%" PRIx64,
+                    addr + bytes_read);
+    bytes_read += num_bytes;
+  }
+  return Status();
+}
+
+Status NativeProcessLinux::WriteMemoryToProcFile(lldb::addr_t addr,
+                                                 const void *buf, size_t size,
+                                                 size_t &bytes_written) {
+  bytes_written = 0;
+  File *file = GetProcMemoryFile();
+  if (!file)
+    return Status("/proc/%" PRIu64 "/mem is not available", GetID());
+  Status error = CheckProcFileRange(addr, size);
+  if (error.Fail())
+    return error;
+
+  off_t offset = addr;
+  while (bytes_written < size) {
+    size_t num_bytes = size - bytes_written;
+    error = file->Write(static_cast<const uint8_t *>(buf) + bytes_written,
+                        num_bytes, offset);
+    if (error.Fail())
+      return error;
+    if (num_bytes == 0)
+      return Status("could not write memory at 0x%" PRIx64,
+                    addr + bytes_written);
+    bytes_written += num_bytes;
+  }
+  return Status();
+}
+
 Status NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf,
                                                  size_t size,
                                                  size_t &bytes_read) {
@@ -1904,12 +2463,49 @@ Status NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf,
                                        size_t size, size_t &bytes_written) {
   const unsigned char *src = static_cast<const unsigned char *>(buf);
   size_t remainder;
-  Status error;
+  bytes_written = 0;
 
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_MEMORY));
   LLDB_LOG(log, "addr = {0}, buf = {1}, size = {2}", addr, buf, size);
 
-  for (bytes_written = 0; bytes_written < size; bytes_written += remainder) {
+  // process_vm_writev is available whenever process_vm_readv is. It honours
+  // the page protections, so writes to code stop at the first read-only
+  // page.
+  if (ProcessVmReadvSupported()) {
+    struct iovec local_iov, remote_iov;
+    local_iov.iov_base = const_cast<void *>(buf);
+    local_iov.iov_len = size;
+    remote_iov.iov_base = reinterpret_cast<void *>(addr);
+    remote_iov.iov_len = size;
+
+    const ssize_t result =
+        process_vm_writev(GetID(), &local_iov, 1, &remote_iov, 1, 0);
+    if (result > 0)
+      bytes_written = result;
+    const bool success = bytes_written == size;
+
+    LLDB_LOG(log,
+             "using process_vm_writev to write {0} bytes to inferior "
+             "address {1:x}: {2}",
+             size, addr, success ? "Success" : llvm::sys::StrError(errno));
+
+    if (success)
+      return Status();
+  }
+
+  // Writes to /proc/pid/mem ignore the page protections, like ptrace does.
+  size_t proc_bytes_written = 0;
+  Status error =
+      WriteMemoryToProcFile(addr + bytes_written, src + bytes_written,
+                            size - bytes_written, proc_bytes_written);
+  bytes_written += proc_bytes_written;
+  if (error.Success() ||
+      (m_supports_proc_mem == eLazyBoolYes && !IsBadProcFileOffset(error)))
+    return error;
+
+  addr += bytes_written;
+  src += bytes_written;
+  for (; bytes_written < size; bytes_written += remainder) {
     remainder = size - bytes_written;
     remainder = remainder > k_ptrace_word_size ? k_ptrace_word_size : remainder;
 
@@ -1963,16 +2559,7 @@ Status NativeProcessLinux::Detach(lldb::tid_t tid) {
 }
 
 bool NativeProcessLinux::HasThreadNoLock(lldb::tid_t thread_id) {
-  for (auto thread_sp : m_threads) {
-    assert(thread_sp && "thread list should not contain NULL threads");
-    if (thread_sp->GetID() == thread_id) {
-      // We have this thread.
-      return true;
-    }
-  }
-
-  // We don't have this thread.
-  return false;
+  return m_threads_by_id.count(thread_id) != 0;
 }
 
 bool NativeProcessLinux::StopTrackingThread(lldb::tid_t thread_id) {
@@ -1980,16 +2567,27 @@ bool NativeProcessLinux::StopTrackingThread(lldb::tid_t thread_id) {
   LLDB_LOG(log, "tid: {0})", thread_id);
 
   bool found = false;
-  for (auto it = m_threads.begin(); it != m_threads.end(); ++it) {
-    if (*it && ((*it)->GetID() == thread_id)) {
-      m_threads.erase(it);
-      found = true;
-      break;
+  if (m_threads_by_id.erase(thread_id)) {
+    for (auto it = m_threads.begin(); it != m_threads.end(); ++it) {
+      if (*it && ((*it)->GetID() == thread_id)) {
+        // Keep the already stopped prefix pointing at the same threads.
+        if (size_t(it - m_threads.begin()) < m_num_threads_known_stopped)
+          --m_num_threads_known_stopped;
+        m_threads.erase(it);
+        found = true;
+        break;
+      }
     }
   }
 
   if (found)
     StopTracingForThread(thread_id);
+  if (thread_id == m_condition_step_over.tid) {
+    if (m_condition_step_over.stepping && !m_condition_step_over.abandoned)
+      ResumeAfterConditionStepOver();
+    else
+      m_condition_step_over.abandoned = true;
+  }
   SignalIfAllThreadsStopped();
   return found;
 }
@@ -2007,6 +2605,7 @@ NativeThreadLinuxSP NativeProcessLinux::AddThread(lldb::tid_t thread_id) {
 
   auto thread_sp = std::make_shared<NativeThreadLinux>(*this, thread_id);
   m_threads.push_back(thread_sp);
+  m_threads_by_id[thread_id] = thread_sp;
 
   if (m_pt_proces_trace_id != LLDB_INVALID_UID) {
     auto traceMonitor = ProcessorTraceMonitor::Create(
@@ -2145,8 +2744,9 @@ Status NativeProcessLinux::GetFileLoadAddress(const llvm::StringRef &file_name,
 }
 
 NativeThreadLinuxSP NativeProcessLinux::GetThreadByID(lldb::tid_t tid) {
-  return std::static_pointer_cast<NativeThreadLinux>(
-      NativeProcessProtocol::GetThreadByID(tid));
+  std::lock_guard<std::recursive_mutex> guard(m_threads_mutex);
+  auto it = m_threads_by_id.find(tid);
+  return it != m_threads_by_id.end() ? it->second : NativeThreadLinuxSP();
 }
 
 Status NativeProcessLinux::ResumeThread(NativeThreadLinux &thread,
@@ -2196,14 +2796,31 @@ void NativeProcessLinux::StopRunningThreads(const lldb::tid_t triggering_tid) {
   LLDB_LOG(log, "about to process event: (triggering_tid: {0})",
            triggering_tid);
 
-  m_pending_notification_tid = triggering_tid;
+  // In non-stop mode the other threads keep running.
+  if (m_non_stop_mode) {
+    ReportThreadStop(triggering_tid);
+    return;
+  }
 
-  // Request a stop for all the thread stops that need to be stopped
-  // and are not already known to be stopped.
-  for (const auto &thread_sp : m_threads) {
-    if (StateIsRunningState(thread_sp->GetState()))
-      static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
+  // A step over a breakpoint whose conditions were false gives way to a stop
+  // that has to be reported.
+  if (m_condition_step_over.tid != LLDB_INVALID_THREAD_ID)
+    m_condition_step_over.abandoned = true;
+
+  // If a notification is already pending, every running thread has been
+  // asked to stop already (new ones by ThreadWasCreated()), so don't send
+  // them another SIGSTOP each time one more thread reports a stop.
+  if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID) {
+    m_num_threads_known_stopped = 0;
+
+    // Request a stop for all the thread stops that need to be stopped
+    // and are not already known to be stopped.
+    for (const auto &thread_sp : m_threads) {
+      if (StateIsRunningState(thread_sp->GetState()))
+        static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
+    }
   }
+  m_pending_notification_tid = triggering_tid;
 
   SignalIfAllThreadsStopped();
   LLDB_LOG(log, "event processing done");
@@ -2213,11 +2830,22 @@ void NativeProcessLinux::SignalIfAllThreadsStopped() {
   if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID)
     return; // No pending notification. Nothing to do.
 
-  for (const auto &thread_sp : m_threads) {
-    if (StateIsRunningState(thread_sp->GetState()))
+  // Each stopping thread calls us, so pick up where the last call left off
+  // instead of walking all the threads every time.
+  for (; m_num_threads_known_stopped < m_threads.size();
+       ++m_num_threads_known_stopped) {
+    if (StateIsRunningState(
+            m_threads[m_num_threads_known_stopped]->GetState()))
       return; // Some threads are still running. Don't signal yet.
   }
 
+  // All the other threads are held, step over the breakpoint whose
+  // conditions were false.
+  if (m_condition_step_over.tid != LLDB_INVALID_THREAD_ID &&
+      !m_condition_step_over.stepping && !m_condition_step_over.abandoned &&
+      StartConditionStepOver())
+    return;
+
   // We have a pending notification and all threads have stopped.
   Log *log(
       GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
@@ -2231,6 +2859,12 @@ void NativeProcessLinux::SignalIfAllThreadsStopped() {
                thread_info.first, error);
   }
   m_threads_stepping_with_breakpoint.clear();
+  m_threads_range_stepping.clear();
+
+  // A step over a breakpoint whose conditions were false was cut short by
+  // this stop. The stepping thread reports its hit or has finished the step.
+  if (m_condition_step_over.tid != LLDB_INVALID_THREAD_ID)
+    EndConditionStepOver();
 
   // Notify the delegate about the stop
   SetCurrentThreadID(m_pending_notification_tid);
@@ -2238,6 +2872,46 @@ void NativeProcessLinux::SignalIfAllThreadsStopped() {
   m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 }
 
+void NativeProcessLinux::ReportThreadStop(lldb::tid_t tid) {
+  Log *log(
+      GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+
+  // Only this thread's temporary single step breakpoint can go, the other
+  // threads may still be stepping.
+  auto step_it = m_threads_stepping_with_breakpoint.find(tid);
+  if (step_it != m_threads_stepping_with_breakpoint.end()) {
+    Status error = RemoveBreakpoint(step_it->second);
+    if (error.Fail())
+      LLDB_LOG(log, "pid = {0} remove stepping breakpoint: {1}", tid, error);
+    m_threads_stepping_with_breakpoint.erase(step_it);
+  }
+  m_threads_range_stepping.erase(tid);
+
+  // If the thread stopped for another reason before our SIGSTOP arrived,
+  // the signal is dropped once the thread runs again.
+  m_threads_stop_requested.erase(tid);
+
+  SetCurrentThreadID(tid);
+  NotifyThreadStopped(tid);
+}
+
+void NativeProcessLinux::RequestThreadStop(NativeThreadLinux &thread) {
+  if (m_threads_stop_requested.insert(thread.GetID()).second)
+    thread.RequestStop();
+}
+
+Status NativeProcessLinux::SetNonStopMode(bool enable) {
+  if (enable == m_non_stop_mode)
+    return Status();
+
+  if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID ||
+      !m_threads_stop_requested.empty())
+    return Status("cannot change the stop mode while threads are stopping");
+
+  m_non_stop_mode = enable;
+  return Status();
+}
+
 void NativeProcessLinux::ThreadWasCreated(NativeThreadLinux &thread) {
   Log *const log = ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_THREAD);
   LLDB_LOG(log, "tid: {0}", thread.GetID());
@@ -2248,6 +2922,8 @@ void NativeProcessLinux::ThreadWasCreated(NativeThreadLinux &thread) {
     // the
     // notification.
     thread.RequestStop();
+    if (m_condition_step_over.tid != LLDB_INVALID_THREAD_ID)
+      m_condition_step_over.paused_tids.insert(thread.GetID());
   }
 }
 
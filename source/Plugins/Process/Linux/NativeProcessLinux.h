@@ -11,11 +11,14 @@
 #define liblldb_NativeProcessLinux_H_
 
 #include <csignal>
+#include <set>
+#include <unordered_map>
 #include <unordered_set>
 
 // Other libraries and framework includes
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Host/Debug.h"
+#include "lldb/Host/File.h"
 #include "lldb/Host/HostThread.h"
 #include "lldb/Host/linux/Support.h"
 #include "lldb/Target/MemoryRegionInfo.h"
@@ -66,6 +69,10 @@ public:
 
   Status Kill() override;
 
+  Status SetNonStopMode(bool enable) override;
+
+  bool SupportsRangeStepping() const override;
+
   Status GetMemoryRegionInfo(lldb::addr_t load_addr,
                              MemoryRegionInfo &range_info) override;
 
@@ -85,6 +92,9 @@ public:
 
   lldb::addr_t GetSharedLibraryInfoAddress() override;
 
+  llvm::Expected<std::vector<SVR4LibraryInfo>>
+  GetLoadedSVR4Libraries() override;
+
   size_t UpdateThreads() override;
 
   bool GetArchitecture(ArchSpec &arch) const override;
@@ -150,12 +160,51 @@ private:
   LazyBool m_supports_mem_region = eLazyBoolCalculate;
   std::vector<std::pair<MemoryRegionInfo, FileSpec>> m_mem_region_cache;
 
+  // /proc/<pid>/mem, opened on first use.
+  LazyBool m_supports_proc_mem = eLazyBoolCalculate;
+  File m_proc_mem_file;
+
   lldb::tid_t m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 
+  // Number of threads at the start of m_threads which are known to have
+  // stopped for the pending notification. Threads don't get resumed while a
+  // notification is pending, so SignalIfAllThreadsStopped() only has to look
+  // at the rest of the list.
+  size_t m_num_threads_known_stopped = 0;
+
+  // Index of m_threads by thread id, so that each waitpid event can find its
+  // thread without walking the list.
+  std::unordered_map<lldb::tid_t, NativeThreadLinuxSP> m_threads_by_id;
+
   // List of thread ids stepping with a breakpoint with the address of
   // the relevan breakpoint
   std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_with_breakpoint;
 
+  // The thread stepping over a breakpoint whose conditions were false. All
+  // the other threads are stopped first, so that none of them can run past
+  // the breakpoint while it is disabled for the step.
+  struct ConditionStepOver {
+    lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+    lldb::addr_t addr = LLDB_INVALID_ADDRESS;
+    // The threads that were running and are resumed after the step. A
+    // thread that was asked to stop may hit the breakpoint first, so this
+    // is a set to resume each thread once.
+    std::set<lldb::tid_t> paused_tids;
+    // Set once the breakpoint is disabled and the thread is stepping.
+    bool stepping = false;
+    // Set when another stop has to be reported instead.
+    bool abandoned = false;
+  };
+  ConditionStepOver m_condition_step_over;
+
+  // List of thread ids range stepping with the [start, end) range they keep
+  // stepping in
+  std::map<lldb::tid_t, std::pair<lldb::addr_t, lldb::addr_t>>
+      m_threads_range_stepping;
+
+  // Threads which were sent a SIGSTOP to stop just them in non-stop mode.
+  std::unordered_set<lldb::tid_t> m_threads_stop_requested;
+
   // ---------------------------------------------------------------------
   // Private Instance Methods
   // ---------------------------------------------------------------------
@@ -178,6 +227,14 @@ private:
 
   void MonitorBreakpoint(NativeThreadLinux &thread);
 
+  bool StepOverFalseCondition(NativeThreadLinux &thread);
+
+  bool StartConditionStepOver();
+
+  void ResumeAfterConditionStepOver();
+
+  void EndConditionStepOver();
+
   void MonitorWatchpoint(NativeThreadLinux &thread, uint32_t wp_index);
 
   void MonitorSignal(const siginfo_t &info, NativeThreadLinux &thread,
@@ -185,6 +242,15 @@ private:
 
   Status SetupSoftwareSingleStepping(NativeThreadLinux &thread);
 
+  // Returns the inferior's /proc/<pid>/mem, or nullptr if it can't be opened.
+  File *GetProcMemoryFile();
+
+  Status ReadMemoryFromProcFile(lldb::addr_t addr, void *buf, size_t size,
+                                size_t &bytes_read);
+
+  Status WriteMemoryToProcFile(lldb::addr_t addr, const void *buf,
+                               size_t size, size_t &bytes_written);
+
 #if 0
         static ::ProcessMessage::CrashReason
         GetCrashReasonForSIGSEGV(const siginfo_t *info);
@@ -232,6 +298,11 @@ private:
   // Notify the delegate if all threads have stopped.
   void SignalIfAllThreadsStopped();
 
+  // Reports a thread stop in non-stop mode.
+  void ReportThreadStop(lldb::tid_t tid);
+
+  void RequestThreadStop(NativeThreadLinux &thread);
+
   // Resume the given thread, optionally passing it the given signal. The type
   // of resume
   // operation (continue, single-step) depends on the state parameter.
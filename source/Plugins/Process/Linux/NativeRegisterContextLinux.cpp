@@ -23,7 +23,30 @@ NativeRegisterContextLinux::NativeRegisterContextLinux(
     NativeThreadProtocol &native_thread, uint32_t concrete_frame_idx,
     RegisterInfoInterface *reg_info_interface_p)
     : NativeRegisterContextRegisterInfo(native_thread, concrete_frame_idx,
-                                        reg_info_interface_p) {}
+                                        reg_info_interface_p),
+      m_cache_register_sets(false), m_gpr_is_cached(false),
+      m_gpr_is_dirty(false), m_fpr_is_cached(false), m_fpr_is_dirty(false),
+      m_ptrace_request_count(0) {}
+
+Status NativeRegisterContextLinux::FlushRegisterSets() {
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_REGISTERS));
+
+  Status error;
+  if (m_gpr_is_dirty)
+    error = DoWriteGPR(GetGPRBuffer(), GetGPRSize());
+  if (error.Success() && m_fpr_is_dirty)
+    error = DoWriteFPR(GetFPRBuffer(), GetFPRSize());
+
+  LLDB_LOG(log, "tid {0}: {1} register ptrace requests since the last stop",
+           m_thread.GetID(), m_ptrace_request_count);
+
+  m_gpr_is_cached = false;
+  m_gpr_is_dirty = false;
+  m_fpr_is_cached = false;
+  m_fpr_is_dirty = false;
+  m_ptrace_request_count = 0;
+  return error;
+}
 
 lldb::ByteOrder NativeRegisterContextLinux::GetByteOrder() const {
   // Get the target process whose privileged thread was used for the register
@@ -104,12 +127,17 @@ NativeRegisterContextLinux::WriteRegisterRaw(uint32_t reg_index,
 }
 
 Status NativeRegisterContextLinux::ReadGPR() {
+  if (m_gpr_is_cached)
+    return Status();
+
   void *buf = GetGPRBuffer();
   if (!buf)
     return Status("GPR buffer is NULL");
   size_t buf_size = GetGPRSize();
 
-  return DoReadGPR(buf, buf_size);
+  Status error = DoReadGPR(buf, buf_size);
+  m_gpr_is_cached = error.Success() && m_cache_register_sets;
+  return error;
 }
 
 Status NativeRegisterContextLinux::WriteGPR() {
@@ -118,16 +146,26 @@ Status NativeRegisterContextLinux::WriteGPR() {
     return Status("GPR buffer is NULL");
   size_t buf_size = GetGPRSize();
 
+  if (m_cache_register_sets) {
+    m_gpr_is_cached = true;
+    m_gpr_is_dirty = true;
+    return Status();
+  }
   return DoWriteGPR(buf, buf_size);
 }
 
 Status NativeRegisterContextLinux::ReadFPR() {
+  if (m_fpr_is_cached)
+    return Status();
+
   void *buf = GetFPRBuffer();
   if (!buf)
     return Status("FPR buffer is NULL");
   size_t buf_size = GetFPRSize();
 
-  return DoReadFPR(buf, buf_size);
+  Status error = DoReadFPR(buf, buf_size);
+  m_fpr_is_cached = error.Success() && m_cache_register_sets;
+  return error;
 }
 
 Status NativeRegisterContextLinux::WriteFPR() {
@@ -136,21 +174,24 @@ Status NativeRegisterContextLinux::WriteFPR() {
     return Status("FPR buffer is NULL");
   size_t buf_size = GetFPRSize();
 
+  if (m_cache_register_sets) {
+    m_fpr_is_cached = true;
+    m_fpr_is_dirty = true;
+    return Status();
+  }
   return DoWriteFPR(buf, buf_size);
 }
 
 Status NativeRegisterContextLinux::ReadRegisterSet(void *buf, size_t buf_size,
                                                    unsigned int regset) {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_GETREGSET, m_thread.GetID(),
-                                           static_cast<void *>(&regset), buf,
-                                           buf_size);
+  return PtraceRegisters(PTRACE_GETREGSET, static_cast<void *>(&regset), buf,
+                         buf_size);
 }
 
 Status NativeRegisterContextLinux::WriteRegisterSet(void *buf, size_t buf_size,
                                                     unsigned int regset) {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_SETREGSET, m_thread.GetID(),
-                                           static_cast<void *>(&regset), buf,
-                                           buf_size);
+  return PtraceRegisters(PTRACE_SETREGSET, static_cast<void *>(&regset), buf,
+                         buf_size);
 }
 
 Status NativeRegisterContextLinux::DoReadRegisterValue(uint32_t offset,
@@ -160,9 +201,8 @@ Status NativeRegisterContextLinux::DoReadRegisterValue(uint32_t offset,
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_REGISTERS));
 
   long data;
-  Status error = NativeProcessLinux::PtraceWrapper(
-      PTRACE_PEEKUSER, m_thread.GetID(), reinterpret_cast<void *>(offset),
-      nullptr, 0, &data);
+  Status error = PtraceRegisters(
+      PTRACE_PEEKUSER, reinterpret_cast<void *>(offset), nullptr, 0, &data);
 
   if (error.Success())
     // First cast to an unsigned of the same size to avoid sign extension.
@@ -179,26 +219,31 @@ Status NativeRegisterContextLinux::DoWriteRegisterValue(
   void *buf = reinterpret_cast<void *>(value.GetAsUInt64());
   LLDB_LOG(log, "{0}: {1}", reg_name, buf);
 
-  return NativeProcessLinux::PtraceWrapper(
-      PTRACE_POKEUSER, m_thread.GetID(), reinterpret_cast<void *>(offset), buf);
+  return PtraceRegisters(PTRACE_POKEUSER, reinterpret_cast<void *>(offset),
+                         buf);
 }
 
 Status NativeRegisterContextLinux::DoReadGPR(void *buf, size_t buf_size) {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_GETREGS, m_thread.GetID(),
-                                           nullptr, buf, buf_size);
+  return PtraceRegisters(PTRACE_GETREGS, nullptr, buf, buf_size);
 }
 
 Status NativeRegisterContextLinux::DoWriteGPR(void *buf, size_t buf_size) {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_SETREGS, m_thread.GetID(),
-                                           nullptr, buf, buf_size);
+  return PtraceRegisters(PTRACE_SETREGS, nullptr, buf, buf_size);
 }
 
 Status NativeRegisterContextLinux::DoReadFPR(void *buf, size_t buf_size) {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_GETFPREGS, m_thread.GetID(),
-                                           nullptr, buf, buf_size);
+  return PtraceRegisters(PTRACE_GETFPREGS, nullptr, buf, buf_size);
 }
 
 Status NativeRegisterContextLinux::DoWriteFPR(void *buf, size_t buf_size) {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_SETFPREGS, m_thread.GetID(),
-                                           nullptr, buf, buf_size);
+  return PtraceRegisters(PTRACE_SETFPREGS, nullptr, buf, buf_size);
+}
+
+Status NativeRegisterContextLinux::PtraceRegisters(int req, void *addr,
+                                                   void *data,
+                                                   size_t data_size,
+                                                   long *result) {
+  ++m_ptrace_request_count;
+  return NativeProcessLinux::PtraceWrapper(req, m_thread.GetID(), addr, data,
+                                           data_size, result);
 }
@@ -36,6 +36,14 @@ public:
                                        NativeThreadProtocol &native_thread,
                                        uint32_t concrete_frame_idx);
 
+  // Writes back the register sets modified since the thread stopped and
+  // drops the cached copies, which are stale once the thread runs. Called
+  // right before the thread is resumed.
+  Status FlushRegisterSets();
+
+  // The number of register ptrace requests issued since the thread stopped.
+  uint32_t GetPtraceRequestCount() const { return m_ptrace_request_count; }
+
 protected:
   lldb::ByteOrder GetByteOrder() const;
 
@@ -84,6 +92,22 @@ protected:
   virtual Status DoReadFPR(void *buf, size_t buf_size);
 
   virtual Status DoWriteFPR(void *buf, size_t buf_size);
+
+  // Issues a register ptrace request for this thread and counts it.
+  Status PtraceRegisters(int req, void *addr = nullptr, void *data = nullptr,
+                         size_t data_size = 0, long *result = nullptr);
+
+  // Subclasses whose GPR and FPR buffers hold the complete register sets
+  // set this to make ReadGPR()/ReadFPR() fetch each set once per stop and
+  // WriteGPR()/WriteFPR() defer the write until FlushRegisterSets().
+  bool m_cache_register_sets;
+  bool m_gpr_is_cached;
+  bool m_gpr_is_dirty;
+  bool m_fpr_is_cached;
+  bool m_fpr_is_dirty;
+
+private:
+  uint32_t m_ptrace_request_count;
 };
 
 } // namespace process_linux
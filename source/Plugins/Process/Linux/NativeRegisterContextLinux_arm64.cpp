@@ -159,6 +159,9 @@ NativeRegisterContextLinux_arm64::NativeRegisterContextLinux_arm64(
   m_max_hwp_supported = 16;
   m_max_hbp_supported = 16;
   m_refresh_hwdebug_info = true;
+
+  // m_gpr_arm64 and m_fpr hold the complete register sets.
+  m_cache_register_sets = true;
 }
 
 uint32_t NativeRegisterContextLinux_arm64::GetRegisterSetCount() const {
@@ -196,6 +199,18 @@ NativeRegisterContextLinux_arm64::ReadRegister(const RegisterInfo *reg_info,
     error = ReadFPR();
     if (error.Fail())
       return error;
+  } else if (IsGPR(reg) &&
+             reg_info->byte_offset + reg_info->byte_size <= GetGPRSize()) {
+    // Extract it from the GPR set, which is fetched once per stop.
+    error = ReadGPR();
+    if (error.Fail())
+      return error;
+
+    const uint8_t *src =
+        reinterpret_cast<const uint8_t *>(&m_gpr_arm64) + reg_info->byte_offset;
+    reg_value.SetFromMemoryData(reg_info, src, reg_info->byte_size,
+                                eByteOrderLittle, error);
+    return error;
   } else {
     uint32_t full_reg = reg;
     bool is_subreg = reg_info->invalidate_regs &&
@@ -244,10 +259,29 @@ Status NativeRegisterContextLinux_arm64::WriteRegister(
                                                ? reg_info->name
                                                : "<unknown register>");
 
-  if (IsGPR(reg_index))
-    return WriteRegisterRaw(reg_index, reg_value);
+  if (IsGPR(reg_index)) {
+    if (reg_info->byte_offset + reg_info->byte_size > GetGPRSize())
+      return WriteRegisterRaw(reg_index, reg_value);
+
+    // Update the cached GPR set, it is written back on resume.
+    Status error = ReadGPR();
+    if (error.Fail())
+      return error;
+
+    uint8_t *dst =
+        reinterpret_cast<uint8_t *>(&m_gpr_arm64) + reg_info->byte_offset;
+    reg_value.GetAsMemoryData(reg_info, dst, reg_info->byte_size,
+                              eByteOrderLittle, error);
+    if (error.Fail())
+      return error;
+    return WriteGPR();
+  }
 
   if (IsFPR(reg_index)) {
+    Status error = ReadFPR();
+    if (error.Fail())
+      return error;
+
     // Get pointer to m_fpr variable and set the data to it.
     uint32_t fpr_offset = CalculateFprOffset(reg_info);
     assert(fpr_offset < sizeof m_fpr);
@@ -268,7 +302,7 @@ Status NativeRegisterContextLinux_arm64::WriteRegister(
                     reg_info->byte_size);
     }
 
-    Status error = WriteFPR();
+    error = WriteFPR();
     if (error.Fail())
       return error;
 
@@ -791,8 +825,6 @@ Status NativeRegisterContextLinux_arm64::ReadHardwareDebugInfo() {
     return Status();
   }
 
-  ::pid_t tid = m_thread.GetID();
-
   int regset = NT_ARM_HW_WATCH;
   struct iovec ioVec;
   struct user_hwdebug_state dreg_state;
@@ -800,8 +832,7 @@ Status NativeRegisterContextLinux_arm64::ReadHardwareDebugInfo() {
 
   ioVec.iov_base = &dreg_state;
   ioVec.iov_len = sizeof(dreg_state);
-  error = NativeProcessLinux::PtraceWrapper(PTRACE_GETREGSET, tid, &regset,
-                                            &ioVec, ioVec.iov_len);
+  error = PtraceRegisters(PTRACE_GETREGSET, &regset, &ioVec, ioVec.iov_len);
 
   if (error.Fail())
     return error;
@@ -809,8 +840,7 @@ Status NativeRegisterContextLinux_arm64::ReadHardwareDebugInfo() {
   m_max_hwp_supported = dreg_state.dbg_info & 0xff;
 
   regset = NT_ARM_HW_BREAK;
-  error = NativeProcessLinux::PtraceWrapper(PTRACE_GETREGSET, tid, &regset,
-                                            &ioVec, ioVec.iov_len);
+  error = PtraceRegisters(PTRACE_GETREGSET, &regset, &ioVec, ioVec.iov_len);
 
   if (error.Fail())
     return error;
@@ -849,8 +879,7 @@ Status NativeRegisterContextLinux_arm64::WriteHardwareDebugRegs(int hwbType) {
     }
   }
 
-  return NativeProcessLinux::PtraceWrapper(PTRACE_SETREGSET, m_thread.GetID(),
-                                           &hwbType, &ioVec, ioVec.iov_len);
+  return PtraceRegisters(PTRACE_SETREGSET, &hwbType, &ioVec, ioVec.iov_len);
 }
 
 Status NativeRegisterContextLinux_arm64::DoReadRegisterValue(
@@ -869,8 +898,7 @@ Status NativeRegisterContextLinux_arm64::DoReadRegisterValue(
 
     ioVec.iov_base = &regs;
     ioVec.iov_len = sizeof regs;
-    error = NativeProcessLinux::PtraceWrapper(
-        PTRACE_GETREGSET, m_thread.GetID(), &regset, &ioVec, sizeof regs);
+    error = PtraceRegisters(PTRACE_GETREGSET, &regset, &ioVec, sizeof regs);
     if (error.Success()) {
       ArchSpec arch;
       if (m_thread.GetProcess().GetArchitecture(arch))
@@ -886,8 +914,7 @@ Status NativeRegisterContextLinux_arm64::DoReadRegisterValue(
 
     ioVec.iov_base = &regs;
     ioVec.iov_len = sizeof regs;
-    error = NativeProcessLinux::PtraceWrapper(
-        PTRACE_GETREGSET, m_thread.GetID(), &regset, &ioVec, sizeof regs);
+    error = PtraceRegisters(PTRACE_GETREGSET, &regset, &ioVec, sizeof regs);
     if (error.Success()) {
       ArchSpec arch;
       if (m_thread.GetProcess().GetArchitecture(arch))
@@ -903,7 +930,6 @@ Status NativeRegisterContextLinux_arm64::DoReadRegisterValue(
 Status NativeRegisterContextLinux_arm64::DoWriteRegisterValue(
     uint32_t offset, const char *reg_name, const RegisterValue &value) {
   Status error;
-  ::pid_t tid = m_thread.GetID();
   if (offset > sizeof(struct user_pt_regs)) {
     offset -= sizeof(struct user_pt_regs);
     if (offset > sizeof(struct user_fpsimd_state)) {
@@ -916,14 +942,12 @@ Status NativeRegisterContextLinux_arm64::DoWriteRegisterValue(
 
     ioVec.iov_base = &regs;
     ioVec.iov_len = sizeof regs;
-    error = NativeProcessLinux::PtraceWrapper(PTRACE_GETREGSET, tid, &regset,
-                                              &ioVec, sizeof regs);
+    error = PtraceRegisters(PTRACE_GETREGSET, &regset, &ioVec, sizeof regs);
 
     if (error.Success()) {
       ::memcpy((void *)(((unsigned char *)(&regs)) + offset), value.GetBytes(),
                16);
-      error = NativeProcessLinux::PtraceWrapper(PTRACE_SETREGSET, tid, &regset,
-                                                &ioVec, sizeof regs);
+      error = PtraceRegisters(PTRACE_SETREGSET, &regset, &ioVec, sizeof regs);
     }
   } else {
     elf_gregset_t regs;
@@ -932,13 +956,11 @@ Status NativeRegisterContextLinux_arm64::DoWriteRegisterValue(
 
     ioVec.iov_base = &regs;
     ioVec.iov_len = sizeof regs;
-    error = NativeProcessLinux::PtraceWrapper(PTRACE_GETREGSET, tid, &regset,
-                                              &ioVec, sizeof regs);
+    error = PtraceRegisters(PTRACE_GETREGSET, &regset, &ioVec, sizeof regs);
     if (error.Success()) {
       ::memcpy((void *)(((unsigned char *)(&regs)) + offset), value.GetBytes(),
                8);
-      error = NativeProcessLinux::PtraceWrapper(PTRACE_SETREGSET, tid, &regset,
-                                                &ioVec, sizeof regs);
+      error = PtraceRegisters(PTRACE_SETREGSET, &regset, &ioVec, sizeof regs);
     }
   }
   return error;
@@ -951,8 +973,7 @@ Status NativeRegisterContextLinux_arm64::DoReadGPR(void *buf, size_t buf_size) {
 
   ioVec.iov_base = buf;
   ioVec.iov_len = buf_size;
-  return NativeProcessLinux::PtraceWrapper(PTRACE_GETREGSET, m_thread.GetID(),
-                                           &regset, &ioVec, buf_size);
+  return PtraceRegisters(PTRACE_GETREGSET, &regset, &ioVec, buf_size);
 }
 
 Status NativeRegisterContextLinux_arm64::DoWriteGPR(void *buf,
@@ -963,8 +984,7 @@ Status NativeRegisterContextLinux_arm64::DoWriteGPR(void *buf,
 
   ioVec.iov_base = buf;
   ioVec.iov_len = buf_size;
-  return NativeProcessLinux::PtraceWrapper(PTRACE_SETREGSET, m_thread.GetID(),
-                                           &regset, &ioVec, buf_size);
+  return PtraceRegisters(PTRACE_SETREGSET, &regset, &ioVec, buf_size);
 }
 
 Status NativeRegisterContextLinux_arm64::DoReadFPR(void *buf, size_t buf_size) {
@@ -974,8 +994,7 @@ Status NativeRegisterContextLinux_arm64::DoReadFPR(void *buf, size_t buf_size) {
 
   ioVec.iov_base = buf;
   ioVec.iov_len = buf_size;
-  return NativeProcessLinux::PtraceWrapper(PTRACE_GETREGSET, m_thread.GetID(),
-                                           &regset, &ioVec, buf_size);
+  return PtraceRegisters(PTRACE_GETREGSET, &regset, &ioVec, buf_size);
 }
 
 Status NativeRegisterContextLinux_arm64::DoWriteFPR(void *buf,
@@ -986,8 +1005,7 @@ Status NativeRegisterContextLinux_arm64::DoWriteFPR(void *buf,
 
   ioVec.iov_base = buf;
   ioVec.iov_len = buf_size;
-  return NativeProcessLinux::PtraceWrapper(PTRACE_SETREGSET, m_thread.GetID(),
-                                           &regset, &ioVec, buf_size);
+  return PtraceRegisters(PTRACE_SETREGSET, &regset, &ioVec, buf_size);
 }
 
 uint32_t NativeRegisterContextLinux_arm64::CalculateFprOffset(
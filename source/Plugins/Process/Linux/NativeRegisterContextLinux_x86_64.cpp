@@ -331,6 +331,9 @@ NativeRegisterContextLinux_x86_64::NativeRegisterContextLinux_x86_64(
     break;
   }
 
+  // The GPR buffer and m_fpr hold the complete register sets.
+  m_cache_register_sets = true;
+
   // Initialize m_iovec to point to the buffer and buffer size
   // using the conventions of Berkeley style UIO structures, as required
   // by PTRACE extensions.
@@ -409,6 +412,18 @@ NativeRegisterContextLinux_x86_64::ReadRegister(const RegisterInfo *reg_info,
     error = ReadFPR();
     if (error.Fail())
       return error;
+  } else if (IsGPR(reg) &&
+             reg_info->byte_offset + reg_info->byte_size <= GetGPRSize()) {
+    // Extract it from the GPR set, which is fetched once per stop.
+    error = ReadGPR();
+    if (error.Fail())
+      return error;
+
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(&m_gpr_x86_64) +
+                         reg_info->byte_offset;
+    reg_value.SetFromMemoryData(reg_info, src, reg_info->byte_size,
+                                GetByteOrder(), error);
+    return error;
   } else {
     uint32_t full_reg = reg;
     bool is_subreg = reg_info->invalidate_regs &&
@@ -540,10 +555,29 @@ Status NativeRegisterContextLinux_x86_64::WriteRegister(
                                                ? reg_info->name
                                                : "<unknown register>");
 
-  if (IsGPR(reg_index))
-    return WriteRegisterRaw(reg_index, reg_value);
+  if (IsGPR(reg_index)) {
+    if (reg_info->byte_offset + reg_info->byte_size > GetGPRSize())
+      return WriteRegisterRaw(reg_index, reg_value);
+
+    // Update the cached GPR set, it is written back on resume.
+    Status error = ReadGPR();
+    if (error.Fail())
+      return error;
+
+    uint8_t *dst =
+        reinterpret_cast<uint8_t *>(&m_gpr_x86_64) + reg_info->byte_offset;
+    reg_value.GetAsMemoryData(reg_info, dst, reg_info->byte_size,
+                              GetByteOrder(), error);
+    if (error.Fail())
+      return error;
+    return WriteGPR();
+  }
 
   if (IsFPR(reg_index) || IsAVX(reg_index) || IsMPX(reg_index)) {
+    Status error = ReadFPR();
+    if (error.Fail())
+      return error;
+
     if (reg_info->encoding == lldb::eEncodingVector) {
       if (reg_index >= m_reg_info.first_st && reg_index <= m_reg_info.last_st)
         ::memcpy(
@@ -622,7 +656,7 @@ Status NativeRegisterContextLinux_x86_64::WriteRegister(
       }
     }
 
-    Status error = WriteFPR();
+    error = WriteFPR();
     if (error.Fail())
       return error;
 
@@ -843,7 +877,8 @@ bool NativeRegisterContextLinux_x86_64::IsFPR(uint32_t reg_index) const {
           reg_index <= m_reg_info.last_fpr);
 }
 
-Status NativeRegisterContextLinux_x86_64::WriteFPR() {
+Status NativeRegisterContextLinux_x86_64::DoWriteFPR(void *buf,
+                                                     size_t buf_size) {
   switch (m_xstate_type) {
   case XStateType::FXSAVE:
     return WriteRegisterSet(
@@ -941,6 +976,9 @@ size_t NativeRegisterContextLinux_x86_64::GetFPRSize() {
 }
 
 Status NativeRegisterContextLinux_x86_64::ReadFPR() {
+  if (m_fpr_is_cached)
+    return Status();
+
   Status error;
 
   // Probe XSAVE and if it is not supported fall back to FXSAVE.
@@ -949,6 +987,7 @@ Status NativeRegisterContextLinux_x86_64::ReadFPR() {
         ReadRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
     if (!error.Fail()) {
       m_xstate_type = XStateType::XSAVE;
+      m_fpr_is_cached = m_cache_register_sets;
       return error;
     }
   }
@@ -957,6 +996,7 @@ Status NativeRegisterContextLinux_x86_64::ReadFPR() {
       fxsr_regset(GetRegisterInfoInterface().GetTargetArchitecture()));
   if (!error.Fail()) {
     m_xstate_type = XStateType::FXSAVE;
+    m_fpr_is_cached = m_cache_register_sets;
     return error;
   }
   return Status("Unrecognized FPR type.");
@@ -74,7 +74,7 @@ protected:
 
   Status ReadFPR() override;
 
-  Status WriteFPR() override;
+  Status DoWriteFPR(void *buf, size_t buf_size) override;
 
 private:
   // Private member types.
@@ -156,6 +156,14 @@ NativeRegisterContextSP NativeThreadLinux::GetRegisterContext() {
   return m_reg_context_sp;
 }
 
+Status NativeThreadLinux::FlushRegisterSets() {
+  NativeRegisterContextSP reg_ctx_sp = GetRegisterContext();
+  if (!reg_ctx_sp)
+    return Status();
+  return std::static_pointer_cast<NativeRegisterContextLinux>(reg_ctx_sp)
+      ->FlushRegisterSets();
+}
+
 Status NativeThreadLinux::SetWatchpoint(lldb::addr_t addr, size_t size,
                                         uint32_t watch_flags, bool hardware) {
   if (!hardware)
@@ -225,12 +233,14 @@ Status NativeThreadLinux::Resume(uint32_t signo) {
   m_stop_info.reason = StopReason::eStopReasonNone;
   m_stop_description.clear();
 
+  NativeProcessLinux &process = GetProcess();
+
   // If watchpoints have been set, but none on this thread,
   // then this is a new thread. So set all existing watchpoints.
-  if (m_watchpoint_index_map.empty()) {
-    NativeProcessLinux &process = GetProcess();
-
-    const auto &watchpoint_map = process.GetWatchpointMap();
+  // Without any watchpoints there is nothing to do, which saves a few
+  // debug register accesses per thread on every resume.
+  const auto &watchpoint_map = process.GetWatchpointMap();
+  if (m_watchpoint_index_map.empty() && !watchpoint_map.empty()) {
     GetRegisterContext()->ClearAllHardwareWatchpoints();
     for (const auto &pair : watchpoint_map) {
       const auto &wp = pair.second;
@@ -239,10 +249,8 @@ Status NativeThreadLinux::Resume(uint32_t signo) {
   }
 
   // Set all active hardware breakpoint on all threads.
-  if (m_hw_break_index_map.empty()) {
-    NativeProcessLinux &process = GetProcess();
-
-    const auto &hw_breakpoint_map = process.GetHardwareBreakpointMap();
+  const auto &hw_breakpoint_map = process.GetHardwareBreakpointMap();
+  if (m_hw_break_index_map.empty() && !hw_breakpoint_map.empty()) {
     GetRegisterContext()->ClearAllHardwareBreakpoints();
     for (const auto &pair : hw_breakpoint_map) {
       const auto &bp = pair.second;
@@ -255,6 +263,10 @@ Status NativeThreadLinux::Resume(uint32_t signo) {
   if (signo != LLDB_INVALID_SIGNAL_NUMBER)
     data = signo;
 
+  Status error = FlushRegisterSets();
+  if (error.Fail())
+    return error;
+
   return NativeProcessLinux::PtraceWrapper(PTRACE_CONT, GetID(), nullptr,
                                            reinterpret_cast<void *>(data));
 }
@@ -276,6 +288,10 @@ Status NativeThreadLinux::SingleStep(uint32_t signo) {
   if (signo != LLDB_INVALID_SIGNAL_NUMBER)
     data = signo;
 
+  Status error = FlushRegisterSets();
+  if (error.Fail())
+    return error;
+
   // If hardware single-stepping is not supported, we just do a continue. The
   // breakpoint on the
   // next instruction has been setup in NativeProcessLinux::Resume.
@@ -432,6 +448,15 @@ Status NativeThreadLinux::RequestStop() {
                 ", tid: %" PRIu64 ")",
                 __FUNCTION__, pid, tid);
 
+  // PTRACE_INTERRUPT would avoid queueing a signal, but it only works on
+  // tracees attached with PTRACE_SEIZE. Launched inferiors are traced with
+  // PTRACE_TRACEME, and seizing changes how every other stop is reported:
+  // new threads and group-stops show up as PTRACE_EVENT_STOP rather than
+  // SIGSTOP, and a group-stop has to be resumed with PTRACE_LISTEN to keep
+  // the process job-control stopped. MonitorCallback() and MonitorSignal()
+  // tell our stops apart from the inferior's by the SIGSTOP, so switching
+  // only this request over would misreport stops. It also wouldn't be any
+  // cheaper: both cost one syscall and one waitpid event per thread.
   Status err;
   errno = 0;
   if (::tgkill(pid, tid, SIGSTOP) != 0) {
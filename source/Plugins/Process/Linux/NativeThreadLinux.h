@@ -89,6 +89,10 @@ private:
 
   Status RequestStop();
 
+  /// Writes back the registers modified while the thread was stopped and
+  /// drops the cached register values.
+  Status FlushRegisterSets();
+
   // ---------------------------------------------------------------------
   // Private interface
   // ---------------------------------------------------------------------
@@ -551,6 +551,7 @@ void RegisterContextLLDB::InitializeNonZerothFrame() {
 
   UnwindPlan::RowSP active_row;
   RegisterKind row_register_kind = eRegisterKindGeneric;
+  bool using_fast_unwind_plan = false;
 
   // Try to get by with just the fast UnwindPlan if possible - the full
   // UnwindPlan may be expensive to get
@@ -559,6 +560,7 @@ void RegisterContextLLDB::InitializeNonZerothFrame() {
 
   if (m_fast_unwind_plan_sp &&
       m_fast_unwind_plan_sp->PlanValidAtAddress(m_current_pc)) {
+    using_fast_unwind_plan = true;
     active_row =
         m_fast_unwind_plan_sp->GetRowForFunctionOffset(m_current_offset);
     row_register_kind = m_fast_unwind_plan_sp->GetRegisterKind();
@@ -608,12 +610,56 @@ void RegisterContextLLDB::InitializeNonZerothFrame() {
     }
   }
 
+  // A frame in the middle of the stack, at a call site which is neither the
+  // first instruction of the function nor one past its end.
+  if (m_frame_type == eNormalFrame &&
+      GetNextFrame()->m_frame_type == eNormalFrame && m_sym_ctx_valid &&
+      !decr_pc_and_recompute_addr_range && m_current_offset > 0) {
+    RecordResolvedUnwindPlan(using_fast_unwind_plan ? m_fast_unwind_plan_sp
+                                                    : m_full_unwind_plan_sp);
+  }
+
   UnwindLogMsg("initialized frame current pc is 0x%" PRIx64
                " cfa is 0x%" PRIx64,
                (uint64_t)m_current_pc.GetLoadAddress(exe_ctx.GetTargetPtr()),
                (uint64_t)m_cfa);
 }
 
+// Record the UnwindPlan this frame settled on in its FuncUnwinders, so that
+// UnwindLLDB can unwind through other call sites in the function without
+// going through GetFastUnwindPlanForFrame() and GetFullUnwindPlanForFrame()
+// again.  Only the first choice for such a frame is recorded -- the fast
+// UnwindPlan, else the call site UnwindPlan -- since that is the one picked
+// at any pc in the function where it is valid.
+
+void RegisterContextLLDB::RecordResolvedUnwindPlan(
+    const UnwindPlanSP &unwind_plan_sp) {
+  ModuleSP pc_module_sp(m_current_pc.GetModule());
+  if (!unwind_plan_sp || !pc_module_sp ||
+      pc_module_sp->GetObjectFile() == NULL)
+    return;
+
+  FuncUnwindersSP func_unwinders_sp(
+      pc_module_sp->GetObjectFile()
+          ->GetUnwindTable()
+          .GetFuncUnwindersContainingAddress(m_current_pc, m_sym_ctx));
+  if (!func_unwinders_sp ||
+      !(func_unwinders_sp->GetFunctionStartAddress() == m_start_pc))
+    return;
+
+  if (unwind_plan_sp != m_fast_unwind_plan_sp) {
+    ProcessSP process_sp(m_thread.GetProcess());
+    if (!process_sp ||
+        unwind_plan_sp != func_unwinders_sp->GetUnwindPlanAtCallSite(
+                              process_sp->GetTarget(),
+                              m_current_offset_backed_up_one))
+      return;
+  }
+
+  func_unwinders_sp->SetResolvedUnwindPlan(unwind_plan_sp,
+                                           GetSymbolOrFunctionName(m_sym_ctx));
+}
+
 bool RegisterContextLLDB::CheckIfLoopingStack() {
   // If we have a bad stack setup, we can get the same CFA value multiple times
   // -- or even
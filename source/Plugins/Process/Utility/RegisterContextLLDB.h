@@ -200,6 +200,8 @@ private:
 
   lldb::UnwindPlanSP GetFullUnwindPlanForFrame();
 
+  void RecordResolvedUnwindPlan(const lldb::UnwindPlanSP &unwind_plan_sp);
+
   void UnwindLogMsg(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
 
   void UnwindLogMsgVerbose(const char *fmt, ...)
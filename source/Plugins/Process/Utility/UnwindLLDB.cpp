@@ -10,10 +10,14 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
 #include "lldb/Target/ABI.h"
+#include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/RegisterNumber.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Utility/Log.h"
@@ -26,7 +30,8 @@ using namespace lldb_private;
 
 UnwindLLDB::UnwindLLDB(Thread &thread)
     : Unwind(thread), m_frames(), m_unwind_complete(false),
-      m_user_supplied_trap_handler_functions() {
+      m_user_supplied_trap_handler_functions(),
+      m_platform_trap_handler_functions(), m_fast_unwind_registers() {
   ProcessSP process_sp(thread.GetProcess());
   if (process_sp) {
     Args args;
@@ -36,6 +41,10 @@ UnwindLLDB::UnwindLLDB(Thread &thread)
       const char *func_name = args.GetArgumentAtIndex(i);
       m_user_supplied_trap_handler_functions.push_back(ConstString(func_name));
     }
+    PlatformSP platform_sp(process_sp->GetTarget().GetPlatform());
+    if (platform_sp)
+      m_platform_trap_handler_functions =
+          platform_sp->GetTrapHandlerSymbolNames();
   }
 }
 
@@ -126,10 +135,6 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
   CursorSP prev_frame = m_frames.back();
   uint32_t cur_idx = m_frames.size();
 
-  CursorSP cursor_sp(new Cursor());
-  RegisterContextLLDBSP reg_ctx_sp(new RegisterContextLLDB(
-      m_thread, prev_frame->reg_ctx_lldb_sp, cursor_sp->sctx, cur_idx, *this));
-
   // We want to detect an unwind that cycles erroneously and stop backtracing.
   // Don't want this maximum unwind limit to be too low -- if you have a
   // backtrace
@@ -150,11 +155,27 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
     return nullptr;
   }
 
+  CursorSP cursor_sp;
+  if (GetOneMoreFrameFast(abi, cursor_sp))
+    return cursor_sp;
+
+  if (!CreateRegisterContextForFrameNum(cur_idx - 1)) {
+    if (log)
+      log->Printf("%*sFrame %d could not create the RegisterContext of the "
+                  "frame below, stopping.",
+                  cur_idx < 100 ? cur_idx : 100, "", cur_idx);
+    return nullptr;
+  }
+
+  cursor_sp.reset(new Cursor());
+  RegisterContextLLDBSP reg_ctx_sp(new RegisterContextLLDB(
+      m_thread, prev_frame->reg_ctx_lldb_sp, cursor_sp->sctx, cur_idx, *this));
+
   if (reg_ctx_sp.get() == NULL) {
     // If the RegisterContextLLDB has a fallback UnwindPlan, it will switch to
     // that and return
     // true.  Subsequent calls to TryFallbackUnwindPlan() will return false.
-    if (prev_frame->reg_ctx_lldb_sp->TryFallbackUnwindPlan()) {
+    if (TryFallbackUnwindPlanForFrame(cur_idx - 1)) {
       // TryFallbackUnwindPlan for prev_frame succeeded and updated
       // reg_ctx_lldb_sp field of
       // prev_frame. However, cfa field of prev_frame still needs to be updated.
@@ -176,7 +197,7 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
     // See if the regctx below this on the stack has a fallback unwind plan it
     // can use.
     // Subsequent calls to TryFallbackUnwindPlan() will return false.
-    if (prev_frame->reg_ctx_lldb_sp->TryFallbackUnwindPlan()) {
+    if (TryFallbackUnwindPlanForFrame(cur_idx - 1)) {
       // TryFallbackUnwindPlan for prev_frame succeeded and updated
       // reg_ctx_lldb_sp field of
       // prev_frame. However, cfa field of prev_frame still needs to be updated.
@@ -197,7 +218,7 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
     // If the RegisterContextLLDB has a fallback UnwindPlan, it will switch to
     // that and return
     // true.  Subsequent calls to TryFallbackUnwindPlan() will return false.
-    if (prev_frame->reg_ctx_lldb_sp->TryFallbackUnwindPlan()) {
+    if (TryFallbackUnwindPlanForFrame(cur_idx - 1)) {
       // TryFallbackUnwindPlan for prev_frame succeeded and updated
       // reg_ctx_lldb_sp field of
       // prev_frame. However, cfa field of prev_frame still needs to be updated.
@@ -232,7 +253,7 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
       if (reg_ctx_sp->TryFallbackUnwindPlan() == false ||
           reg_ctx_sp->GetCFA(cursor_sp->cfa) == false ||
           abi->CallFrameAddressIsValid(cursor_sp->cfa) == false) {
-        if (prev_frame->reg_ctx_lldb_sp->TryFallbackUnwindPlan()) {
+        if (TryFallbackUnwindPlanForFrame(cur_idx - 1)) {
           // TryFallbackUnwindPlan for prev_frame succeeded and updated
           // reg_ctx_lldb_sp field of
           // prev_frame. However, cfa field of prev_frame still needs to be
@@ -261,7 +282,7 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
     // If the RegisterContextLLDB has a fallback UnwindPlan, it will switch to
     // that and return
     // true.  Subsequent calls to TryFallbackUnwindPlan() will return false.
-    if (prev_frame->reg_ctx_lldb_sp->TryFallbackUnwindPlan()) {
+    if (TryFallbackUnwindPlanForFrame(cur_idx - 1)) {
       // TryFallbackUnwindPlan for prev_frame succeeded and updated
       // reg_ctx_lldb_sp field of
       // prev_frame. However, cfa field of prev_frame still needs to be updated.
@@ -282,7 +303,7 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
     // If the RegisterContextLLDB has a fallback UnwindPlan, it will switch to
     // that and return
     // true.  Subsequent calls to TryFallbackUnwindPlan() will return false.
-    if (prev_frame->reg_ctx_lldb_sp->TryFallbackUnwindPlan()) {
+    if (TryFallbackUnwindPlanForFrame(cur_idx - 1)) {
       // TryFallbackUnwindPlan for prev_frame succeeded and updated
       // reg_ctx_lldb_sp field of
       // prev_frame. However, cfa field of prev_frame still needs to be updated.
@@ -371,8 +392,7 @@ bool UnwindLLDB::AddOneMoreFrame(ABI *abi) {
   // We can't go further from the frame returned by GetOneMore frame. Lets try
   // to get a
   // different frame with using the fallback unwind plan.
-  if (!m_frames[m_frames.size() - 2]
-           ->reg_ctx_lldb_sp->TryFallbackUnwindPlan()) {
+  if (!TryFallbackUnwindPlanForFrame(m_frames.size() - 2)) {
     // We don't have a valid fallback unwind plan. Accept the frame as it is.
     // This is a
     // valid situation when we are at the bottom of the stack.
@@ -464,10 +484,8 @@ UnwindLLDB::DoCreateRegisterContextForFrame(StackFrame *frame) {
   }
 
   const uint32_t num_frames = m_frames.size();
-  if (idx < num_frames) {
-    Cursor *frame_cursor = m_frames[idx].get();
-    reg_ctx_sp = frame_cursor->reg_ctx_lldb_sp;
-  }
+  if (idx < num_frames)
+    reg_ctx_sp = CreateRegisterContextForFrameNum(idx);
   return reg_ctx_sp;
 }
 
@@ -536,3 +554,315 @@ bool UnwindLLDB::SearchForSavedLocationForRegister(
   }
   return false;
 }
+
+bool UnwindLLDB::GetOneMoreFrameFast(ABI *abi, CursorSP &cursor_sp) {
+  cursor_sp.reset();
+
+  const uint32_t cur_idx = m_frames.size();
+  Cursor &prev_frame = *m_frames.back();
+  if (!prev_frame.row_sp && !SetUpFastUnwindFromRegisterContext(cur_idx - 1))
+    return false;
+
+  ProcessSP process_sp(m_thread.GetProcess());
+  const FastUnwindRegisters *regs =
+      GetFastUnwindRegisters(prev_frame.unwind_plan_sp->GetRegisterKind());
+  if (!process_sp || !regs)
+    return false;
+
+  // A RegisterContextLLDB gives up on the stack once the caller's pc can't
+  // be found, unless it can switch to a fallback UnwindPlan -- which it
+  // never does for an UnwindPlan from the compiler.
+  const bool sourced_from_compiler =
+      prev_frame.unwind_plan_sp->GetSourcedFromCompiler() == eLazyBoolYes;
+
+  // Where the previous frame saved its caller's pc.  Like a
+  // RegisterContextLLDB, look for the return address register (e.g. lr on
+  // arm) instead if a full UnwindPlan defines one.
+  uint32_t pc_reg_num = regs->pc;
+  if (sourced_from_compiler &&
+      prev_frame.unwind_plan_sp->GetReturnAddressRegister() !=
+          LLDB_INVALID_REGNUM)
+    pc_reg_num = prev_frame.unwind_plan_sp->GetReturnAddressRegister();
+  UnwindPlan::Row::RegisterLocation regloc;
+  if (!prev_frame.row_sp->GetRegisterInfo(pc_reg_num, regloc))
+    return false;
+  if (regloc.IsUndefined())
+    return sourced_from_compiler;
+  if (!regloc.IsAtCFAPlusOffset())
+    return false;
+
+  Status error;
+  addr_t pc = process_sp->ReadPointerFromMemory(
+      prev_frame.cfa + regloc.GetOffset(), error);
+  if (error.Fail())
+    return false;
+  if (abi)
+    pc = abi->FixCodeAddress(pc);
+  // A pc of 0 or 1 in the middle of the stack is the end of the stack walk.
+  if (pc == 0 || pc == 1)
+    return sourced_from_compiler;
+
+  CursorSP new_frame(new Cursor());
+  new_frame->start_pc = pc;
+  if (!ReadFastUnwindCallerRegister(prev_frame, abi, regs->sp,
+                                    LLDB_REGNUM_GENERIC_SP, prev_frame.sp,
+                                    new_frame->sp) ||
+      !ReadFastUnwindCallerRegister(prev_frame, abi, regs->fp,
+                                    LLDB_REGNUM_GENERIC_FP, prev_frame.fp,
+                                    new_frame->fp))
+    return false;
+
+  addr_t cfa;
+  if (!GetFastUnwindRow(*new_frame, cfa))
+    return false;
+  new_frame->cfa = cfa;
+
+  // Leave anything suspicious to the full unwinder, which knows how to try
+  // other UnwindPlans.
+  if (abi && (!abi->CallFrameAddressIsValid(cfa) ||
+              !abi->CodeAddressIsValid(pc)))
+    return false;
+  if (cfa == prev_frame.cfa ||
+      (cur_idx >= 2 && cfa == m_frames[cur_idx - 2]->cfa))
+    return false;
+
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_UNWIND));
+  if (log && log->GetVerbose())
+    log->Printf("%*sth%d/fr%u fast unwind pc = 0x%" PRIx64 " cfa = 0x%" PRIx64,
+                cur_idx < 100 ? cur_idx : 100, "", m_thread.GetIndexID(),
+                cur_idx, pc, cfa);
+
+  cursor_sp = new_frame;
+  return true;
+}
+
+bool UnwindLLDB::GetFastUnwindRow(Cursor &cursor, addr_t &cfa) {
+  ProcessSP process_sp(m_thread.GetProcess());
+  if (!process_sp)
+    return false;
+  Target &target = process_sp->GetTarget();
+
+  Address pc_addr;
+  if (!pc_addr.SetLoadAddress(cursor.start_pc, &target))
+    return false;
+  ModuleSP pc_module_sp(pc_addr.GetModule());
+  if (!pc_module_sp || pc_module_sp->GetObjectFile() == NULL)
+    return false;
+
+  FuncUnwindersSP func_unwinders_sp(
+      pc_module_sp->GetObjectFile()
+          ->GetUnwindTable()
+          .GetExistingFuncUnwindersContainingAddress(pc_addr));
+  if (!func_unwinders_sp)
+    return false;
+
+  ConstString function_name;
+  UnwindPlanSP unwind_plan_sp(
+      func_unwinders_sp->GetResolvedUnwindPlan(function_name));
+  if (!unwind_plan_sp || !unwind_plan_sp->PlanValidAtAddress(pc_addr) ||
+      IsTrapHandlerFunctionName(function_name))
+    return false;
+
+  // A RegisterContextLLDB backs up a pc at the start of a function by one
+  // and looks it up again; leave that to it.
+  const addr_t func_load_addr =
+      func_unwinders_sp->GetFunctionStartAddress().GetLoadAddress(&target);
+  if (func_load_addr == LLDB_INVALID_ADDRESS ||
+      cursor.start_pc <= func_load_addr)
+    return false;
+  UnwindPlan::RowSP row_sp(unwind_plan_sp->GetRowForFunctionOffset(
+      cursor.start_pc - func_load_addr));
+  if (!row_sp)
+    return false;
+
+  const FastUnwindRegisters *regs =
+      GetFastUnwindRegisters(unwind_plan_sp->GetRegisterKind());
+  if (!regs)
+    return false;
+  UnwindPlan::Row::CFAValue &cfa_value = row_sp->GetCFAValue();
+  if (!cfa_value.IsRegisterPlusOffset())
+    return false;
+  addr_t base;
+  if (cfa_value.GetRegisterNumber() == regs->sp)
+    base = cursor.sp;
+  else if (cfa_value.GetRegisterNumber() == regs->fp)
+    base = cursor.fp;
+  else
+    return false;
+  if (base == LLDB_INVALID_ADDRESS)
+    return false;
+
+  cfa = base + cfa_value.GetOffset();
+  cursor.unwind_plan_sp = unwind_plan_sp;
+  cursor.row_sp = row_sp;
+  return true;
+}
+
+bool UnwindLLDB::SetUpFastUnwindFromRegisterContext(uint32_t frame_num) {
+  if (frame_num == 0 || frame_num >= m_frames.size())
+    return false;
+
+  // Only a frame in the middle of the stack above a normal frame uses the
+  // resolved UnwindPlan of its function.
+  Cursor &cursor = *m_frames[frame_num];
+  RegisterContextLLDB *reg_ctx = cursor.reg_ctx_lldb_sp.get();
+  RegisterContextLLDB *next_reg_ctx =
+      m_frames[frame_num - 1]->reg_ctx_lldb_sp.get();
+  if (!reg_ctx || reg_ctx->m_frame_type != RegisterContextLLDB::eNormalFrame ||
+      (next_reg_ctx &&
+       next_reg_ctx->m_frame_type != RegisterContextLLDB::eNormalFrame))
+    return false;
+
+  cursor.sp = reg_ctx->GetSP();
+  cursor.fp = reg_ctx->GetFP();
+
+  // The frame must be using that UnwindPlan, not a fallback one, and agree
+  // on the CFA.
+  UnwindPlanSP active_unwind_plan_sp = reg_ctx->m_fast_unwind_plan_sp
+                                           ? reg_ctx->m_fast_unwind_plan_sp
+                                           : reg_ctx->m_full_unwind_plan_sp;
+  addr_t cfa;
+  if (!GetFastUnwindRow(cursor, cfa) ||
+      cursor.unwind_plan_sp != active_unwind_plan_sp || cfa != cursor.cfa) {
+    cursor.unwind_plan_sp.reset();
+    cursor.row_sp.reset();
+    return false;
+  }
+  return true;
+}
+
+// Find the caller's value of the sp or fp register from the row of frame,
+// the way RegisterContextLLDB::SavedLocationForRegister() would.  The value
+// may come out as LLDB_INVALID_ADDRESS if the register is volatile.
+
+bool UnwindLLDB::ReadFastUnwindCallerRegister(const Cursor &frame, ABI *abi,
+                                              uint32_t reg_num,
+                                              uint32_t generic_reg_num,
+                                              addr_t frame_value,
+                                              addr_t &value) {
+  UnwindPlan::Row::RegisterLocation regloc;
+  if (!frame.row_sp->GetRegisterInfo(reg_num, regloc)) {
+    // A RegisterContextLLDB which isn't using an UnwindPlan from the
+    // compiler would look for the register in the full UnwindPlan next.
+    if (frame.unwind_plan_sp->GetSourcedFromCompiler() != eLazyBoolYes)
+      return false;
+
+    RegisterContextSP reg_ctx_sp(m_thread.GetRegisterContext());
+    const RegisterInfo *reg_info =
+        reg_ctx_sp ? reg_ctx_sp->GetRegisterInfo(eRegisterKindGeneric,
+                                                 generic_reg_num)
+                   : nullptr;
+    if (!abi || !reg_info ||
+        !abi->GetFallbackRegisterLocation(reg_info, regloc)) {
+      // The register is preserved and this frame left it alone.
+      value = frame_value;
+      return true;
+    }
+  }
+
+  if (regloc.IsSame()) {
+    value = frame_value;
+    return true;
+  }
+  if (regloc.IsUndefined()) {
+    value = LLDB_INVALID_ADDRESS;
+    return true;
+  }
+  if (regloc.IsCFAPlusOffset()) {
+    value = frame.cfa + regloc.GetOffset();
+    return true;
+  }
+  if (regloc.IsAtCFAPlusOffset()) {
+    ProcessSP process_sp(m_thread.GetProcess());
+    if (!process_sp)
+      return false;
+    Status error;
+    value = process_sp->ReadPointerFromMemory(frame.cfa + regloc.GetOffset(),
+                                              error);
+    return error.Success();
+  }
+  return false;
+}
+
+const UnwindLLDB::FastUnwindRegisters *
+UnwindLLDB::GetFastUnwindRegisters(RegisterKind kind) {
+  auto pos = m_fast_unwind_registers.find(kind);
+  if (pos == m_fast_unwind_registers.end()) {
+    FastUnwindRegisters regs;
+    regs.pc = RegisterNumber(m_thread, eRegisterKindGeneric,
+                             LLDB_REGNUM_GENERIC_PC)
+                  .GetAsKind(kind);
+    regs.sp = RegisterNumber(m_thread, eRegisterKindGeneric,
+                             LLDB_REGNUM_GENERIC_SP)
+                  .GetAsKind(kind);
+    regs.fp = RegisterNumber(m_thread, eRegisterKindGeneric,
+                             LLDB_REGNUM_GENERIC_FP)
+                  .GetAsKind(kind);
+    pos = m_fast_unwind_registers.insert(std::make_pair(kind, regs)).first;
+  }
+  const FastUnwindRegisters &regs = pos->second;
+  if (regs.pc == LLDB_INVALID_REGNUM || regs.sp == LLDB_INVALID_REGNUM ||
+      regs.fp == LLDB_INVALID_REGNUM)
+    return nullptr;
+  return &regs;
+}
+
+bool UnwindLLDB::IsTrapHandlerFunctionName(ConstString name) const {
+  for (ConstString trap_handler : m_platform_trap_handler_functions)
+    if (name == trap_handler)
+      return true;
+  for (ConstString trap_handler : m_user_supplied_trap_handler_functions)
+    if (name == trap_handler)
+      return true;
+  return false;
+}
+
+UnwindLLDB::RegisterContextLLDBSP
+UnwindLLDB::CreateRegisterContextForFrameNum(uint32_t frame_num) {
+  if (frame_num >= m_frames.size())
+    return RegisterContextLLDBSP();
+
+  // Frame zero always has one.
+  uint32_t first_frame_num = frame_num;
+  while (first_frame_num > 0 && !m_frames[first_frame_num]->reg_ctx_lldb_sp)
+    --first_frame_num;
+
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_UNWIND));
+  for (uint32_t i = first_frame_num + 1; i <= frame_num; ++i) {
+    Cursor &cursor = *m_frames[i];
+    RegisterContextLLDBSP reg_ctx_sp(new RegisterContextLLDB(
+        m_thread, m_frames[i - 1]->reg_ctx_lldb_sp, cursor.sctx, i, *this));
+    if (!reg_ctx_sp->IsValid()) {
+      if (log)
+        log->Printf("th%d frame %u found by the fast unwinder has no valid "
+                    "RegisterContext",
+                    m_thread.GetIndexID(), i);
+      return RegisterContextLLDBSP();
+    }
+    addr_t cfa;
+    if (log && (!reg_ctx_sp->GetCFA(cfa) || cfa != cursor.cfa))
+      log->Printf("th%d frame %u found by the fast unwinder has cfa 0x%" PRIx64
+                  " but its RegisterContext disagrees",
+                  m_thread.GetIndexID(), i, cursor.cfa);
+    cursor.reg_ctx_lldb_sp = reg_ctx_sp;
+  }
+  return m_frames[frame_num]->reg_ctx_lldb_sp;
+}
+
+bool UnwindLLDB::TryFallbackUnwindPlanForFrame(uint32_t frame_num) {
+  // A frame the fast unwinder found with an UnwindPlan from the compiler has
+  // no fallback, so don't bother creating its RegisterContextLLDB.
+  Cursor &cursor = *m_frames[frame_num];
+  if (!cursor.reg_ctx_lldb_sp && cursor.unwind_plan_sp &&
+      cursor.unwind_plan_sp->GetSourcedFromCompiler() == eLazyBoolYes)
+    return false;
+
+  RegisterContextLLDBSP reg_ctx_sp(CreateRegisterContextForFrameNum(frame_num));
+  if (!reg_ctx_sp || !reg_ctx_sp->TryFallbackUnwindPlan())
+    return false;
+
+  // The frame no longer uses the row the fast unwinder knows about.
+  cursor.unwind_plan_sp.reset();
+  cursor.row_sp.reset();
+  return true;
+}
@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <map>
 #include <vector>
 
 // Other libraries and framework includes
@@ -121,11 +122,21 @@ private:
     lldb_private::SymbolContext sctx; // A symbol context we'll contribute to &
                                       // provide to the StackFrame creation
     RegisterContextLLDBSP
-        reg_ctx_lldb_sp; // These are all RegisterContextLLDB's
+        reg_ctx_lldb_sp; // These are all RegisterContextLLDB's; empty for a
+                         // frame found by the fast unwinder until needed
+
+    // For the fast unwinder: the UnwindPlan row this frame's CFA comes from,
+    // and the frame's sp and fp values.  row_sp is empty if the caller must
+    // be found with a RegisterContextLLDB.
+    lldb::UnwindPlanSP unwind_plan_sp;
+    UnwindPlan::RowSP row_sp;
+    lldb::addr_t sp;
+    lldb::addr_t fp;
 
     Cursor()
         : start_pc(LLDB_INVALID_ADDRESS), cfa(LLDB_INVALID_ADDRESS), sctx(),
-          reg_ctx_lldb_sp() {}
+          reg_ctx_lldb_sp(), unwind_plan_sp(), row_sp(),
+          sp(LLDB_INVALID_ADDRESS), fp(LLDB_INVALID_ADDRESS) {}
 
   private:
     DISALLOW_COPY_AND_ASSIGN(Cursor);
@@ -141,6 +152,16 @@ private:
   // is how far we've currently gone.
 
   std::vector<ConstString> m_user_supplied_trap_handler_functions;
+  std::vector<ConstString> m_platform_trap_handler_functions;
+
+  // The numbers of the registers the fast unwinder tracks in an UnwindPlan's
+  // register numbering scheme.
+  struct FastUnwindRegisters {
+    uint32_t pc;
+    uint32_t sp;
+    uint32_t fp;
+  };
+  std::map<lldb::RegisterKind, FastUnwindRegisters> m_fast_unwind_registers;
 
   //-----------------------------------------------------------------
   // Check if Full UnwindPlan of First frame is valid or not.
@@ -156,6 +177,45 @@ private:
 
   bool AddFirstFrame();
 
+  //-----------------------------------------------------------------
+  // The fast unwinder finds the caller of a frame in the middle of the
+  // stack without creating a RegisterContextLLDB.  It handles frames in
+  // functions whose UnwindPlan an earlier unwind already picked (see
+  // FuncUnwinders::GetResolvedUnwindPlan) and whose row gives the CFA as
+  // sp or fp plus an offset and saves the caller's pc and fp at offsets
+  // from the CFA.  The RegisterContextLLDBs of the frames it finds are
+  // created when they are asked for.
+  //
+  // Returns false if the full unwinder has to find the next frame, true
+  // otherwise with an empty cursor_sp if the stack ends here.
+  //-----------------------------------------------------------------
+  bool GetOneMoreFrameFast(ABI *abi, CursorSP &cursor_sp);
+
+  // Find the resolved UnwindPlan row for cursor's pc and the CFA it gives
+  // with cursor's sp and fp.
+  bool GetFastUnwindRow(Cursor &cursor, lldb::addr_t &cfa);
+
+  // Let the fast unwinder continue from a frame which has a
+  // RegisterContextLLDB.
+  bool SetUpFastUnwindFromRegisterContext(uint32_t frame_num);
+
+  // Find the caller's value of a register the fast unwinder tracks.
+  bool ReadFastUnwindCallerRegister(const Cursor &frame, ABI *abi,
+                                    uint32_t reg_num, uint32_t generic_reg_num,
+                                    lldb::addr_t frame_value,
+                                    lldb::addr_t &value);
+
+  const FastUnwindRegisters *GetFastUnwindRegisters(lldb::RegisterKind kind);
+
+  bool IsTrapHandlerFunctionName(ConstString name) const;
+
+  // Create the RegisterContextLLDBs of frame_num and the frames below it
+  // which the fast unwinder found.
+  RegisterContextLLDBSP CreateRegisterContextForFrameNum(uint32_t frame_num);
+
+  // RegisterContextLLDB::TryFallbackUnwindPlan() for frame_num.
+  bool TryFallbackUnwindPlanForFrame(uint32_t frame_num);
+
   //------------------------------------------------------------------
   // For UnwindLLDB only
   //------------------------------------------------------------------
@@ -17,6 +17,7 @@
 // C++ Includes
 // Other libraries and framework includes
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Host/Config.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/HostInfo.h"
@@ -50,6 +51,10 @@
 #include <zlib.h>
 #endif
 
+#if defined(HAVE_LIBLZ4)
+#include <lz4.h>
+#endif
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::process_gdb_remote;
@@ -139,7 +144,8 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
 #endif
       m_echo_number(0), m_supports_qEcho(eLazyBoolCalculate), m_history(512),
       m_send_acks(true), m_compression_type(CompressionType::None),
-      m_listen_url() {
+      m_send_compression_type(CompressionType::None),
+      m_send_compression_min_size(0), m_listen_url() {
 }
 
 //----------------------------------------------------------------------
@@ -191,6 +197,13 @@ size_t GDBRemoteCommunication::SendNack() {
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::SendPacketNoLock(llvm::StringRef payload) {
   if (IsConnected()) {
+    // The checksum covers the compressed form of the payload.
+    std::string compressed_payload;
+    if (m_send_compression_type != CompressionType::None) {
+      compressed_payload = CompressPayload(payload);
+      payload = compressed_payload;
+    }
+
     StreamString packet(0, 4, eByteOrderBig);
 
     packet.PutChar('$');
@@ -261,6 +274,44 @@ GDBRemoteCommunication::SendPacketNoLock(llvm::StringRef payload) {
   return PacketResult::ErrorSendFailed;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendNotificationPacketNoLock(
+    llvm::StringRef notify_type, llvm::StringRef payload) {
+  if (!IsConnected())
+    return PacketResult::ErrorSendFailed;
+
+  StreamString notification;
+  notification.Printf("%s:", notify_type.str().c_str());
+  notification.Write(payload.data(), payload.size());
+
+  StreamString packet(0, 4, eByteOrderBig);
+  packet.PutChar('%');
+  packet.PutCString(notification.GetString());
+  packet.PutChar('#');
+  packet.PutHex8(CalculcateChecksum(notification.GetString()));
+
+  Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS));
+  ConnectionStatus status = eConnectionStatusSuccess;
+  llvm::StringRef packet_str = packet.GetString();
+  size_t bytes_written =
+      Write(packet_str.data(), packet_str.size(), status, NULL);
+  if (log)
+    log->Printf("<%4" PRIu64 "> send notification: %.*s",
+                (uint64_t)bytes_written, (int)packet_str.size(),
+                packet_str.data());
+
+  m_history.AddPacket(packet_str, packet_str.size(), History::ePacketTypeSend,
+                      bytes_written);
+
+  if (bytes_written != packet_str.size()) {
+    if (log)
+      log->Printf("error: failed to send notification: %.*s",
+                  (int)packet_str.size(), packet_str.data());
+    return PacketResult::ErrorSendFailed;
+  }
+  return PacketResult::Success;
+}
+
 GDBRemoteCommunication::PacketResult GDBRemoteCommunication::GetAck() {
   StringExtractorGDBRemote packet;
   PacketResult result = ReadPacket(packet, GetPacketTimeout(), false);
@@ -465,6 +516,72 @@ GDBRemoteCommunication::WaitForPacketNoLock(StringExtractorGDBRemote &packet,
     return PacketResult::ErrorReplyFailed;
 }
 
+std::string GDBRemoteCommunication::CompressPayload(llvm::StringRef payload) {
+  std::string result;
+  if (payload.size() >= m_send_compression_min_size) {
+    std::vector<uint8_t> compressed;
+    size_t compressed_size = 0;
+    switch (m_send_compression_type) {
+#if defined(HAVE_LIBZ)
+    case CompressionType::ZlibDeflate: {
+      z_stream stream;
+      memset(&stream, 0, sizeof(z_stream));
+      if (deflateInit2(&stream, 5, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) !=
+          Z_OK)
+        break;
+      compressed.resize(deflateBound(&stream, payload.size()));
+      stream.next_in = (Bytef *)payload.data();
+      stream.avail_in = (uInt)payload.size();
+      stream.next_out = (Bytef *)compressed.data();
+      stream.avail_out = (uInt)compressed.size();
+      if (deflate(&stream, Z_FINISH) == Z_STREAM_END)
+        compressed_size = stream.total_out;
+      deflateEnd(&stream);
+      break;
+    }
+#endif
+#if defined(HAVE_LIBLZ4)
+    case CompressionType::LZ4: {
+      compressed.resize(LZ4_compressBound(payload.size()));
+      const int bytes = LZ4_compress_default(
+          payload.data(), (char *)compressed.data(), (int)payload.size(),
+          (int)compressed.size());
+      if (bytes > 0)
+        compressed_size = bytes;
+      break;
+    }
+#endif
+    default:
+      break;
+    }
+
+    // Payloads that don't shrink are cheaper to send as they are.
+    if (compressed_size > 0 && compressed_size < payload.size()) {
+      result.reserve(compressed_size + compressed_size / 8 + 24);
+      result.push_back('C');
+      result.append(std::to_string(payload.size()));
+      result.push_back(':');
+      // Apply the gdb-remote binary escaping so that the compressed bytes
+      // can't be mistaken for packet delimiters.
+      for (size_t i = 0; i < compressed_size; ++i) {
+        const uint8_t byte = compressed[i];
+        if (byte == '#' || byte == '$' || byte == '}' || byte == '*') {
+          result.push_back('}');
+          result.push_back(byte ^ 0x20);
+        } else {
+          result.push_back(byte);
+        }
+      }
+      return result;
+    }
+  }
+
+  result.reserve(payload.size() + 1);
+  result.push_back('N');
+  result.append(payload.data(), payload.size());
+  return result;
+}
+
 bool GDBRemoteCommunication::DecompressPacket() {
   Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS));
 
@@ -656,6 +773,18 @@ bool GDBRemoteCommunication::DecompressPacket() {
   }
 #endif
 
+#if defined(HAVE_LIBLZ4)
+  if (decompressed_bytes == 0 && decompressed_bufsize != ULONG_MAX &&
+      decompressed_buffer != nullptr &&
+      m_compression_type == CompressionType::LZ4) {
+    const int bytes = LZ4_decompress_safe(
+        (const char *)unescaped_content.data(), (char *)decompressed_buffer,
+        (int)unescaped_content.size(), (int)decompressed_bufsize);
+    if (bytes > 0)
+      decompressed_bytes = bytes;
+  }
+#endif
+
   if (decompressed_bytes == 0 || decompressed_buffer == nullptr) {
     if (decompressed_buffer)
       free(decompressed_buffer);
@@ -895,7 +1024,8 @@ GDBRemoteCommunication::CheckForPacket(const uint8_t *src, size_t src_len,
         assert(checksum_idx < m_bytes.size());
         if (::isxdigit(m_bytes[checksum_idx + 0]) ||
             ::isxdigit(m_bytes[checksum_idx + 1])) {
-          if (GetSendAcks()) {
+          // Notifications are never acknowledged.
+          if (GetSendAcks() && m_bytes[0] == '$') {
             const char *packet_checksum_cstr = &m_bytes[checksum_idx];
             char packet_checksum = strtol(packet_checksum_cstr, NULL, 16);
             char actual_checksum = CalculcateChecksum(packet_str);
@@ -226,9 +226,16 @@ protected:
                       // a single process
 
   CompressionType m_compression_type;
+  CompressionType m_send_compression_type;
+  size_t m_send_compression_min_size;
 
   PacketResult SendPacketNoLock(llvm::StringRef payload);
 
+  // Sends an asynchronous "%<notify_type>:<payload>" notification. These
+  // are neither compressed nor acknowledged.
+  PacketResult SendNotificationPacketNoLock(llvm::StringRef notify_type,
+                                            llvm::StringRef payload);
+
   PacketResult ReadPacket(StringExtractorGDBRemote &response,
                           Timeout<std::micro> timeout, bool sync_on_timeout);
 
@@ -255,6 +262,19 @@ protected:
   // on m_bytes.  The checksum was for the compressed packet.
   bool DecompressPacket();
 
+  // Compress the payloads of all packets sent from now on with \a type.
+  // Payloads smaller than \a min_size are sent uncompressed.  Only a debug
+  // stub compresses the packets it sends, lldb uses m_compression_type to
+  // decompress the packets it receives.
+  void SetSendCompression(CompressionType type, size_t min_size) {
+    m_send_compression_type = type;
+    m_send_compression_min_size = min_size;
+  }
+
+  // Returns the "N<payload>" or "C<size>:<compressed payload>" form of
+  // \a payload for the compression set with SetSendCompression().
+  std::string CompressPayload(llvm::StringRef payload);
+
   Status StartListenThread(const char *hostname = "127.0.0.1",
                            uint16_t port = 0);
 
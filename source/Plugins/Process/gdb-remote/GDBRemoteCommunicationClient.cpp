@@ -63,6 +63,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_supports_vCont_C(eLazyBoolCalculate),
       m_supports_vCont_s(eLazyBoolCalculate),
       m_supports_vCont_S(eLazyBoolCalculate),
+      m_supports_vCont_r(eLazyBoolCalculate),
       m_qHostInfo_is_valid(eLazyBoolCalculate),
       m_curr_pid_is_valid(eLazyBoolCalculate),
       m_qProcessInfo_is_valid(eLazyBoolCalculate),
@@ -75,12 +76,15 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_attach_or_wait_reply(eLazyBoolCalculate),
       m_prepare_for_reg_writing_reply(eLazyBoolCalculate),
       m_supports_p(eLazyBoolCalculate), m_supports_x(eLazyBoolCalculate),
+      m_supports_X(eLazyBoolCalculate),
       m_avoid_g_packets(eLazyBoolCalculate),
       m_supports_QSaveRegisterState(eLazyBoolCalculate),
       m_supports_qXfer_auxv_read(eLazyBoolCalculate),
       m_supports_qXfer_libraries_read(eLazyBoolCalculate),
       m_supports_qXfer_libraries_svr4_read(eLazyBoolCalculate),
       m_supports_qXfer_features_read(eLazyBoolCalculate),
+      m_supports_MultiMemRead(eLazyBoolCalculate),
+      m_supports_ConditionalBreakpoints(eLazyBoolCalculate),
       m_supports_augmented_libraries_svr4_read(eLazyBoolCalculate),
       m_supports_jThreadExtendedInfo(eLazyBoolCalculate),
       m_supports_jLoadedDynamicLibrariesInfos(eLazyBoolCalculate),
@@ -192,6 +196,20 @@ bool GDBRemoteCommunicationClient::GetQXferFeaturesReadSupported() {
   return m_supports_qXfer_features_read == eLazyBoolYes;
 }
 
+bool GDBRemoteCommunicationClient::GetMultiMemReadSupported() {
+  if (m_supports_MultiMemRead == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_MultiMemRead == eLazyBoolYes;
+}
+
+bool GDBRemoteCommunicationClient::GetConditionalBreakpointsSupported() {
+  if (m_supports_ConditionalBreakpoints == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_ConditionalBreakpoints == eLazyBoolYes;
+}
+
 uint64_t GDBRemoteCommunicationClient::GetRemoteMaxPacketSize() {
   if (m_max_packet_size == 0) {
     GetRemoteQSupported();
@@ -281,8 +299,10 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_supports_vCont_C = eLazyBoolCalculate;
     m_supports_vCont_s = eLazyBoolCalculate;
     m_supports_vCont_S = eLazyBoolCalculate;
+    m_supports_vCont_r = eLazyBoolCalculate;
     m_supports_p = eLazyBoolCalculate;
     m_supports_x = eLazyBoolCalculate;
+    m_supports_X = eLazyBoolCalculate;
     m_supports_QSaveRegisterState = eLazyBoolCalculate;
     m_qHostInfo_is_valid = eLazyBoolCalculate;
     m_curr_pid_is_valid = eLazyBoolCalculate;
@@ -296,6 +316,8 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_supports_qXfer_libraries_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
     m_supports_qXfer_features_read = eLazyBoolCalculate;
+    m_supports_MultiMemRead = eLazyBoolCalculate;
+    m_supports_ConditionalBreakpoints = eLazyBoolCalculate;
     m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
@@ -342,6 +364,8 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
   m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
   m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
   m_supports_qXfer_features_read = eLazyBoolNo;
+  m_supports_MultiMemRead = eLazyBoolNo;
+  m_supports_ConditionalBreakpoints = eLazyBoolNo;
   m_max_packet_size = UINT64_MAX; // It's supposed to always be there, but if
                                   // not, we assume no limit
 
@@ -377,47 +401,48 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
       m_supports_qXfer_libraries_read = eLazyBoolYes;
     if (::strstr(response_cstr, "qXfer:features:read+"))
       m_supports_qXfer_features_read = eLazyBoolYes;
+    if (::strstr(response_cstr, "MultiMemRead+"))
+      m_supports_MultiMemRead = eLazyBoolYes;
+    if (::strstr(response_cstr, "ConditionalBreakpoints+"))
+      m_supports_ConditionalBreakpoints = eLazyBoolYes;
 
     // Look for a list of compressions in the features list e.g.
     // qXfer:features:read+;PacketSize=20000;qEcho+;SupportedCompressions=zlib-deflate,lzma
-    const char *features_list = ::strstr(response_cstr, "qXfer:features:");
-    if (features_list) {
-      const char *compressions =
-          ::strstr(features_list, "SupportedCompressions=");
-      if (compressions) {
-        std::vector<std::string> supported_compressions;
-        compressions += sizeof("SupportedCompressions=") - 1;
-        const char *end_of_compressions = strchr(compressions, ';');
-        if (end_of_compressions == NULL) {
-          end_of_compressions = strchr(compressions, '\0');
+    const char *compressions =
+        ::strstr(response_cstr, "SupportedCompressions=");
+    if (compressions) {
+      std::vector<std::string> supported_compressions;
+      compressions += sizeof("SupportedCompressions=") - 1;
+      const char *end_of_compressions = strchr(compressions, ';');
+      if (end_of_compressions == NULL) {
+        end_of_compressions = strchr(compressions, '\0');
+      }
+      const char *current_compression = compressions;
+      while (current_compression < end_of_compressions) {
+        const char *next_compression_name = strchr(current_compression, ',');
+        const char *end_of_this_word = next_compression_name;
+        if (next_compression_name == NULL ||
+            end_of_compressions < next_compression_name) {
+          end_of_this_word = end_of_compressions;
         }
-        const char *current_compression = compressions;
-        while (current_compression < end_of_compressions) {
-          const char *next_compression_name = strchr(current_compression, ',');
-          const char *end_of_this_word = next_compression_name;
-          if (next_compression_name == NULL ||
-              end_of_compressions < next_compression_name) {
-            end_of_this_word = end_of_compressions;
-          }
 
-          if (end_of_this_word) {
-            if (end_of_this_word == current_compression) {
-              current_compression++;
-            } else {
-              std::string this_compression(
-                  current_compression, end_of_this_word - current_compression);
-              supported_compressions.push_back(this_compression);
-              current_compression = end_of_this_word + 1;
-            }
+        if (end_of_this_word) {
+          if (end_of_this_word == current_compression) {
+            current_compression++;
           } else {
-            supported_compressions.push_back(current_compression);
-            current_compression = end_of_compressions;
+            std::string this_compression(
+                current_compression, end_of_this_word - current_compression);
+            supported_compressions.push_back(this_compression);
+            current_compression = end_of_this_word + 1;
           }
+        } else {
+          supported_compressions.push_back(current_compression);
+          current_compression = end_of_compressions;
         }
+      }
 
-        if (supported_compressions.size() > 0) {
-          MaybeEnableCompression(supported_compressions);
-        }
+      if (supported_compressions.size() > 0) {
+        MaybeEnableCompression(supported_compressions);
       }
     }
 
@@ -469,6 +494,7 @@ bool GDBRemoteCommunicationClient::GetVContSupported(char flavor) {
     m_supports_vCont_C = eLazyBoolNo;
     m_supports_vCont_s = eLazyBoolNo;
     m_supports_vCont_S = eLazyBoolNo;
+    m_supports_vCont_r = eLazyBoolNo;
     if (SendPacketAndWaitForResponse("vCont?", response, false) ==
         PacketResult::Success) {
       const char *response_cstr = response.GetStringRef().c_str();
@@ -484,6 +510,9 @@ bool GDBRemoteCommunicationClient::GetVContSupported(char flavor) {
       if (::strstr(response_cstr, ";S"))
         m_supports_vCont_S = eLazyBoolYes;
 
+      if (::strstr(response_cstr, ";r"))
+        m_supports_vCont_r = eLazyBoolYes;
+
       if (m_supports_vCont_c == eLazyBoolYes &&
           m_supports_vCont_C == eLazyBoolYes &&
           m_supports_vCont_s == eLazyBoolYes &&
@@ -513,6 +542,8 @@ bool GDBRemoteCommunicationClient::GetVContSupported(char flavor) {
     return m_supports_vCont_s;
   case 'S':
     return m_supports_vCont_S;
+  case 'r':
+    return m_supports_vCont_r;
   default:
     break;
   }
@@ -656,6 +687,20 @@ bool GDBRemoteCommunicationClient::GetxPacketSupported() {
   return m_supports_x;
 }
 
+bool GDBRemoteCommunicationClient::GetXPacketSupported() {
+  if (m_supports_X == eLazyBoolCalculate) {
+    StringExtractorGDBRemote response;
+    m_supports_X = eLazyBoolNo;
+    // A zero-length write is how gdb probes for binary write support too.
+    if (SendPacketAndWaitForResponse("X0,0:", response, false) ==
+        PacketResult::Success) {
+      if (response.IsOKResponse())
+        m_supports_X = eLazyBoolYes;
+    }
+  }
+  return m_supports_X;
+}
+
 GDBRemoteCommunicationClient::PacketResult
 GDBRemoteCommunicationClient::SendPacketsAndConcatenateResponses(
     const char *payload_prefix, std::string &response_string) {
@@ -1078,6 +1123,18 @@ void GDBRemoteCommunicationClient::MaybeEnableCompression(
   }
 #endif
 
+#if defined(HAVE_LIBLZ4)
+  if (avail_type == CompressionType::None) {
+    for (auto compression : supported_compressions) {
+      if (compression == "lz4") {
+        avail_type = CompressionType::LZ4;
+        avail_name = compression;
+        break;
+      }
+    }
+  }
+#endif
+
 #if defined(HAVE_LIBCOMPRESSION)
   // libcompression is weak linked so test if compression_decode_buffer() is
   // available
@@ -2526,7 +2583,8 @@ bool GDBRemoteCommunicationClient::GetThreadStopInfo(
 }
 
 uint8_t GDBRemoteCommunicationClient::SendGDBStoppointTypePacket(
-    GDBStoppointType type, bool insert, addr_t addr, uint32_t length) {
+    GDBStoppointType type, bool insert, addr_t addr, uint32_t length,
+    llvm::ArrayRef<AgentExpression> conditions) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
   if (log)
     log->Printf("GDBRemoteCommunicationClient::%s() %s at addr = 0x%" PRIx64,
@@ -2536,19 +2594,24 @@ uint8_t GDBRemoteCommunicationClient::SendGDBStoppointTypePacket(
   if (!SupportsGDBStoppointPacket(type))
     return UINT8_MAX;
   // Construct the breakpoint packet
-  char packet[64];
-  const int packet_len =
-      ::snprintf(packet, sizeof(packet), "%c%i,%" PRIx64 ",%x",
-                 insert ? 'Z' : 'z', type, addr, length);
-  // Check we haven't overwritten the end of the packet buffer
-  assert(packet_len + 1 < (int)sizeof(packet));
-  UNUSED_IF_ASSERT_DISABLED(packet_len);
+  StreamString packet;
+  packet.Printf("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', type, addr,
+                length);
+  // The stub evaluates the conditions and only reports the hits where one of
+  // them is true.
+  if (insert && type == eBreakpointSoftware) {
+    for (const AgentExpression &condition : conditions) {
+      packet.Printf(";X%zx,", condition.GetBytecode().size());
+      packet.PutBytesAsRawHex8(condition.GetBytecode().data(),
+                               condition.GetBytecode().size());
+    }
+  }
   StringExtractorGDBRemote response;
   // Make sure the response is either "OK", "EXX" where XX are two hex digits,
   // or "" (unsupported)
   response.SetResponseValidatorToOKErrorNotSupported();
   // Try to send the breakpoint packet, and check that it was correctly sent
-  if (SendPacketAndWaitForResponse(packet, response, true) ==
+  if (SendPacketAndWaitForResponse(packet.GetString(), response, true) ==
       PacketResult::Success) {
     // Receive and OK packet when the breakpoint successfully placed
     if (response.IsOKResponse())
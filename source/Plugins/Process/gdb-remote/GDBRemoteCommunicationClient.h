@@ -24,6 +24,7 @@
 // Project includes
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Utility/AgentExpression.h"
 #include "lldb/Utility/StreamGDBRemote.h"
 #include "lldb/Utility/StructuredData.h"
 
@@ -253,10 +254,15 @@ public:
 
   bool GetVContSupported(char flavor);
 
+  // Forget the vCont actions, so the next GetVContSupported() asks again.
+  void ResetVContSupported() { m_supports_vCont_c = eLazyBoolCalculate; }
+
   bool GetpPacketSupported(lldb::tid_t tid);
 
   bool GetxPacketSupported();
 
+  bool GetXPacketSupported();
+
   bool GetVAttachOrWaitSupported();
 
   bool GetSyncThreadStateSupported();
@@ -319,7 +325,8 @@ public:
       GDBStoppointType type, // Type of breakpoint or watchpoint
       bool insert,           // Insert or remove?
       lldb::addr_t addr,     // Address of breakpoint or watchpoint
-      uint32_t length);      // Byte Size of breakpoint or watchpoint
+      uint32_t length,       // Byte Size of breakpoint or watchpoint
+      llvm::ArrayRef<AgentExpression> conditions = llvm::None); // Z0 only
 
   bool SetNonStopMode(const bool enable);
 
@@ -356,6 +363,10 @@ public:
 
   bool GetQXferFeaturesReadSupported();
 
+  bool GetMultiMemReadSupported();
+
+  bool GetConditionalBreakpointsSupported();
+
   LazyBool SupportsAllocDeallocMemory() // const
   {
     // Uncomment this to have lldb pretend the debug server doesn't respond to
@@ -527,6 +538,7 @@ protected:
   LazyBool m_supports_vCont_C;
   LazyBool m_supports_vCont_s;
   LazyBool m_supports_vCont_S;
+  LazyBool m_supports_vCont_r;
   LazyBool m_qHostInfo_is_valid;
   LazyBool m_curr_pid_is_valid;
   LazyBool m_qProcessInfo_is_valid;
@@ -540,12 +552,15 @@ protected:
   LazyBool m_prepare_for_reg_writing_reply;
   LazyBool m_supports_p;
   LazyBool m_supports_x;
+  LazyBool m_supports_X;
   LazyBool m_avoid_g_packets;
   LazyBool m_supports_QSaveRegisterState;
   LazyBool m_supports_qXfer_auxv_read;
   LazyBool m_supports_qXfer_libraries_read;
   LazyBool m_supports_qXfer_libraries_svr4_read;
   LazyBool m_supports_qXfer_features_read;
+  LazyBool m_supports_MultiMemRead;
+  LazyBool m_supports_ConditionalBreakpoints;
   LazyBool m_supports_augmented_libraries_svr4_read;
   LazyBool m_supports_jThreadExtendedInfo;
   LazyBool m_supports_jLoadedDynamicLibrariesInfos;
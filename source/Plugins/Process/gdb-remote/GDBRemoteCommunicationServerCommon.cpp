@@ -38,6 +38,9 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/StreamGDBRemote.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Triple.h"
 
 // Project includes
@@ -60,6 +63,23 @@ const static uint32_t g_default_packet_timeout_sec = 20; // seconds
 const static uint32_t g_default_packet_timeout_sec = 0; // not specified
 #endif
 
+// Replies shorter than this gain little from compression, see
+// "QEnableCompression" in docs/lldb-gdb-remote.txt.
+const static size_t g_default_compression_min_size = 384;
+
+// The algorithms this stub can compress its replies with, in the order of
+// preference.
+static llvm::SmallVector<llvm::StringRef, 2> GetSupportedCompressions() {
+  llvm::SmallVector<llvm::StringRef, 2> compressions;
+#if defined(HAVE_LIBZ)
+  compressions.push_back("zlib-deflate");
+#endif
+#if defined(HAVE_LIBLZ4)
+  compressions.push_back("lz4");
+#endif
+  return compressions;
+}
+
 //----------------------------------------------------------------------
 // GDBRemoteCommunicationServerCommon constructor
 //----------------------------------------------------------------------
@@ -98,6 +118,9 @@ GDBRemoteCommunicationServerCommon::GDBRemoteCommunicationServerCommon(
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qEcho,
       &GDBRemoteCommunicationServerCommon::Handle_qEcho);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+      &GDBRemoteCommunicationServerCommon::Handle_QEnableCompression);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qModuleInfo,
       &GDBRemoteCommunicationServerCommon::Handle_qModuleInfo);
@@ -830,18 +853,32 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported(
   StreamGDBRemote response;
 
   // Features common to lldb-platform and llgs.
-  uint32_t max_packet_size = 128 * 1024; // 128KBytes is a reasonable max packet
-                                         // size--debugger can always use less
-  response.Printf("PacketSize=%x", max_packet_size);
+  response.Printf("PacketSize=%x", g_max_packet_size);
 
   response.PutCString(";QStartNoAckMode+");
   response.PutCString(";QThreadSuffixSupported+");
   response.PutCString(";QListThreadsInStopReply+");
   response.PutCString(";qEcho+");
+  response.PutCString(";qXfer:features:read+");
+  response.PutCString(";MultiMemRead+");
 #if defined(__linux__) || defined(__NetBSD__)
   response.PutCString(";QPassSignals+");
   response.PutCString(";qXfer:auxv:read+");
 #endif
+#if defined(__linux__)
+  response.PutCString(";qXfer:libraries-svr4:read+");
+  response.PutCString(";QNonStop+");
+  response.PutCString(";ConditionalBreakpoints+");
+#endif
+
+  auto compressions = GetSupportedCompressions();
+  if (!compressions.empty()) {
+    response.PutCString(";SupportedCompressions=");
+    response.PutCString(
+        llvm::join(compressions.begin(), compressions.end(), ","));
+    response.Printf(";DefaultCompressionMinSize=%" PRIu64,
+                    (uint64_t)g_default_compression_min_size);
+  }
 
   return SendPacketNoLock(response.GetString());
 }
@@ -860,6 +897,38 @@ GDBRemoteCommunicationServerCommon::Handle_QListThreadsInStopReply(
   return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerCommon::Handle_QEnableCompression(
+    StringExtractorGDBRemote &packet) {
+  // QEnableCompression:type:zlib-deflate;minsize:512;
+  packet.SetFilePos(::strlen("QEnableCompression:"));
+
+  CompressionType type = CompressionType::None;
+  size_t min_size = g_default_compression_min_size;
+  llvm::StringRef key, value;
+  while (packet.GetNameColonValue(key, value)) {
+    if (key == "type") {
+      if (llvm::is_contained(GetSupportedCompressions(), value))
+        type = llvm::StringSwitch<CompressionType>(value)
+                   .Case("zlib-deflate", CompressionType::ZlibDeflate)
+                   .Case("lz4", CompressionType::LZ4)
+                   .Default(CompressionType::None);
+    } else if (key == "minsize") {
+      if (value.getAsInteger(10, min_size))
+        return SendIllFormedResponse(packet, "Invalid minsize.");
+    }
+  }
+
+  if (type == CompressionType::None)
+    return SendErrorResponse(0x1);
+
+  // The reply itself must not be compressed.
+  PacketResult result = SendOKResponse();
+  if (result == PacketResult::Success)
+    SetSendCompression(type, min_size);
+  return result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QSetDetachOnError(
     StringExtractorGDBRemote &packet) {
@@ -37,6 +37,10 @@ public:
   ~GDBRemoteCommunicationServerCommon() override;
 
 protected:
+  // The PacketSize that qSupported advertises. 128KBytes is a reasonable max
+  // packet size--debugger can always use less.
+  static const uint32_t g_max_packet_size = 128 * 1024;
+
   ProcessLaunchInfo m_process_launch_info;
   Status m_process_launch_error;
   ProcessInstanceInfoList m_proc_infos;
@@ -100,6 +104,8 @@ protected:
 
   PacketResult Handle_QListThreadsInStopReply(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_QEnableCompression(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_QSetDetachOnError(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_QStartNoAckMode(StringExtractorGDBRemote &packet);
@@ -43,6 +43,7 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/StreamString.h"
 #include "lldb/Utility/UriParser.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Support/ScopedPrinter.h"
 
@@ -101,6 +102,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                 &GDBRemoteCommunicationServerLLGS::Handle_M);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+      &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_p,
                                 &GDBRemoteCommunicationServerLLGS::Handle_p);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_P,
@@ -155,6 +159,12 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qXfer_auxv_read,
       &GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_qXfer_features_read,
+      &GDBRemoteCommunicationServerLLGS::Handle_qXfer_features_read);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_qXfer_libraries_svr4_read,
+      &GDBRemoteCommunicationServerLLGS::Handle_qXfer_libraries_svr4_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_s,
                                 &GDBRemoteCommunicationServerLLGS::Handle_s);
   RegisterMemberFunctionHandler(
@@ -172,6 +182,8 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_x,
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
+  RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_X,
+                                &GDBRemoteCommunicationServerLLGS::Handle_X);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_Z,
                                 &GDBRemoteCommunicationServerLLGS::Handle_Z);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_z,
@@ -179,6 +191,12 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_QPassSignals,
       &GDBRemoteCommunicationServerLLGS::Handle_QPassSignals);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_QNonStop,
+      &GDBRemoteCommunicationServerLLGS::Handle_QNonStop);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_vStopped,
+      &GDBRemoteCommunicationServerLLGS::Handle_vStopped);
 
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_jTraceStart,
@@ -254,6 +272,12 @@ Status GDBRemoteCommunicationServerLLGS::LaunchProcess() {
     m_debugged_process_up = std::move(*process_or);
   }
 
+  if (m_non_stop_mode) {
+    Status status = m_debugged_process_up->SetNonStopMode(true);
+    if (status.Fail())
+      return status;
+  }
+
   // Handle mirroring of inferior stdout/stderr over the gdb-remote protocol
   // as needed.
   // llgs local-process debugging may specify PTY paths, which will make these
@@ -324,6 +348,12 @@ Status GDBRemoteCommunicationServerLLGS::AttachToProcess(lldb::pid_t pid) {
   }
   m_debugged_process_up = std::move(*process_or);
 
+  if (m_non_stop_mode) {
+    Status status = m_debugged_process_up->SetNonStopMode(true);
+    if (status.Fail())
+      return status;
+  }
+
   // Setup stdout/stderr mapping from inferior.
   auto terminal_fd = m_debugged_process_up->GetTerminalFileDescriptor();
   if (terminal_fd >= 0) {
@@ -359,7 +389,7 @@ void GDBRemoteCommunicationServerLLGS::InitializeDelegate(
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendWResponse(
-    NativeProcessProtocol *process) {
+    NativeProcessProtocol *process, bool notification) {
   assert(process && "process cannot be NULL");
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
@@ -380,6 +410,8 @@ GDBRemoteCommunicationServerLLGS::SendWResponse(
 
   StreamGDBRemote response;
   response.Format("{0:g}", *wait_status);
+  if (notification)
+    return SendNotificationPacketNoLock("Stop", response.GetString());
   return SendPacketNoLock(response.GetString());
 }
 
@@ -429,30 +461,15 @@ static JSONObject::SP GetRegistersAsJSON(NativeThreadProtocol &thread) {
 
   JSONObject::SP register_object_sp = std::make_shared<JSONObject>();
 
-#ifdef LLDB_JTHREADSINFO_FULL_REGISTER_SET
   // Expedite all registers in the first register set (i.e. should be GPRs) that
-  // are not contained in other registers.
+  // are not contained in other registers, like the stop reply does, so the
+  // client doesn't have to read any of them back for a thread it unwinds.
   const RegisterSet *reg_set_p = reg_ctx_sp->GetRegisterSet(0);
   if (!reg_set_p)
     return nullptr;
   for (const uint32_t *reg_num_p = reg_set_p->registers;
        *reg_num_p != LLDB_INVALID_REGNUM; ++reg_num_p) {
     uint32_t reg_num = *reg_num_p;
-#else
-  // Expedite only a couple of registers until we figure out why sending
-  // registers is
-  // expensive.
-  static const uint32_t k_expedited_registers[] = {
-      LLDB_REGNUM_GENERIC_PC, LLDB_REGNUM_GENERIC_SP, LLDB_REGNUM_GENERIC_FP,
-      LLDB_REGNUM_GENERIC_RA, LLDB_INVALID_REGNUM};
-
-  for (const uint32_t *generic_reg_p = k_expedited_registers;
-       *generic_reg_p != LLDB_INVALID_REGNUM; ++generic_reg_p) {
-    uint32_t reg_num = reg_ctx_sp->ConvertRegisterKindToRegisterNumber(
-        eRegisterKindGeneric, *generic_reg_p);
-    if (reg_num == LLDB_INVALID_REGNUM)
-      continue; // Target does not support the given register.
-#endif
 
     const RegisterInfo *const reg_info_p =
         reg_ctx_sp->GetRegisterInfoAtIndex(reg_num);
@@ -491,6 +508,51 @@ static JSONObject::SP GetRegistersAsJSON(NativeThreadProtocol &thread) {
   return register_object_sp;
 }
 
+namespace {
+struct ExpeditedMemory {
+  lldb::addr_t addr;
+  std::vector<uint8_t> bytes;
+};
+} // namespace
+
+// Reads the memory at the stack and frame pointers of a stopped thread,
+// which the client is all but certain to read when it unwinds the thread.
+static std::vector<ExpeditedMemory>
+GetExpeditedMemory(NativeProcessProtocol &process, NativeThreadProtocol &thread,
+                   uint32_t window_size) {
+  std::vector<ExpeditedMemory> memory;
+  if (window_size == 0)
+    return memory;
+
+  NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext();
+  if (!reg_ctx_sp)
+    return memory;
+
+  const lldb::addr_t sp = reg_ctx_sp->GetSP();
+  const lldb::addr_t fp = reg_ctx_sp->GetFP();
+  for (lldb::addr_t addr : {sp, fp}) {
+    if (addr == 0 || addr == LLDB_INVALID_ADDRESS)
+      continue;
+    // The frame pointer is usually close enough to the stack pointer that
+    // one window covers both.
+    if (addr == fp && sp != LLDB_INVALID_ADDRESS && fp >= sp &&
+        fp + 2 * sizeof(lldb::addr_t) <= sp + window_size)
+      continue;
+
+    ExpeditedMemory window;
+    window.addr = addr;
+    window.bytes.resize(window_size);
+    size_t bytes_read = 0;
+    process.ReadMemoryWithoutTrap(addr, window.bytes.data(), window_size,
+                                  bytes_read);
+    if (bytes_read == 0)
+      continue;
+    window.bytes.resize(bytes_read);
+    memory.push_back(std::move(window));
+  }
+  return memory;
+}
+
 static const char *GetStopReasonString(StopReason stop_reason) {
   switch (stop_reason) {
   case eStopReasonTrace:
@@ -516,7 +578,8 @@ static const char *GetStopReasonString(StopReason stop_reason) {
 }
 
 static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
-                                        bool abridged) {
+                                        bool abridged,
+                                        uint32_t expedited_stack_size) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
 
   JSONArray::SP threads_array_sp = std::make_shared<JSONArray>();
@@ -529,6 +592,10 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
 
     lldb::tid_t tid = thread_sp->GetID();
 
+    // Threads keep running in non-stop mode.
+    if (StateIsRunningState(thread_sp->GetState()))
+      continue;
+
     // Grab the reason this thread stopped.
     struct ThreadStopInfo tid_stop_info;
     std::string description;
@@ -584,7 +651,22 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
       thread_obj_sp->SetObject("medata", medata_array_sp);
     }
 
-    // TODO: Expedite interesting regions of inferior memory
+    if (!abridged) {
+      JSONArray::SP memory_array_sp = std::make_shared<JSONArray>();
+      for (const ExpeditedMemory &window :
+           GetExpeditedMemory(process, *thread_sp, expedited_stack_size)) {
+        StreamString bytes;
+        bytes.PutBytesAsRawHex8(window.bytes.data(), window.bytes.size());
+        JSONObject::SP window_obj_sp = std::make_shared<JSONObject>();
+        window_obj_sp->SetObject("address",
+                                 std::make_shared<JSONNumber>(window.addr));
+        window_obj_sp->SetObject(
+            "bytes", std::make_shared<JSONString>(bytes.GetString()));
+        memory_array_sp->AppendObject(window_obj_sp);
+      }
+      if (memory_array_sp->GetNumElements() > 0)
+        thread_obj_sp->SetObject("memory", memory_array_sp);
+    }
   }
 
   return threads_array_sp;
@@ -592,7 +674,7 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
-    lldb::tid_t tid) {
+    lldb::tid_t tid, bool notification) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
 
   // Ensure we have a debugged process.
@@ -661,7 +743,9 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
   // and qsThreadInfo packets, but it also might take a lot of room in the
   // stop reply packet, so it must be enabled only on systems where there
   // are no limits on packet lengths.
-  if (m_list_threads_in_stop_reply) {
+  // In non-stop mode the other threads are running, so the client has to ask
+  // for the thread list and their state itself.
+  if (m_list_threads_in_stop_reply && !m_non_stop_mode) {
     response.PutCString("threads:");
 
     uint32_t thread_index = 0;
@@ -685,8 +769,10 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
     // the info it needs.
     if (thread_index > 0) {
       const bool threads_with_valid_stop_info_only = true;
-      JSONArray::SP threads_info_sp = GetJSONThreadsInfo(
-          *m_debugged_process_up, threads_with_valid_stop_info_only);
+      JSONArray::SP threads_info_sp =
+          GetJSONThreadsInfo(*m_debugged_process_up,
+                             threads_with_valid_stop_info_only,
+                             m_expedited_stack_size);
       if (threads_info_sp) {
         response.PutCString("jstopinfo:");
         StreamString unescaped_response;
@@ -787,6 +873,15 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
     }
   }
 
+  // Expedite the stack memory the client needs to unwind this thread, in the
+  // "memory:<addr>=<hex bytes>;" form the client adds to its memory cache.
+  for (const ExpeditedMemory &window : GetExpeditedMemory(
+           *m_debugged_process_up, *thread_sp, m_expedited_stack_size)) {
+    response.Printf("memory:0x%" PRIx64 "=", window.addr);
+    response.PutBytesAsRawHex8(window.bytes.data(), window.bytes.size());
+    response.PutChar(';');
+  }
+
   const char *reason_str = GetStopReasonString(tid_stop_info.reason);
   if (reason_str != nullptr) {
     response.Printf("reason:%s;", reason_str);
@@ -812,6 +907,8 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
     }
   }
 
+  if (notification)
+    return SendNotificationPacketNoLock("Stop", response.GetString());
   return SendPacketNoLock(response.GetString());
 }
 
@@ -823,7 +920,11 @@ void GDBRemoteCommunicationServerLLGS::HandleInferiorState_Exited(
   if (log)
     log->Printf("GDBRemoteCommunicationServerLLGS::%s called", __FUNCTION__);
 
-  PacketResult result = SendStopReasonForState(StateType::eStateExited);
+  m_stop_notification_queue.clear();
+
+  PacketResult result = m_non_stop_mode
+                            ? SendWResponse(process, true)
+                            : SendStopReasonForState(StateType::eStateExited);
   if (result != PacketResult::Success) {
     if (log)
       log->Printf("GDBRemoteCommunicationServerLLGS::%s failed to send stop "
@@ -879,7 +980,10 @@ void GDBRemoteCommunicationServerLLGS::ProcessStateChanged(
 
   switch (state) {
   case StateType::eStateRunning:
-    StartSTDIOForwarding();
+    // $O packets would be taken as the reply to whatever the client sends
+    // next while the process runs in non-stop mode.
+    if (!m_non_stop_mode)
+      StartSTDIOForwarding();
     break;
 
   case StateType::eStateStopped:
@@ -918,6 +1022,20 @@ void GDBRemoteCommunicationServerLLGS::DidExec(NativeProcessProtocol *process) {
   ClearProcessSpecificData();
 }
 
+void GDBRemoteCommunicationServerLLGS::ThreadStopped(
+    NativeProcessProtocol *process, lldb::tid_t tid) {
+  assert(process && "process cannot be NULL");
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+  LLDB_LOG(log, "pid {0} tid {1} stopped, {2} stops queued", process->GetID(),
+           tid, m_stop_notification_queue.size());
+
+  // Only one stop notification is outstanding at a time, the client asks
+  // for the rest with vStopped.
+  m_stop_notification_queue.push_back(tid);
+  if (m_stop_notification_queue.size() == 1)
+    SendStopReplyPacketForThread(tid, true);
+}
+
 void GDBRemoteCommunicationServerLLGS::DataAvailableCallback() {
   Log *log(GetLogIfAnyCategoriesSet(GDBR_LOG_COMM));
 
@@ -1459,6 +1577,10 @@ GDBRemoteCommunicationServerLLGS::Handle_C(StringExtractorGDBRemote &packet) {
     return SendErrorResponse(0x38);
   }
 
+  // In non-stop mode the stop is reported later with a notification.
+  if (m_non_stop_mode)
+    return SendOKResponse();
+
   // Don't send an "OK" packet; response is the stopped/exited message.
   return PacketResult::Success;
 }
@@ -1499,6 +1621,9 @@ GDBRemoteCommunicationServerLLGS::Handle_c(StringExtractorGDBRemote &packet) {
   }
 
   LLDB_LOG(log, "continued process {0}", m_debugged_process_up->GetID());
+  // In non-stop mode the stop is reported later with a notification.
+  if (m_non_stop_mode)
+    return SendOKResponse();
   // No response required from continue.
   return PacketResult::Success;
 }
@@ -1507,7 +1632,11 @@ GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_vCont_actions(
     StringExtractorGDBRemote &packet) {
   StreamString response;
-  response.Printf("vCont;c;C;s;S");
+  response.Printf("vCont;c;C;s;S;t");
+  // Without range stepping the client sets a breakpoint on the next branch
+  // itself, so only offer it when the process really does it.
+  if (m_debugged_process_up && m_debugged_process_up->SupportsRangeStepping())
+    response.PutCString(";r");
 
   return SendPacketNoLock(response.GetString());
 }
@@ -1558,6 +1687,8 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont(
     thread_action.tid = LLDB_INVALID_THREAD_ID;
     thread_action.state = eStateInvalid;
     thread_action.signal = 0;
+    thread_action.step_range_start = 0;
+    thread_action.step_range_end = 0;
 
     const char action = packet.GetChar();
     switch (action) {
@@ -1585,6 +1716,30 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont(
       thread_action.state = eStateStepping;
       break;
 
+    case 'r':
+      // Step while the PC stays in [start, end).
+      thread_action.step_range_start =
+          packet.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+      if (thread_action.step_range_start == LLDB_INVALID_ADDRESS ||
+          !packet.GetBytesLeft() || packet.GetChar() != ',')
+        return SendIllFormedResponse(
+            packet, "Could not parse range start in vCont packet r action");
+      thread_action.step_range_end =
+          packet.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+      if (thread_action.step_range_end == LLDB_INVALID_ADDRESS)
+        return SendIllFormedResponse(
+            packet, "Could not parse range end in vCont packet r action");
+      thread_action.state = eStateStepping;
+      break;
+
+    case 't':
+      // Stop, only running threads are affected in non-stop mode.
+      if (!m_non_stop_mode)
+        return SendIllFormedResponse(
+            packet, "vCont t action requires non-stop mode");
+      thread_action.state = eStateStopped;
+      break;
+
     default:
       return SendIllFormedResponse(packet, "Unsupported vCont action");
       break;
@@ -1612,6 +1767,9 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont(
   }
 
   LLDB_LOG(log, "continued process {0}", m_debugged_process_up->GetID());
+  // In non-stop mode the stop is reported later with a notification.
+  if (m_non_stop_mode)
+    return SendOKResponse();
   // No response required from vCont.
   return PacketResult::Success;
 }
@@ -1641,7 +1799,26 @@ GDBRemoteCommunicationServerLLGS::Handle_stop_reason(
   if (!m_debugged_process_up)
     return SendErrorResponse(02);
 
-  return SendStopReasonForState(m_debugged_process_up->GetState());
+  const StateType process_state = m_debugged_process_up->GetState();
+  if (m_non_stop_mode && (StateIsRunningState(process_state) ||
+                          StateIsStoppedState(process_state, true))) {
+    // Report every stopped thread, the first one now and the others in
+    // reply to vStopped.
+    m_stop_notification_queue.clear();
+    NativeThreadProtocolSP thread_sp;
+    for (uint32_t i = 0;
+         (thread_sp = m_debugged_process_up->GetThreadAtIndex(i)); ++i) {
+      if (StateIsStoppedState(thread_sp->GetState(), true))
+        m_stop_notification_queue.push_back(thread_sp->GetID());
+    }
+    if (m_stop_notification_queue.empty())
+      return SendOKResponse();
+
+    SetCurrentThreadID(m_stop_notification_queue.front());
+    return SendStopReplyPacketForThread(m_stop_notification_queue.front());
+  }
+
+  return SendStopReasonForState(process_state);
 }
 
 GDBRemoteCommunication::PacketResult
@@ -1683,6 +1860,184 @@ GDBRemoteCommunicationServerLLGS::SendStopReasonForState(
   return SendErrorResponse(0);
 }
 
+static llvm::StringRef GetEncodingNameOrEmpty(const RegisterInfo &reg_info) {
+  switch (reg_info.encoding) {
+  case eEncodingUint:
+    return "uint";
+  case eEncodingSint:
+    return "sint";
+  case eEncodingIEEE754:
+    return "ieee754";
+  case eEncodingVector:
+    return "vector";
+  default:
+    return "";
+  }
+}
+
+static llvm::StringRef GetFormatNameOrEmpty(const RegisterInfo &reg_info) {
+  switch (reg_info.format) {
+  case eFormatBinary:
+    return "binary";
+  case eFormatDecimal:
+    return "decimal";
+  case eFormatHex:
+    return "hex";
+  case eFormatFloat:
+    return "float";
+  case eFormatVectorOfSInt8:
+    return "vector-sint8";
+  case eFormatVectorOfUInt8:
+    return "vector-uint8";
+  case eFormatVectorOfSInt16:
+    return "vector-sint16";
+  case eFormatVectorOfUInt16:
+    return "vector-uint16";
+  case eFormatVectorOfSInt32:
+    return "vector-sint32";
+  case eFormatVectorOfUInt32:
+    return "vector-uint32";
+  case eFormatVectorOfFloat32:
+    return "vector-float32";
+  case eFormatVectorOfUInt64:
+    return "vector-uint64";
+  case eFormatVectorOfUInt128:
+    return "vector-uint128";
+  default:
+    return "";
+  };
+}
+
+static llvm::StringRef GetKindGenericOrEmpty(const RegisterInfo &reg_info) {
+  switch (reg_info.kinds[RegisterKind::eRegisterKindGeneric]) {
+  case LLDB_REGNUM_GENERIC_PC:
+    return "pc";
+  case LLDB_REGNUM_GENERIC_SP:
+    return "sp";
+  case LLDB_REGNUM_GENERIC_FP:
+    return "fp";
+  case LLDB_REGNUM_GENERIC_RA:
+    return "ra";
+  case LLDB_REGNUM_GENERIC_FLAGS:
+    return "flags";
+  case LLDB_REGNUM_GENERIC_ARG1:
+    return "arg1";
+  case LLDB_REGNUM_GENERIC_ARG2:
+    return "arg2";
+  case LLDB_REGNUM_GENERIC_ARG3:
+    return "arg3";
+  case LLDB_REGNUM_GENERIC_ARG4:
+    return "arg4";
+  case LLDB_REGNUM_GENERIC_ARG5:
+    return "arg5";
+  case LLDB_REGNUM_GENERIC_ARG6:
+    return "arg6";
+  case LLDB_REGNUM_GENERIC_ARG7:
+    return "arg7";
+  case LLDB_REGNUM_GENERIC_ARG8:
+    return "arg8";
+  default:
+    return "";
+  }
+}
+
+// Writes the LLDB_INVALID_REGNUM terminated list of register numbers as
+// comma separated hex (qRegisterInfo) or decimal (target.xml) numbers.
+static void CollectRegNums(const uint32_t *reg_num, Stream &response,
+                           bool usehex) {
+  for (int i = 0; *reg_num != LLDB_INVALID_REGNUM; ++reg_num, ++i) {
+    if (i > 0)
+      response.PutChar(',');
+    if (usehex)
+      response.Printf("%" PRIx32, *reg_num);
+    else
+      response.Printf("%" PRIu32, *reg_num);
+  }
+}
+
+// Describes all user registers of \a reg_context in the gdb target
+// description format, using the attributes ProcessGDBRemote understands in
+// addition to the standard ones so that nothing qRegisterInfo reports is
+// lost.
+static void BuildTargetXml(NativeRegisterContext &reg_context,
+                           const ArchSpec &arch, Stream &xml) {
+  xml.PutCString("<?xml version=\"1.0\"?>\n");
+  xml.PutCString("<target version=\"1.0\">\n");
+  if (arch.IsValid())
+    xml.Printf("<architecture>%s</architecture>\n",
+               arch.GetTriple().getArchName().str().c_str());
+  xml.PutCString("<feature>\n");
+
+  const uint32_t reg_count = reg_context.GetUserRegisterCount();
+  for (uint32_t reg_index = 0; reg_index < reg_count; ++reg_index) {
+    const RegisterInfo *reg_info =
+        reg_context.GetRegisterInfoAtIndex(reg_index);
+    if (!reg_info)
+      continue;
+
+    xml.Printf("<reg name=\"%s\" bitsize=\"%" PRIu32 "\" regnum=\"%" PRIu32
+               "\" offset=\"%" PRIu32 "\"",
+               reg_info->name, reg_info->byte_size * 8, reg_index,
+               reg_info->byte_offset);
+
+    if (reg_info->alt_name && reg_info->alt_name[0])
+      xml.Printf(" altname=\"%s\"", reg_info->alt_name);
+
+    llvm::StringRef encoding = GetEncodingNameOrEmpty(*reg_info);
+    if (!encoding.empty())
+      xml.Printf(" encoding=\"%s\"", encoding.str().c_str());
+
+    llvm::StringRef format = GetFormatNameOrEmpty(*reg_info);
+    if (!format.empty())
+      xml.Printf(" format=\"%s\"", format.str().c_str());
+
+    const char *const register_set_name =
+        reg_context.GetRegisterSetNameForRegisterAtIndex(reg_index);
+    if (register_set_name)
+      xml.Printf(" group=\"%s\"", register_set_name);
+
+    if (reg_info->kinds[RegisterKind::eRegisterKindEHFrame] !=
+        LLDB_INVALID_REGNUM)
+      xml.Printf(" ehframe_regnum=\"%" PRIu32 "\"",
+                 reg_info->kinds[RegisterKind::eRegisterKindEHFrame]);
+
+    if (reg_info->kinds[RegisterKind::eRegisterKindDWARF] !=
+        LLDB_INVALID_REGNUM)
+      xml.Printf(" dwarf_regnum=\"%" PRIu32 "\"",
+                 reg_info->kinds[RegisterKind::eRegisterKindDWARF]);
+
+    llvm::StringRef kind_generic = GetKindGenericOrEmpty(*reg_info);
+    if (!kind_generic.empty())
+      xml.Printf(" generic=\"%s\"", kind_generic.str().c_str());
+
+    if (reg_info->value_regs &&
+        reg_info->value_regs[0] != LLDB_INVALID_REGNUM) {
+      xml.PutCString(" value_regnums=\"");
+      CollectRegNums(reg_info->value_regs, xml, false);
+      xml.PutChar('"');
+    }
+
+    if (reg_info->invalidate_regs && reg_info->invalidate_regs[0]) {
+      xml.PutCString(" invalidate_regnums=\"");
+      CollectRegNums(reg_info->invalidate_regs, xml, false);
+      xml.PutChar('"');
+    }
+
+    if (reg_info->dynamic_size_dwarf_expr_bytes) {
+      const size_t dwarf_opcode_len = reg_info->dynamic_size_dwarf_len;
+      xml.PutCString(" dynamic_size_dwarf_expr_bytes=\"");
+      for (uint32_t i = 0; i < dwarf_opcode_len; ++i)
+        xml.PutHex8(reg_info->dynamic_size_dwarf_expr_bytes[i]);
+      xml.PutChar('"');
+    }
+
+    xml.PutCString("/>\n");
+  }
+
+  xml.PutCString("</feature>\n");
+  xml.PutCString("</target>\n");
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_qRegisterInfo(
     StringExtractorGDBRemote &packet) {
@@ -1734,66 +2089,19 @@ GDBRemoteCommunicationServerLLGS::Handle_qRegisterInfo(
   response.Printf("bitsize:%" PRIu32 ";offset:%" PRIu32 ";",
                   reg_info->byte_size * 8, reg_info->byte_offset);
 
-  switch (reg_info->encoding) {
-  case eEncodingUint:
-    response.PutCString("encoding:uint;");
-    break;
-  case eEncodingSint:
-    response.PutCString("encoding:sint;");
-    break;
-  case eEncodingIEEE754:
-    response.PutCString("encoding:ieee754;");
-    break;
-  case eEncodingVector:
-    response.PutCString("encoding:vector;");
-    break;
-  default:
-    break;
+  llvm::StringRef encoding = GetEncodingNameOrEmpty(*reg_info);
+  if (!encoding.empty()) {
+    response.PutCString("encoding:");
+    response.PutCString(encoding);
+    response.PutChar(';');
   }
 
-  switch (reg_info->format) {
-  case eFormatBinary:
-    response.PutCString("format:binary;");
-    break;
-  case eFormatDecimal:
-    response.PutCString("format:decimal;");
-    break;
-  case eFormatHex:
-    response.PutCString("format:hex;");
-    break;
-  case eFormatFloat:
-    response.PutCString("format:float;");
-    break;
-  case eFormatVectorOfSInt8:
-    response.PutCString("format:vector-sint8;");
-    break;
-  case eFormatVectorOfUInt8:
-    response.PutCString("format:vector-uint8;");
-    break;
-  case eFormatVectorOfSInt16:
-    response.PutCString("format:vector-sint16;");
-    break;
-  case eFormatVectorOfUInt16:
-    response.PutCString("format:vector-uint16;");
-    break;
-  case eFormatVectorOfSInt32:
-    response.PutCString("format:vector-sint32;");
-    break;
-  case eFormatVectorOfUInt32:
-    response.PutCString("format:vector-uint32;");
-    break;
-  case eFormatVectorOfFloat32:
-    response.PutCString("format:vector-float32;");
-    break;
-  case eFormatVectorOfUInt64:
-    response.PutCString("format:vector-uint64;");
-    break;
-  case eFormatVectorOfUInt128:
-    response.PutCString("format:vector-uint128;");
-    break;
-  default:
-    break;
-  };
+  llvm::StringRef format = GetFormatNameOrEmpty(*reg_info);
+  if (!format.empty()) {
+    response.PutCString("format:");
+    response.PutCString(format);
+    response.PutChar(';');
+  }
 
   const char *const register_set_name =
       reg_context_sp->GetRegisterSetNameForRegisterAtIndex(reg_index);
@@ -1812,71 +2120,22 @@ GDBRemoteCommunicationServerLLGS::Handle_qRegisterInfo(
     response.Printf("dwarf:%" PRIu32 ";",
                     reg_info->kinds[RegisterKind::eRegisterKindDWARF]);
 
-  switch (reg_info->kinds[RegisterKind::eRegisterKindGeneric]) {
-  case LLDB_REGNUM_GENERIC_PC:
-    response.PutCString("generic:pc;");
-    break;
-  case LLDB_REGNUM_GENERIC_SP:
-    response.PutCString("generic:sp;");
-    break;
-  case LLDB_REGNUM_GENERIC_FP:
-    response.PutCString("generic:fp;");
-    break;
-  case LLDB_REGNUM_GENERIC_RA:
-    response.PutCString("generic:ra;");
-    break;
-  case LLDB_REGNUM_GENERIC_FLAGS:
-    response.PutCString("generic:flags;");
-    break;
-  case LLDB_REGNUM_GENERIC_ARG1:
-    response.PutCString("generic:arg1;");
-    break;
-  case LLDB_REGNUM_GENERIC_ARG2:
-    response.PutCString("generic:arg2;");
-    break;
-  case LLDB_REGNUM_GENERIC_ARG3:
-    response.PutCString("generic:arg3;");
-    break;
-  case LLDB_REGNUM_GENERIC_ARG4:
-    response.PutCString("generic:arg4;");
-    break;
-  case LLDB_REGNUM_GENERIC_ARG5:
-    response.PutCString("generic:arg5;");
-    break;
-  case LLDB_REGNUM_GENERIC_ARG6:
-    response.PutCString("generic:arg6;");
-    break;
-  case LLDB_REGNUM_GENERIC_ARG7:
-    response.PutCString("generic:arg7;");
-    break;
-  case LLDB_REGNUM_GENERIC_ARG8:
-    response.PutCString("generic:arg8;");
-    break;
-  default:
-    break;
+  llvm::StringRef kind_generic = GetKindGenericOrEmpty(*reg_info);
+  if (!kind_generic.empty()) {
+    response.PutCString("generic:");
+    response.PutCString(kind_generic);
+    response.PutChar(';');
   }
 
   if (reg_info->value_regs && reg_info->value_regs[0] != LLDB_INVALID_REGNUM) {
     response.PutCString("container-regs:");
-    int i = 0;
-    for (const uint32_t *reg_num = reg_info->value_regs;
-         *reg_num != LLDB_INVALID_REGNUM; ++reg_num, ++i) {
-      if (i > 0)
-        response.PutChar(',');
-      response.Printf("%" PRIx32, *reg_num);
-    }
+    CollectRegNums(reg_info->value_regs, response, true);
     response.PutChar(';');
   }
 
   if (reg_info->invalidate_regs && reg_info->invalidate_regs[0]) {
     response.PutCString("invalidate-regs:");
-    int i = 0;
-    for (const uint32_t *reg_num = reg_info->invalidate_regs;
-         *reg_num != LLDB_INVALID_REGNUM; ++reg_num, ++i) {
-      if (i > 0)
-        response.PutChar(',');
-      response.Printf("%" PRIx32, *reg_num);
-    }
+    CollectRegNums(reg_info->invalidate_regs, response, true);
     response.PutChar(';');
   }
 
@@ -2429,6 +2688,133 @@ GDBRemoteCommunicationServerLLGS::Handle_M(StringExtractorGDBRemote &packet) {
   return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_X(StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOG(log, "failed, no process available");
+    return SendErrorResponse(0x15);
+  }
+
+  // X<addr>,<length>:<binary data>
+  packet.SetFilePos(strlen("X"));
+  if (packet.GetBytesLeft() < 1)
+    return SendIllFormedResponse(packet, "Too short X packet");
+
+  const lldb::addr_t write_addr = packet.GetHexMaxU64(false, 0);
+
+  if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ','))
+    return SendIllFormedResponse(packet, "Comma sep missing in X packet");
+
+  if (packet.GetBytesLeft() < 1)
+    return SendIllFormedResponse(packet, "Length missing in X packet");
+
+  const uint64_t byte_count = packet.GetHexMaxU64(false, 0);
+
+  if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ':'))
+    return SendIllFormedResponse(
+        packet, "Colon sep missing in X packet after byte length");
+
+  // Clients probe for X support with a zero-length write.
+  if (byte_count == 0)
+    return SendOKResponse();
+
+  // The communication layer has already removed the binary escaping, so the
+  // rest of the packet is the data itself.
+  if (packet.GetBytesLeft() != byte_count) {
+    LLDB_LOG(log,
+             "pid {0} mem {1:x}: asked to write {2} bytes, but found {3}.",
+             m_debugged_process_up->GetID(), write_addr, byte_count,
+             packet.GetBytesLeft());
+    return SendIllFormedResponse(packet, "X content byte length specified did "
+                                         "not match the content length");
+  }
+
+  size_t bytes_written = 0;
+  Status error = m_debugged_process_up->WriteMemory(
+      write_addr, packet.Peek(), byte_count, bytes_written);
+  if (error.Fail()) {
+    LLDB_LOG(log, "pid {0} mem {1:x}: failed to write. Error: {2}",
+             m_debugged_process_up->GetID(), write_addr, error);
+    return SendErrorResponse(0x09);
+  }
+
+  if (bytes_written == 0) {
+    LLDB_LOG(log, "pid {0} mem {1:x}: wrote 0 of {2} requested bytes",
+             m_debugged_process_up->GetID(), write_addr, byte_count);
+    return SendErrorResponse(0x09);
+  }
+
+  return SendOKResponse();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead(
+    StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOG(log, "failed, no process available");
+    return SendErrorResponse(0x15);
+  }
+
+  // MultiMemRead:ranges:<addr>,<length>[,<addr>,<length>]*;
+  llvm::StringRef ranges_str = llvm::StringRef(packet.GetStringRef())
+                                   .drop_front(strlen("MultiMemRead:"));
+  if (!ranges_str.consume_front("ranges:") || !ranges_str.consume_back(";"))
+    return SendIllFormedResponse(packet, "MultiMemRead packet missing ranges");
+
+  llvm::SmallVector<llvm::StringRef, 32> fields;
+  ranges_str.split(fields, ',');
+  if (fields.size() % 2 != 0)
+    return SendIllFormedResponse(packet,
+                                 "MultiMemRead range missing its length");
+
+  std::vector<std::pair<lldb::addr_t, uint64_t>> ranges;
+  uint64_t total_size = 0;
+  for (size_t i = 0; i < fields.size(); i += 2) {
+    lldb::addr_t addr;
+    uint64_t size;
+    if (fields[i].getAsInteger(16, addr) ||
+        fields[i + 1].getAsInteger(16, size))
+      return SendIllFormedResponse(packet, "MultiMemRead malformed range");
+    // The client never asks for more than fits in one packet, so don't
+    // allocate room for more than that, nor let the sum wrap around.
+    if (size > g_max_packet_size - total_size) {
+      LLDB_LOG(log, "MultiMemRead ranges exceed the maximum packet size");
+      return SendErrorResponse(0x78);
+    }
+    total_size += size;
+    ranges.emplace_back(addr, size);
+  }
+
+  // Read every range back to back, then reply with the number of bytes read
+  // from each range followed by all of the data. A range that can't be read
+  // in full just contributes fewer bytes, it doesn't fail the packet.
+  std::string data(total_size, '\0');
+  StreamGDBRemote response;
+  size_t data_size = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    size_t bytes_read = 0;
+    if (ranges[i].second > 0) {
+      Status error = m_debugged_process_up->ReadMemoryWithoutTrap(
+          ranges[i].first, &data[data_size], ranges[i].second, bytes_read);
+      if (error.Fail())
+        LLDB_LOG(log, "pid {0} mem {1:x}: failed to read. Error: {2}",
+                 m_debugged_process_up->GetID(), ranges[i].first, error);
+    }
+    response.Printf("%s%" PRIx64, i == 0 ? "" : ",", (uint64_t)bytes_read);
+    data_size += bytes_read;
+  }
+  response.PutChar(';');
+  response.PutEscapedBytes(data.data(), data_size);
+
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfoSupported(
     StringExtractorGDBRemote &packet) {
@@ -2604,10 +2990,33 @@ GDBRemoteCommunicationServerLLGS::Handle_Z(StringExtractorGDBRemote &packet) {
     return SendIllFormedResponse(
         packet, "Malformed Z packet, failed to parse size argument");
 
+  // Parse out the breakpoint conditions, each one an agent expression in
+  // the form ";X<length>,<bytecode>".
+  std::vector<AgentExpression> conditions;
+  while (packet.GetBytesLeft() > 0) {
+    if (packet.GetChar() != ';' || packet.GetChar() != 'X' || !want_breakpoint)
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, expecting breakpoint conditions");
+    const uint32_t length = packet.GetHexMaxU32(false, 0);
+    if (length == 0 || packet.GetChar() != ',')
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, failed to parse condition length");
+    std::vector<uint8_t> bytecode(length);
+    if (packet.GetHexBytes(bytecode, 0) != length)
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, failed to parse condition bytecode");
+    conditions.emplace_back(bytecode);
+  }
+
   if (want_breakpoint) {
     // Try to set the breakpoint.
-    const Status error =
+    Status error =
         m_debugged_process_up->SetBreakpoint(addr, size, want_hardware);
+    // The conditions replace the ones the breakpoint had. Hardware
+    // breakpoints ignore them and report every hit.
+    if (error.Success() && !want_hardware)
+      error = m_debugged_process_up->SetBreakpointConditions(
+          addr, std::move(conditions));
     if (error.Success())
       return SendOKResponse();
     Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
@@ -2750,8 +3159,10 @@ GDBRemoteCommunicationServerLLGS::Handle_s(StringExtractorGDBRemote &packet) {
   ResumeActionList actions;
   actions.Append(action);
 
-  // All other threads stop while we're single stepping a thread.
-  actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
+  // All other threads stop while we're single stepping a thread, unless
+  // they are running on their own in non-stop mode.
+  if (!m_non_stop_mode)
+    actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
   Status error = m_debugged_process_up->Resume(actions);
   if (error.Fail()) {
     if (log)
@@ -2762,6 +3173,10 @@ GDBRemoteCommunicationServerLLGS::Handle_s(StringExtractorGDBRemote &packet) {
     return SendErrorResponse(0x49);
   }
 
+  // In non-stop mode the stop is reported later with a notification.
+  if (m_non_stop_mode)
+    return SendOKResponse();
+
   // No response here - the stop or exit will come from the resulting action.
   return PacketResult::Success;
 }
@@ -2856,6 +3271,162 @@ GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read(
 #endif
 }
 
+// Appends the part of a qXfer document that starts at \a offset, prefixed
+// with 'l' if it is the last one or 'm' if more follows.
+static void PutXferChunk(llvm::StringRef buffer, uint64_t offset,
+                         uint64_t length, StreamGDBRemote &response) {
+  if (offset >= buffer.size()) {
+    response.PutChar('l');
+    return;
+  }
+  buffer = buffer.drop_front(offset);
+  if (length >= buffer.size()) {
+    response.PutChar('l');
+  } else {
+    response.PutChar('m');
+    buffer = buffer.take_front(length);
+  }
+  response.PutEscapedBytes(buffer.data(), buffer.size());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qXfer_features_read(
+    StringExtractorGDBRemote &packet) {
+  // qXfer:features:read:<annex>:<offset>,<length>
+  llvm::StringRef annex, range;
+  std::tie(annex, range) = llvm::StringRef(packet.GetStringRef())
+                               .drop_front(strlen("qXfer:features:read:"))
+                               .split(':');
+  if (range.empty())
+    return SendIllFormedResponse(
+        packet, "qXfer:features:read: packet missing offset");
+  packet.SetFilePos(packet.GetStringRef().size() - range.size());
+
+  // Only the target description itself is served, it includes no other
+  // documents.
+  if (annex != "target.xml")
+    return SendErrorResponse(0x00);
+
+  const uint64_t xfer_offset =
+      packet.GetHexMaxU64(false, std::numeric_limits<uint64_t>::max());
+  if (xfer_offset == std::numeric_limits<uint64_t>::max())
+    return SendIllFormedResponse(
+        packet, "qXfer:features:read: packet missing offset");
+
+  if (packet.GetBytesLeft() < 1 || packet.GetChar() != ',')
+    return SendIllFormedResponse(
+        packet, "qXfer:features:read: packet missing comma after offset");
+
+  const uint64_t xfer_length =
+      packet.GetHexMaxU64(false, std::numeric_limits<uint64_t>::max());
+  if (xfer_length == std::numeric_limits<uint64_t>::max())
+    return SendIllFormedResponse(
+        packet, "qXfer:features:read: packet missing length");
+
+  // Fail if we don't have a current process.
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID))
+    return SendErrorResponse(68);
+
+  // All threads share the register layout of the first one.
+  NativeThreadProtocolSP thread_sp(m_debugged_process_up->GetThreadAtIndex(0));
+  if (!thread_sp)
+    return SendErrorResponse(69);
+
+  NativeRegisterContextSP reg_context_sp(thread_sp->GetRegisterContext());
+  if (!reg_context_sp)
+    return SendErrorResponse(69);
+
+  // The description is cheap to build compared to a round trip, so it is
+  // rebuilt for every chunk rather than cached across requests.
+  ArchSpec arch;
+  m_debugged_process_up->GetArchitecture(arch);
+  StreamString target_xml;
+  BuildTargetXml(*reg_context_sp, arch, target_xml);
+
+  StreamGDBRemote response;
+  PutXferChunk(target_xml.GetString(), xfer_offset, xfer_length, response);
+  return SendPacketNoLock(response.GetString());
+}
+
+// Escapes the characters that may not appear verbatim in an XML attribute
+// value.
+static void PutXmlAttributeValue(llvm::StringRef value, Stream &response) {
+  for (char c : value) {
+    switch (c) {
+    case '&':
+      response.PutCString("&amp;");
+      break;
+    case '<':
+      response.PutCString("&lt;");
+      break;
+    case '>':
+      response.PutCString("&gt;");
+      break;
+    case '"':
+      response.PutCString("&quot;");
+      break;
+    default:
+      response.PutChar(c);
+      break;
+    }
+  }
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qXfer_libraries_svr4_read(
+    StringExtractorGDBRemote &packet) {
+  // qXfer:libraries-svr4:read::<offset>,<length>
+  packet.SetFilePos(strlen("qXfer:libraries-svr4:read::"));
+  const uint64_t xfer_offset =
+      packet.GetHexMaxU64(false, std::numeric_limits<uint64_t>::max());
+  if (xfer_offset == std::numeric_limits<uint64_t>::max())
+    return SendIllFormedResponse(
+        packet, "qXfer:libraries-svr4:read:: packet missing offset");
+
+  if (packet.GetBytesLeft() < 1 || packet.GetChar() != ',')
+    return SendIllFormedResponse(
+        packet,
+        "qXfer:libraries-svr4:read:: packet missing comma after offset");
+
+  const uint64_t xfer_length =
+      packet.GetHexMaxU64(false, std::numeric_limits<uint64_t>::max());
+  if (xfer_length == std::numeric_limits<uint64_t>::max())
+    return SendIllFormedResponse(
+        packet, "qXfer:libraries-svr4:read:: packet missing length");
+
+  // Fail if we don't have a current process.
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID))
+    return SendErrorResponse(68);
+
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+  auto libraries_or_error = m_debugged_process_up->GetLoadedSVR4Libraries();
+  if (!libraries_or_error) {
+    Status error(libraries_or_error.takeError());
+    LLDB_LOG(log, "failed to read the link_map list: {0}", error);
+    return SendErrorResponse(error);
+  }
+
+  // The list deliberately carries no main-lm attribute: the client would take
+  // it for the address of the r_debug structure when the rendezvous address
+  // isn't otherwise known.
+  StreamString library_list;
+  library_list.PutCString("<library-list-svr4 version=\"1.0\">");
+  for (const auto &library : *libraries_or_error) {
+    library_list.PutCString("<library name=\"");
+    PutXmlAttributeValue(library.name, library_list);
+    library_list.Printf("\" lm=\"0x%" PRIx64 "\" l_addr=\"0x%" PRIx64
+                        "\" l_ld=\"0x%" PRIx64 "\"/>",
+                        library.link_map, library.base_addr, library.ld_addr);
+  }
+  library_list.PutCString("</library-list-svr4>");
+
+  StreamGDBRemote response;
+  PutXferChunk(library_list.GetString(), xfer_offset, xfer_length, response);
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_QSaveRegisterState(
     StringExtractorGDBRemote &packet) {
@@ -3092,8 +3663,10 @@ GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo(
 
   StreamString response;
   const bool threads_with_valid_stop_info_only = false;
-  JSONArray::SP threads_array_sp = GetJSONThreadsInfo(
-      *m_debugged_process_up, threads_with_valid_stop_info_only);
+  JSONArray::SP threads_array_sp =
+      GetJSONThreadsInfo(*m_debugged_process_up,
+                         threads_with_valid_stop_info_only,
+                         m_expedited_stack_size);
   if (!threads_array_sp) {
     LLDB_LOG(log, "failed to prepare a packet for pid {0}",
              m_debugged_process_up->GetID());
@@ -3194,6 +3767,50 @@ GDBRemoteCommunicationServerLLGS::Handle_QPassSignals(
   return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QNonStop(
+    StringExtractorGDBRemote &packet) {
+  packet.SetFilePos(strlen("QNonStop:"));
+  const uint32_t enable = packet.GetU32(UINT32_MAX);
+  if (enable > 1 || packet.GetBytesLeft() > 0)
+    return SendIllFormedResponse(packet, "QNonStop expects 0 or 1");
+
+  // A process launched or attached to later gets the mode then.
+  if (m_debugged_process_up) {
+    Status error = m_debugged_process_up->SetNonStopMode(enable);
+    if (error.Fail())
+      return SendErrorResponse(error);
+  }
+
+  m_non_stop_mode = enable;
+  m_stop_notification_queue.clear();
+  return SendOKResponse();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_vStopped(
+    StringExtractorGDBRemote &packet) {
+  if (!m_non_stop_mode)
+    return SendUnimplementedResponse(packet.GetStringRef().c_str());
+
+  // The client has seen the stop at the front of the queue. Reply with the
+  // next thread that is still stopped, or OK when there is none.
+  if (!m_stop_notification_queue.empty())
+    m_stop_notification_queue.pop_front();
+
+  while (!m_stop_notification_queue.empty()) {
+    const lldb::tid_t tid = m_stop_notification_queue.front();
+    NativeThreadProtocolSP thread_sp;
+    if (m_debugged_process_up)
+      thread_sp = m_debugged_process_up->GetThreadByID(tid);
+    if (thread_sp && StateIsStoppedState(thread_sp->GetState(), true))
+      return SendStopReplyPacketForThread(tid);
+    m_stop_notification_queue.pop_front();
+  }
+
+  return SendOKResponse();
+}
+
 void GDBRemoteCommunicationServerLLGS::MaybeCloseInferiorTerminalConnection() {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
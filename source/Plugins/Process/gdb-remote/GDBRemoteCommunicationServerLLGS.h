@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
 #include <mutex>
 #include <unordered_map>
 
@@ -95,6 +96,17 @@ public:
   //------------------------------------------------------------------
   Status AttachToProcess(lldb::pid_t pid);
 
+  //------------------------------------------------------------------
+  /// Specify how much stack memory to send along with each stopped
+  /// thread.
+  ///
+  /// Stop replies and jThreadsInfo include this many bytes at the
+  /// stack pointer and frame pointer of a thread, so that the client
+  /// can start unwinding it without reading any memory. Zero disables
+  /// sending memory.
+  //------------------------------------------------------------------
+  void SetExpeditedStackSize(uint32_t size) { m_expedited_stack_size = size; }
+
   //------------------------------------------------------------------
   // NativeProcessProtocol::NativeDelegate overrides
   //------------------------------------------------------------------
@@ -105,6 +117,8 @@ public:
 
   void DidExec(NativeProcessProtocol *process) override;
 
+  void ThreadStopped(NativeProcessProtocol *process, lldb::tid_t tid) override;
+
   Status InitializeConnection(std::unique_ptr<Connection> &&connection);
 
 protected:
@@ -125,12 +139,19 @@ protected:
   std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
   uint32_t m_next_saved_registers_id = 1;
   bool m_handshake_completed = false;
+  uint32_t m_expedited_stack_size = 256;
+  bool m_non_stop_mode = false;
+  // Threads whose stops are waiting to be reported in non-stop mode. The
+  // front one has been sent to the client and is dropped by vStopped.
+  std::deque<lldb::tid_t> m_stop_notification_queue;
 
   PacketResult SendONotification(const char *buffer, uint32_t len);
 
-  PacketResult SendWResponse(NativeProcessProtocol *process);
+  PacketResult SendWResponse(NativeProcessProtocol *process,
+                             bool notification = false);
 
-  PacketResult SendStopReplyPacketForThread(lldb::tid_t tid);
+  PacketResult SendStopReplyPacketForThread(lldb::tid_t tid,
+                                            bool notification = false);
 
   PacketResult SendStopReasonForState(lldb::StateType process_state);
 
@@ -177,6 +198,10 @@ protected:
 
   PacketResult Handle_M(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_X(StringExtractorGDBRemote &packet);
+
+  PacketResult Handle_MultiMemRead(StringExtractorGDBRemote &packet);
+
   PacketResult
   Handle_qMemoryRegionInfoSupported(StringExtractorGDBRemote &packet);
 
@@ -190,6 +215,11 @@ protected:
 
   PacketResult Handle_qXfer_auxv_read(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_qXfer_features_read(StringExtractorGDBRemote &packet);
+
+  PacketResult
+  Handle_qXfer_libraries_svr4_read(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_QSaveRegisterState(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_jTraceStart(StringExtractorGDBRemote &packet);
@@ -216,6 +246,10 @@ protected:
 
   PacketResult Handle_QPassSignals(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_QNonStop(StringExtractorGDBRemote &packet);
+
+  PacketResult Handle_vStopped(StringExtractorGDBRemote &packet);
+
   void SetCurrentThreadID(lldb::tid_t tid);
 
   lldb::tid_t GetCurrentThreadID() const;
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <map>
 #include <mutex>
+#include <set>
 #include <sstream>
 
 #include "lldb/Breakpoint/Watchpoint.h"
@@ -1055,6 +1056,10 @@ void ProcessGDBRemote::DidLaunchOrAttach(ArchSpec &process_arch) {
   if (GetID() != LLDB_INVALID_PROCESS_ID) {
     BuildDynamicRegisterInfo(false);
 
+    // Whether lldb-server can range step depends on the process, which
+    // didn't exist yet when the vCont actions were first asked for.
+    m_gdb_comm.ResetVContSupported();
+
     // See if the GDB server supports the qHostInfo information
 
     // See if the GDB server supports the qProcessInfo packet, if so
@@ -1281,11 +1286,16 @@ Status ProcessGDBRemote::WillResume() {
   m_continue_C_tids.clear();
   m_continue_s_tids.clear();
   m_continue_S_tids.clear();
+  m_continue_r_ranges.clear();
   m_jstopinfo_sp.reset();
   m_jthreadsinfo_sp.reset();
   return Status();
 }
 
+bool ProcessGDBRemote::SupportsRangeStepping() {
+  return m_gdb_comm.GetVContSupported('r');
+}
+
 Status ProcessGDBRemote::DoResume() {
   Status error;
   Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS));
@@ -1342,8 +1352,15 @@ Status ProcessGDBRemote::DoResume() {
             for (tid_collection::const_iterator
                      t_pos = m_continue_s_tids.begin(),
                      t_end = m_continue_s_tids.end();
-                 t_pos != t_end; ++t_pos)
-              continue_packet.Printf(";s:%4.4" PRIx64, *t_pos);
+                 t_pos != t_end; ++t_pos) {
+              auto range_pos = m_continue_r_ranges.find(*t_pos);
+              if (range_pos != m_continue_r_ranges.end())
+                continue_packet.Printf(";r%" PRIx64 ",%" PRIx64 ":%4.4" PRIx64,
+                                       range_pos->second.first,
+                                       range_pos->second.second, *t_pos);
+              else
+                continue_packet.Printf(";s:%4.4" PRIx64, *t_pos);
+            }
           } else
             continue_packet_error = true;
         }
@@ -2436,6 +2453,16 @@ Status ProcessGDBRemote::DoHalt(bool &caused_stop) {
     // We are being asked to halt during an attach. We need to just close
     // our file handle and debugserver will go away, and we can be done...
     m_gdb_comm.Disconnect();
+  } else if (GetTarget().GetNonStopModeEnabled()) {
+    // There is no continue packet to interrupt in non-stop mode. Ask for
+    // every thread to stop, the stops arrive as notifications.
+    StringExtractorGDBRemote response;
+    if (m_gdb_comm.SendPacketAndWaitForResponse("vCont;t", response, false) ==
+            GDBRemoteCommunication::PacketResult::Success &&
+        response.IsOKResponse())
+      caused_stop = true;
+    else
+      error.SetErrorString("failed to stop the threads of the process");
   } else
     caused_stop = m_gdb_comm.Interrupt();
   return error;
@@ -2809,11 +2836,84 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   return 0;
 }
 
+bool ProcessGDBRemote::DoReadMemoryRanges(llvm::ArrayRef<MemoryRange> ranges,
+                                          uint8_t *buf,
+                                          std::vector<size_t> &bytes_read) {
+  if (!m_gdb_comm.GetMultiMemReadSupported())
+    return false;
+
+  GetMaxMemorySize();
+  bytes_read.assign(ranges.size(), 0);
+
+  // Send as many ranges per packet as fit in both the request and the reply.
+  // A range larger than a whole reply is read in part.
+  size_t first = 0;
+  uint8_t *first_buf = buf;
+  while (first < ranges.size()) {
+    StreamString packet;
+    packet.PutCString("MultiMemRead:ranges:");
+    size_t last = first;
+    uint64_t reply_size = 0;
+    std::vector<uint64_t> sizes;
+    while (last < ranges.size()) {
+      const uint64_t size =
+          std::min<uint64_t>(ranges[last].GetByteSize(), m_max_memory_size);
+      if (last > first && (reply_size + size > m_max_memory_size ||
+                           packet.GetSize() + 40 > m_max_memory_size))
+        break;
+      packet.Printf("%s%" PRIx64 ",%" PRIx64, last > first ? "," : "",
+                    ranges[last].GetRangeBase(), size);
+      sizes.push_back(size);
+      reply_size += size;
+      ++last;
+    }
+    packet.PutChar(';');
+
+    // The reply is the number of bytes read from each range, followed by the
+    // bytes of all of the ranges.
+    StringExtractorGDBRemote response;
+    if (m_gdb_comm.SendPacketAndWaitForResponse(packet.GetString(), response,
+                                                true) ==
+            GDBRemoteCommunication::PacketResult::Success &&
+        response.IsNormalResponse()) {
+      std::vector<uint64_t> lengths;
+      for (size_t i = first; i < last; ++i) {
+        lengths.push_back(response.GetHexMaxU64(false, UINT64_MAX));
+        if (response.GetChar() != (i + 1 < last ? ',' : ';'))
+          break;
+      }
+
+      if (lengths.size() == sizes.size()) {
+        const char *data = response.Peek();
+        uint64_t data_left = response.GetBytesLeft();
+        uint8_t *dst = first_buf;
+        for (size_t i = 0; i < lengths.size(); ++i) {
+          const uint64_t length = std::min(lengths[i], sizes[i]);
+          if (length > data_left)
+            break;
+          memcpy(dst, data, length);
+          bytes_read[first + i] = length;
+          data += lengths[i];
+          data_left -= std::min(lengths[i], data_left);
+          dst += ranges[first + i].GetByteSize();
+        }
+      }
+    }
+
+    for (size_t i = first; i < last; ++i)
+      first_buf += ranges[i].GetByteSize();
+    first = last;
+  }
+  return true;
+}
+
 size_t ProcessGDBRemote::DoWriteMemory(addr_t addr, const void *buf,
                                        size_t size, Status &error) {
   GetMaxMemorySize();
-  // M and m packets take 2 bytes for 1 byte of memory
-  size_t max_memory_size = m_max_memory_size / 2;
+  bool binary_memory_write = m_gdb_comm.GetXPacketSupported();
+  // M packets take 2 bytes for 1 byte of memory
+  size_t max_memory_size =
+      binary_memory_write ? m_max_memory_size : m_max_memory_size / 2;
   if (size > max_memory_size) {
     // Keep memory read sizes down to a sane limit. This function will be
     // called multiple times in order to complete the task by
@@ -2821,10 +2921,24 @@ size_t ProcessGDBRemote::DoWriteMemory(addr_t addr, const void *buf,
     size = max_memory_size;
   }
 
-  StreamString packet;
-  packet.Printf("M%" PRIx64 ",%" PRIx64 ":", addr, (uint64_t)size);
-  packet.PutBytesAsRawHex8(buf, size, endian::InlHostByteOrder(),
-                           endian::InlHostByteOrder());
+  StreamGDBRemote packet;
+  if (binary_memory_write) {
+    // X packets take 1 byte for most bytes of memory, and 2 for the ones that
+    // need escaping, so stop once the packet is full rather than assuming
+    // the worst.
+    StreamGDBRemote data;
+    const uint8_t *src = static_cast<const uint8_t *>(buf);
+    size_t data_size = 0;
+    while (data_size < size && data.GetSize() + 2 <= max_memory_size)
+      data.PutEscapedBytes(src + data_size++, 1);
+    size = data_size;
+    packet.Printf("X%" PRIx64 ",%" PRIx64 ":", addr, (uint64_t)size);
+    packet.Write(data.GetData(), data.GetSize());
+  } else {
+    packet.Printf("M%" PRIx64 ",%" PRIx64 ":", addr, (uint64_t)size);
+    packet.PutBytesAsRawHex8(buf, size, endian::InlHostByteOrder(),
+                             endian::InlHostByteOrder());
+  }
   StringExtractorGDBRemote response;
   if (m_gdb_comm.SendPacketAndWaitForResponse(packet.GetString(), response,
                                               true) ==
@@ -3007,9 +3121,16 @@ Status ProcessGDBRemote::EnableBreakpointSite(BreakpointSite *bp_site) {
   // skip over software breakpoints.
   if (m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware) &&
       (!bp_site->HardwareRequired())) {
+    // Let the stub evaluate the conditions of the owners if it can, so that
+    // hits where they are false don't stop the process.
+    std::vector<AgentExpression> conditions;
+    if (GetTarget().GetBreakpointConditionsInTarget() &&
+        m_gdb_comm.GetConditionalBreakpointsSupported())
+      bp_site->GetAgentConditions(conditions);
+
     // Try to send off a software breakpoint packet ($Z0)
     uint8_t error_no = m_gdb_comm.SendGDBStoppointTypePacket(
-        eBreakpointSoftware, true, addr, bp_op_size);
+        eBreakpointSoftware, true, addr, bp_op_size, conditions);
     if (error_no == 0) {
       // The breakpoint was placed successfully
       bp_site->SetEnabled(true);
@@ -3101,6 +3222,29 @@ Status ProcessGDBRemote::EnableBreakpointSite(BreakpointSite *bp_site) {
   return EnableSoftwareBreakpoint(bp_site);
 }
 
+void ProcessGDBRemote::UpdateBreakpointSiteConditions(BreakpointSite *bp_site) {
+  // Only software breakpoints placed by the stub carry conditions.
+  if (!bp_site->IsEnabled() ||
+      bp_site->GetType() != BreakpointSite::eExternal ||
+      !GetTarget().GetBreakpointConditionsInTarget() ||
+      !m_gdb_comm.GetConditionalBreakpointsSupported())
+    return;
+
+  // Insert the breakpoint again with the new conditions.
+  Status error = DisableBreakpointSite(bp_site);
+  if (error.Success())
+    error = EnableBreakpointSite(bp_site);
+  if (error.Fail()) {
+    Log *log(
+        ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+    if (log)
+      log->Printf("ProcessGDBRemote::UpdateBreakpointSiteConditions (site_id = "
+                  "%" PRIu64 ") address = 0x%" PRIx64 " -- FAILED: %s",
+                  bp_site->GetID(), (uint64_t)bp_site->GetLoadAddress(),
+                  error.AsCString());
+  }
+}
+
 Status ProcessGDBRemote::DisableBreakpointSite(BreakpointSite *bp_site) {
   Status error;
   assert(bp_site != NULL);
@@ -4639,6 +4783,9 @@ size_t ProcessGDBRemote::LoadModules(LoadedModuleInfoList &module_list) {
 
   // get a list of all the modules
   ModuleList new_modules;
+  // The names of the libraries that couldn't be loaded, so that the modules
+  // we already had for them aren't taken for unloaded ones.
+  std::set<ConstString> unresolved_names;
 
   for (LoadedModuleInfoList::LoadedModuleInfo &modInfo : module_list.m_list) {
     std::string mod_name;
@@ -4662,6 +4809,8 @@ size_t ProcessGDBRemote::LoadModules(LoadedModuleInfoList &module_list) {
 
     if (module_sp.get())
       new_modules.Append(module_sp);
+    else
+      unresolved_names.insert(file.GetFilename());
   }
 
   if (new_modules.GetSize() > 0) {
@@ -4679,11 +4828,15 @@ size_t ProcessGDBRemote::LoadModules(LoadedModuleInfoList &module_list) {
       }
 
       // The main executable will never be included in libraries-svr4, don't
-      // remove it
-      if (!found &&
-          loaded_module.get() != target.GetExecutableModulePointer()) {
-        removed_modules.Append(loaded_module);
-      }
+      // remove it. Neither are modules read from memory, such as the vdso.
+      if (found ||
+          loaded_module.get() == target.GetExecutableModulePointer() ||
+          unresolved_names.count(loaded_module->GetFileSpec().GetFilename()))
+        continue;
+      ObjectFile *obj = loaded_module->GetObjectFile();
+      if (obj && obj->IsInMemory())
+        continue;
+      removed_modules.Append(loaded_module);
     }
 
     loaded_modules.Remove(removed_modules);
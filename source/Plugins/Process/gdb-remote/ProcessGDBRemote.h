@@ -117,6 +117,8 @@ public:
 
   Status DoResume() override;
 
+  bool SupportsRangeStepping() override;
+
   Status DoHalt(bool &caused_stop) override;
 
   Status DoDetach(bool keep_stopped) override;
@@ -146,6 +148,9 @@ public:
   size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                       Status &error) override;
 
+  bool DoReadMemoryRanges(llvm::ArrayRef<MemoryRange> ranges, uint8_t *buf,
+                          std::vector<size_t> &bytes_read) override;
+
   size_t DoWriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                        Status &error) override;
 
@@ -169,6 +174,8 @@ public:
 
   Status DisableBreakpointSite(BreakpointSite *bp_site) override;
 
+  void UpdateBreakpointSiteConditions(BreakpointSite *bp_site) override;
+
   //----------------------------------------------------------------------
   // Process Watchpoints
   //----------------------------------------------------------------------
@@ -293,6 +300,8 @@ protected:
   tid_sig_collection m_continue_C_tids;       // 'C' for continue with signal
   tid_collection m_continue_s_tids;           // 's' for step
   tid_sig_collection m_continue_S_tids;       // 'S' for step with signal
+  std::map<lldb::tid_t, std::pair<lldb::addr_t, lldb::addr_t>>
+      m_continue_r_ranges; // 'r' ranges for the 's' threads that have one
   uint64_t m_max_memory_size; // The maximum number of bytes to read/write when
                               // reading and writing memory
   uint64_t m_remote_stub_max_memory_size; // The maximum memory size the remote
@@ -39,8 +39,8 @@ using namespace std;
 extern int g_verbose;
 
 DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF *dwarf2Data)
-    : m_dwarf2Data(dwarf2Data), m_abbrevs(NULL), m_user_data(NULL),
-      m_die_array(), m_func_aranges_ap(), m_base_addr(0),
+    : m_dwarf2Data(dwarf2Data), m_abbrevs(NULL), m_abbrev_infos(),
+      m_user_data(NULL), m_die_array(), m_func_aranges_ap(), m_base_addr(0),
       m_offset(DW_INVALID_OFFSET), m_length(0), m_version(0),
       m_addr_size(DWARFCompileUnit::GetDefaultAddressSize()),
       m_producer(eProducerInvalid), m_producer_version_major(0),
@@ -56,6 +56,7 @@ void DWARFCompileUnit::Clear() {
   m_length = 0;
   m_version = 0;
   m_abbrevs = NULL;
+  m_abbrev_infos.clear();
   m_addr_size = DWARFCompileUnit::GetDefaultAddressSize();
   m_base_addr = 0;
   m_die_array.clear();
@@ -93,6 +94,7 @@ bool DWARFCompileUnit::Extract(const DWARFDataExtractor &debug_info,
     if (length_OK && version_OK && addr_size_OK && abbr_offset_OK &&
         abbr != NULL) {
       m_abbrevs = abbr->GetAbbreviationDeclarationSet(abbr_offset);
+      BuildAbbreviationInfos();
       return true;
     }
 
@@ -103,6 +105,82 @@ bool DWARFCompileUnit::Extract(const DWARFDataExtractor &debug_info,
   return false;
 }
 
+uint32_t DWARFCompileUnit::GetHotAttribute(dw_attr_t attr) {
+  switch (attr) {
+  case DW_AT_name:
+    return eHotAttributeName;
+  case DW_AT_low_pc:
+    return eHotAttributeLowPC;
+  case DW_AT_high_pc:
+    return eHotAttributeHighPC;
+  case DW_AT_specification:
+    return eHotAttributeSpecification;
+  case DW_AT_abstract_origin:
+    return eHotAttributeAbstractOrigin;
+  default:
+    return kNumHotAttributes;
+  }
+}
+
+//----------------------------------------------------------------------
+// BuildAbbreviationInfos
+//
+// Work out the layout of the DIEs of every abbreviation this compile
+// unit can use. The layout depends on the address and offset sizes of
+// the compile unit, so it can't be shared with other compile units that
+// use the same abbreviation set.
+//----------------------------------------------------------------------
+void DWARFCompileUnit::BuildAbbreviationInfos() {
+  m_abbrev_infos.clear();
+  if (m_abbrevs == NULL)
+    return;
+
+  const DWARFAbbreviationDeclarationColl &decls = m_abbrevs->GetDeclarations();
+  dw_uleb128_t max_code = 0;
+  for (const DWARFAbbreviationDeclaration &decl : decls)
+    max_code = std::max(max_code, decl.Code());
+  // DIEs can't refer to codes that don't fit in their abbreviation index.
+  max_code =
+      std::min<dw_uleb128_t>(max_code, (1u << DIE_ABBR_IDX_BITSIZE) - 1);
+  m_abbrev_infos.resize(max_code + 1, AbbreviationInfo());
+
+  DWARFFormValue::FixedFormSizes fixed_form_sizes = GetFixedFormSizes();
+  for (const DWARFAbbreviationDeclaration &decl : decls) {
+    // Like DWARFAbbreviationDeclarationSet, the first declaration of a
+    // code wins.
+    if (decl.Code() > max_code || m_abbrev_infos[decl.Code()].decl)
+      continue;
+    AbbreviationInfo &info = m_abbrev_infos[decl.Code()];
+    info.decl = &decl;
+    for (HotAttributeLocation &location : info.hot_attributes)
+      location.index = location.offset = UINT16_MAX;
+
+    uint32_t offset = 0;
+    bool is_fixed = true;
+    const uint32_t num_attributes = decl.NumAttributes();
+    for (uint32_t idx = 0; idx < num_attributes; ++idx) {
+      dw_attr_t attr;
+      dw_form_t form;
+      decl.GetAttrAndFormByIndexUnchecked(idx, attr, form);
+      const uint32_t hot_attr = GetHotAttribute(attr);
+      if (hot_attr < kNumHotAttributes && idx < UINT16_MAX &&
+          info.hot_attributes[hot_attr].index == UINT16_MAX) {
+        info.hot_attributes[hot_attr].index = idx;
+        if (is_fixed && offset < UINT16_MAX)
+          info.hot_attributes[hot_attr].offset = offset;
+      }
+      if (!is_fixed)
+        continue;
+      const uint8_t fixed_size = fixed_form_sizes.GetSize(form);
+      if (fixed_size || form == DW_FORM_flag_present)
+        offset += fixed_size;
+      else
+        is_fixed = false;
+    }
+    info.fixed_attributes_size = is_fixed ? offset : UINT32_MAX;
+  }
+}
+
 void DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die) {
   if (m_die_array.size() > 1) {
     // std::vectors never get any smaller when resized to a smaller size,
@@ -619,7 +697,8 @@ void DWARFCompileUnit::Index(NameToDIE &func_basenames,
                              NameToDIE &func_selectors,
                              NameToDIE &objc_class_selectors,
                              NameToDIE &globals, NameToDIE &types,
-                             NameToDIE &namespaces) {
+                             NameToDIE &namespaces,
+                             DeferredDIEs *deferred_dies) {
   Log *log(LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS));
 
   if (log) {
@@ -636,14 +715,41 @@ void DWARFCompileUnit::Index(NameToDIE &func_basenames,
 
   IndexPrivate(this, cu_language, fixed_form_sizes, GetOffset(), func_basenames,
                func_fullnames, func_methods, func_selectors,
-               objc_class_selectors, globals, types, namespaces);
+               objc_class_selectors, globals, types, namespaces, nullptr,
+               deferred_dies);
 
   SymbolFileDWARFDwo *dwo_symbol_file = GetDwoSymbolFile();
   if (dwo_symbol_file) {
     IndexPrivate(dwo_symbol_file->GetCompileUnit(), cu_language,
                  fixed_form_sizes, GetOffset(), func_basenames, func_fullnames,
                  func_methods, func_selectors, objc_class_selectors, globals,
-                 types, namespaces);
+                 types, namespaces, nullptr, deferred_dies);
+  }
+}
+
+void DWARFCompileUnit::IndexDeferredDIEs(
+    const DeferredDIEs &deferred_dies, NameToDIE &func_basenames,
+    NameToDIE &func_fullnames, NameToDIE &func_methods,
+    NameToDIE &func_selectors, NameToDIE &objc_class_selectors,
+    NameToDIE &globals, NameToDIE &types, NameToDIE &namespaces) {
+  const LanguageType cu_language = GetLanguageType();
+  DWARFFormValue::FixedFormSizes fixed_form_sizes =
+      DWARFFormValue::GetFixedFormSizesForAddressSize(GetAddressByteSize(),
+                                                      m_is_dwarf64);
+
+  // Index() defers the DIEs of this compile unit before those of its .dwo
+  // compile unit, so each compile unit's DIEs are next to each other.
+  std::vector<dw_offset_t> die_offsets;
+  for (size_t i = 0; i < deferred_dies.size(); ++i) {
+    die_offsets.push_back(deferred_dies[i].die_offset);
+    DWARFCompileUnit *dwarf_cu = deferred_dies[i].cu;
+    if (i + 1 < deferred_dies.size() && deferred_dies[i + 1].cu == dwarf_cu)
+      continue;
+    IndexPrivate(dwarf_cu, cu_language, fixed_form_sizes, GetOffset(),
+                 func_basenames, func_fullnames, func_methods, func_selectors,
+                 objc_class_selectors, globals, types, namespaces,
+                 &die_offsets, nullptr);
+    die_offsets.clear();
   }
 }
 
@@ -653,12 +759,19 @@ void DWARFCompileUnit::IndexPrivate(
     const dw_offset_t cu_offset, NameToDIE &func_basenames,
     NameToDIE &func_fullnames, NameToDIE &func_methods,
     NameToDIE &func_selectors, NameToDIE &objc_class_selectors,
-    NameToDIE &globals, NameToDIE &types, NameToDIE &namespaces) {
-  DWARFDebugInfoEntry::const_iterator pos;
-  DWARFDebugInfoEntry::const_iterator begin = dwarf_cu->m_die_array.begin();
-  DWARFDebugInfoEntry::const_iterator end = dwarf_cu->m_die_array.end();
-  for (pos = begin; pos != end; ++pos) {
-    const DWARFDebugInfoEntry &die = *pos;
+    NameToDIE &globals, NameToDIE &types, NameToDIE &namespaces,
+    const std::vector<dw_offset_t> *die_offsets, DeferredDIEs *deferred_dies) {
+  const size_t num_dies =
+      die_offsets ? die_offsets->size() : dwarf_cu->m_die_array.size();
+  for (size_t die_idx = 0; die_idx < num_dies; ++die_idx) {
+    const DWARFDebugInfoEntry *die_ptr = nullptr;
+    if (die_offsets)
+      die_ptr = dwarf_cu->GetDIE((*die_offsets)[die_idx]).GetDIE();
+    else
+      die_ptr = &dwarf_cu->m_die_array[die_idx];
+    if (die_ptr == nullptr)
+      continue;
+    const DWARFDebugInfoEntry &die = *die_ptr;
 
     const dw_tag_t tag = die.Tag();
 
@@ -694,8 +807,14 @@ void DWARFCompileUnit::IndexPrivate(
     bool is_global_or_static_variable = false;
 
     DWARFFormValue specification_die_form;
+    bool foreign_reference = false;
     const size_t num_attributes =
-        die.GetAttributes(dwarf_cu, fixed_form_sizes, attributes);
+        die.GetAttributes(dwarf_cu, fixed_form_sizes, attributes,
+                          deferred_dies ? &foreign_reference : nullptr);
+    if (foreign_reference) {
+      deferred_dies->push_back({dwarf_cu, die.GetOffset()});
+      continue;
+    }
     if (num_attributes > 0) {
       for (uint32_t i = 0; i < num_attributes; ++i) {
         dw_attr_t attr = attributes.AttributeAtIndex(i);
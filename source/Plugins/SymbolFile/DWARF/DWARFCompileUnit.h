@@ -28,6 +28,54 @@ public:
     eProcucerOther
   };
 
+  //------------------------------------------------------------------
+  // A DIE that Index() left out because its DW_AT_specification or
+  // DW_AT_abstract_origin is in another compile unit. \a cu is the
+  // compile unit the DIE is in, which is the .dwo compile unit for split
+  // DWARF.
+  //------------------------------------------------------------------
+  struct DeferredDIE {
+    DWARFCompileUnit *cu;
+    dw_offset_t die_offset;
+  };
+  typedef std::vector<DeferredDIE> DeferredDIEs;
+
+  // Attributes that are read for most DIEs, whose location in a DIE is
+  // worked out once per abbreviation.
+  enum HotAttribute {
+    eHotAttributeName = 0,
+    eHotAttributeLowPC,
+    eHotAttributeHighPC,
+    eHotAttributeSpecification,
+    eHotAttributeAbstractOrigin,
+    kNumHotAttributes
+  };
+
+  //------------------------------------------------------------------
+  // Where a hot attribute lives in the DIEs of an abbreviation: its
+  // index in the abbreviation declaration (UINT16_MAX if the
+  // abbreviation doesn't have it) and, if all the values before it have
+  // a fixed size in this compile unit, its offset from the end of the
+  // abbreviation code (UINT16_MAX otherwise).
+  //------------------------------------------------------------------
+  struct HotAttributeLocation {
+    uint16_t index;
+    uint16_t offset;
+  };
+
+  //------------------------------------------------------------------
+  // An abbreviation declaration used by this compile unit along with
+  // the layout of its DIEs, so that extracting DIEs and reading their
+  // attributes doesn't have to look up and walk the declaration again.
+  //------------------------------------------------------------------
+  struct AbbreviationInfo {
+    const DWARFAbbreviationDeclaration *decl;
+    // The size of all the attribute values of a DIE, or UINT32_MAX if
+    // some of them have a variable size.
+    uint32_t fixed_attributes_size;
+    HotAttributeLocation hot_attributes[kNumHotAttributes];
+  };
+
   DWARFCompileUnit(SymbolFileDWARF *dwarf2Data);
   ~DWARFCompileUnit();
 
@@ -67,6 +115,13 @@ public:
     return m_abbrevs;
   }
   dw_offset_t GetAbbrevOffset() const;
+  const AbbreviationInfo *GetAbbreviationInfo(dw_uleb128_t abbr_code) const {
+    if (abbr_code < m_abbrev_infos.size() && m_abbrev_infos[abbr_code].decl)
+      return &m_abbrev_infos[abbr_code];
+    return NULL;
+  }
+  // Returns the HotAttribute for \a attr, or kNumHotAttributes.
+  static uint32_t GetHotAttribute(dw_attr_t attr);
   uint8_t GetAddressByteSize() const { return m_addr_size; }
   dw_addr_t GetBaseAddress() const { return m_base_addr; }
   dw_addr_t GetAddrBase() const { return m_addr_base; }
@@ -130,10 +185,28 @@ public:
 
   bool Supports_unnamed_objc_bitfields();
 
+  //------------------------------------------------------------------
+  // Add the names of this compile unit's DIEs to the given maps. If
+  // \a deferred_dies is not NULL, DIEs that refer to a DIE in another
+  // compile unit are appended to it instead, so that Index() only ever
+  // reads the DIEs of this compile unit.
+  //------------------------------------------------------------------
   void Index(NameToDIE &func_basenames, NameToDIE &func_fullnames,
              NameToDIE &func_methods, NameToDIE &func_selectors,
              NameToDIE &objc_class_selectors, NameToDIE &globals,
-             NameToDIE &types, NameToDIE &namespaces);
+             NameToDIE &types, NameToDIE &namespaces,
+             DeferredDIEs *deferred_dies = nullptr);
+
+  //------------------------------------------------------------------
+  // Add the names of the DIEs that Index() deferred to the given maps.
+  // This reads the DIEs of other compile units, so no other thread may
+  // be extracting or clearing DIEs meanwhile.
+  //------------------------------------------------------------------
+  void IndexDeferredDIEs(const DeferredDIEs &deferred_dies,
+                         NameToDIE &func_basenames, NameToDIE &func_fullnames,
+                         NameToDIE &func_methods, NameToDIE &func_selectors,
+                         NameToDIE &objc_class_selectors, NameToDIE &globals,
+                         NameToDIE &types, NameToDIE &namespaces);
 
   const DWARFDebugAranges &GetFunctionAranges();
 
@@ -165,6 +238,8 @@ protected:
   SymbolFileDWARF *m_dwarf2Data;
   std::unique_ptr<SymbolFileDWARFDwo> m_dwo_symbol_file;
   const DWARFAbbreviationDeclarationSet *m_abbrevs;
+  // Indexed by abbreviation code.
+  std::vector<AbbreviationInfo> m_abbrev_infos;
   void *m_user_data;
   DWARFDebugInfoEntry::collection
       m_die_array; // The compile unit debug information entry item
@@ -194,13 +269,17 @@ protected:
 
   void ParseProducerInfo();
 
+  void BuildAbbreviationInfos();
+
   static void
   IndexPrivate(DWARFCompileUnit *dwarf_cu, const lldb::LanguageType cu_language,
                const DWARFFormValue::FixedFormSizes &fixed_form_sizes,
                const dw_offset_t cu_offset, NameToDIE &func_basenames,
                NameToDIE &func_fullnames, NameToDIE &func_methods,
                NameToDIE &func_selectors, NameToDIE &objc_class_selectors,
-               NameToDIE &globals, NameToDIE &types, NameToDIE &namespaces);
+               NameToDIE &globals, NameToDIE &types, NameToDIE &namespaces,
+               const std::vector<dw_offset_t> *die_offsets,
+               DeferredDIEs *deferred_dies);
 
 private:
   const DWARFDebugInfoEntry *GetCompileUnitDIEPtrOnly() {
@@ -409,7 +409,7 @@ size_t DWARFDIE::GetAttributes(DWARFAttributes &attributes,
                                uint32_t depth) const {
   if (IsValid()) {
     return m_die->GetAttributes(m_cu, m_cu->GetFixedFormSizes(), attributes,
-                                depth);
+                                nullptr, depth);
   }
   if (depth == 0)
     attributes.Clear();
@@ -46,6 +46,10 @@ public:
   const DWARFAbbreviationDeclaration *
   GetAbbreviationDeclaration(dw_uleb128_t abbrCode) const;
 
+  const DWARFAbbreviationDeclarationColl &GetDeclarations() const {
+    return m_decls;
+  }
+
 private:
   dw_offset_t m_offset;
   uint32_t m_idx_offset;
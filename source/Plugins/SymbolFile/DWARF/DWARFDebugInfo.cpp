@@ -67,6 +67,18 @@ DWARFDebugAranges &DWARFDebugInfo::GetCompileUnitAranges() {
         cus_with_data.insert(offset);
     }
 
+    // The address area of a .gdb_index describes every compile unit the
+    // linker saw, use it before falling back to parsing the DIEs.
+    DWARFGdbIndex *gdb_index = m_dwarf2Data->GetGdbIndex();
+    if (gdb_index) {
+      if (log)
+        log->Printf(
+            "DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" from "
+            ".gdb_index",
+            m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str());
+      gdb_index->AppendAddressRanges(*m_cu_aranges_ap, cus_with_data);
+    }
+
     // Manually build arange data for everything that wasn't in the
     // .debug_aranges table.
     bool printed = false;
@@ -33,6 +33,40 @@ using namespace lldb_private;
 using namespace std;
 extern int g_verbose;
 
+//----------------------------------------------------------------------
+// Look up the abbreviation of the DIE at \a die_offset and set \a offset
+// to the offset of its first attribute value.
+//----------------------------------------------------------------------
+static const DWARFCompileUnit::AbbreviationInfo *
+GetAbbreviationInfo(SymbolFileDWARF *dwarf2Data, const DWARFCompileUnit *cu,
+                    dw_offset_t die_offset, dw_uleb128_t abbr_idx,
+                    lldb::offset_t &offset) {
+  if (dwarf2Data) {
+    offset = die_offset;
+
+    const DWARFCompileUnit::AbbreviationInfo *abbrev_info =
+        cu->GetAbbreviationInfo(abbr_idx);
+    if (abbrev_info) {
+      // Make sure the abbreviation code still matches. If it doesn't and
+      // the DWARF data was mmap'ed, the backing file might have been modified
+      // which is bad news.
+      const uint64_t abbrev_code =
+          dwarf2Data->get_debug_info_data().GetULEB128(&offset);
+
+      if (abbrev_info->decl->Code() == abbrev_code)
+        return abbrev_info;
+
+      dwarf2Data->GetObjectFile()->GetModule()->ReportErrorIfModifyDetected(
+          "0x%8.8x: the DWARF debug information has been modified (abbrev "
+          "code was %u, and is now %u)",
+          die_offset, (uint32_t)abbrev_info->decl->Code(),
+          (uint32_t)abbrev_code);
+    }
+  }
+  offset = DW_INVALID_OFFSET;
+  return NULL;
+}
+
 bool DWARFDebugInfoEntry::FastExtract(
     const DWARFDataExtractor &debug_info_data, const DWARFCompileUnit *cu,
     const DWARFFormValue::FixedFormSizes &fixed_form_sizes,
@@ -51,10 +85,10 @@ bool DWARFDebugInfoEntry::FastExtract(
   if (m_abbr_idx) {
     lldb::offset_t offset = *offset_ptr;
 
-    const DWARFAbbreviationDeclaration *abbrevDecl =
-        cu->GetAbbreviations()->GetAbbreviationDeclaration(m_abbr_idx);
+    const DWARFCompileUnit::AbbreviationInfo *abbrev_info =
+        cu->GetAbbreviationInfo(m_abbr_idx);
 
-    if (abbrevDecl == NULL) {
+    if (abbrev_info == NULL) {
       cu->GetSymbolFileDWARF()->GetObjectFile()->GetModule()->ReportError(
           "{0x%8.8x}: invalid abbreviation code %u, please file a bug and "
           "attach the file at the start of this error message",
@@ -63,8 +97,15 @@ bool DWARFDebugInfoEntry::FastExtract(
       *offset_ptr = UINT32_MAX;
       return false;
     }
+    const DWARFAbbreviationDeclaration *abbrevDecl = abbrev_info->decl;
     m_tag = abbrevDecl->Tag();
     m_has_children = abbrevDecl->HasChildren();
+    // Most abbreviations only use fixed size forms, skip their values in
+    // one go.
+    if (abbrev_info->fixed_attributes_size != UINT32_MAX) {
+      *offset_ptr = offset + abbrev_info->fixed_attributes_size;
+      return true;
+    }
     // Skip all data in the .debug_info for the attributes
     const uint32_t numAttributes = abbrevDecl->NumAttributes();
     uint32_t i;
@@ -765,7 +806,8 @@ void DWARFDebugInfoEntry::DumpAttribute(
 //----------------------------------------------------------------------
 size_t DWARFDebugInfoEntry::GetAttributes(
     const DWARFCompileUnit *cu, DWARFFormValue::FixedFormSizes fixed_form_sizes,
-    DWARFAttributes &attributes, uint32_t curr_depth) const {
+    DWARFAttributes &attributes, bool *foreign_reference,
+    uint32_t curr_depth) const {
   SymbolFileDWARF *dwarf2Data = nullptr;
   const DWARFAbbreviationDeclaration *abbrevDecl = nullptr;
   lldb::offset_t offset = 0;
@@ -774,7 +816,8 @@ size_t DWARFDebugInfoEntry::GetAttributes(
       SymbolFileDWARFDwo *dwo_symbol_file = cu->GetDwoSymbolFile();
       if (dwo_symbol_file)
         return GetAttributes(dwo_symbol_file->GetCompileUnit(),
-                             fixed_form_sizes, attributes, curr_depth);
+                             fixed_form_sizes, attributes, foreign_reference,
+                             curr_depth);
     }
 
     dwarf2Data = cu->GetSymbolFileDWARF();
@@ -818,10 +861,18 @@ size_t DWARFDebugInfoEntry::GetAttributes(
         DWARFFormValue form_value(cu, form);
         if (form_value.ExtractValue(debug_info_data, &offset)) {
           dw_offset_t die_offset = form_value.Reference();
-          DWARFDIE spec_die =
-              const_cast<DWARFCompileUnit *>(cu)->GetDIE(die_offset);
-          if (spec_die)
-            spec_die.GetAttributes(attributes, curr_depth + 1);
+          if (foreign_reference && !cu->ContainsDIEOffset(die_offset)) {
+            // Another thread may be extracting or clearing the DIEs of that
+            // compile unit, so leave it to the caller.
+            *foreign_reference = true;
+          } else {
+            DWARFDIE spec_die =
+                const_cast<DWARFCompileUnit *>(cu)->GetDIE(die_offset);
+            if (spec_die)
+              spec_die.GetDIE()->GetAttributes(
+                  spec_die.GetCU(), spec_die.GetCU()->GetFixedFormSizes(),
+                  attributes, foreign_reference, curr_depth + 1);
+          }
         }
       } else {
         const uint8_t fixed_skip_size = fixed_form_sizes.GetSize(form);
@@ -857,17 +908,32 @@ dw_offset_t DWARFDebugInfoEntry::GetAttributeValue(
                              check_specification_or_abstract_origin);
 
   lldb::offset_t offset;
-  const DWARFAbbreviationDeclaration *abbrevDecl =
-      GetAbbreviationDeclarationPtr(dwarf2Data, cu, offset);
-
-  if (abbrevDecl) {
-    uint32_t attr_idx = abbrevDecl->FindAttributeIndex(attr);
+  const DWARFCompileUnit::AbbreviationInfo *abbrev_info =
+      GetAbbreviationInfo(dwarf2Data, cu, m_offset, m_abbr_idx, offset);
+
+  if (abbrev_info) {
+    const DWARFAbbreviationDeclaration *abbrevDecl = abbrev_info->decl;
+    const uint32_t hot_attr = DWARFCompileUnit::GetHotAttribute(attr);
+    uint32_t attr_idx = DW_INVALID_INDEX;
+    uint32_t attr_offset_in_die = UINT16_MAX;
+    if (hot_attr < DWARFCompileUnit::kNumHotAttributes) {
+      const DWARFCompileUnit::HotAttributeLocation &location =
+          abbrev_info->hot_attributes[hot_attr];
+      if (location.index != UINT16_MAX)
+        attr_idx = location.index;
+      attr_offset_in_die = location.offset;
+    } else
+      attr_idx = abbrevDecl->FindAttributeIndex(attr);
 
     if (attr_idx != DW_INVALID_INDEX) {
       const DWARFDataExtractor &debug_info_data =
           dwarf2Data->get_debug_info_data();
 
       uint32_t idx = 0;
+      if (attr_offset_in_die != UINT16_MAX) {
+        offset += attr_offset_in_die;
+        idx = attr_idx;
+      }
       while (idx < attr_idx)
         DWARFFormValue::SkipValue(abbrevDecl->GetFormByIndex(idx++),
                                   debug_info_data, &offset, cu);
@@ -1787,32 +1853,9 @@ const DWARFAbbreviationDeclaration *
 DWARFDebugInfoEntry::GetAbbreviationDeclarationPtr(
     SymbolFileDWARF *dwarf2Data, const DWARFCompileUnit *cu,
     lldb::offset_t &offset) const {
-  if (dwarf2Data) {
-    offset = GetOffset();
-
-    const DWARFAbbreviationDeclarationSet *abbrev_set = cu->GetAbbreviations();
-    if (abbrev_set) {
-      const DWARFAbbreviationDeclaration *abbrev_decl =
-          abbrev_set->GetAbbreviationDeclaration(m_abbr_idx);
-      if (abbrev_decl) {
-        // Make sure the abbreviation code still matches. If it doesn't and
-        // the DWARF data was mmap'ed, the backing file might have been modified
-        // which is bad news.
-        const uint64_t abbrev_code =
-            dwarf2Data->get_debug_info_data().GetULEB128(&offset);
-
-        if (abbrev_decl->Code() == abbrev_code)
-          return abbrev_decl;
-
-        dwarf2Data->GetObjectFile()->GetModule()->ReportErrorIfModifyDetected(
-            "0x%8.8x: the DWARF debug information has been modified (abbrev "
-            "code was %u, and is now %u)",
-            GetOffset(), (uint32_t)abbrev_decl->Code(), (uint32_t)abbrev_code);
-      }
-    }
-  }
-  offset = DW_INVALID_OFFSET;
-  return NULL;
+  const DWARFCompileUnit::AbbreviationInfo *abbrev_info =
+      GetAbbreviationInfo(dwarf2Data, cu, GetOffset(), m_abbr_idx, offset);
+  return abbrev_info ? abbrev_info->decl : NULL;
 }
 
 bool DWARFDebugInfoEntry::OffsetLessThan(const DWARFDebugInfoEntry &a,
@@ -93,9 +93,14 @@ public:
                      DWARFDebugInfoEntry **function_die,
                      DWARFDebugInfoEntry **block_die);
 
+  // If \a foreign_reference is not NULL, DW_AT_specification and
+  // DW_AT_abstract_origin are only followed within \a cu. A reference to a
+  // DIE in another compile unit sets *foreign_reference to true and leaves
+  // \a attrs without that DIE's attributes.
   size_t GetAttributes(const DWARFCompileUnit *cu,
                        DWARFFormValue::FixedFormSizes fixed_form_sizes,
                        DWARFAttributes &attrs,
+                       bool *foreign_reference = nullptr,
                        uint32_t curr_depth = 0)
       const; // "curr_depth" for internal use only, don't set this yourself!!!
 
@@ -12,6 +12,8 @@
 //#define ENABLE_DEBUG_PRINTF   // DO NOT LEAVE THIS DEFINED: DEBUG ONLY!!!
 #include <assert.h>
 
+#include <algorithm>
+
 #include "lldb/Core/FileSpecList.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Host/Host.h"
@@ -478,7 +480,8 @@ bool DWARFDebugLine::ParseSupportFiles(
 //----------------------------------------------------------------------
 bool DWARFDebugLine::ParseStatementTable(
     const DWARFDataExtractor &debug_line_data, lldb::offset_t *offset_ptr,
-    DWARFDebugLine::State::Callback callback, void *userData) {
+    DWARFDebugLine::State::Callback callback, void *userData,
+    dw_offset_t sequence_offset) {
   Log *log(LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
   Prologue::shared_ptr prologue(new Prologue());
 
@@ -506,6 +509,14 @@ bool DWARFDebugLine::ParseStatementTable(
 
   State state(prologue, log, callback, userData);
 
+  if (sequence_offset != DW_INVALID_OFFSET) {
+    if (sequence_offset < *offset_ptr || sequence_offset >= end_offset) {
+      *offset_ptr = debug_line_offset;
+      return false;
+    }
+    *offset_ptr = sequence_offset;
+  }
+
   while (*offset_ptr < end_offset) {
     // DEBUG_PRINTF("0x%8.8x: ", *offset_ptr);
     uint8_t opcode = debug_line_data.GetU8(offset_ptr);
@@ -531,6 +542,8 @@ bool DWARFDebugLine::ParseStatementTable(
         state.end_sequence = true;
         state.AppendRowToMatrix(*offset_ptr);
         state.Reset();
+        if (sequence_offset != DW_INVALID_OFFSET)
+          *offset_ptr = end_offset;
         break;
 
       case DW_LNE_set_address:
@@ -747,6 +760,98 @@ bool DWARFDebugLine::ParseStatementTable(
   return end_offset;
 }
 
+struct ParseSequenceIndexInfo {
+  DWARFDebugLine::SequenceIndex *sequences;
+  DWARFDebugLine::Sequence sequence;
+  size_t num_files;
+  bool defines_files;
+};
+
+//----------------------------------------------------------------------
+// ParseSequenceIndexCallback
+//----------------------------------------------------------------------
+static void ParseSequenceIndexCallback(dw_offset_t offset,
+                                       const DWARFDebugLine::State &state,
+                                       void *userData) {
+  ParseSequenceIndexInfo *info = (ParseSequenceIndexInfo *)userData;
+  if (state.row == DWARFDebugLine::State::StartParsingLineTable) {
+    info->num_files = state.prologue->file_names.size();
+  } else if (state.row == DWARFDebugLine::State::DoneParsingLineTable) {
+    info->defines_files =
+        state.prologue->file_names.size() != info->num_files;
+  } else {
+    if (info->sequence.low_pc == LLDB_INVALID_ADDRESS)
+      info->sequence.low_pc = state.address;
+    if (state.end_sequence) {
+      info->sequence.high_pc = state.address;
+      if (info->sequence.low_pc < info->sequence.high_pc)
+        info->sequences->push_back(info->sequence);
+      // The next sequence starts right after this one.
+      info->sequence.low_pc = LLDB_INVALID_ADDRESS;
+      info->sequence.offset = offset;
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+// ParseSequenceIndex
+//----------------------------------------------------------------------
+bool DWARFDebugLine::ParseSequenceIndex(
+    const DWARFDataExtractor &debug_line_data, dw_offset_t line_offset,
+    SequenceIndex &sequences) {
+  sequences.clear();
+
+  // Find where the first sequence starts.
+  lldb::offset_t offset = line_offset;
+  Prologue prologue;
+  if (!ParsePrologue(debug_line_data, &offset, &prologue))
+    return false;
+
+  ParseSequenceIndexInfo info;
+  info.sequences = &sequences;
+  info.sequence.low_pc = LLDB_INVALID_ADDRESS;
+  info.sequence.high_pc = LLDB_INVALID_ADDRESS;
+  info.sequence.offset = offset;
+  info.num_files = 0;
+  info.defines_files = false;
+
+  offset = line_offset;
+  if (!ParseStatementTable(debug_line_data, &offset,
+                           ParseSequenceIndexCallback, &info) ||
+      info.defines_files) {
+    sequences.clear();
+    return false;
+  }
+
+  std::stable_sort(sequences.begin(), sequences.end(),
+                   [](const Sequence &lhs, const Sequence &rhs) {
+                     return lhs.low_pc < rhs.low_pc;
+                   });
+  return true;
+}
+
+//----------------------------------------------------------------------
+// FindSequence
+//
+// Sequences of discarded functions can overlap others (they are usually
+// all at address zero). Only the last sequence that starts at or before
+// \a address is considered, callers fall back to the full line table if
+// it doesn't contain \a address.
+//----------------------------------------------------------------------
+const DWARFDebugLine::Sequence *
+DWARFDebugLine::FindSequence(const SequenceIndex &sequences,
+                             dw_addr_t address) {
+  auto pos = std::upper_bound(
+      sequences.begin(), sequences.end(), address,
+      [](dw_addr_t addr, const Sequence &sequence) {
+        return addr < sequence.low_pc;
+      });
+  if (pos == sequences.begin())
+    return nullptr;
+  --pos;
+  return address < pos->high_pc ? &*pos : nullptr;
+}
+
 //----------------------------------------------------------------------
 // ParseStatementTableCallback
 //----------------------------------------------------------------------
@@ -188,6 +188,22 @@ public:
     DISALLOW_COPY_AND_ASSIGN(State);
   };
 
+  //------------------------------------------------------------------
+  // Sequence
+  //
+  // The address range covered by one sequence of a line table and the
+  // .debug_line offset of its first opcode. A sequence starts with the
+  // state machine registers at their initial values, so it can be
+  // decoded on its own.
+  //------------------------------------------------------------------
+  struct Sequence {
+    dw_addr_t low_pc;
+    dw_addr_t high_pc;
+    dw_offset_t offset;
+  };
+  // Sorted by low_pc.
+  typedef std::vector<Sequence> SequenceIndex;
+
   static bool DumpOpcodes(
       lldb_private::Log *log, SymbolFileDWARF *dwarf2Data,
       dw_offset_t line_offset = DW_INVALID_OFFSET,
@@ -204,10 +220,22 @@ public:
   static bool
   ParsePrologue(const lldb_private::DWARFDataExtractor &debug_line_data,
                 lldb::offset_t *offset_ptr, Prologue *prologue);
+  // If \a sequence_offset is valid, only the sequence that starts there
+  // is decoded.
   static bool
   ParseStatementTable(const lldb_private::DWARFDataExtractor &debug_line_data,
                       lldb::offset_t *offset_ptr, State::Callback callback,
-                      void *userData);
+                      void *userData,
+                      dw_offset_t sequence_offset = DW_INVALID_OFFSET);
+  // Run the line program at \a line_offset without building any rows to
+  // find the address range of each of its sequences. Returns false if the
+  // sequences can't be decoded on their own, which is the case when the
+  // program defines files with DW_LNE_define_file.
+  static bool
+  ParseSequenceIndex(const lldb_private::DWARFDataExtractor &debug_line_data,
+                     dw_offset_t line_offset, SequenceIndex &sequences);
+  static const Sequence *FindSequence(const SequenceIndex &sequences,
+                                      dw_addr_t address);
   static dw_offset_t
   DumpStatementTable(lldb_private::Log *log,
                      const lldb_private::DWARFDataExtractor &debug_line_data,
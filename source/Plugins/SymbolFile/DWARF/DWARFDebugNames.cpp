@@ -0,0 +1,274 @@
+//===-- DWARFDebugNames.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFDebugNames.h"
+
+#include <algorithm>
+
+#include "lldb/Utility/RegularExpression.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+DWARFDebugNames::DWARFDebugNames(const DWARFDataExtractor &debug_names_data,
+                                 const DWARFDataExtractor &debug_str_data)
+    : m_data(debug_names_data), m_debug_str_data(debug_str_data),
+      m_name_indexes(), m_is_valid(false) {
+  lldb::offset_t offset = 0;
+  while (m_data.ValidOffset(offset)) {
+    NameIndex index;
+    if (!ParseNameIndex(&offset, index)) {
+      m_name_indexes.clear();
+      return;
+    }
+    m_name_indexes.push_back(std::move(index));
+  }
+  m_is_valid = !m_name_indexes.empty();
+}
+
+uint32_t DWARFDebugNames::HashName(llvm::StringRef name) {
+  // DWARF v5 uses the DJB hash of the case folded name. Only ASCII names
+  // are folded here; callers look up other names without the hash table.
+  uint32_t h = 5381;
+  for (unsigned char c : name) {
+    if (c >= 'A' && c <= 'Z')
+      c = c - 'A' + 'a';
+    h = ((h << 5) + h) + c;
+  }
+  return h;
+}
+
+bool DWARFDebugNames::ParseNameIndex(lldb::offset_t *offset_ptr,
+                                     NameIndex &index) {
+  uint64_t unit_length = m_data.GetU32(offset_ptr);
+  index.offset_size = 4;
+  if (unit_length == UINT32_MAX) {
+    unit_length = m_data.GetU64(offset_ptr);
+    index.offset_size = 8;
+  } else if (unit_length >= 0xfffffff0) {
+    return false;
+  }
+  const lldb::offset_t unit_end = *offset_ptr + unit_length;
+  if (unit_length == 0 || !m_data.ValidOffset(unit_end - 1))
+    return false;
+
+  const uint16_t version = m_data.GetU16(offset_ptr);
+  m_data.GetU16(offset_ptr); // Padding
+  if (version != 5)
+    return false;
+
+  index.comp_unit_count = m_data.GetU32(offset_ptr);
+  index.local_type_unit_count = m_data.GetU32(offset_ptr);
+  const uint32_t foreign_type_unit_count = m_data.GetU32(offset_ptr);
+  index.bucket_count = m_data.GetU32(offset_ptr);
+  index.name_count = m_data.GetU32(offset_ptr);
+  const uint32_t abbrev_table_size = m_data.GetU32(offset_ptr);
+  const uint32_t augmentation_string_size = m_data.GetU32(offset_ptr);
+  *offset_ptr += augmentation_string_size;
+
+  const uint64_t offset_size = index.offset_size;
+  index.cu_list_offset = *offset_ptr;
+  index.buckets_offset = index.cu_list_offset +
+                         index.comp_unit_count * offset_size +
+                         index.local_type_unit_count * offset_size +
+                         foreign_type_unit_count * 8ull;
+  index.hashes_offset = index.buckets_offset + index.bucket_count * 4ull;
+  index.string_offsets_offset =
+      index.hashes_offset + (index.bucket_count ? index.name_count * 4ull : 0);
+  index.entry_offsets_offset =
+      index.string_offsets_offset + index.name_count * offset_size;
+  const lldb::offset_t abbrev_offset =
+      index.entry_offsets_offset + index.name_count * offset_size;
+  index.entry_pool_offset = abbrev_offset + abbrev_table_size;
+  if (index.entry_pool_offset > unit_end)
+    return false;
+
+  // Parse the abbreviation table.
+  lldb::offset_t offset = abbrev_offset;
+  while (offset < index.entry_pool_offset) {
+    const uint32_t code = m_data.GetULEB128(&offset);
+    if (code == 0)
+      break;
+    Abbrev abbrev;
+    abbrev.tag = m_data.GetULEB128(&offset);
+    while (offset < index.entry_pool_offset) {
+      const uint32_t idx = m_data.GetULEB128(&offset);
+      const dw_form_t form = m_data.GetULEB128(&offset);
+      if (idx == 0 && form == 0)
+        break;
+      abbrev.attributes.push_back(std::make_pair(idx, form));
+    }
+    index.abbrevs[code] = std::move(abbrev);
+  }
+
+  *offset_ptr = unit_end;
+  return true;
+}
+
+uint64_t DWARFDebugNames::ReadOffset(const NameIndex &index,
+                                     lldb::offset_t offset) const {
+  return m_data.GetMaxU64(&offset, index.offset_size);
+}
+
+const char *DWARFDebugNames::GetName(const NameIndex &index,
+                                     uint32_t name_idx) const {
+  const uint64_t str_offset = ReadOffset(
+      index, index.string_offsets_offset + (name_idx - 1) * index.offset_size);
+  return m_debug_str_data.PeekCStr(str_offset);
+}
+
+bool DWARFDebugNames::ReadFormValue(const NameIndex &index, dw_form_t form,
+                                    lldb::offset_t *offset_ptr,
+                                    uint64_t &value) const {
+  switch (form) {
+  case DW_FORM_flag_present:
+    value = 1;
+    return true;
+  case DW_FORM_data1:
+  case DW_FORM_ref1:
+  case DW_FORM_flag:
+    value = m_data.GetU8(offset_ptr);
+    return true;
+  case DW_FORM_data2:
+  case DW_FORM_ref2:
+    value = m_data.GetU16(offset_ptr);
+    return true;
+  case DW_FORM_data4:
+  case DW_FORM_ref4:
+    value = m_data.GetU32(offset_ptr);
+    return true;
+  case DW_FORM_data8:
+  case DW_FORM_ref8:
+  case DW_FORM_ref_sig8:
+    value = m_data.GetU64(offset_ptr);
+    return true;
+  case DW_FORM_udata:
+  case DW_FORM_ref_udata:
+    value = m_data.GetULEB128(offset_ptr);
+    return true;
+  case DW_FORM_sdata:
+    value = m_data.GetSLEB128(offset_ptr);
+    return true;
+  case DW_FORM_strp:
+  case DW_FORM_sec_offset:
+    value = m_data.GetMaxU64(offset_ptr, index.offset_size);
+    return true;
+  default:
+    return false;
+  }
+}
+
+void DWARFDebugNames::AppendEntries(const NameIndex &index, uint32_t name_idx,
+                                    llvm::ArrayRef<dw_tag_t> tags,
+                                    DIEArray &die_offsets) const {
+  lldb::offset_t offset =
+      index.entry_pool_offset +
+      ReadOffset(index, index.entry_offsets_offset +
+                            (name_idx - 1) * index.offset_size);
+  while (m_data.ValidOffset(offset)) {
+    const uint32_t code = m_data.GetULEB128(&offset);
+    if (code == 0)
+      break;
+    auto pos = index.abbrevs.find(code);
+    if (pos == index.abbrevs.end())
+      break;
+    const Abbrev &abbrev = pos->second;
+
+    // A name index that covers a single compile unit may omit
+    // DW_IDX_compile_unit.
+    uint64_t cu_idx = index.comp_unit_count == 1 ? 0 : UINT64_MAX;
+    uint64_t die_offset = UINT64_MAX;
+    bool in_type_unit = false;
+    for (const auto &attr : abbrev.attributes) {
+      uint64_t value = 0;
+      if (!ReadFormValue(index, attr.second, &offset, value))
+        return;
+      switch (attr.first) {
+      case eIndexCompileUnit:
+        cu_idx = value;
+        break;
+      case eIndexTypeUnit:
+        in_type_unit = true;
+        break;
+      case eIndexDIEOffset:
+        die_offset = value;
+        break;
+      default:
+        break;
+      }
+    }
+
+    if (in_type_unit || cu_idx >= index.comp_unit_count ||
+        die_offset == UINT64_MAX)
+      continue;
+    if (!tags.empty() &&
+        std::find(tags.begin(), tags.end(), abbrev.tag) == tags.end())
+      continue;
+
+    const dw_offset_t cu_offset = ReadOffset(
+        index, index.cu_list_offset + cu_idx * index.offset_size);
+    die_offsets.push_back(DIERef(cu_offset, cu_offset + die_offset));
+  }
+}
+
+size_t DWARFDebugNames::FindByName(llvm::StringRef name, DIEArray &die_offsets,
+                                   llvm::ArrayRef<dw_tag_t> tags) const {
+  const size_t initial_size = die_offsets.size();
+  if (name.empty())
+    return 0;
+
+  const bool is_ascii = std::all_of(name.begin(), name.end(), [](char c) {
+    return static_cast<unsigned char>(c) < 0x80;
+  });
+  const uint32_t hash = HashName(name);
+
+  for (const NameIndex &index : m_name_indexes) {
+    if (index.bucket_count == 0 || !is_ascii) {
+      // No usable hash table, compare every name in this index.
+      for (uint32_t name_idx = 1; name_idx <= index.name_count; ++name_idx) {
+        const char *index_name = GetName(index, name_idx);
+        if (index_name && name == index_name)
+          AppendEntries(index, name_idx, tags, die_offsets);
+      }
+      continue;
+    }
+
+    const uint32_t bucket = hash % index.bucket_count;
+    lldb::offset_t offset = index.buckets_offset + bucket * 4;
+    uint32_t name_idx = m_data.GetU32(&offset);
+    if (name_idx == 0)
+      continue;
+    for (; name_idx <= index.name_count; ++name_idx) {
+      offset = index.hashes_offset + (name_idx - 1) * 4;
+      const uint32_t name_hash = m_data.GetU32(&offset);
+      if (name_hash % index.bucket_count != bucket)
+        break;
+      if (name_hash != hash)
+        continue;
+      const char *index_name = GetName(index, name_idx);
+      if (index_name && name == index_name)
+        AppendEntries(index, name_idx, tags, die_offsets);
+    }
+  }
+  return die_offsets.size() - initial_size;
+}
+
+size_t DWARFDebugNames::AppendAllDIEsThatMatchingRegex(
+    const RegularExpression &regex, DIEArray &die_offsets,
+    llvm::ArrayRef<dw_tag_t> tags) const {
+  const size_t initial_size = die_offsets.size();
+  for (const NameIndex &index : m_name_indexes) {
+    for (uint32_t name_idx = 1; name_idx <= index.name_count; ++name_idx) {
+      const char *index_name = GetName(index, name_idx);
+      if (index_name && regex.Execute(llvm::StringRef(index_name)))
+        AppendEntries(index, name_idx, tags, die_offsets);
+    }
+  }
+  return die_offsets.size() - initial_size;
+}
@@ -0,0 +1,112 @@
+//===-- DWARFDebugNames.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFDebugNames_h_
+#define SymbolFileDWARF_DWARFDebugNames_h_
+
+#include <map>
+#include <vector>
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+
+#include "lldb/Core/dwarf.h"
+#include "lldb/lldb-private.h"
+
+#include "DIERef.h"
+#include "DWARFDataExtractor.h"
+
+//----------------------------------------------------------------------
+// DWARFDebugNames
+//
+// A reader for the DWARF v5 .debug_names accelerator table. The section
+// may contain several name indexes (one per compile unit if the linker
+// did not merge them); lookups consult each of them. Names are found
+// through the hash table when present, so a lookup only touches the
+// buckets and entries for that name and never needs to extract any
+// compile unit DIEs.
+//----------------------------------------------------------------------
+class DWARFDebugNames {
+public:
+  DWARFDebugNames(const lldb_private::DWARFDataExtractor &debug_names_data,
+                  const lldb_private::DWARFDataExtractor &debug_str_data);
+
+  //------------------------------------------------------------------
+  // Returns true if the section contained at least one name index and
+  // all of them could be parsed.
+  //------------------------------------------------------------------
+  bool IsValid() const { return m_is_valid; }
+
+  //------------------------------------------------------------------
+  // Append the DIEs named \a name to \a die_offsets. If \a tags is not
+  // empty, only DIEs with one of those tags are returned.
+  //------------------------------------------------------------------
+  size_t FindByName(llvm::StringRef name, DIEArray &die_offsets,
+                    llvm::ArrayRef<dw_tag_t> tags = {}) const;
+
+  size_t AppendAllDIEsThatMatchingRegex(
+      const lldb_private::RegularExpression &regex, DIEArray &die_offsets,
+      llvm::ArrayRef<dw_tag_t> tags = {}) const;
+
+  static uint32_t HashName(llvm::StringRef name);
+
+protected:
+  // DW_IDX_* index attribute encodings.
+  enum IndexAttribute : uint32_t {
+    eIndexCompileUnit = 1,
+    eIndexTypeUnit = 2,
+    eIndexDIEOffset = 3,
+    eIndexParent = 4,
+    eIndexTypeHash = 5
+  };
+
+  struct Abbrev {
+    dw_tag_t tag;
+    std::vector<std::pair<uint32_t, dw_form_t>> attributes;
+  };
+
+  struct NameIndex {
+    uint8_t offset_size;
+    uint32_t comp_unit_count;
+    uint32_t local_type_unit_count;
+    uint32_t bucket_count;
+    uint32_t name_count;
+    lldb::offset_t cu_list_offset;
+    lldb::offset_t buckets_offset;
+    lldb::offset_t hashes_offset;
+    lldb::offset_t string_offsets_offset;
+    lldb::offset_t entry_offsets_offset;
+    lldb::offset_t entry_pool_offset;
+    std::map<uint32_t, Abbrev> abbrevs;
+  };
+
+  bool ParseNameIndex(lldb::offset_t *offset_ptr, NameIndex &index);
+
+  uint64_t ReadOffset(const NameIndex &index, lldb::offset_t offset) const;
+
+  const char *GetName(const NameIndex &index, uint32_t name_idx) const;
+
+  bool ReadFormValue(const NameIndex &index, dw_form_t form,
+                     lldb::offset_t *offset_ptr, uint64_t &value) const;
+
+  // Append the entries of the 1 based name \a name_idx of \a index.
+  void AppendEntries(const NameIndex &index, uint32_t name_idx,
+                     llvm::ArrayRef<dw_tag_t> tags,
+                     DIEArray &die_offsets) const;
+
+  lldb_private::DWARFDataExtractor m_data;
+  lldb_private::DWARFDataExtractor m_debug_str_data;
+  std::vector<NameIndex> m_name_indexes;
+  bool m_is_valid;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DWARFDebugNames);
+};
+
+#endif // SymbolFileDWARF_DWARFDebugNames_h_
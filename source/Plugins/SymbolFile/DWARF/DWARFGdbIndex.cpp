@@ -0,0 +1,213 @@
+//===-- DWARFGdbIndex.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFGdbIndex.h"
+
+#include <algorithm>
+
+#include "Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
+#include "lldb/Utility/ConstString.h"
+
+#include "DWARFDebugAranges.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+// Each CU vector entry packs the index of a unit in the CU and TU lists
+// with the kind of the symbol.
+const uint32_t kCUIndexMask = 0x00ffffff;
+const uint32_t kSymbolKindShift = 28;
+const uint32_t kSymbolKindMask = 7;
+
+// Sizes of the entries in the CU list and address area.
+const uint32_t kCUListEntrySize = 16;
+const uint32_t kAddressAreaEntrySize = 20;
+
+llvm::StringRef GetBaseName(const char *name) {
+  llvm::StringRef context, identifier;
+  if (llvm::StringRef(name).contains("::") &&
+      CPlusPlusLanguage::ExtractContextAndIdentifier(name, context, identifier))
+    return identifier;
+  return name;
+}
+} // namespace
+
+DWARFGdbIndex::DWARFGdbIndex(const DWARFDataExtractor &data)
+    : m_data(data), m_version(0), m_address_area_offset(0),
+      m_symbol_table_offset(0), m_constant_pool_offset(0),
+      m_num_symbol_slots(0), m_cu_offsets(), m_sorted_cu_offsets(),
+      m_base_names(), m_is_valid(false) {
+  lldb::offset_t offset = 0;
+  if (!m_data.ValidOffsetForDataOfSize(offset, 24))
+    return;
+  m_version = m_data.GetU32(&offset);
+  // Version 5 introduced the hash function that is still in use, version 7
+  // added symbol kinds. Version 8 only differs in how gdb treats the
+  // contents.
+  if (m_version < 5 || m_version > 8)
+    return;
+
+  const lldb::offset_t cu_list_offset = m_data.GetU32(&offset);
+  const lldb::offset_t types_cu_list_offset = m_data.GetU32(&offset);
+  m_address_area_offset = m_data.GetU32(&offset);
+  m_symbol_table_offset = m_data.GetU32(&offset);
+  m_constant_pool_offset = m_data.GetU32(&offset);
+  if (cu_list_offset > types_cu_list_offset ||
+      types_cu_list_offset > m_address_area_offset ||
+      m_address_area_offset > m_symbol_table_offset ||
+      m_symbol_table_offset > m_constant_pool_offset ||
+      m_constant_pool_offset > m_data.GetByteSize())
+    return;
+
+  m_num_symbol_slots = (m_constant_pool_offset - m_symbol_table_offset) / 8;
+  // The symbol table is an open addressed hash table whose size is a
+  // power of two.
+  if (m_num_symbol_slots & (m_num_symbol_slots - 1))
+    return;
+
+  const uint32_t num_cus =
+      (types_cu_list_offset - cu_list_offset) / kCUListEntrySize;
+  m_cu_offsets.reserve(num_cus);
+  offset = cu_list_offset;
+  for (uint32_t i = 0; i < num_cus; ++i) {
+    m_cu_offsets.push_back(m_data.GetU64(&offset));
+    m_data.GetU64(&offset); // Length
+  }
+  m_sorted_cu_offsets = m_cu_offsets;
+  std::sort(m_sorted_cu_offsets.begin(), m_sorted_cu_offsets.end());
+  m_is_valid = true;
+}
+
+uint32_t DWARFGdbIndex::HashName(llvm::StringRef name) {
+  // This is mapped_index_string_hash() from gdb, which folds the name to
+  // lower case since version 5.
+  uint32_t h = 0;
+  for (unsigned char c : name) {
+    if (c >= 'A' && c <= 'Z')
+      c = c - 'A' + 'a';
+    h = h * 67 + c - 113;
+  }
+  return h;
+}
+
+bool DWARFGdbIndex::ContainsCompileUnit(dw_offset_t cu_offset) const {
+  return std::binary_search(m_sorted_cu_offsets.begin(),
+                            m_sorted_cu_offsets.end(), cu_offset);
+}
+
+uint32_t DWARFGdbIndex::FindSymbol(llvm::StringRef name) const {
+  if (m_num_symbol_slots == 0)
+    return UINT32_MAX;
+
+  const uint32_t mask = m_num_symbol_slots - 1;
+  const uint32_t hash = HashName(name);
+  const uint32_t step = ((hash * 17) & mask) | 1;
+  uint32_t slot = hash & mask;
+  for (uint32_t i = 0; i < m_num_symbol_slots; ++i) {
+    lldb::offset_t offset = m_symbol_table_offset + slot * 8;
+    const uint32_t name_offset = m_data.GetU32(&offset);
+    const uint32_t cu_vector_offset = m_data.GetU32(&offset);
+    if (name_offset == 0 && cu_vector_offset == 0)
+      break;
+    const char *symbol_name =
+        m_data.PeekCStr(m_constant_pool_offset + name_offset);
+    if (symbol_name && name == symbol_name)
+      return cu_vector_offset;
+    slot = (slot + step) & mask;
+  }
+  return UINT32_MAX;
+}
+
+void DWARFGdbIndex::AppendCompileUnits(
+    uint32_t cu_vector_offset, SymbolKind kind,
+    std::vector<dw_offset_t> &cu_offsets) const {
+  lldb::offset_t offset = m_constant_pool_offset + cu_vector_offset;
+  const uint32_t count = m_data.GetU32(&offset);
+  if (!m_data.ValidOffsetForDataOfSize(offset, count * 4ull))
+    return;
+  for (uint32_t i = 0; i < count; ++i) {
+    const uint32_t value = m_data.GetU32(&offset);
+    const uint32_t cu_idx = value & kCUIndexMask;
+    const uint32_t symbol_kind = (value >> kSymbolKindShift) & kSymbolKindMask;
+    // Type units follow the compile units in the index space.
+    if (cu_idx >= m_cu_offsets.size())
+      continue;
+    if (kind != eSymbolKindNone && symbol_kind != eSymbolKindNone &&
+        symbol_kind != kind)
+      continue;
+    cu_offsets.push_back(m_cu_offsets[cu_idx]);
+  }
+}
+
+void DWARFGdbIndex::BuildBaseNameTable() {
+  for (uint32_t slot = 0; slot < m_num_symbol_slots; ++slot) {
+    lldb::offset_t offset = m_symbol_table_offset + slot * 8;
+    const uint32_t name_offset = m_data.GetU32(&offset);
+    const uint32_t cu_vector_offset = m_data.GetU32(&offset);
+    if (name_offset == 0 && cu_vector_offset == 0)
+      continue;
+    const char *symbol_name =
+        m_data.PeekCStr(m_constant_pool_offset + name_offset);
+    if (symbol_name && symbol_name[0])
+      m_base_names.Append(ConstString(GetBaseName(symbol_name)),
+                          cu_vector_offset);
+  }
+  m_base_names.Sort();
+  m_base_names.SizeToFit();
+}
+
+size_t DWARFGdbIndex::FindCompileUnits(llvm::StringRef name, SymbolKind kind,
+                                       std::vector<dw_offset_t> &cu_offsets) {
+  const size_t initial_size = cu_offsets.size();
+  if (name.empty())
+    return 0;
+
+  std::vector<uint32_t> cu_vector_offsets;
+  if (name.contains("::")) {
+    const uint32_t cu_vector_offset = FindSymbol(name);
+    if (cu_vector_offset != UINT32_MAX)
+      cu_vector_offsets.push_back(cu_vector_offset);
+  }
+  if (cu_vector_offsets.empty()) {
+    llvm::call_once(m_base_names_once_flag,
+                    [this]() { BuildBaseNameTable(); });
+    const std::string name_str = name.str();
+    m_base_names.GetValues(ConstString(GetBaseName(name_str.c_str())),
+                           cu_vector_offsets);
+  }
+
+  for (uint32_t cu_vector_offset : cu_vector_offsets)
+    AppendCompileUnits(cu_vector_offset, kind, cu_offsets);
+
+  std::sort(cu_offsets.begin() + initial_size, cu_offsets.end());
+  cu_offsets.erase(
+      std::unique(cu_offsets.begin() + initial_size, cu_offsets.end()),
+      cu_offsets.end());
+  return cu_offsets.size() - initial_size;
+}
+
+void DWARFGdbIndex::AppendAddressRanges(
+    DWARFDebugAranges &aranges, std::set<dw_offset_t> &cus_with_data) const {
+  std::set<dw_offset_t> added_cus;
+  lldb::offset_t offset = m_address_area_offset;
+  while (offset + kAddressAreaEntrySize <= m_symbol_table_offset) {
+    const dw_addr_t low_pc = m_data.GetU64(&offset);
+    const dw_addr_t high_pc = m_data.GetU64(&offset);
+    const uint32_t cu_idx = m_data.GetU32(&offset);
+    if (cu_idx >= m_cu_offsets.size() || low_pc >= high_pc)
+      continue;
+    const dw_offset_t cu_offset = m_cu_offsets[cu_idx];
+    if (cus_with_data.count(cu_offset))
+      continue;
+    aranges.AppendRange(cu_offset, low_pc, high_pc);
+    added_cus.insert(cu_offset);
+  }
+  cus_with_data.insert(added_cus.begin(), added_cus.end());
+}
@@ -0,0 +1,119 @@
+//===-- DWARFGdbIndex.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFGdbIndex_h_
+#define SymbolFileDWARF_DWARFGdbIndex_h_
+
+#include <set>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Threading.h"
+
+#include "lldb/Core/UniqueCStringMap.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/lldb-private.h"
+
+#include "DWARFDataExtractor.h"
+
+class DWARFDebugAranges;
+
+//----------------------------------------------------------------------
+// DWARFGdbIndex
+//
+// A reader for the .gdb_index section that gold and lld emit when linking
+// with --gdb-index. The section maps every global name to the list of
+// compile units that define it, and every address range to its compile
+// unit. Unlike the Apple and DWARF v5 accelerator tables it does not name
+// individual DIEs, so SymbolFileDWARF uses it to find out which compile
+// units it has to index for a given name instead of indexing them all.
+//
+// The symbol table holds qualified names without parameter lists
+// ("ns::Class::method"). Lookups by a base name ("method") are answered
+// from a base name table that is built from the symbol table the first
+// time it is needed.
+//----------------------------------------------------------------------
+class DWARFGdbIndex {
+public:
+  // The kind of a symbol, stored in the CU vectors of version 7 and
+  // later. Older versions always use eSymbolKindNone.
+  enum SymbolKind : uint8_t {
+    eSymbolKindNone = 0,
+    eSymbolKindType = 1,
+    eSymbolKindVariable = 2,
+    eSymbolKindFunction = 3,
+    eSymbolKindOther = 4
+  };
+
+  DWARFGdbIndex(const lldb_private::DWARFDataExtractor &data);
+
+  //------------------------------------------------------------------
+  // Returns true if the section has a version we understand and all of
+  // its areas are inside the section.
+  //------------------------------------------------------------------
+  bool IsValid() const { return m_is_valid; }
+
+  uint32_t GetVersion() const { return m_version; }
+
+  uint32_t GetNumCompileUnits() const { return m_cu_offsets.size(); }
+
+  //------------------------------------------------------------------
+  // Returns true if the CU list describes the compile unit at
+  // \a cu_offset in .debug_info.
+  //------------------------------------------------------------------
+  bool ContainsCompileUnit(dw_offset_t cu_offset) const;
+
+  //------------------------------------------------------------------
+  // Append the .debug_info offsets of the compile units that define
+  // \a name to \a cu_offsets. A qualified name is looked up in the
+  // symbol table as is; if it is not there, or if \a name is not
+  // qualified, every symbol with the same base name matches. If \a kind
+  // is not eSymbolKindNone, symbols of other kinds are skipped.
+  //------------------------------------------------------------------
+  size_t FindCompileUnits(llvm::StringRef name, SymbolKind kind,
+                          std::vector<dw_offset_t> &cu_offsets);
+
+  //------------------------------------------------------------------
+  // Append the address area ranges of every compile unit that is not in
+  // \a cus_with_data to \a aranges and add those compile units to
+  // \a cus_with_data.
+  //------------------------------------------------------------------
+  void AppendAddressRanges(DWARFDebugAranges &aranges,
+                           std::set<dw_offset_t> &cus_with_data) const;
+
+  static uint32_t HashName(llvm::StringRef name);
+
+protected:
+  // Returns the constant pool offset of the CU vector for \a name, or
+  // UINT32_MAX if the symbol table does not contain \a name.
+  uint32_t FindSymbol(llvm::StringRef name) const;
+
+  void AppendCompileUnits(uint32_t cu_vector_offset, SymbolKind kind,
+                          std::vector<dw_offset_t> &cu_offsets) const;
+
+  void BuildBaseNameTable();
+
+  lldb_private::DWARFDataExtractor m_data;
+  uint32_t m_version;
+  lldb::offset_t m_address_area_offset;
+  lldb::offset_t m_symbol_table_offset;
+  lldb::offset_t m_constant_pool_offset;
+  uint32_t m_num_symbol_slots;
+  std::vector<dw_offset_t> m_cu_offsets;
+  std::vector<dw_offset_t> m_sorted_cu_offsets;
+  // Maps the base name of every symbol to its CU vector.
+  lldb_private::UniqueCStringMap<uint32_t> m_base_names;
+  llvm::once_flag m_base_names_once_flag;
+  bool m_is_valid;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DWARFGdbIndex);
+};
+
+#endif // SymbolFileDWARF_DWARFGdbIndex_h_
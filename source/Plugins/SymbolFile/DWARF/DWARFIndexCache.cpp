@@ -0,0 +1,234 @@
+//===-- DWARFIndexCache.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFIndexCache.h"
+
+#include <algorithm>
+
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/DataBufferLLVM.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Log.h"
+#include "lldb/Utility/StreamString.h"
+#include "lldb/Utility/UUID.h"
+
+#include "LogChannelDWARF.h"
+#include "NameToDIE.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+const uint32_t kCacheMagic = 0x5844444c; // "LDDX"
+const uint32_t kCacheVersion = 2;
+const char *kCacheFileExtension = ".dwarf-index";
+
+struct CacheFileInfo {
+  std::string path;
+  uint64_t byte_size;
+  llvm::sys::TimePoint<> mod_time;
+};
+
+// Bump the modification time of a cache entry when it is used so that
+// Prune() can evict the least recently used entries first. Access times
+// are not reliable since many file systems are mounted with noatime.
+void TouchCacheFile(const std::string &path) {
+  int fd = -1;
+  if (llvm::sys::fs::openFileForWrite(path, fd, llvm::sys::fs::F_Append))
+    return;
+  llvm::sys::fs::setLastModificationAndAccessTime(
+      fd, std::chrono::system_clock::now());
+  llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+}
+
+} // namespace
+
+DWARFIndexCache::DWARFIndexCache(const FileSpec &cache_dir,
+                                 uint64_t max_byte_size)
+    : m_cache_dir(cache_dir), m_max_byte_size(max_byte_size) {}
+
+bool DWARFIndexCache::GetCacheEntry(ObjectFile &objfile, FileSpec &entry_spec,
+                                    EntryKey &key) {
+  UUID uuid;
+  if (!m_cache_dir || !objfile.GetUUID(&uuid) || !uuid.IsValid())
+    return false;
+
+  // A stripped binary and its separate debug file share a UUID, so the
+  // path is part of the entry's name, and is checked along with the size
+  // and the full resolution modification time to notice rebuilds.
+  key.path = objfile.GetFileSpec().GetPath();
+  llvm::sys::fs::file_status status;
+  if (key.path.empty() || llvm::sys::fs::status(key.path, status))
+    return false;
+  key.mod_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     status.getLastModificationTime().time_since_epoch())
+                     .count();
+  key.byte_size = status.getSize();
+
+  llvm::MD5 md5;
+  md5.update(key.path);
+  llvm::MD5::MD5Result md5_result;
+  md5.final(md5_result);
+  llvm::SmallString<32> path_hash;
+  llvm::MD5::stringifyResult(md5_result, path_hash);
+
+  entry_spec = m_cache_dir;
+  entry_spec.AppendPathComponent(uuid.GetAsString("") + "-" +
+                                 path_hash.str().str() + kCacheFileExtension);
+  return true;
+}
+
+bool DWARFIndexCache::Load(ObjectFile &objfile,
+                           const std::vector<NameToDIE *> &indexes) {
+  FileSpec entry_spec;
+  EntryKey key;
+  if (!GetCacheEntry(objfile, entry_spec, key) || !entry_spec.Exists())
+    return false;
+
+  const std::string path = entry_spec.GetPath();
+  // Large entries are mapped into memory rather than read.
+  auto data_sp = DataBufferLLVM::CreateFromPath(path);
+  if (!data_sp)
+    return false;
+
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  DataExtractor data(data_sp, eByteOrderLittle, 4);
+  lldb::offset_t offset = 0;
+  const char *entry_path = nullptr;
+  if (!data.ValidOffsetForDataOfSize(offset, 24) ||
+      data.GetU32(&offset) != kCacheMagic ||
+      data.GetU32(&offset) != kCacheVersion ||
+      data.GetU64(&offset) != key.mod_time ||
+      data.GetU64(&offset) != key.byte_size ||
+      !(entry_path = data.GetCStr(&offset)) || key.path != entry_path ||
+      !data.ValidOffsetForDataOfSize(offset, 4) ||
+      data.GetU32(&offset) != indexes.size()) {
+    if (log)
+      log->Printf("DWARF index cache entry '%s' is stale", path.c_str());
+    return false;
+  }
+
+  for (NameToDIE *index : indexes) {
+    if (!index->Decode(data, &offset)) {
+      if (log)
+        log->Printf("DWARF index cache entry '%s' is corrupt", path.c_str());
+      for (NameToDIE *clear_index : indexes)
+        *clear_index = NameToDIE();
+      return false;
+    }
+  }
+  for (NameToDIE *index : indexes)
+    index->Finalize();
+
+  TouchCacheFile(path);
+  if (log)
+    log->Printf("loaded DWARF index for '%s' from cache entry '%s'",
+                objfile.GetFileSpec().GetPath().c_str(), path.c_str());
+  return true;
+}
+
+bool DWARFIndexCache::Save(ObjectFile &objfile,
+                           const std::vector<NameToDIE *> &indexes) {
+  namespace fs = llvm::sys::fs;
+
+  FileSpec entry_spec;
+  EntryKey key;
+  if (!GetCacheEntry(objfile, entry_spec, key))
+    return false;
+
+  if (fs::create_directories(m_cache_dir.GetPath(), true,
+                             fs::perms::owner_all))
+    return false;
+
+  StreamString strm(Stream::eBinary, 4, eByteOrderLittle);
+  strm.PutHex32(kCacheMagic);
+  strm.PutHex32(kCacheVersion);
+  strm.PutHex64(key.mod_time);
+  strm.PutHex64(key.byte_size);
+  strm.PutCString(key.path);
+  strm.PutHex32(indexes.size());
+  for (const NameToDIE *index : indexes)
+    index->Encode(strm);
+
+  if (strm.GetSize() > m_max_byte_size)
+    return false;
+
+  // Write to a temporary file and rename it into place so concurrent
+  // debug sessions never observe a partially written entry.
+  const std::string path = entry_spec.GetPath();
+  int fd = -1;
+  llvm::SmallString<128> temp_path;
+  if (fs::createUniqueFile(path + "-%%%%%%.tmp", fd, temp_path))
+    return false;
+  {
+    llvm::raw_fd_ostream os(fd, true);
+    os << strm.GetString();
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      fs::remove(temp_path);
+      return false;
+    }
+  }
+  if (fs::rename(temp_path, path)) {
+    fs::remove(temp_path);
+    return false;
+  }
+
+  Prune();
+  return true;
+}
+
+void DWARFIndexCache::Prune() {
+  namespace fs = llvm::sys::fs;
+
+  std::vector<CacheFileInfo> entries;
+  uint64_t total_byte_size = 0;
+  std::error_code EC;
+  fs::directory_iterator Iter(m_cache_dir.GetPath(), EC);
+  fs::directory_iterator End;
+  for (; Iter != End && !EC; Iter.increment(EC)) {
+    const std::string &path = Iter->path();
+    if (llvm::sys::path::extension(path) != kCacheFileExtension)
+      continue;
+    fs::file_status status;
+    if (Iter->status(status) || !fs::is_regular_file(status))
+      continue;
+    entries.push_back({path, status.getSize(),
+                       status.getLastModificationTime()});
+    total_byte_size += status.getSize();
+  }
+
+  if (total_byte_size <= m_max_byte_size)
+    return;
+
+  std::sort(entries.begin(), entries.end(),
+            [](const CacheFileInfo &lhs, const CacheFileInfo &rhs) {
+              return lhs.mod_time < rhs.mod_time;
+            });
+
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  for (const CacheFileInfo &entry : entries) {
+    if (total_byte_size <= m_max_byte_size)
+      break;
+    if (fs::remove(entry.path))
+      continue;
+    total_byte_size -= entry.byte_size;
+    if (log)
+      log->Printf("evicted DWARF index cache entry '%s'", entry.path.c_str());
+  }
+}
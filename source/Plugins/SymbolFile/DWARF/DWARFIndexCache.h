@@ -0,0 +1,78 @@
+//===-- DWARFIndexCache.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFIndexCache_h_
+#define SymbolFileDWARF_DWARFIndexCache_h_
+
+#include <string>
+#include <vector>
+
+#include "lldb/Utility/FileSpec.h"
+#include "lldb/lldb-private.h"
+
+class NameToDIE;
+
+//----------------------------------------------------------------------
+// DWARFIndexCache
+//
+// A persistent, on disk cache of the NameToDIE tables that
+// SymbolFileDWARF::Index() builds when no accelerator tables are
+// available. Entries are keyed by the UUID and path of the object file
+// and validated against its size and modification time, so a second
+// debug session for the same binary can skip walking every DIE of every
+// compile unit.
+//
+// The total size of the cache directory is capped; when a new entry
+// pushes it over the limit, the least recently used entries are removed.
+//----------------------------------------------------------------------
+class DWARFIndexCache {
+public:
+  DWARFIndexCache(const lldb_private::FileSpec &cache_dir,
+                  uint64_t max_byte_size);
+
+  //------------------------------------------------------------------
+  // Fill in \a indexes from the cache entry for \a objfile. Returns
+  // false if there is no valid entry, in which case \a indexes are
+  // left empty.
+  //------------------------------------------------------------------
+  bool Load(lldb_private::ObjectFile &objfile,
+            const std::vector<NameToDIE *> &indexes);
+
+  //------------------------------------------------------------------
+  // Write \a indexes out as the cache entry for \a objfile and evict
+  // old entries if the cache grew over its size limit.
+  //------------------------------------------------------------------
+  bool Save(lldb_private::ObjectFile &objfile,
+            const std::vector<NameToDIE *> &indexes);
+
+  //------------------------------------------------------------------
+  // Remove the least recently used entries until the cache fits in
+  // the configured size limit.
+  //------------------------------------------------------------------
+  void Prune();
+
+protected:
+  // What a cache entry records about the object file it was built from.
+  struct EntryKey {
+    std::string path;
+    uint64_t mod_time = 0; // In nanoseconds
+    uint64_t byte_size = 0;
+  };
+
+  bool GetCacheEntry(lldb_private::ObjectFile &objfile,
+                     lldb_private::FileSpec &entry_spec, EntryKey &key);
+
+  lldb_private::FileSpec m_cache_dir;
+  uint64_t m_max_byte_size;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DWARFIndexCache);
+};
+
+#endif // SymbolFileDWARF_DWARFIndexCache_h_
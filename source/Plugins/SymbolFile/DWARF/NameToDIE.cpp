@@ -10,6 +10,7 @@
 #include "NameToDIE.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
@@ -27,6 +28,11 @@ void NameToDIE::Finalize() {
   m_map.SizeToFit();
 }
 
+void NameToDIE::Finalize(size_t num_sorted) {
+  m_map.SortAppended(num_sorted);
+  m_map.SizeToFit();
+}
+
 void NameToDIE::Insert(const ConstString &name, const DIERef &die_ref) {
   m_map.Append(name, die_ref);
 }
@@ -80,3 +86,35 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+void NameToDIE::Encode(Stream &strm) const {
+  const uint32_t size = m_map.GetSize();
+  strm.PutHex32(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    llvm::StringRef name = m_map.GetCStringAtIndexUnchecked(i).GetStringRef();
+    const DIERef &die_ref = m_map.GetValueRefAtIndexUnchecked(i);
+    strm.PutCString(name);
+    strm.PutHex32(die_ref.cu_offset);
+    strm.PutHex32(die_ref.die_offset);
+  }
+}
+
+bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr) {
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, 4))
+    return false;
+  const uint32_t size = data.GetU32(offset_ptr);
+  // Every entry takes at least 9 bytes, so reject obviously bogus counts
+  // before reserving memory for them.
+  if (size > data.BytesLeft(*offset_ptr) / 9)
+    return false;
+  m_map.Reserve(m_map.GetSize() + size);
+  for (uint32_t i = 0; i < size; ++i) {
+    const char *name = data.GetCStr(offset_ptr);
+    if (name == nullptr || !data.ValidOffsetForDataOfSize(*offset_ptr, 8))
+      return false;
+    const dw_offset_t cu_offset = data.GetU32(offset_ptr);
+    const dw_offset_t die_offset = data.GetU32(offset_ptr);
+    m_map.Append(ConstString(name), DIERef(cu_offset, die_offset));
+  }
+  return true;
+}
@@ -33,6 +33,14 @@ public:
 
   void Finalize();
 
+  //------------------------------------------------------------------
+  // Finalize a map whose first \a num_sorted entries were finalized
+  // before more entries were appended to it.
+  //------------------------------------------------------------------
+  void Finalize(size_t num_sorted);
+
+  size_t GetSize() const { return m_map.GetSize(); }
+
   size_t Find(const lldb_private::ConstString &name,
               DIEArray &info_array) const;
 
@@ -47,6 +55,16 @@ public:
                              const DIERef &die_ref)> const
               &callback) const;
 
+  //------------------------------------------------------------------
+  // Serialize the map into a binary stream so it can be saved in the
+  // on disk index cache, and read it back again. Decode() appends to
+  // the current contents; call Finalize() when done.
+  //------------------------------------------------------------------
+  void Encode(lldb_private::Stream &strm) const;
+
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr);
+
 protected:
   lldb_private::UniqueCStringMap<DIERef> m_map;
 };
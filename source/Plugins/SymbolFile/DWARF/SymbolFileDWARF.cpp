@@ -52,6 +52,7 @@
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 
 #include "lldb/Target/Language.h"
+#include "lldb/Target/Platform.h"
 
 #include "lldb/Host/TaskPool.h"
 
@@ -64,10 +65,12 @@
 #include "DWARFDebugInfo.h"
 #include "DWARFDebugLine.h"
 #include "DWARFDebugMacro.h"
+#include "DWARFDebugNames.h"
 #include "DWARFDebugPubnames.h"
 #include "DWARFDebugRanges.h"
 #include "DWARFDeclContext.h"
 #include "DWARFFormValue.h"
+#include "DWARFIndexCache.h"
 #include "LogChannelDWARF.h"
 #include "SymbolFileDWARFDebugMap.h"
 #include "SymbolFileDWARFDwo.h"
@@ -75,7 +78,9 @@
 
 #include "llvm/Support/FileSystem.h"
 
+#include <condition_variable>
 #include <map>
+#include <numeric>
 
 #include <ctype.h>
 #include <string.h>
@@ -116,9 +121,30 @@ PropertyDefinition g_properties[] = {
     {"comp-dir-symlink-paths", OptionValue::eTypeFileSpecList, true, 0, nullptr,
      nullptr, "If the DW_AT_comp_dir matches any of these paths the symbolic "
               "links will be resolved at DWARF parse time."},
+    {"enable-index-cache", OptionValue::eTypeBoolean, true, false, nullptr,
+     nullptr, "Save the name indexes built for DWARF without accelerator "
+              "tables to disk, and reuse them in later debug sessions."},
+    {"index-cache-path", OptionValue::eTypeFileSpec, true, 0, nullptr,
+     nullptr, "Directory in which the DWARF name index cache is stored. "
+              "Defaults to a \"dwarf-index\" directory inside "
+              "platform.module-cache-directory."},
+    {"index-cache-max-size", OptionValue::eTypeUInt64, true,
+     1024 * 1024 * 1024, nullptr, nullptr,
+     "Maximum size in bytes of the DWARF name index cache. The least "
+     "recently used entries are removed when the cache grows past it."},
+    {"index-memory-budget", OptionValue::eTypeUInt64, true, 0, nullptr,
+     nullptr, "Approximate number of bytes of DIEs that DWARF indexing may "
+              "keep in memory at once. Compile units wait for others to "
+              "finish when the budget is used up. 0 means no limit."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
-enum { ePropertySymLinkPaths };
+enum {
+  ePropertySymLinkPaths,
+  ePropertyEnableIndexCache,
+  ePropertyIndexCachePath,
+  ePropertyIndexCacheMaxSize,
+  ePropertyIndexMemoryBudget
+};
 
 class PluginProperties : public Properties {
 public:
@@ -138,6 +164,36 @@ public:
     assert(option_value);
     return option_value->GetCurrentValue();
   }
+
+  bool GetEnableIndexCache() const {
+    const uint32_t idx = ePropertyEnableIndexCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+  }
+
+  FileSpec GetIndexCachePath() const {
+    FileSpec cache_dir = m_collection_sp->GetPropertyAtIndexAsFileSpec(
+        nullptr, ePropertyIndexCachePath);
+    if (cache_dir)
+      return cache_dir;
+    cache_dir =
+        Platform::GetGlobalPlatformProperties()->GetModuleCacheDirectory();
+    if (cache_dir)
+      cache_dir.AppendPathComponent("dwarf-index");
+    return cache_dir;
+  }
+
+  uint64_t GetIndexCacheMaxSize() const {
+    const uint32_t idx = ePropertyIndexCacheMaxSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(
+        nullptr, idx, g_properties[idx].default_uint_value);
+  }
+
+  uint64_t GetIndexMemoryBudget() const {
+    const uint32_t idx = ePropertyIndexMemoryBudget;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(
+        nullptr, idx, g_properties[idx].default_uint_value);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -147,8 +203,65 @@ static const SymbolFileDWARFPropertiesSP &GetGlobalPluginProperties() {
   return g_settings_sp;
 }
 
+//----------------------------------------------------------------------
+// Limits the memory taken by the DIEs of the compile units that are being
+// indexed at the same time. A compile unit is always admitted when no
+// other one is in flight, so a single one that is larger than the budget
+// cannot stall indexing.
+//----------------------------------------------------------------------
+class IndexMemoryBudget {
+public:
+  explicit IndexMemoryBudget(uint64_t byte_size)
+      : m_byte_size(byte_size), m_bytes_in_use(0) {}
+
+  void Acquire(uint64_t byte_size) {
+    if (m_byte_size == 0)
+      return;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this, byte_size] {
+      return m_bytes_in_use == 0 || m_bytes_in_use + byte_size <= m_byte_size;
+    });
+    m_bytes_in_use += byte_size;
+  }
+
+  void Release(uint64_t byte_size) {
+    if (m_byte_size == 0)
+      return;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_bytes_in_use -= byte_size;
+    }
+    m_condition.notify_all();
+  }
+
+private:
+  const uint64_t m_byte_size;
+  uint64_t m_bytes_in_use;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+};
+
+// The extracted DIEs of a compile unit take about twice the space of its
+// .debug_info contents. This only needs to be good enough to pace indexing.
+uint64_t EstimateDIEByteSize(const DWARFCompileUnit *dwarf_cu) {
+  return 2 * uint64_t(dwarf_cu->GetNextCompileUnitOffset() -
+                      dwarf_cu->GetOffset());
+}
+
 } // anonymous namespace end
 
+// DIE tags to look for in the .debug_names table for each kind of lookup.
+// These mirror what DWARFCompileUnit::Index() puts into each NameToDIE.
+static const dw_tag_t g_debug_names_function_tags[] = {
+    DW_TAG_subprogram, DW_TAG_inlined_subroutine};
+static const dw_tag_t g_debug_names_variable_tags[] = {DW_TAG_variable};
+static const dw_tag_t g_debug_names_type_tags[] = {
+    DW_TAG_array_type,     DW_TAG_base_type,        DW_TAG_class_type,
+    DW_TAG_constant,       DW_TAG_enumeration_type, DW_TAG_string_type,
+    DW_TAG_structure_type, DW_TAG_subroutine_type,  DW_TAG_typedef,
+    DW_TAG_union_type,     DW_TAG_unspecified_type};
+static const dw_tag_t g_debug_names_namespace_tags[] = {DW_TAG_namespace};
+
 static const char *removeHostnameFromPathname(const char *path_from_dwarf) {
   if (!path_from_dwarf || !path_from_dwarf[0]) {
     return path_from_dwarf;
@@ -396,11 +509,13 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile *objfile)
       m_data_debug_ranges(), m_data_debug_str(), m_data_apple_names(),
       m_data_apple_types(), m_data_apple_namespaces(), m_abbr(), m_info(),
       m_line(), m_apple_names_ap(), m_apple_types_ap(), m_apple_namespaces_ap(),
-      m_apple_objc_ap(), m_function_basename_index(),
-      m_function_fullname_index(), m_function_method_index(),
-      m_function_selector_index(), m_objc_class_selectors_index(),
-      m_global_index(), m_type_index(), m_namespace_index(), m_indexed(false),
-      m_using_apple_tables(false), m_fetched_external_modules(false),
+      m_apple_objc_ap(), m_debug_names_ap(), m_gdb_index_ap(),
+      m_function_basename_index(), m_function_fullname_index(),
+      m_function_method_index(), m_function_selector_index(),
+      m_objc_class_selectors_index(), m_global_index(), m_type_index(),
+      m_namespace_index(), m_indexed(false), m_using_apple_tables(false),
+      m_fetched_external_modules(false), m_indexed_compile_units(),
+      m_indexed_uncovered_compile_units(false),
       m_supports_DW_AT_APPLE_objc_complete_type(eLazyBoolCalculate), m_ranges(),
       m_unique_ast_type_map() {}
 
@@ -484,6 +599,28 @@ void SymbolFileDWARF::InitializeObject() {
     else
       m_apple_objc_ap.reset();
   }
+
+  // The Apple tables take precedence, they describe more than .debug_names.
+  if (!m_using_apple_tables) {
+    get_debug_names_data();
+    if (m_data_debug_names.m_data.GetByteSize() > 0) {
+      m_debug_names_ap.reset(new DWARFDebugNames(m_data_debug_names.m_data,
+                                                 get_debug_str_data()));
+      if (!m_debug_names_ap->IsValid())
+        m_debug_names_ap.reset();
+    }
+  }
+
+  // A .gdb_index only tells us which compile units to index for a name, so
+  // it is used when there are no tables that name the DIEs themselves.
+  if (!m_using_apple_tables && !m_debug_names_ap) {
+    get_gdb_index_data();
+    if (m_data_gdb_index.m_data.GetByteSize() > 0) {
+      m_gdb_index_ap.reset(new DWARFGdbIndex(m_data_gdb_index.m_data));
+      if (!m_gdb_index_ap->IsValid())
+        m_gdb_index_ap.reset();
+    }
+  }
 }
 
 bool SymbolFileDWARF::SupportedVersion(uint16_t version) {
@@ -661,6 +798,14 @@ const DWARFDataExtractor &SymbolFileDWARF::get_debug_str_offsets_data() {
                               m_data_debug_str_offsets);
 }
 
+const DWARFDataExtractor &SymbolFileDWARF::get_debug_names_data() {
+  return GetCachedSectionData(eSectionTypeDWARFDebugNames, m_data_debug_names);
+}
+
+const DWARFDataExtractor &SymbolFileDWARF::get_gdb_index_data() {
+  return GetCachedSectionData(eSectionTypeDWARFGdbIndex, m_data_gdb_index);
+}
+
 const DWARFDataExtractor &SymbolFileDWARF::get_apple_names_data() {
   return GetCachedSectionData(eSectionTypeDWARFAppleNames, m_data_apple_names);
 }
@@ -1014,6 +1159,26 @@ static void ParseDWARFLineTableCallback(dw_offset_t offset,
   }
 }
 
+static lldb::addr_t GetLineTableAddressMask(ObjectFile *objfile) {
+  /*
+   * MIPS:
+   * The SymbolContext may not have a valid target, thus we may not be able
+   * to call Address::GetOpcodeLoadAddress() which would clear the bit #0
+   * for MIPS. Use ArchSpec to clear the bit #0.
+  */
+  ArchSpec arch;
+  objfile->GetArchitecture(arch);
+  switch (arch.GetMachine()) {
+  case llvm::Triple::mips:
+  case llvm::Triple::mipsel:
+  case llvm::Triple::mips64:
+  case llvm::Triple::mips64el:
+    return ~((lldb::addr_t)1);
+  default:
+    return ~((lldb::addr_t)0);
+  }
+}
+
 bool SymbolFileDWARF::ParseCompileUnitLineTable(const SymbolContext &sc) {
   assert(sc.comp_unit);
   if (sc.comp_unit->GetLineTable() != NULL)
@@ -1031,28 +1196,7 @@ bool SymbolFileDWARF::ParseCompileUnitLineTable(const SymbolContext &sc) {
         if (line_table_ap.get()) {
           ParseDWARFLineTableCallbackInfo info;
           info.line_table = line_table_ap.get();
-
-          /*
-           * MIPS:
-           * The SymbolContext may not have a valid target, thus we may not be
-           * able
-           * to call Address::GetOpcodeLoadAddress() which would clear the bit
-           * #0
-           * for MIPS. Use ArchSpec to clear the bit #0.
-          */
-          ArchSpec arch;
-          GetObjectFile()->GetArchitecture(arch);
-          switch (arch.GetMachine()) {
-          case llvm::Triple::mips:
-          case llvm::Triple::mipsel:
-          case llvm::Triple::mips64:
-          case llvm::Triple::mips64el:
-            info.addr_mask = ~((lldb::addr_t)1);
-            break;
-          default:
-            info.addr_mask = ~((lldb::addr_t)0);
-            break;
-          }
+          info.addr_mask = GetLineTableAddressMask(GetObjectFile());
 
           lldb::offset_t offset = cu_line_offset;
           DWARFDebugLine::ParseStatementTable(get_debug_line_data(), &offset,
@@ -1077,6 +1221,57 @@ bool SymbolFileDWARF::ParseCompileUnitLineTable(const SymbolContext &sc) {
   return false;
 }
 
+//----------------------------------------------------------------------
+// ResolveLineEntryFromSequence
+//
+// Find the line entry for \a so_addr by decoding only the line table
+// sequence that contains it. The sequences of a compile unit's line
+// program are indexed the first time one of its addresses is looked up,
+// which only runs the line program without building any rows.
+//----------------------------------------------------------------------
+bool SymbolFileDWARF::ResolveLineEntryFromSequence(DWARFCompileUnit *dwarf_cu,
+                                                   CompileUnit *comp_unit,
+                                                   const Address &so_addr,
+                                                   LineEntry &line_entry) {
+  // Line tables from .o files have to be linked as a whole.
+  if (GetDebugMapSymfile())
+    return false;
+
+  const DWARFDIE dwarf_cu_die = dwarf_cu->GetCompileUnitDIEOnly();
+  if (!dwarf_cu_die)
+    return false;
+  const dw_offset_t cu_line_offset = dwarf_cu_die.GetAttributeValueAsUnsigned(
+      DW_AT_stmt_list, DW_INVALID_OFFSET);
+  if (cu_line_offset == DW_INVALID_OFFSET)
+    return false;
+
+  const DWARFDataExtractor &debug_line_data = get_debug_line_data();
+  auto pos = m_line_sequence_indexes.find(cu_line_offset);
+  if (pos == m_line_sequence_indexes.end()) {
+    pos = m_line_sequence_indexes
+              .emplace(cu_line_offset, DWARFDebugLine::SequenceIndex())
+              .first;
+    DWARFDebugLine::ParseSequenceIndex(debug_line_data, cu_line_offset,
+                                       pos->second);
+  }
+
+  const DWARFDebugLine::Sequence *sequence =
+      DWARFDebugLine::FindSequence(pos->second, so_addr.GetFileAddress());
+  if (sequence == NULL)
+    return false;
+
+  LineTable line_table(comp_unit);
+  ParseDWARFLineTableCallbackInfo info;
+  info.line_table = &line_table;
+  info.addr_mask = GetLineTableAddressMask(GetObjectFile());
+  lldb::offset_t offset = cu_line_offset;
+  if (!DWARFDebugLine::ParseStatementTable(debug_line_data, &offset,
+                                           ParseDWARFLineTableCallback, &info,
+                                           sequence->offset))
+    return false;
+  return line_table.FindLineEntryByAddress(so_addr, line_entry);
+}
+
 lldb_private::DebugMacrosSP
 SymbolFileDWARF::ParseDebugMacros(lldb::offset_t *offset) {
   auto iter = m_debug_macros_map.find(*offset);
@@ -1819,7 +2014,15 @@ uint32_t SymbolFileDWARF::ResolveSymbolContext(const Address &so_addr,
 
             if ((resolve_scope & eSymbolContextLineEntry) ||
                 force_check_line_table) {
-              LineTable *line_table = sc.comp_unit->GetLineTable();
+              // Symbolicating a single address shouldn't parse the whole
+              // line table of its compile unit if nobody needed it so far.
+              LineTable *line_table = NULL;
+              if (sc.comp_unit->GetLineTableIfParsed() == NULL &&
+                  ResolveLineEntryFromSequence(dwarf_cu, sc.comp_unit, so_addr,
+                                               sc.line_entry))
+                resolved |= eSymbolContextLineEntry;
+              else
+                line_table = sc.comp_unit->GetLineTable();
               if (line_table != NULL) {
                 // And address that makes it into this function should be in
                 // terms
@@ -2003,95 +2206,26 @@ void SymbolFileDWARF::Index() {
     if (num_compile_units == 0)
       return;
 
-    std::vector<NameToDIE> function_basename_index(num_compile_units);
-    std::vector<NameToDIE> function_fullname_index(num_compile_units);
-    std::vector<NameToDIE> function_method_index(num_compile_units);
-    std::vector<NameToDIE> function_selector_index(num_compile_units);
-    std::vector<NameToDIE> objc_class_selectors_index(num_compile_units);
-    std::vector<NameToDIE> global_index(num_compile_units);
-    std::vector<NameToDIE> type_index(num_compile_units);
-    std::vector<NameToDIE> namespace_index(num_compile_units);
-
-    // std::vector<bool> might be implemented using bit test-and-set, so use
-    // uint8_t instead.
-    std::vector<uint8_t> clear_cu_dies(num_compile_units, false);
-    auto parser_fn = [debug_info, &function_basename_index,
-                      &function_fullname_index, &function_method_index,
-                      &function_selector_index, &objc_class_selectors_index,
-                      &global_index, &type_index,
-                      &namespace_index](size_t cu_idx) {
-      DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-      if (dwarf_cu) {
-        dwarf_cu->Index(
-            function_basename_index[cu_idx], function_fullname_index[cu_idx],
-            function_method_index[cu_idx], function_selector_index[cu_idx],
-            objc_class_selectors_index[cu_idx], global_index[cu_idx],
-            type_index[cu_idx], namespace_index[cu_idx]);
-      }
-    };
-
-    auto extract_fn = [debug_info, &clear_cu_dies](size_t cu_idx) {
-      DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-      if (dwarf_cu) {
-        // dwarf_cu->ExtractDIEsIfNeeded(false) will return zero if the
-        // DIEs for a compile unit have already been parsed.
-        if (dwarf_cu->ExtractDIEsIfNeeded(false) > 1)
-          clear_cu_dies[cu_idx] = true;
-      }
-    };
-
-    // Create a task runner that extracts dies for each DWARF compile unit in a
-    // separate thread
-    //----------------------------------------------------------------------
-    // First figure out which compile units didn't have their DIEs already
-    // parsed and remember this.  If no DIEs were parsed prior to this index
-    // function call, we are going to want to clear the CU dies after we
-    // are done indexing to make sure we don't pull in all DWARF dies, but
-    // we need to wait until all compile units have been indexed in case
-    // a DIE in one compile unit refers to another and the indexes accesses
-    // those DIEs.
-    //----------------------------------------------------------------------
-    TaskMapOverInt(0, num_compile_units, extract_fn);
-
-    // Now create a task runner that can index each DWARF compile unit in a
-    // separate
-    // thread so we can index quickly.
-
-    TaskMapOverInt(0, num_compile_units, parser_fn);
-
-    auto finalize_fn = [](NameToDIE &index, std::vector<NameToDIE> &srcs) {
-      for (auto &src : srcs)
-        index.Append(src);
-      index.Finalize();
-    };
-
-    TaskPool::RunTasks(
-        [&]() {
-          finalize_fn(m_function_basename_index, function_basename_index);
-        },
-        [&]() {
-          finalize_fn(m_function_fullname_index, function_fullname_index);
-        },
-        [&]() { finalize_fn(m_function_method_index, function_method_index); },
-        [&]() {
-          finalize_fn(m_function_selector_index, function_selector_index);
-        },
-        [&]() {
-          finalize_fn(m_objc_class_selectors_index, objc_class_selectors_index);
-        },
-        [&]() { finalize_fn(m_global_index, global_index); },
-        [&]() { finalize_fn(m_type_index, type_index); },
-        [&]() { finalize_fn(m_namespace_index, namespace_index); });
-
-    //----------------------------------------------------------------------
-    // Keep memory down by clearing DIEs for any compile units if indexing
-    // caused us to load the compile unit's DIEs.
-    //----------------------------------------------------------------------
-    for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx) {
-      if (clear_cu_dies[cu_idx])
-        debug_info->GetCompileUnitAtIndex(cu_idx)->ClearDIEs(true);
+    // The cache holds complete indexes only, so skip it if some compile
+    // units were already indexed for .gdb_index lookups.
+    std::unique_ptr<DWARFIndexCache> index_cache;
+    if (GetGlobalPluginProperties()->GetEnableIndexCache() &&
+        m_indexed_compile_units.empty()) {
+      index_cache.reset(new DWARFIndexCache(
+          GetGlobalPluginProperties()->GetIndexCachePath(),
+          GetGlobalPluginProperties()->GetIndexCacheMaxSize()));
+      if (index_cache->Load(*GetObjectFile(), GetNameToDIEIndexes()))
+        return;
     }
 
+    std::vector<uint32_t> cu_indexes(num_compile_units);
+    for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+      cu_indexes[cu_idx] = cu_idx;
+    IndexCompileUnits(cu_indexes);
+
+    if (index_cache)
+      index_cache->Save(*GetObjectFile(), GetNameToDIEIndexes());
+
 #if defined(ENABLE_DEBUG_PRINTF)
     StreamFile s(stdout, false);
     s.Printf("DWARF index for '%s':",
@@ -2116,6 +2250,243 @@ void SymbolFileDWARF::Index() {
   }
 }
 
+void SymbolFileDWARF::IndexCompileUnits(
+    const std::vector<uint32_t> &cu_indexes) {
+  DWARFDebugInfo *debug_info = DebugInfo();
+  if (!debug_info)
+    return;
+
+  const uint32_t num_compile_units = GetNumCompileUnits();
+  m_indexed_compile_units.resize(num_compile_units, false);
+  std::vector<uint32_t> new_cu_indexes;
+  for (uint32_t cu_idx : cu_indexes) {
+    if (cu_idx < num_compile_units && !m_indexed_compile_units[cu_idx]) {
+      m_indexed_compile_units[cu_idx] = true;
+      new_cu_indexes.push_back(cu_idx);
+    }
+  }
+  const size_t num_new_cus = new_cu_indexes.size();
+  if (num_new_cus == 0)
+    return;
+
+  static Timer::Category extract_cat("SymbolFileDWARF::Index extract DIEs");
+  static Timer::Category index_cat("SymbolFileDWARF::Index index DIEs");
+  static Timer::Category clear_cat("SymbolFileDWARF::Index clear DIEs");
+  static Timer::Category merge_cat("SymbolFileDWARF::Index merge indexes");
+
+  std::vector<NameToDIE> function_basename_index(num_new_cus);
+  std::vector<NameToDIE> function_fullname_index(num_new_cus);
+  std::vector<NameToDIE> function_method_index(num_new_cus);
+  std::vector<NameToDIE> function_selector_index(num_new_cus);
+  std::vector<NameToDIE> objc_class_selectors_index(num_new_cus);
+  std::vector<NameToDIE> global_index(num_new_cus);
+  std::vector<NameToDIE> type_index(num_new_cus);
+  std::vector<NameToDIE> namespace_index(num_new_cus);
+  std::vector<DWARFCompileUnit::DeferredDIEs> deferred_dies(num_new_cus);
+
+  // TaskMapOverInt() hands out work one item at a time to whichever worker
+  // is free. Give out the largest compile units first so that a big one
+  // picked up late does not keep a single worker busy after all the others
+  // ran out of work.
+  std::vector<size_t> schedule(num_new_cus);
+  std::iota(schedule.begin(), schedule.end(), 0);
+  std::vector<uint64_t> die_byte_sizes(num_new_cus, 0);
+  for (size_t i = 0; i < num_new_cus; ++i) {
+    DWARFCompileUnit *dwarf_cu =
+        debug_info->GetCompileUnitAtIndex(new_cu_indexes[i]);
+    if (dwarf_cu)
+      die_byte_sizes[i] = EstimateDIEByteSize(dwarf_cu);
+  }
+  std::stable_sort(schedule.begin(), schedule.end(),
+                   [&die_byte_sizes](size_t lhs, size_t rhs) {
+                     return die_byte_sizes[lhs] > die_byte_sizes[rhs];
+                   });
+
+  IndexMemoryBudget memory_budget(
+      GetGlobalPluginProperties()->GetIndexMemoryBudget());
+
+  //----------------------------------------------------------------------
+  // Extract, index and clear each compile unit in one go so that only the
+  // DIEs of the compile units that are being worked on are in memory.
+  // Clearing them right away is safe since DWARFCompileUnit::Index() does
+  // not read the DIEs of other compile units when it is given a list of
+  // deferred DIEs to fill in. DIEs that were parsed before we got here are
+  // left alone.
+  //----------------------------------------------------------------------
+  auto index_fn = [&](size_t n) {
+    const size_t i = schedule[n];
+    DWARFCompileUnit *dwarf_cu =
+        debug_info->GetCompileUnitAtIndex(new_cu_indexes[i]);
+    if (!dwarf_cu)
+      return;
+
+    memory_budget.Acquire(die_byte_sizes[i]);
+    bool clear_dies = false;
+    {
+      Timer scoped_timer(extract_cat, "%8.8x: extract DIEs",
+                         dwarf_cu->GetOffset());
+      // dwarf_cu->ExtractDIEsIfNeeded(false) will return zero if the
+      // DIEs for a compile unit have already been parsed.
+      clear_dies = dwarf_cu->ExtractDIEsIfNeeded(false) > 1;
+    }
+    {
+      Timer scoped_timer(index_cat, "%8.8x: index DIEs", dwarf_cu->GetOffset());
+      dwarf_cu->Index(function_basename_index[i], function_fullname_index[i],
+                      function_method_index[i], function_selector_index[i],
+                      objc_class_selectors_index[i], global_index[i],
+                      type_index[i], namespace_index[i], &deferred_dies[i]);
+    }
+    if (clear_dies) {
+      Timer scoped_timer(clear_cat, "%8.8x: clear DIEs", dwarf_cu->GetOffset());
+      dwarf_cu->ClearDIEs(true);
+    }
+    memory_budget.Release(die_byte_sizes[i]);
+  };
+
+  TaskMapOverInt(0, num_new_cus, index_fn);
+
+  //----------------------------------------------------------------------
+  // Now that the workers are done, index the DIEs that refer to DIEs in
+  // other compile units. That extracts those compile units again, so
+  // whatever was extracted for one compile unit is cleared before moving
+  // on to the next.
+  //----------------------------------------------------------------------
+  {
+    Timer scoped_timer(index_cat, "index deferred DIEs");
+    const size_t num_cus = debug_info->GetNumCompileUnits();
+    std::vector<bool> had_dies(num_cus, false);
+    for (size_t cu_idx = 0; cu_idx < num_cus; ++cu_idx) {
+      DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+      had_dies[cu_idx] = dwarf_cu && dwarf_cu->HasDIEsParsed();
+    }
+    for (size_t i = 0; i < num_new_cus; ++i) {
+      if (deferred_dies[i].empty())
+        continue;
+      DWARFCompileUnit *dwarf_cu =
+          debug_info->GetCompileUnitAtIndex(new_cu_indexes[i]);
+      dwarf_cu->IndexDeferredDIEs(
+          deferred_dies[i], function_basename_index[i],
+          function_fullname_index[i], function_method_index[i],
+          function_selector_index[i], objc_class_selectors_index[i],
+          global_index[i], type_index[i], namespace_index[i]);
+      // This also clears the .dwo compile unit of a skeleton compile unit,
+      // which HasDIEsParsed() doesn't look at.
+      if (!had_dies[new_cu_indexes[i]])
+        dwarf_cu->ClearDIEs(true);
+      for (size_t cu_idx = 0; cu_idx < num_cus; ++cu_idx) {
+        DWARFCompileUnit *other_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+        if (other_cu && !had_dies[cu_idx] && other_cu->HasDIEsParsed())
+          other_cu->ClearDIEs(true);
+      }
+    }
+  }
+
+  auto finalize_fn = [](NameToDIE &index, std::vector<NameToDIE> &srcs) {
+    Timer scoped_timer(merge_cat, "merge indexes");
+    // Entries from compile units indexed by an earlier call are already
+    // sorted, only the new ones need to be merged in.
+    const size_t num_sorted = index.GetSize();
+    for (auto &src : srcs)
+      index.Append(src);
+    index.Finalize(num_sorted);
+  };
+
+  TaskPool::RunTasks(
+      [&]() {
+        finalize_fn(m_function_basename_index, function_basename_index);
+      },
+      [&]() {
+        finalize_fn(m_function_fullname_index, function_fullname_index);
+      },
+      [&]() { finalize_fn(m_function_method_index, function_method_index); },
+      [&]() {
+        finalize_fn(m_function_selector_index, function_selector_index);
+      },
+      [&]() {
+        finalize_fn(m_objc_class_selectors_index, objc_class_selectors_index);
+      },
+      [&]() { finalize_fn(m_global_index, global_index); },
+      [&]() { finalize_fn(m_type_index, type_index); },
+      [&]() { finalize_fn(m_namespace_index, namespace_index); });
+
+  if (std::find(m_indexed_compile_units.begin(), m_indexed_compile_units.end(),
+                false) == m_indexed_compile_units.end())
+    m_indexed = true;
+}
+
+void SymbolFileDWARF::IndexForName(const ConstString &name,
+                                   DWARFGdbIndex::SymbolKind kind) {
+  if (m_indexed)
+    return;
+
+  // The .gdb_index has no Objective-C names.
+  if (!m_gdb_index_ap || !name ||
+      ObjCLanguage::IsPossibleObjCMethodName(name.GetCString())) {
+    Index();
+    return;
+  }
+
+  DWARFDebugInfo *debug_info = DebugInfo();
+  if (!debug_info)
+    return;
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "SymbolFileDWARF::IndexForName (%s)",
+                     name.GetCString());
+
+  // The .gdb_index holds neither linkage names nor parameter lists, so
+  // look up the base name of those.
+  llvm::StringRef lookup_name = name.GetStringRef();
+  ConstString demangled_name;
+  if (CPlusPlusLanguage::IsCPPMangledName(name.GetCString())) {
+    Mangled mangled(name, true);
+    demangled_name = mangled.GetDemangledName(eLanguageTypeC_plus_plus);
+    if (demangled_name)
+      lookup_name = demangled_name.GetStringRef();
+  }
+  ConstString base_name;
+  if (lookup_name.contains('(')) {
+    CPlusPlusLanguage::MethodName method(ConstString(lookup_name));
+    if (method.IsValid()) {
+      base_name.SetString(method.GetBasename());
+      lookup_name = base_name.GetStringRef();
+    }
+  }
+
+  std::vector<dw_offset_t> cu_offsets;
+  m_gdb_index_ap->FindCompileUnits(lookup_name, kind, cu_offsets);
+
+  std::vector<uint32_t> cu_indexes;
+  for (dw_offset_t cu_offset : cu_offsets) {
+    uint32_t cu_idx = UINT32_MAX;
+    if (debug_info->GetCompileUnit(cu_offset, &cu_idx))
+      cu_indexes.push_back(cu_idx);
+  }
+
+  // Compile units that the .gdb_index does not describe could define any
+  // name, so they are indexed along with the first lookup.
+  if (!m_indexed_uncovered_compile_units) {
+    m_indexed_uncovered_compile_units = true;
+    const uint32_t num_compile_units = GetNumCompileUnits();
+    for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx) {
+      DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+      if (dwarf_cu &&
+          !m_gdb_index_ap->ContainsCompileUnit(dwarf_cu->GetOffset()))
+        cu_indexes.push_back(cu_idx);
+    }
+  }
+
+  IndexCompileUnits(cu_indexes);
+}
+
+std::vector<NameToDIE *> SymbolFileDWARF::GetNameToDIEIndexes() {
+  // The order of this list defines the layout of the on disk index cache.
+  return {&m_function_basename_index,   &m_function_fullname_index,
+          &m_function_method_index,     &m_function_selector_index,
+          &m_objc_class_selectors_index, &m_global_index,
+          &m_type_index,                &m_namespace_index};
+}
+
 bool SymbolFileDWARF::DeclContextMatchesThisSymbolFile(
     const lldb_private::CompilerDeclContext *decl_ctx) {
   if (decl_ctx == nullptr || !decl_ctx->IsValid()) {
@@ -2182,10 +2553,12 @@ uint32_t SymbolFileDWARF::FindGlobalVariables(
 
       m_apple_names_ap->FindByName(basename.data(), die_offsets);
     }
+  } else if (m_debug_names_ap) {
+    m_debug_names_ap->FindByName(name.GetStringRef(), die_offsets,
+                                 g_debug_names_variable_tags);
   } else {
     // Index the DWARF if we haven't already
-    if (!m_indexed)
-      Index();
+    IndexForName(name, DWARFGdbIndex::eSymbolKindVariable);
 
     m_global_index.Find(name, die_offsets);
   }
@@ -2287,6 +2660,9 @@ uint32_t SymbolFileDWARF::FindGlobalVariables(const RegularExpression &regex,
                                                            hash_data_array))
         DWARFMappedHash::ExtractDIEArray(hash_data_array, die_offsets);
     }
+  } else if (m_debug_names_ap) {
+    m_debug_names_ap->AppendAllDIEsThatMatchingRegex(
+        regex, die_offsets, g_debug_names_variable_tags);
   } else {
     // Index the DWARF if we haven't already
     if (!m_indexed)
@@ -2419,6 +2795,71 @@ void SymbolFileDWARF::FindFunctions(
   }
 }
 
+void SymbolFileDWARF::FindFunctionsInDebugNames(
+    const ConstString &name, const CompilerDeclContext *parent_decl_ctx,
+    uint32_t name_type_mask, bool include_inlines,
+    std::set<const DWARFDebugInfoEntry *> &resolved_dies,
+    SymbolContextList &sc_list) {
+  // The .debug_names table holds both the DW_AT_name and the linkage name
+  // of every function, so classify each match the same way
+  // DWARFCompileUnit::Index() sorts DIEs into its basename, fullname and
+  // method tables.
+  DIEArray die_offsets;
+  m_debug_names_ap->FindByName(name.GetStringRef(), die_offsets,
+                               g_debug_names_function_tags);
+  for (const DIERef &die_ref : die_offsets) {
+    DWARFDIE die = GetDIE(die_ref);
+    if (!die) {
+      GetObjectFile()->GetModule()->ReportErrorIfModifyDetected(
+          "the DWARF debug information has been modified (.debug_names "
+          "accelerator table had bad die 0x%8.8x for '%s')",
+          die_ref.die_offset, name.GetCString());
+      continue;
+    }
+    if (resolved_dies.find(die.GetDIE()) != resolved_dies.end())
+      continue;
+
+    const char *die_name = die.GetName();
+    const char *mangled_name = die.GetMangledName();
+    const bool matches_name = die_name && name.GetStringRef() == die_name;
+    const bool matches_mangled_name =
+        mangled_name && name.GetStringRef() == mangled_name;
+
+    bool is_method = false;
+    if (die.Tag() == DW_TAG_subprogram) {
+      if (die.GetParent().IsStructOrClass()) {
+        is_method = true;
+      } else {
+        DWARFDIE spec_die = die.GetReferencedDIE(DW_AT_specification);
+        is_method = spec_die && spec_die.GetParent().IsStructOrClass();
+      }
+    }
+
+    bool matches = false;
+    if ((name_type_mask & eFunctionNameTypeFull) &&
+        (matches_mangled_name ||
+         (matches_name && !mangled_name && !is_method)))
+      matches = true;
+    if ((name_type_mask & eFunctionNameTypeBase) && matches_name && !is_method)
+      matches = true;
+    if ((name_type_mask & eFunctionNameTypeMethod) && matches_name &&
+        is_method && !parent_decl_ctx)
+      matches = true;
+    if ((name_type_mask & eFunctionNameTypeSelector) && matches_name &&
+        (!parent_decl_ctx || !parent_decl_ctx->IsValid()) &&
+        ObjCLanguage::IsPossibleObjCMethodName(die_name))
+      matches = true;
+    if (!matches)
+      continue;
+
+    if (!DIEInDeclContext(parent_decl_ctx, die))
+      continue; // The containing decl contexts don't match
+
+    if (ResolveFunction(die, include_inlines, sc_list))
+      resolved_dies.insert(die.GetDIE());
+  }
+}
+
 void SymbolFileDWARF::ParseFunctions(const DIEArray &die_offsets,
                                      bool include_inlines,
                                      SymbolContextList &sc_list) {
@@ -2629,11 +3070,17 @@ SymbolFileDWARF::FindFunctions(const ConstString &name,
         die_offsets.clear();
       }
     }
+  } else if (m_debug_names_ap) {
+    FindFunctionsInDebugNames(name, parent_decl_ctx, name_type_mask,
+                              include_inlines, resolved_dies, sc_list);
   } else {
 
-    // Index the DWARF if we haven't already
-    if (!m_indexed)
+    // Index the DWARF if we haven't already. Selectors are not in the
+    // .gdb_index.
+    if (name_type_mask & eFunctionNameTypeSelector)
       Index();
+    else
+      IndexForName(name, DWARFGdbIndex::eSymbolKindFunction);
 
     if (name_type_mask & eFunctionNameTypeFull) {
       FindFunctions(name, m_function_fullname_index, include_inlines, sc_list);
@@ -2759,6 +3206,11 @@ uint32_t SymbolFileDWARF::FindFunctions(const RegularExpression &regex,
   if (m_using_apple_tables) {
     if (m_apple_names_ap.get())
       FindFunctions(regex, *m_apple_names_ap, include_inlines, sc_list);
+  } else if (m_debug_names_ap) {
+    DIEArray die_offsets;
+    if (m_debug_names_ap->AppendAllDIEsThatMatchingRegex(
+            regex, die_offsets, g_debug_names_function_tags))
+      ParseFunctions(die_offsets, include_inlines, sc_list);
   } else {
     // Index the DWARF if we haven't already
     if (!m_indexed)
@@ -2850,9 +3302,11 @@ uint32_t SymbolFileDWARF::FindTypes(
       const char *name_cstr = name.GetCString();
       m_apple_types_ap->FindByName(name_cstr, die_offsets);
     }
+  } else if (m_debug_names_ap) {
+    m_debug_names_ap->FindByName(name.GetStringRef(), die_offsets,
+                                 g_debug_names_type_tags);
   } else {
-    if (!m_indexed)
-      Index();
+    IndexForName(name, DWARFGdbIndex::eSymbolKindType);
 
     m_type_index.Find(name, die_offsets);
   }
@@ -2944,9 +3398,11 @@ size_t SymbolFileDWARF::FindTypes(const std::vector<CompilerContext> &context,
       const char *name_cstr = name.GetCString();
       m_apple_types_ap->FindByName(name_cstr, die_offsets);
     }
+  } else if (m_debug_names_ap) {
+    m_debug_names_ap->FindByName(name.GetStringRef(), die_offsets,
+                                 g_debug_names_type_tags);
   } else {
-    if (!m_indexed)
-      Index();
+    IndexForName(name, DWARFGdbIndex::eSymbolKindType);
 
     m_type_index.Find(name, die_offsets);
   }
@@ -3013,9 +3469,11 @@ SymbolFileDWARF::FindNamespace(const SymbolContext &sc, const ConstString &name,
         const char *name_cstr = name.GetCString();
         m_apple_namespaces_ap->FindByName(name_cstr, die_offsets);
       }
+    } else if (m_debug_names_ap) {
+      m_debug_names_ap->FindByName(name.GetStringRef(), die_offsets,
+                                   g_debug_names_namespace_tags);
     } else {
-      if (!m_indexed)
-        Index();
+      IndexForName(name, DWARFGdbIndex::eSymbolKindNone);
 
       m_namespace_index.Find(name, die_offsets);
     }
@@ -3412,9 +3870,13 @@ TypeSP SymbolFileDWARF::FindDefinitionTypeForDWARFDeclContext(
             m_apple_types_ap->FindByName(type_name.GetCString(), die_offsets);
           }
         }
+      } else if (m_debug_names_ap) {
+        m_debug_names_ap->FindByName(type_name.GetStringRef(), die_offsets,
+                                     g_debug_names_type_tags);
       } else {
-        if (!m_indexed)
-          Index();
+        // Only the compile units that define this exact type are needed.
+        IndexForName(ConstString(dwarf_decl_ctx.GetQualifiedName()),
+                     DWARFGdbIndex::eSymbolKindType);
 
         m_type_index.Find(type_name, die_offsets);
       }
@@ -3683,9 +4145,16 @@ size_t SymbolFileDWARF::ParseVariablesForContext(const SymbolContext &sc) {
           }
         } else {
           // Index if we already haven't to make sure the compile units
-          // get indexed and make their global DIE index list
-          if (!m_indexed)
-            Index();
+          // get indexed and make their global DIE index list. With a
+          // .gdb_index only this compile unit needs to be indexed.
+          if (!m_indexed) {
+            uint32_t cu_idx = UINT32_MAX;
+            if (m_gdb_index_ap &&
+                info->GetCompileUnit(dwarf_cu->GetOffset(), &cu_idx))
+              IndexCompileUnits(std::vector<uint32_t>(1, cu_idx));
+            else
+              Index();
+          }
 
           m_global_index.FindAllEntriesForCompileUnit(dwarf_cu->GetOffset(),
                                                       die_offsets);
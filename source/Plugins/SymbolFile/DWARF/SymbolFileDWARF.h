@@ -37,7 +37,9 @@
 
 // Project includes
 #include "DWARFDataExtractor.h"
+#include "DWARFDebugLine.h"
 #include "DWARFDefines.h"
+#include "DWARFGdbIndex.h"
 #include "HashedNameToDIE.h"
 #include "NameToDIE.h"
 #include "UniqueDWARFASTType.h"
@@ -53,7 +55,7 @@ class DWARFDebugAbbrev;
 class DWARFDebugAranges;
 class DWARFDebugInfo;
 class DWARFDebugInfoEntry;
-class DWARFDebugLine;
+class DWARFDebugNames;
 class DWARFDebugPubnames;
 class DWARFDebugRanges;
 class DWARFDeclContext;
@@ -247,6 +249,9 @@ public:
   const lldb_private::DWARFDataExtractor &get_debug_ranges_data();
   const lldb_private::DWARFDataExtractor &get_debug_str_data();
   const lldb_private::DWARFDataExtractor &get_debug_str_offsets_data();
+  const lldb_private::DWARFDataExtractor &get_debug_names_data();
+  const lldb_private::DWARFDataExtractor &get_gdb_index_data();
+
   const lldb_private::DWARFDataExtractor &get_apple_names_data();
   const lldb_private::DWARFDataExtractor &get_apple_types_data();
   const lldb_private::DWARFDataExtractor &get_apple_namespaces_data();
@@ -264,6 +269,8 @@ public:
 
   const DWARFDebugRanges *DebugRanges() const;
 
+  DWARFGdbIndex *GetGdbIndex() { return m_gdb_index_ap.get(); }
+
   static bool SupportedVersion(uint16_t version);
 
   DWARFDIE
@@ -406,11 +413,36 @@ protected:
   void ParseFunctions(const DIEArray &die_offsets, bool include_inlines,
                       lldb_private::SymbolContextList &sc_list);
 
+  void FindFunctionsInDebugNames(
+      const lldb_private::ConstString &name,
+      const lldb_private::CompilerDeclContext *parent_decl_ctx,
+      uint32_t name_type_mask, bool include_inlines,
+      std::set<const DWARFDebugInfoEntry *> &resolved_dies,
+      lldb_private::SymbolContextList &sc_list);
+
   lldb::TypeSP GetTypeForDIE(const DWARFDIE &die,
                              bool resolve_function_context = false);
 
+  bool ResolveLineEntryFromSequence(DWARFCompileUnit *dwarf_cu,
+                                    lldb_private::CompileUnit *comp_unit,
+                                    const lldb_private::Address &so_addr,
+                                    lldb_private::LineEntry &line_entry);
+
   void Index();
 
+  //------------------------------------------------------------------
+  // Make sure the manual index covers every compile unit that may
+  // define \a name. With a .gdb_index only those compile units, and
+  // the ones the .gdb_index does not describe, are indexed; without
+  // one this is the same as Index().
+  //------------------------------------------------------------------
+  void IndexForName(const lldb_private::ConstString &name,
+                    DWARFGdbIndex::SymbolKind kind);
+
+  void IndexCompileUnits(const std::vector<uint32_t> &cu_indexes);
+
+  std::vector<NameToDIE *> GetNameToDIEIndexes();
+
   void DumpIndexes();
 
   void SetDebugMapModule(const lldb::ModuleSP &module_sp) {
@@ -486,6 +518,8 @@ protected:
   DWARFDataSegment m_data_debug_ranges;
   DWARFDataSegment m_data_debug_str;
   DWARFDataSegment m_data_debug_str_offsets;
+  DWARFDataSegment m_data_debug_names;
+  DWARFDataSegment m_data_gdb_index;
   DWARFDataSegment m_data_apple_names;
   DWARFDataSegment m_data_apple_types;
   DWARFDataSegment m_data_apple_namespaces;
@@ -501,12 +535,20 @@ protected:
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_types_ap;
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_namespaces_ap;
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_objc_ap;
+  std::unique_ptr<DWARFDebugNames> m_debug_names_ap;
+  std::unique_ptr<DWARFGdbIndex> m_gdb_index_ap;
   std::unique_ptr<GlobalVariableMap> m_global_aranges_ap;
 
   typedef std::unordered_map<lldb::offset_t, lldb_private::DebugMacrosSP>
       DebugMacrosMap;
   DebugMacrosMap m_debug_macros_map;
 
+  // Line table sequence indexes by .debug_line offset, for compile units
+  // whose line table hasn't been parsed.
+  typedef std::unordered_map<dw_offset_t, DWARFDebugLine::SequenceIndex>
+      LineSequenceIndexMap;
+  LineSequenceIndexMap m_line_sequence_indexes;
+
   ExternalTypeModuleMap m_external_type_modules;
   NameToDIE m_function_basename_index; // All concrete functions
   NameToDIE m_function_fullname_index; // All concrete functions
@@ -519,6 +561,10 @@ protected:
   NameToDIE m_type_index;                 // All type DIE offsets
   NameToDIE m_namespace_index;            // All type DIE offsets
   bool m_indexed : 1, m_using_apple_tables : 1, m_fetched_external_modules : 1;
+  // Compile units that are in the manual index when it was built one
+  // compile unit at a time for a .gdb_index lookup.
+  std::vector<bool> m_indexed_compile_units;
+  bool m_indexed_uncovered_compile_units;
   lldb_private::LazyBool m_supports_DW_AT_APPLE_objc_complete_type;
 
   typedef std::shared_ptr<std::set<DIERef>> DIERefSetSP;
@@ -134,6 +134,7 @@ SymbolVendorELF::CreateInstance(const lldb::ModuleSP &module_sp,
               eSectionTypeDWARFDebugMacInfo,  eSectionTypeDWARFDebugPubNames,
               eSectionTypeDWARFDebugPubTypes, eSectionTypeDWARFDebugRanges,
               eSectionTypeDWARFDebugStr,      eSectionTypeDWARFDebugStrOffsets,
+              eSectionTypeDWARFDebugNames,    eSectionTypeDWARFGdbIndex,
               eSectionTypeELFSymbolTable,
           };
           for (size_t idx = 0; idx < sizeof(g_sections) / sizeof(g_sections[0]);
@@ -150,6 +150,37 @@ GetGNUEHPointer(const DataExtractor &DE, offset_t *offset_ptr,
   return baseAddress + addressValue;
 }
 
+// Returns the size of pointers with the encoding eh_ptr_enc, or zero if it
+// varies.
+static uint32_t GetGNUEHPointerSize(uint8_t eh_ptr_enc, uint32_t addr_size) {
+  switch (eh_ptr_enc & DW_EH_PE_MASK_ENCODING) {
+  case DW_EH_PE_absptr:
+    return addr_size;
+  case DW_EH_PE_udata2:
+  case DW_EH_PE_sdata2:
+    return 2;
+  case DW_EH_PE_udata4:
+  case DW_EH_PE_sdata4:
+    return 4;
+  case DW_EH_PE_udata8:
+  case DW_EH_PE_sdata8:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
+// Thumb functions have the low bit of their addresses set.
+static bool ClearsAddressZerothBit(ObjectFile &objfile) {
+  ArchSpec arch;
+  if (objfile.GetArchitecture(arch)) {
+    if (arch.GetTriple().getArch() == llvm::Triple::arm ||
+        arch.GetTriple().getArch() == llvm::Triple::thumb)
+      return true;
+  }
+  return false;
+}
+
 DWARFCallFrameInfo::DWARFCallFrameInfo(ObjectFile &objfile,
                                        SectionSP &section_sp, Type type)
     : m_objfile(objfile), m_section_sp(section_sp), m_type(type) {}
@@ -178,15 +209,11 @@ bool DWARFCallFrameInfo::GetAddressRange(Address addr, AddressRange &range) {
       module_sp->GetObjectFile() != &m_objfile)
     return false;
 
-  if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
-    return false;
-  GetFDEIndex();
-  FDEEntryMap::Entry *fde_entry =
-      m_fde_index.FindEntryThatContains(addr.GetFileAddress());
-  if (!fde_entry)
+  FDEEntryMap::Entry fde_entry;
+  if (!GetFDEEntryByFileAddress(addr.GetFileAddress(), fde_entry))
     return false;
 
-  range = AddressRange(fde_entry->base, fde_entry->size,
+  range = AddressRange(fde_entry.base, fde_entry.size,
                        m_objfile.GetSectionList());
   return true;
 }
@@ -196,6 +223,19 @@ bool DWARFCallFrameInfo::GetFDEEntryByFileAddress(
   if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
     return false;
 
+  // Until something needs all of the FDEs, look single ones up in the
+  // .eh_frame_hdr table if there is one.
+  if (!m_fde_index_initialized) {
+    std::lock_guard<std::mutex> guard(m_fde_index_mutex);
+    if (!m_fde_index_initialized) {
+      GetEHFrameHdr();
+      if (m_eh_frame_hdr_fde_count > 0 &&
+          GetFDEEntryFromEHFrameHdr(file_addr, fde_entry))
+        return true;
+    }
+  }
+
+  // The table may leave functions out, so a miss falls back to the full scan.
   GetFDEIndex();
 
   if (m_fde_index.IsEmpty())
@@ -230,16 +270,14 @@ void DWARFCallFrameInfo::GetFunctionAddressAndSizeVector(
 
 const DWARFCallFrameInfo::CIE *
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset) {
-  cie_map_t::iterator pos = m_cie_map.find(cie_offset);
-
-  if (pos != m_cie_map.end()) {
-    // Parse and cache the CIE
-    if (pos->second.get() == nullptr)
-      pos->second = ParseCIE(cie_offset);
-
-    return pos->second.get();
-  }
-  return nullptr;
+  // FDEs found through .eh_frame_hdr refer to CIEs that the FDE index hasn't
+  // seen, so parse and cache those on demand. Several threads may be
+  // unwinding through this module at once.
+  std::lock_guard<std::mutex> guard(m_cie_map_mutex);
+  CIESP &cie_sp = m_cie_map[cie_offset];
+  if (!cie_sp)
+    cie_sp = ParseCIE(cie_offset);
+  return cie_sp.get();
 }
 
 DWARFCallFrameInfo::CIESP
@@ -402,6 +440,7 @@ DWARFCallFrameInfo::ParseCIE(const dw_offset_t cie_offset) {
 }
 
 void DWARFCallFrameInfo::GetCFIData() {
+  std::lock_guard<std::mutex> guard(m_cfi_data_mutex);
   if (m_cfi_data_initialized == false) {
     Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_UNWIND));
     if (log)
@@ -432,13 +471,7 @@ void DWARFCallFrameInfo::GetFDEIndex() {
   Timer scoped_timer(func_cat, "%s - %s", LLVM_PRETTY_FUNCTION,
                      m_objfile.GetFileSpec().GetFilename().AsCString(""));
 
-  bool clear_address_zeroth_bit = false;
-  ArchSpec arch;
-  if (m_objfile.GetArchitecture(arch)) {
-    if (arch.GetTriple().getArch() == llvm::Triple::arm ||
-        arch.GetTriple().getArch() == llvm::Triple::thumb)
-      clear_address_zeroth_bit = true;
-  }
+  const bool clear_address_zeroth_bit = ClearsAddressZerothBit(m_objfile);
 
   lldb::offset_t offset = 0;
   if (m_cfi_data_initialized == false)
@@ -484,7 +517,9 @@ void DWARFCallFrameInfo::GetFDEIndex() {
         return;
       }
 
-      m_cie_map[current_entry] = std::move(cie_sp);
+      // Keep a CIE that was parsed on demand, as it may be in use.
+      std::lock_guard<std::mutex> guard(m_cie_map_mutex);
+      m_cie_map.emplace(current_entry, std::move(cie_sp));
       offset = next_entry;
       continue;
     }
@@ -533,6 +568,160 @@ void DWARFCallFrameInfo::GetFDEIndex() {
   m_fde_index_initialized = true;
 }
 
+void DWARFCallFrameInfo::GetEHFrameHdr() {
+  if (m_eh_frame_hdr_initialized)
+    return;
+  m_eh_frame_hdr_initialized = true;
+
+  if (m_type != EH)
+    return;
+  SectionList *section_list = m_objfile.GetSectionList();
+  if (!section_list)
+    return;
+  SectionSP hdr_sp =
+      section_list->FindSectionByName(ConstString(".eh_frame_hdr"));
+  if (!hdr_sp || hdr_sp->IsEncrypted())
+    return;
+
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_UNWIND));
+  DataExtractor data;
+  if (m_objfile.ReadSectionData(hdr_sp.get(), data) < 4)
+    return;
+
+  lldb::offset_t offset = 0;
+  const uint8_t version = data.GetU8(&offset);
+  const uint8_t eh_frame_ptr_enc = data.GetU8(&offset);
+  const uint8_t fde_count_enc = data.GetU8(&offset);
+  const uint8_t table_enc = data.GetU8(&offset);
+  const uint32_t entry_size =
+      GetGNUEHPointerSize(table_enc, data.GetAddressByteSize());
+  if (version != 1 || eh_frame_ptr_enc == DW_EH_PE_omit ||
+      (eh_frame_ptr_enc & DW_EH_PE_indirect) ||
+      fde_count_enc == DW_EH_PE_omit || (fde_count_enc & DW_EH_PE_indirect) ||
+      table_enc == DW_EH_PE_omit || (table_enc & DW_EH_PE_indirect) ||
+      entry_size == 0) {
+    LLDB_LOG(log, "unsupported .eh_frame_hdr version {0} or encodings",
+             version);
+    return;
+  }
+
+  const addr_t hdr_addr = hdr_sp->GetFileAddress();
+  const addr_t eh_frame_addr =
+      GetGNUEHPointer(data, &offset, eh_frame_ptr_enc, hdr_addr,
+                      LLDB_INVALID_ADDRESS, hdr_addr);
+  const uint64_t fde_count =
+      GetGNUEHPointer(data, &offset, fde_count_enc, hdr_addr,
+                      LLDB_INVALID_ADDRESS, hdr_addr);
+  if (eh_frame_addr != m_section_sp->GetFileAddress() ||
+      fde_count >= UINT32_MAX ||
+      !data.ValidOffsetForDataOfSize(offset, fde_count * 2 * entry_size)) {
+    LLDB_LOG(log, ".eh_frame_hdr doesn't match .eh_frame, ignoring it");
+    return;
+  }
+
+  // The table is only useful if it is sorted. Its initial locations are
+  // much smaller than the FDEs they point at, so checking that is cheap.
+  lldb::offset_t entry_offset = offset;
+  addr_t prev_initial_loc = 0;
+  for (uint64_t i = 0; i < fde_count; ++i) {
+    const addr_t initial_loc =
+        GetGNUEHPointer(data, &entry_offset, table_enc, hdr_addr,
+                        LLDB_INVALID_ADDRESS, hdr_addr);
+    entry_offset += entry_size;
+    if (initial_loc < prev_initial_loc) {
+      LLDB_LOG(log, ".eh_frame_hdr table isn't sorted, ignoring it");
+      return;
+    }
+    prev_initial_loc = initial_loc;
+  }
+
+  m_eh_frame_hdr_data = data;
+  m_eh_frame_hdr_addr = hdr_addr;
+  m_eh_frame_hdr_table_offset = offset;
+  m_eh_frame_hdr_fde_count = fde_count;
+  m_eh_frame_hdr_table_enc = table_enc;
+  m_eh_frame_hdr_entry_size = entry_size;
+  m_clear_address_zeroth_bit = ClearsAddressZerothBit(m_objfile);
+}
+
+bool DWARFCallFrameInfo::GetFDEEntryFromEHFrameHdr(
+    addr_t file_addr, FDEEntryMap::Entry &fde_entry) {
+  const DataExtractor &data = m_eh_frame_hdr_data;
+  const addr_t hdr_addr = m_eh_frame_hdr_addr;
+  const uint32_t entry_size = m_eh_frame_hdr_entry_size;
+
+  // Find the last entry whose initial location is at or before file_addr.
+  auto get_pointer = [&](uint32_t idx, uint32_t half) {
+    lldb::offset_t offset =
+        m_eh_frame_hdr_table_offset + (idx * 2 + half) * entry_size;
+    return GetGNUEHPointer(data, &offset, m_eh_frame_hdr_table_enc, hdr_addr,
+                           LLDB_INVALID_ADDRESS, hdr_addr);
+  };
+  uint32_t lo = 0;
+  uint32_t hi = m_eh_frame_hdr_fde_count;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    addr_t initial_loc = get_pointer(mid, 0);
+    if (m_clear_address_zeroth_bit)
+      initial_loc &= ~1ull;
+    if (initial_loc <= file_addr)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo == 0)
+    return false;
+
+  const addr_t fde_addr = get_pointer(lo - 1, 1);
+  const addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+  if (fde_addr < eh_frame_addr ||
+      fde_addr - eh_frame_addr >= m_section_sp->GetFileSize())
+    return false;
+  return GetFDEEntryAtOffset(fde_addr - eh_frame_addr, fde_entry) &&
+         fde_entry.Contains(file_addr);
+}
+
+bool DWARFCallFrameInfo::GetFDEEntryAtOffset(dw_offset_t fde_offset,
+                                             FDEEntryMap::Entry &fde_entry) {
+  if (m_cfi_data_initialized == false)
+    GetCFIData();
+
+  lldb::offset_t offset = fde_offset;
+  if (!m_cfi_data.ValidOffsetForDataOfSize(offset, 8))
+    return false;
+  dw_offset_t cie_offset;
+  uint64_t cie_id;
+  const uint32_t len = m_cfi_data.GetU32(&offset);
+  if (len == UINT32_MAX) {
+    m_cfi_data.GetU64(&offset);
+    cie_id = m_cfi_data.GetU64(&offset);
+    cie_offset = fde_offset + 12 - cie_id;
+  } else {
+    cie_id = m_cfi_data.GetU32(&offset);
+    cie_offset = fde_offset + 4 - cie_id;
+  }
+  // Entries with a zero CIE id are CIEs themselves.
+  if (len == 0 || cie_id == 0 || cie_offset > m_cfi_data.GetByteSize())
+    return false;
+
+  const CIE *cie = GetCIE(cie_offset);
+  if (!cie)
+    return false;
+
+  const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
+  const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
+  const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
+  lldb::addr_t addr = GetGNUEHPointer(m_cfi_data, &offset, cie->ptr_encoding,
+                                      pc_rel_addr, text_addr, data_addr);
+  if (m_clear_address_zeroth_bit)
+    addr &= ~1ull;
+  lldb::addr_t length = GetGNUEHPointer(
+      m_cfi_data, &offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING,
+      pc_rel_addr, text_addr, data_addr);
+  fde_entry = FDEEntryMap::Entry(addr, length, fde_offset);
+  return true;
+}
+
 bool DWARFCallFrameInfo::FDEToUnwindPlan(dw_offset_t dwarf_offset,
                                          Address startaddr,
                                          UnwindPlan &unwind_plan) {
@@ -38,6 +38,7 @@ FuncUnwinders::FuncUnwinders(UnwindTable &unwind_table, AddressRange range)
       m_unwind_plan_arm_unwind_sp(), m_unwind_plan_fast_sp(),
       m_unwind_plan_arch_default_sp(),
       m_unwind_plan_arch_default_at_func_entry_sp(),
+      m_unwind_plan_resolved_sp(), m_resolved_function_name(),
       m_tried_unwind_plan_assembly(false), m_tried_unwind_plan_eh_frame(false),
       m_tried_unwind_plan_debug_frame(false),
       m_tried_unwind_plan_eh_frame_augmented(false),
@@ -376,6 +377,19 @@ UnwindPlanSP FuncUnwinders::GetUnwindPlanFastUnwind(Target &target,
   return m_unwind_plan_fast_sp;
 }
 
+UnwindPlanSP FuncUnwinders::GetResolvedUnwindPlan(ConstString &function_name) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  function_name = m_resolved_function_name;
+  return m_unwind_plan_resolved_sp;
+}
+
+void FuncUnwinders::SetResolvedUnwindPlan(const UnwindPlanSP &unwind_plan_sp,
+                                          ConstString function_name) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  m_unwind_plan_resolved_sp = unwind_plan_sp;
+  m_resolved_function_name = function_name;
+}
+
 UnwindPlanSP FuncUnwinders::GetUnwindPlanArchitectureDefault(Thread &thread) {
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   if (m_unwind_plan_arch_default_sp.get() || m_tried_unwind_arch_default)
@@ -7,18 +7,22 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <map>
 #include <set>
+#include <thread>
 
 #include "Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/STLUtils.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/Symtab.h"
+#include "lldb/Utility/PartialDemangler.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
@@ -52,6 +56,7 @@ uint32_t Symtab::AddSymbol(const Symbol &symbol) {
   uint32_t symbol_idx = m_symbols.size();
   m_name_to_index.Clear();
   m_file_addr_to_index.Clear();
+  m_lazily_demangled.clear();
   m_symbols.push_back(symbol);
   m_file_addr_to_index_computed = false;
   m_name_indexes_computed = false;
@@ -244,94 +249,126 @@ void Symtab::InitNameIndexes() {
     m_name_to_index.Reserve(actual_count);
 #endif
 
-    NameToIndexMap::Entry entry;
-
     // The "const char *" in "class_contexts" must come from a
     // ConstString::GetCString()
     std::set<const char *> class_contexts;
     UniqueCStringMap<uint32_t> mangled_name_to_index;
     std::vector<const char *> symbol_contexts(num_symbols, nullptr);
 
-    for (entry.value = 0; entry.value < num_symbols; ++entry.value) {
-      const Symbol *symbol = &m_symbols[entry.value];
-
-      // Don't let trampolines get into the lookup by name map
-      // If we ever need the trampoline symbols to be searchable by name
-      // we can remove this and then possibly add a new bool to any of the
-      // Symtab functions that lookup symbols by name to indicate if they
-      // want trampolines.
-      if (symbol->IsTrampoline())
-        continue;
-
-      const Mangled &mangled = symbol->GetMangled();
-      entry.cstring = mangled.GetMangledName();
-      if (entry.cstring) {
-        m_name_to_index.Append(entry);
-
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(
-                                        entry.cstring.GetStringRef()));
-          m_name_to_index.Append(entry);
-        }
+    // Demangling dominates the time it takes to index the names, so the
+    // symbols are split into batches that are indexed in parallel, each
+    // into its own set of maps. Whether a C++ function is a method only
+    // depends on the class contexts found in all batches, so that is
+    // decided once the batches are merged.
+    struct NameIndexBatch {
+      NameToIndexMap name_to_index;
+      NameToIndexMap basename_to_index;
+      NameToIndexMap method_to_index;
+      NameToIndexMap selector_to_index;
+      NameToIndexMap mangled_name_to_index;
+      std::set<const char *> class_contexts;
+      IndexCollection lazily_demangled;
+      uint64_t num_demangled = 0;
+    };
+    const size_t min_batch_size = 4096;
+    const size_t num_batches = std::max<size_t>(
+        1, std::min<size_t>(num_symbols / min_batch_size,
+                            4 * std::thread::hardware_concurrency()));
+    const size_t batch_size = (num_symbols + num_batches - 1) / num_batches;
+    std::vector<NameIndexBatch> batches(num_batches);
+
+    auto index_batch = [&](size_t batch_idx) {
+      NameIndexBatch &batch = batches[batch_idx];
+      PartialDemangler demangler;
+      const size_t batch_end =
+          std::min(num_symbols, (batch_idx + 1) * batch_size);
+      NameToIndexMap::Entry entry;
+      for (entry.value = batch_idx * batch_size; entry.value < batch_end;
+           ++entry.value) {
+        const Symbol *symbol = &m_symbols[entry.value];
+
+        // Don't let trampolines get into the lookup by name map
+        // If we ever need the trampoline symbols to be searchable by name
+        // we can remove this and then possibly add a new bool to any of the
+        // Symtab functions that lookup symbols by name to indicate if they
+        // want trampolines.
+        if (symbol->IsTrampoline())
+          continue;
+
+        const Mangled &mangled = symbol->GetMangled();
+        bool demangle_lazily = false;
+        entry.cstring = mangled.GetMangledName();
+        if (entry.cstring) {
+          batch.name_to_index.Append(entry);
+
+          if (symbol->ContainsLinkerAnnotations()) {
+            // If the symbol has linker annotations, also add the version
+            // without the annotations.
+            entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(
+                entry.cstring.GetStringRef()));
+            batch.name_to_index.Append(entry);
+          }
 
-        const SymbolType symbol_type = symbol->GetType();
-        if (symbol_type == eSymbolTypeCode ||
-            symbol_type == eSymbolTypeResolver) {
-          llvm::StringRef entry_ref(entry.cstring.GetStringRef());
-          if (entry_ref[0] == '_' && entry_ref[1] == 'Z' &&
-              (entry_ref[2] != 'T' && // avoid virtual table, VTT structure,
-                                      // typeinfo structure, and typeinfo
-                                      // name
-               entry_ref[2] != 'G' && // avoid guard variables
-               entry_ref[2] != 'Z'))  // named local entities (if we
-                                          // eventually handle eSymbolTypeData,
-                                          // we will want this back)
-          {
-            CPlusPlusLanguage::MethodName cxx_method(
-                mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
-            entry.cstring = ConstString(cxx_method.GetBasename());
-            if (entry.cstring) {
-              // ConstString objects permanently store the string in the pool so
-              // calling
-              // GetCString() on the value gets us a const char * that will
-              // never go away
-              const char *const_context =
-                  ConstString(cxx_method.GetContext()).GetCString();
-
-              if (!const_context || const_context[0] == 0) {
-                // No context for this function so this has to be a basename
-                m_basename_to_index.Append(entry);
-                // If there is no context (no namespaces or class scopes that
-                // come before the function name) then this also could be a
-                // fullname.
-                m_name_to_index.Append(entry);
+          const SymbolType symbol_type = symbol->GetType();
+          if (symbol_type == eSymbolTypeCode ||
+              symbol_type == eSymbolTypeResolver) {
+            llvm::StringRef entry_ref(entry.cstring.GetStringRef());
+            if (entry_ref[0] == '_' && entry_ref[1] == 'Z' &&
+                (entry_ref[2] != 'T' && // avoid virtual table, VTT structure,
+                                        // typeinfo structure, and typeinfo
+                                        // name
+                 entry_ref[2] != 'G' && // avoid guard variables
+                 entry_ref[2] != 'Z'))  // named local entities (if we
+                                        // eventually handle eSymbolTypeData,
+                                        // we will want this back)
+            {
+              // Most names can be taken apart without demangling them, only
+              // fall back to parsing the demangled name when that fails.
+              llvm::StringRef basename, context, qualifiers;
+              CPlusPlusLanguage::MethodName cxx_method;
+              if (demangler.Parse(entry_ref)) {
+                basename = demangler.GetBasename();
+                context = demangler.GetContext();
+                qualifiers = demangler.GetQualifiers();
+                demangle_lazily = !symbol->ContainsLinkerAnnotations();
               } else {
-                entry_ref = entry.cstring.GetStringRef();
-                if (entry_ref[0] == '~' ||
-                    !cxx_method.GetQualifiers().empty()) {
-                  // The first character of the demangled basename is '~' which
-                  // means we have a class destructor. We can use this information
-                  // to help us know what is a class and what isn't.
-                  if (class_contexts.find(const_context) == class_contexts.end())
-                    class_contexts.insert(const_context);
-                  m_method_to_index.Append(entry);
+                cxx_method = CPlusPlusLanguage::MethodName(
+                    mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
+                basename = cxx_method.GetBasename();
+                context = cxx_method.GetContext();
+                qualifiers = cxx_method.GetQualifiers();
+              }
+              entry.cstring = ConstString(basename);
+              if (entry.cstring) {
+                // ConstString objects permanently store the string in the pool
+                // so calling GetCString() on the value gets us a const char *
+                // that will never go away
+                const char *const_context = ConstString(context).GetCString();
+
+                if (!const_context || const_context[0] == 0) {
+                  // No context for this function so this has to be a basename
+                  batch.basename_to_index.Append(entry);
+                  // If there is no context (no namespaces or class scopes that
+                  // come before the function name) then this also could be a
+                  // fullname.
+                  batch.name_to_index.Append(entry);
                 } else {
-                  if (class_contexts.find(const_context) !=
-                      class_contexts.end()) {
-                    // The current decl context is in our "class_contexts" which
-                    // means
-                    // this is a method on a class
-                    m_method_to_index.Append(entry);
+                  entry_ref = entry.cstring.GetStringRef();
+                  if (entry_ref[0] == '~' || !qualifiers.empty()) {
+                    // The first character of the demangled basename is '~'
+                    // which means we have a class destructor. We can use this
+                    // information to help us know what is a class and what
+                    // isn't.
+                    batch.class_contexts.insert(const_context);
+                    batch.method_to_index.Append(entry);
                   } else {
-                    // We don't know if this is a function basename or a method,
-                    // so put it into a temporary collection so once we are done
-                    // we can look in class_contexts to see if each entry is a
-                    // class
-                    // or just a function and will put any remaining items into
-                    // m_method_to_index or m_basename_to_index as needed
-                    mangled_name_to_index.Append(entry);
+                    // We don't know if this is a function basename or a
+                    // method, so put it into a temporary collection so once
+                    // all batches are done we can look in class_contexts to
+                    // see if each entry is a class or just a function and
+                    // will put any remaining items into m_method_to_index or
+                    // m_basename_to_index as needed
+                    batch.mangled_name_to_index.Append(entry);
                     symbol_contexts[entry.value] = const_context;
                   }
                 }
@@ -339,38 +376,77 @@ void Symtab::InitNameIndexes() {
             }
           }
         }
-      }
 
-      entry.cstring = mangled.GetDemangledName(symbol->GetLanguage());
-      if (entry.cstring) {
-        m_name_to_index.Append(entry);
+        // The demangled name of a function the partial demangler took apart
+        // is only needed to look it up by that name, which is rare, see
+        // InitDemangledNameIndexes().
+        if (demangle_lazily) {
+          batch.lazily_demangled.push_back(entry.value);
+          continue;
+        }
 
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(
-                                        entry.cstring.GetStringRef()));
-          m_name_to_index.Append(entry);
+        entry.cstring = mangled.GetDemangledName(symbol->GetLanguage());
+        if (entry.cstring) {
+          batch.name_to_index.Append(entry);
+          if (mangled.GetMangledName())
+            ++batch.num_demangled;
+
+          if (symbol->ContainsLinkerAnnotations()) {
+            // If the symbol has linker annotations, also add the version
+            // without the annotations.
+            entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(
+                entry.cstring.GetStringRef()));
+            batch.name_to_index.Append(entry);
+          }
         }
-      }
 
-      // If the demangled name turns out to be an ObjC name, and
-      // is a category name, add the version without categories to the index
-      // too.
-      ObjCLanguage::MethodName objc_method(entry.cstring.GetStringRef(), true);
-      if (objc_method.IsValid(true)) {
-        entry.cstring = objc_method.GetSelector();
-        m_selector_to_index.Append(entry);
-
-        ConstString objc_method_no_category(
-            objc_method.GetFullNameWithoutCategory(true));
-        if (objc_method_no_category) {
-          entry.cstring = objc_method_no_category;
-          m_name_to_index.Append(entry);
+        // If the demangled name turns out to be an ObjC name, and
+        // is a category name, add the version without categories to the index
+        // too.
+        ObjCLanguage::MethodName objc_method(entry.cstring.GetStringRef(),
+                                             true);
+        if (objc_method.IsValid(true)) {
+          entry.cstring = objc_method.GetSelector();
+          batch.selector_to_index.Append(entry);
+
+          ConstString objc_method_no_category(
+              objc_method.GetFullNameWithoutCategory(true));
+          if (objc_method_no_category) {
+            entry.cstring = objc_method_no_category;
+            batch.name_to_index.Append(entry);
+          }
         }
       }
+    };
+
+    {
+      static Timer::Category demangle_cat("Symtab::InitNameIndexes demangling");
+      Timer demangle_timer(demangle_cat, "Demangle %" PRIu64 " symbols",
+                           (uint64_t)num_symbols);
+      if (num_batches == 1)
+        index_batch(0);
+      else
+        TaskMapOverInt(0, num_batches, index_batch);
+      for (const NameIndexBatch &batch : batches)
+        demangle_cat.AddItems(batch.num_demangled);
     }
 
+    m_lazily_demangled.clear();
+    for (const NameIndexBatch &batch : batches) {
+      m_name_to_index.Append(batch.name_to_index);
+      m_basename_to_index.Append(batch.basename_to_index);
+      m_method_to_index.Append(batch.method_to_index);
+      m_selector_to_index.Append(batch.selector_to_index);
+      mangled_name_to_index.Append(batch.mangled_name_to_index);
+      class_contexts.insert(batch.class_contexts.begin(),
+                            batch.class_contexts.end());
+      m_lazily_demangled.insert(m_lazily_demangled.end(),
+                                batch.lazily_demangled.begin(),
+                                batch.lazily_demangled.end());
+    }
+    batches.clear();
+
+    NameToIndexMap::Entry entry;
     size_t count;
     if (!mangled_name_to_index.IsEmpty()) {
       count = mangled_name_to_index.GetSize();
@@ -391,13 +467,13 @@ void Symtab::InitNameIndexes() {
         }
       }
     }
-    m_name_to_index.Sort();
+    TaskPool::RunTasks([&]() { m_name_to_index.Sort(); },
+                       [&]() { m_selector_to_index.Sort(); },
+                       [&]() { m_basename_to_index.Sort(); },
+                       [&]() { m_method_to_index.Sort(); });
     m_name_to_index.SizeToFit();
-    m_selector_to_index.Sort();
     m_selector_to_index.SizeToFit();
-    m_basename_to_index.Sort();
     m_basename_to_index.SizeToFit();
-    m_method_to_index.Sort();
     m_method_to_index.SizeToFit();
 
     //        static StreamFile a ("/tmp/a.txt");
@@ -425,6 +501,32 @@ void Symtab::InitNameIndexes() {
   }
 }
 
+void Symtab::InitDemangledNameIndexes() {
+  // Protected function, no need to lock mutex...
+  if (m_lazily_demangled.empty())
+    return;
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
+  IndexCollection indexes;
+  indexes.swap(m_lazily_demangled);
+  std::vector<ConstString> names(indexes.size());
+  TaskMapOverInt(0, indexes.size(), [&](size_t i) {
+    const Symbol &symbol = m_symbols[indexes[i]];
+    names[i] = symbol.GetMangled().GetDemangledName(symbol.GetLanguage());
+  });
+  func_cat.AddItems(indexes.size());
+
+  NameToIndexMap::Entry entry;
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    entry.cstring = names[i];
+    entry.value = indexes[i];
+    if (entry.cstring)
+      m_name_to_index.Append(entry);
+  }
+  m_name_to_index.Sort();
+  m_name_to_index.SizeToFit();
+}
+
 void Symtab::PreloadSymbols() {
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   InitNameIndexes();
@@ -631,6 +733,9 @@ uint32_t Symtab::AppendSymbolIndexesWithName(const ConstString &symbol_name,
   if (symbol_name) {
     if (!m_name_indexes_computed)
       InitNameIndexes();
+    // Only the demangled name of a C++ function has a parameter list.
+    if (symbol_name.GetStringRef().contains('('))
+      InitDemangledNameIndexes();
 
     return m_name_to_index.GetValues(symbol_name, indexes);
   }
@@ -649,6 +754,8 @@ uint32_t Symtab::AppendSymbolIndexesWithName(const ConstString &symbol_name,
     const size_t old_size = indexes.size();
     if (!m_name_indexes_computed)
       InitNameIndexes();
+    if (symbol_name.GetStringRef().contains('('))
+      InitDemangledNameIndexes();
 
     std::vector<uint32_t> all_name_indexes;
     const size_t name_match_count =
@@ -99,17 +99,14 @@ llvm::Optional<AddressRange> UnwindTable::GetAddressRange(const Address &addr,
   return llvm::None;
 }
 
-FuncUnwindersSP
-UnwindTable::GetFuncUnwindersContainingAddress(const Address &addr,
-                                               SymbolContext &sc) {
-  Initialize();
-
-  std::lock_guard<std::mutex> guard(m_mutex);
-
+// Find the FuncUnwinders containing addr; if there is none, return end() and
+// set insert_pos to where one for addr belongs.  m_mutex must be held.
+UnwindTable::iterator UnwindTable::FindFuncUnwinders(const Address &addr,
+                                                     iterator &insert_pos) {
   // There is an UnwindTable per object file, so we can safely use file handles
   addr_t file_addr = addr.GetFileAddress();
   iterator end = m_unwinds.end();
-  iterator insert_pos = end;
+  insert_pos = end;
   if (!m_unwinds.empty()) {
     insert_pos = m_unwinds.lower_bound(file_addr);
     iterator pos = insert_pos;
@@ -119,8 +116,33 @@ UnwindTable::GetFuncUnwindersContainingAddress(const Address &addr,
       --pos;
 
     if (pos->second->ContainsAddress(addr))
-      return pos->second;
+      return pos;
   }
+  return end;
+}
+
+FuncUnwindersSP
+UnwindTable::GetExistingFuncUnwindersContainingAddress(const Address &addr) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  iterator insert_pos;
+  iterator pos = FindFuncUnwinders(addr, insert_pos);
+  if (pos != m_unwinds.end())
+    return pos->second;
+  return nullptr;
+}
+
+FuncUnwindersSP
+UnwindTable::GetFuncUnwindersContainingAddress(const Address &addr,
+                                               SymbolContext &sc) {
+  Initialize();
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+
+  iterator insert_pos;
+  iterator pos = FindFuncUnwinders(addr, insert_pos);
+  if (pos != m_unwinds.end())
+    return pos->second;
 
   auto range_or = GetAddressRange(addr, sc);
   if (!range_or)
@@ -11,24 +11,208 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/RangeMap.h"
+#include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
+#include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/SectionLoadList.h"
+#include "lldb/Target/Target.h"
 #include "lldb/Utility/DataBufferHeap.h"
 #include "lldb/Utility/Log.h"
+#include "llvm/Support/MathExtras.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+//----------------------------------------------------------------------
+// MemoryCacheLineTable
+//----------------------------------------------------------------------
+MemoryCacheLineTable::MemoryCacheLineTable(uint32_t line_byte_size)
+    : m_slots(), m_hash_shift(64), m_slabs(), m_free_lines(),
+      m_num_allocated_lines(0), m_num_lines(0),
+      m_line_byte_size(line_byte_size) {}
+
+MemoryCacheLineTable::~MemoryCacheLineTable() {}
+
+void MemoryCacheLineTable::Clear(uint32_t line_byte_size) {
+  if (line_byte_size != m_line_byte_size) {
+    m_slabs.clear();
+    m_line_byte_size = line_byte_size;
+  }
+  if (m_num_lines > 0) {
+    for (Slot &slot : m_slots)
+      slot.line_addr = LLDB_INVALID_ADDRESS;
+  }
+  m_free_lines.clear();
+  m_num_allocated_lines = 0;
+  m_num_lines = 0;
+}
+
+uint32_t MemoryCacheLineTable::GetHomeSlot(addr_t line_addr) const {
+  // Fibonacci hashing spreads the consecutive line numbers of sequential
+  // reads over the whole table.
+  const uint64_t line_number = line_addr / m_line_byte_size;
+  return (line_number * UINT64_C(0x9e3779b97f4a7c15)) >> m_hash_shift;
+}
+
+uint32_t MemoryCacheLineTable::FindSlot(addr_t line_addr) const {
+  if (m_num_lines == 0)
+    return UINT32_MAX;
+  const uint32_t mask = m_slots.size() - 1;
+  for (uint32_t idx = GetHomeSlot(line_addr);; idx = (idx + 1) & mask) {
+    const Slot &slot = m_slots[idx];
+    if (slot.line_addr == line_addr)
+      return idx;
+    if (slot.line_addr == LLDB_INVALID_ADDRESS)
+      return UINT32_MAX;
+  }
+}
+
+uint8_t *MemoryCacheLineTable::GetLineBytes(uint32_t line_idx) const {
+  return m_slabs[line_idx / kLinesPerSlab].get() +
+         size_t(line_idx % kLinesPerSlab) * m_line_byte_size;
+}
+
+uint32_t MemoryCacheLineTable::AllocateLine() {
+  if (!m_free_lines.empty()) {
+    const uint32_t line_idx = m_free_lines.back();
+    m_free_lines.pop_back();
+    return line_idx;
+  }
+  if (m_num_allocated_lines == m_slabs.size() * kLinesPerSlab)
+    m_slabs.emplace_back(
+        new uint8_t[size_t(kLinesPerSlab) * m_line_byte_size]);
+  return m_num_allocated_lines++;
+}
+
+void MemoryCacheLineTable::Grow() {
+  std::vector<Slot> old_slots;
+  old_slots.swap(m_slots);
+  const size_t num_slots = old_slots.empty() ? 64 : old_slots.size() * 2;
+  m_slots.resize(num_slots, Slot{LLDB_INVALID_ADDRESS, 0, 0});
+  m_hash_shift = 64 - llvm::Log2_64(num_slots);
+
+  const uint32_t mask = num_slots - 1;
+  for (const Slot &slot : old_slots) {
+    if (slot.line_addr == LLDB_INVALID_ADDRESS)
+      continue;
+    uint32_t idx = GetHomeSlot(slot.line_addr);
+    while (m_slots[idx].line_addr != LLDB_INVALID_ADDRESS)
+      idx = (idx + 1) & mask;
+    m_slots[idx] = slot;
+  }
+}
+
+const uint8_t *MemoryCacheLineTable::Find(addr_t line_addr,
+                                          uint32_t &byte_size) const {
+  const uint32_t idx = FindSlot(line_addr);
+  if (idx == UINT32_MAX)
+    return nullptr;
+  byte_size = m_slots[idx].byte_size;
+  return GetLineBytes(m_slots[idx].line_idx);
+}
+
+void MemoryCacheLineTable::Insert(addr_t line_addr, const uint8_t *src,
+                                  uint32_t byte_size) {
+  assert(byte_size <= m_line_byte_size);
+  uint32_t idx = FindSlot(line_addr);
+  if (idx == UINT32_MAX) {
+    if ((m_num_lines + 1) * 4 > m_slots.size() * 3)
+      Grow();
+    const uint32_t mask = m_slots.size() - 1;
+    idx = GetHomeSlot(line_addr);
+    while (m_slots[idx].line_addr != LLDB_INVALID_ADDRESS)
+      idx = (idx + 1) & mask;
+    m_slots[idx].line_addr = line_addr;
+    m_slots[idx].line_idx = AllocateLine();
+    ++m_num_lines;
+  }
+  m_slots[idx].byte_size = byte_size;
+  memcpy(GetLineBytes(m_slots[idx].line_idx), src, byte_size);
+}
+
+bool MemoryCacheLineTable::Erase(addr_t line_addr) {
+  uint32_t hole = FindSlot(line_addr);
+  if (hole == UINT32_MAX)
+    return false;
+  m_free_lines.push_back(m_slots[hole].line_idx);
+  --m_num_lines;
+
+  // Shift the slots after the hole back into it unless that would move
+  // them in front of their home slot, so that lookups never need
+  // tombstones.
+  const uint32_t mask = m_slots.size() - 1;
+  for (uint32_t idx = (hole + 1) & mask;
+       m_slots[idx].line_addr != LLDB_INVALID_ADDRESS;
+       idx = (idx + 1) & mask) {
+    const uint32_t home = GetHomeSlot(m_slots[idx].line_addr);
+    const bool home_in_gap = hole <= idx ? (hole < home && home <= idx)
+                                         : (hole < home || home <= idx);
+    if (!home_in_gap) {
+      m_slots[hole] = m_slots[idx];
+      hole = idx;
+    }
+  }
+  m_slots[hole].line_addr = LLDB_INVALID_ADDRESS;
+  return true;
+}
+
+size_t MemoryCacheLineTable::Erase(addr_t addr, addr_t size) {
+  if (size == 0 || m_num_lines == 0)
+    return 0;
+
+  const addr_t end_addr = addr + size - 1;
+  const addr_t first_line_addr = addr - (addr % m_line_byte_size);
+  const addr_t last_line_addr = end_addr - (end_addr % m_line_byte_size);
+
+  // Look the lines up one by one if there are fewer of them in the range
+  // than in the table, and go through the table otherwise. This also keeps
+  // ranges that wrap around the end of the address space finite.
+  std::vector<addr_t> line_addrs;
+  if (last_line_addr >= first_line_addr &&
+      (last_line_addr - first_line_addr) / m_line_byte_size < m_num_lines) {
+    for (addr_t line_addr = first_line_addr; line_addr <= last_line_addr;
+         line_addr += m_line_byte_size)
+      line_addrs.push_back(line_addr);
+  } else {
+    for (const Slot &slot : m_slots) {
+      if (slot.line_addr == LLDB_INVALID_ADDRESS)
+        continue;
+      const bool in_range = last_line_addr >= first_line_addr
+                                ? (slot.line_addr >= first_line_addr &&
+                                   slot.line_addr <= last_line_addr)
+                                : (slot.line_addr >= first_line_addr ||
+                                   slot.line_addr <= last_line_addr);
+      if (in_range)
+        line_addrs.push_back(slot.line_addr);
+    }
+  }
+
+  size_t num_erased = 0;
+  for (addr_t line_addr : line_addrs) {
+    if (Erase(line_addr))
+      ++num_erased;
+  }
+  return num_erased;
+}
+
 //----------------------------------------------------------------------
 // MemoryCache constructor
 //----------------------------------------------------------------------
 MemoryCache::MemoryCache(Process &process)
-    : m_mutex(), m_L1_cache(), m_L2_cache(), m_invalid_ranges(),
+    : m_mutex(), m_L1_cache(),
+      m_L2_cache(process.GetMemoryCacheLineSize()),
+      m_read_only_cache(process.GetMemoryCacheLineSize()),
+      m_region_permissions(), m_process_regions(), m_invalid_ranges(),
       m_process(process),
-      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {}
+      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()),
+      m_max_read_ahead_lines(process.GetMemoryCacheReadAhead()),
+      m_next_sequential_line_addr(LLDB_INVALID_ADDRESS),
+      m_read_ahead_lines(1), m_generation(0), m_stats() {}
 
 //----------------------------------------------------------------------
 // Destructor
@@ -36,12 +220,45 @@ MemoryCache::MemoryCache(Process &process)
 MemoryCache::~MemoryCache() {}
 
 void MemoryCache::Clear(bool clear_invalid_ranges) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  std::lock_guard<std::mutex> guard(m_mutex);
   m_L1_cache.clear();
-  m_L2_cache.clear();
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
   m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_max_read_ahead_lines = m_process.GetMemoryCacheReadAhead();
+  m_L2_cache.Clear(m_L2_cache_line_byte_size);
+  if (m_read_only_cache.GetLineByteSize() != m_L2_cache_line_byte_size) {
+    m_read_only_cache.Clear(m_L2_cache_line_byte_size);
+  } else {
+    // Only the loaded sections are known to stay mapped the same way.
+    for (size_t i = 0; i < m_process_regions.GetSize(); ++i) {
+      const RegionPermissions::Entry *entry =
+          m_process_regions.GetEntryAtIndex(i);
+      if (entry->data)
+        m_read_only_cache.Erase(entry->GetRangeBase(), entry->GetByteSize());
+    }
+  }
+  m_process_regions.Clear();
+  m_next_sequential_line_addr = LLDB_INVALID_ADDRESS;
+  m_read_ahead_lines = 1;
+  ++m_generation;
+}
+
+void MemoryCache::ClearReadOnly() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  ++m_generation;
+  if (!m_read_only_cache.IsEmpty())
+    ++m_stats.read_only_invalidations;
+  m_read_only_cache.Clear();
+  m_region_permissions.Clear();
+  m_process_regions.Clear();
+}
+
+MemoryCache::Stats MemoryCache::GetStats() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  Stats stats = m_stats;
+  stats.read_only_lines = m_read_only_cache.GetSize();
+  return stats;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -52,7 +269,7 @@ void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr,
                                  const DataBufferSP &data_buffer_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  std::lock_guard<std::mutex> guard(m_mutex);
   m_L1_cache[addr] = data_buffer_sp;
 }
 
@@ -60,7 +277,8 @@ void MemoryCache::Flush(addr_t addr, size_t size) {
   if (size == 0)
     return;
 
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  std::lock_guard<std::mutex> guard(m_mutex);
+  ++m_generation;
 
   // Erase any blocks from the L1 cache that intersect with the flush range
   if (!m_L1_cache.empty()) {
@@ -77,37 +295,15 @@ void MemoryCache::Flush(addr_t addr, size_t size) {
     }
   }
 
-  if (!m_L2_cache.empty()) {
-    const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
-    const addr_t end_addr = (addr + size - 1);
-    const addr_t first_cache_line_addr = addr - (addr % cache_line_byte_size);
-    const addr_t last_cache_line_addr =
-        end_addr - (end_addr % cache_line_byte_size);
-    // Watch for overflow where size will cause us to go off the end of the
-    // 64 bit address space
-    uint32_t num_cache_lines;
-    if (last_cache_line_addr >= first_cache_line_addr)
-      num_cache_lines = ((last_cache_line_addr - first_cache_line_addr) /
-                         cache_line_byte_size) +
-                        1;
-    else
-      num_cache_lines =
-          (UINT64_MAX - first_cache_line_addr + 1) / cache_line_byte_size;
-
-    uint32_t cache_idx = 0;
-    for (addr_t curr_addr = first_cache_line_addr; cache_idx < num_cache_lines;
-         curr_addr += cache_line_byte_size, ++cache_idx) {
-      BlockMap::iterator pos = m_L2_cache.find(curr_addr);
-      if (pos != m_L2_cache.end())
-        m_L2_cache.erase(pos);
-    }
-  }
+  m_L2_cache.Erase(addr, size);
+  if (m_read_only_cache.Erase(addr, size) > 0)
+    ++m_stats.read_only_invalidations;
 }
 
 void MemoryCache::AddInvalidRange(lldb::addr_t base_addr,
                                   lldb::addr_t byte_size) {
   if (byte_size > 0) {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    std::lock_guard<std::mutex> guard(m_mutex);
     InvalidRanges::Entry range(base_addr, byte_size);
     m_invalid_ranges.Append(range);
     m_invalid_ranges.Sort();
@@ -117,7 +313,7 @@ void MemoryCache::AddInvalidRange(lldb::addr_t base_addr,
 bool MemoryCache::RemoveInvalidRange(lldb::addr_t base_addr,
                                      lldb::addr_t byte_size) {
   if (byte_size > 0) {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    std::lock_guard<std::mutex> guard(m_mutex);
     const uint32_t idx = m_invalid_ranges.FindEntryIndexThatContains(base_addr);
     if (idx != UINT32_MAX) {
       const InvalidRanges::Entry *entry = m_invalid_ranges.GetEntryAtIndex(idx);
@@ -140,7 +336,7 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   // m_L2_cache_line_byte_size bytes in size, so we don't try anything
   // tricky when reading from them (no partial reads from the L1 cache).
 
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  std::unique_lock<std::mutex> lock(m_mutex);
   if (!m_L1_cache.empty()) {
     AddrRange read_range(addr, dst_len);
     BlockMap::iterator pos = m_L1_cache.upper_bound(addr);
@@ -151,6 +347,7 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
     if (chunk_range.Contains(read_range)) {
       memcpy(dst, pos->second->GetBytes() + addr - chunk_range.GetRangeBase(),
              dst_len);
+      ++m_stats.hits;
       return dst_len;
     }
   }
@@ -163,12 +360,16 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   // 4 bytes after the large memory read - so there's little benefit to saving
   // it in the cache.
   if (dst && dst_len > m_L2_cache_line_byte_size) {
+    ++m_stats.misses;
+    const uint32_t generation = m_generation;
+    lock.unlock();
     size_t bytes_read =
         m_process.ReadMemoryFromInferior(addr, dst, dst_len, error);
+    lock.lock();
     // Add this non block sized range to the L1 cache if we actually read
-    // anything
-    if (bytes_read > 0)
-      AddL1CacheData(addr, dst, bytes_read);
+    // anything, and nothing was flushed while we did.
+    if (bytes_read > 0 && generation == m_generation)
+      m_L1_cache[addr] = DataBufferSP(new DataBufferHeap(dst, bytes_read));
     return bytes_read;
   }
 
@@ -177,6 +378,7 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
     uint8_t *dst_buf = (uint8_t *)dst;
     addr_t curr_addr = addr - (addr % cache_line_byte_size);
     addr_t cache_offset = addr - curr_addr;
+    std::vector<uint8_t> read_buf;
 
     while (bytes_left > 0) {
       if (m_invalid_ranges.FindEntryThatContains(curr_addr)) {
@@ -185,70 +387,245 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
         return dst_len - bytes_left;
       }
 
-      BlockMap::const_iterator pos = m_L2_cache.find(curr_addr);
-      BlockMap::const_iterator end = m_L2_cache.end();
+      uint32_t line_byte_size = 0;
+      const uint8_t *line = m_L2_cache.Find(curr_addr, line_byte_size);
+      if (line) {
+        ++m_stats.hits;
+      } else if ((line = m_read_only_cache.Find(curr_addr, line_byte_size))) {
+        ++m_stats.read_only_hits;
+      } else {
+        // We need to read from the process
+        ++m_stats.misses;
+        if (!ReadCacheLines(curr_addr, lock, read_buf, line_byte_size, error))
+          return dst_len - bytes_left;
+        line = read_buf.data();
+      }
 
-      if (pos != end) {
-        size_t curr_read_size = cache_line_byte_size - cache_offset;
-        if (curr_read_size > bytes_left)
-          curr_read_size = bytes_left;
+      if (cache_offset >= line_byte_size)
+        return dst_len - bytes_left;
 
-        memcpy(dst_buf + dst_len - bytes_left,
-               pos->second->GetBytes() + cache_offset, curr_read_size);
+      size_t curr_read_size = line_byte_size - cache_offset;
+      if (curr_read_size > bytes_left)
+        curr_read_size = bytes_left;
 
-        bytes_left -= curr_read_size;
-        curr_addr += curr_read_size + cache_offset;
-        cache_offset = 0;
+      memcpy(dst_buf + dst_len - bytes_left, line + cache_offset,
+             curr_read_size);
+      bytes_left -= curr_read_size;
 
-        if (bytes_left > 0) {
-          // Get sequential cache page hits
-          for (++pos; (pos != end) && (bytes_left > 0); ++pos) {
-            assert((curr_addr % cache_line_byte_size) == 0);
+      // We have a cache page that succeeded to read some bytes but not an
+      // entire page. If this happens, we must cap off how much data we are
+      // able to read...
+      if (line_byte_size != cache_line_byte_size)
+        return dst_len - bytes_left;
 
-            if (pos->first != curr_addr)
-              break;
+      // Another thread may have changed the line size while the lock was
+      // dropped, so the following lines are cached differently.
+      if (cache_line_byte_size != m_L2_cache_line_byte_size)
+        return dst_len - bytes_left;
 
-            curr_read_size = pos->second->GetByteSize();
-            if (curr_read_size > bytes_left)
-              curr_read_size = bytes_left;
+      curr_addr += cache_line_byte_size;
+      cache_offset = 0;
+    }
+  }
 
-            memcpy(dst_buf + dst_len - bytes_left, pos->second->GetBytes(),
-                   curr_read_size);
+  return dst_len - bytes_left;
+}
 
-            bytes_left -= curr_read_size;
-            curr_addr += curr_read_size;
+bool MemoryCache::ReadCacheLines(addr_t line_addr,
+                                 std::unique_lock<std::mutex> &lock,
+                                 std::vector<uint8_t> &buf,
+                                 uint32_t &line_byte_size, Status &error) {
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+
+  // Each miss on the line after the last ones read doubles how many lines
+  // are read at once, and any other miss starts over with a single line.
+  if (line_addr == m_next_sequential_line_addr)
+    m_read_ahead_lines = std::min(m_read_ahead_lines * 2,
+                                  std::max(m_max_read_ahead_lines, 1u));
+  else
+    m_read_ahead_lines = 1;
+
+  // Stop reading ahead at memory that is cached or known to be invalid.
+  uint32_t num_lines = 1;
+  for (addr_t next_addr = line_addr + cache_line_byte_size;
+       num_lines < m_read_ahead_lines && next_addr > line_addr;
+       next_addr += cache_line_byte_size, ++num_lines) {
+    if (m_L2_cache.Contains(next_addr) ||
+        m_read_only_cache.Contains(next_addr) ||
+        m_invalid_ranges.FindEntryThatContains(next_addr))
+      break;
+  }
 
-            // We have a cache page that succeeded to read some bytes
-            // but not an entire page. If this happens, we must cap
-            // off how much data we are able to read...
-            if (pos->second->GetByteSize() != cache_line_byte_size)
-              return dst_len - bytes_left;
-          }
-        }
-      }
+  buf.resize(size_t(num_lines) * cache_line_byte_size);
+  const uint32_t generation = m_generation;
+  const bool need_region = !FindRegionPermissions(line_addr);
+  lock.unlock();
+  size_t bytes_read = m_process.ReadMemoryFromInferior(line_addr, buf.data(),
+                                                       buf.size(), error);
+  // Some stubs fail reads that only partly fit in mapped memory, so don't
+  // let reading ahead cost the line that was asked for.
+  if (bytes_read == 0 && num_lines > 1) {
+    error.Clear();
+    num_lines = 1;
+    bytes_read = m_process.ReadMemoryFromInferior(
+        line_addr, buf.data(), cache_line_byte_size, error);
+  }
+  RegionPermissions::Entry region;
+  bool from_section = false;
+  const bool got_region =
+      need_region && bytes_read > 0 &&
+      GetRegionPermissions(line_addr, region, from_section);
+  lock.lock();
+  if (bytes_read == 0) {
+    m_next_sequential_line_addr = LLDB_INVALID_ADDRESS;
+    return false;
+  }
+  line_byte_size = std::min<size_t>(bytes_read, cache_line_byte_size);
+  // What was read is still good for this read, but mustn't outlive a flush
+  // which raced with it.
+  if (generation != m_generation)
+    return true;
+  if (got_region)
+    AddRegionPermissions(region, from_section);
+
+  // Lines that could only be read in part are cached short, which ends the
+  // lines that were read.
+  uint32_t line_idx = 0;
+  for (size_t offset = 0; offset < bytes_read;
+       offset += cache_line_byte_size, ++line_idx)
+    AddCacheLine(line_addr + offset, buf.data() + offset,
+                 std::min<size_t>(bytes_read - offset, cache_line_byte_size));
+  m_stats.read_ahead_lines += line_idx - 1;
+  m_next_sequential_line_addr =
+      bytes_read == buf.size() ? line_addr + buf.size() : LLDB_INVALID_ADDRESS;
+  return true;
+}
 
-      // We need to read from the process
+void MemoryCache::AddCacheLine(addr_t line_addr, const uint8_t *src,
+                               uint32_t byte_size) {
+  if (IsReadOnly(line_addr, byte_size))
+    m_read_only_cache.Insert(line_addr, src, byte_size);
+  else
+    m_L2_cache.Insert(line_addr, src, byte_size);
+}
 
-      if (bytes_left > 0) {
-        assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(
-            new DataBufferHeap(cache_line_byte_size, 0));
-        size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_ap->GetBytes(),
-            data_buffer_heap_ap->GetByteSize(), error);
-        if (process_bytes_read == 0)
-          return dst_len - bytes_left;
+bool MemoryCache::IsReadOnly(addr_t addr, addr_t size) {
+  // Memory whose permissions aren't known yet is taken to be writable.
+  const RegionPermissions::Entry *entry = FindRegionPermissions(addr);
+  return entry && entry->data && entry->Contains(addr + size - 1);
+}
 
-        if (process_bytes_read != cache_line_byte_size)
-          data_buffer_heap_ap->SetByteSize(process_bytes_read);
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_ap.release());
-        // We have read data and put it into the cache, continue through the
-        // loop again to get the data out of the cache...
-      }
-    }
+const MemoryCache::RegionPermissions::Entry *
+MemoryCache::FindRegionPermissions(addr_t addr) {
+  if (const RegionPermissions::Entry *entry =
+          m_region_permissions.FindEntryThatContains(addr))
+    return entry;
+  return m_process_regions.FindEntryThatContains(addr);
+}
+
+bool MemoryCache::GetRegionPermissions(addr_t addr,
+                                       RegionPermissions::Entry &region,
+                                       bool &from_section) {
+  // Loaded sections know their permissions, so only ask the process about
+  // the memory outside of them.
+  Target &target = m_process.GetTarget();
+  Address so_addr;
+  SectionSP section_sp;
+  if (target.GetSectionLoadList().ResolveLoadAddress(addr, so_addr))
+    section_sp = so_addr.GetSection();
+  if (section_sp && section_sp->GetPermissions() != 0) {
+    region.SetRangeBase(section_sp->GetLoadBaseAddress(&target));
+    region.SetByteSize(section_sp->GetByteSize());
+    region.data = (section_sp->GetPermissions() & ePermissionsWritable) == 0;
+    from_section = true;
+  } else {
+    MemoryRegionInfo info;
+    if (m_process.GetMemoryRegionInfo(addr, info).Fail())
+      return false;
+    region.SetRangeBase(info.GetRange().GetRangeBase());
+    region.SetByteSize(info.GetRange().GetByteSize());
+    region.data = info.GetReadable() == MemoryRegionInfo::eYes &&
+                  info.GetWritable() == MemoryRegionInfo::eNo;
+    from_section = false;
   }
+  return region.Contains(addr);
+}
 
-  return dst_len - bytes_left;
+void MemoryCache::AddRegionPermissions(const RegionPermissions::Entry &region,
+                                       bool from_section) {
+  // Either answer is remembered until the mappings change, which for memory
+  // outside of the loaded sections may be whenever the process runs.
+  if (FindRegionPermissions(region.GetRangeBase()))
+    return;
+  RegionPermissions &regions =
+      from_section ? m_region_permissions : m_process_regions;
+  regions.Append(region);
+  regions.Sort();
+}
+
+void MemoryCache::Prefetch(llvm::ArrayRef<lldb::addr_t> addrs) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+  std::vector<addr_t> line_addrs;
+  line_addrs.reserve(addrs.size());
+  for (addr_t addr : addrs)
+    line_addrs.push_back(addr - (addr % cache_line_byte_size));
+  std::sort(line_addrs.begin(), line_addrs.end());
+  line_addrs.erase(std::unique(line_addrs.begin(), line_addrs.end()),
+                   line_addrs.end());
+
+  std::vector<Process::MemoryRange> ranges;
+  for (addr_t line_addr : line_addrs) {
+    if (m_L2_cache.Contains(line_addr) ||
+        m_read_only_cache.Contains(line_addr) ||
+        m_invalid_ranges.FindEntryThatContains(line_addr))
+      continue;
+    ranges.push_back(Process::MemoryRange(line_addr, cache_line_byte_size));
+  }
+  if (ranges.empty())
+    return;
+
+  std::vector<addr_t> unknown_addrs;
+  for (const Process::MemoryRange &range : ranges) {
+    if (!FindRegionPermissions(range.GetRangeBase()))
+      unknown_addrs.push_back(range.GetRangeBase());
+  }
+
+  std::vector<uint8_t> buf(ranges.size() * cache_line_byte_size);
+  std::vector<size_t> bytes_read;
+  const uint32_t generation = m_generation;
+  lock.unlock();
+  if (!m_process.ReadMemoryRangesFromInferior(ranges, buf.data(), bytes_read))
+    return;
+  // Like in ReadCacheLines(), look up the permissions without the lock.
+  std::vector<std::pair<RegionPermissions::Entry, bool>> regions;
+  for (addr_t addr : unknown_addrs) {
+    auto pos = std::find_if(
+        regions.begin(), regions.end(),
+        [addr](const std::pair<RegionPermissions::Entry, bool> &r) {
+          return r.first.Contains(addr);
+        });
+    RegionPermissions::Entry region;
+    bool from_section = false;
+    if (pos == regions.end() &&
+        GetRegionPermissions(addr, region, from_section))
+      regions.push_back(std::make_pair(region, from_section));
+  }
+  lock.lock();
+  if (generation != m_generation)
+    return;
+  for (const auto &region : regions)
+    AddRegionPermissions(region.first, region.second);
+
+  // Lines that could only be read in part are cached short, just like Read()
+  // does, so that reads past their end fail the same way.
+  m_stats.misses += ranges.size();
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] == 0)
+      continue;
+    AddCacheLine(ranges[i].GetRangeBase(),
+                 buf.data() + i * cache_line_byte_size, bytes_read[i]);
+  }
 }
 
 AllocatedBlock::AllocatedBlock(lldb::addr_t addr, uint32_t byte_size,
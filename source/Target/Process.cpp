@@ -141,9 +141,16 @@ static PropertyDefinition g_properties[] = {
      nullptr, "If true, detach will attempt to keep the process stopped."},
     {"memory-cache-line-size", OptionValue::eTypeUInt64, false, 512, nullptr,
      nullptr, "The memory cache line size"},
+    {"memory-cache-read-ahead", OptionValue::eTypeUInt64, false, 8, nullptr,
+     nullptr, "The most memory cache lines to read at once when memory is "
+              "read sequentially, up to 64.  Set to 1 to disable reading "
+              "ahead."},
     {"optimization-warnings", OptionValue::eTypeBoolean, false, true, nullptr,
      nullptr, "If true, warn when stopped in code that is optimized where "
               "stepping and variable availability may not behave as expected."},
+    {"parallel-unwind", OptionValue::eTypeBoolean, false, true, nullptr,
+     nullptr, "If true, commands that show the stacks of all threads unwind "
+              "the threads in parallel."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
 enum {
@@ -155,7 +162,9 @@ enum {
   ePropertyStopOnSharedLibraryEvents,
   ePropertyDetachKeepsStopped,
   ePropertyMemCacheLineSize,
-  ePropertyWarningOptimization
+  ePropertyMemCacheReadAhead,
+  ePropertyWarningOptimization,
+  ePropertyParallelUnwind
 };
 
 ProcessProperties::ProcessProperties(lldb_private::Process *process)
@@ -200,6 +209,16 @@ uint64_t ProcessProperties::GetMemoryCacheLineSize() const {
       nullptr, idx, g_properties[idx].default_uint_value);
 }
 
+uint64_t ProcessProperties::GetMemoryCacheReadAhead() const {
+  const uint32_t idx = ePropertyMemCacheReadAhead;
+  // Reading further ahead saves few round trips, but makes every miss read
+  // that much more memory once it does.
+  const uint64_t max_read_ahead = 64;
+  return std::min(m_collection_sp->GetPropertyAtIndexAsUInt64(
+                      nullptr, idx, g_properties[idx].default_uint_value),
+                  max_read_ahead);
+}
+
 Args ProcessProperties::GetExtraStartupCommands() const {
   Args args;
   const uint32_t idx = ePropertyExtraStartCommand;
@@ -272,6 +291,12 @@ bool ProcessProperties::GetWarningsOptimization() const {
       nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool ProcessProperties::GetParallelUnwind() const {
+  const uint32_t idx = ePropertyParallelUnwind;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 void ProcessInstanceInfo::Dump(Stream &s, Platform *platform) const {
   const char *cstr;
   if (m_pid != LLDB_INVALID_PROCESS_ID)
@@ -867,6 +892,7 @@ void Process::Finalize() {
   m_notifications.swap(empty_notifications);
   m_image_tokens.clear();
   m_memory_cache.Clear();
+  m_memory_cache.ClearReadOnly();
   m_allocated_memory_cache.Clear();
   m_language_runtimes.clear();
   m_instrumentation_runtimes.clear();
@@ -1922,6 +1948,7 @@ Process::CreateBreakpointSite(const BreakpointLocationSP &owner,
     if (bp_site_sp) {
       bp_site_sp->AddOwner(owner);
       owner->SetBreakpointSite(bp_site_sp);
+      UpdateBreakpointSiteConditions(bp_site_sp.get());
       return bp_site_sp->GetID();
     } else {
       bp_site_sp.reset(new BreakpointSite(&m_breakpoint_site_list, owner,
@@ -2037,6 +2064,10 @@ Status Process::EnableSoftwareBreakpoint(BreakpointSite *bp_site) {
       return error;
     }
 
+    // The trap is written behind the memory cache's back, and the code it
+    // replaces is likely to be in the read-only cache.
+    m_memory_cache.Flush(bp_addr, bp_opcode_size);
+
     // Save the original opcode by reading it
     if (DoReadMemory(bp_addr, bp_site->GetSavedOpcodeBytes(), bp_opcode_size,
                      error) == bp_opcode_size) {
@@ -2095,6 +2126,8 @@ Status Process::DisableSoftwareBreakpoint(BreakpointSite *bp_site) {
       assert(break_op_size <= sizeof(curr_break_op));
       bool break_op_found = false;
 
+      m_memory_cache.Flush(bp_addr, break_op_size);
+
       // Read the breakpoint opcode
       if (DoReadMemory(bp_addr, curr_break_op, break_op_size, error) ==
           break_op_size) {
@@ -2350,6 +2383,30 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+bool Process::ReadMemoryRangesFromInferior(llvm::ArrayRef<MemoryRange> ranges,
+                                           uint8_t *buf,
+                                           std::vector<size_t> &bytes_read) {
+  bytes_read.clear();
+  if (!DoReadMemoryRanges(ranges, buf, bytes_read))
+    return false;
+  assert(bytes_read.size() == ranges.size());
+
+  // Replace any software breakpoint opcodes that fall into these ranges
+  // back into "buf" before we return
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      RemoveBreakpointOpcodesFromBuffer(ranges[i].GetRangeBase(),
+                                        bytes_read[i], buf);
+    buf += ranges[i].GetByteSize();
+  }
+  return true;
+}
+
+void Process::PrefetchMemory(llvm::ArrayRef<lldb::addr_t> addrs) {
+  if (!GetDisableMemoryCache())
+    m_memory_cache.Prefetch(addrs);
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
@@ -5857,6 +5914,7 @@ void Process::DidExec() {
   m_instrumentation_runtimes.clear();
   m_thread_list.DiscardThreadPlans();
   m_memory_cache.Clear(true);
+  m_memory_cache.ClearReadOnly();
   m_stop_info_override_callback = nullptr;
   DoDidExec();
   CompleteAttach();
@@ -5945,6 +6003,12 @@ void Process::ModulesDidLoad(ModuleList &module_list) {
   }
 }
 
+void Process::ModulesDidUnload(ModuleList &module_list) {
+  // The unloaded modules' memory may be unmapped or reused for something
+  // writable, so the read-only memory cache can't be trusted anymore.
+  m_memory_cache.ClearReadOnly();
+}
+
 void Process::PrintWarning(uint64_t warning_type, const void *repeat_key,
                            const char *fmt, ...) {
   bool print_warning = true;
@@ -1575,6 +1575,8 @@ void Target::SymbolsDidLoad(ModuleList &module_list) {
 void Target::ModulesDidUnload(ModuleList &module_list, bool delete_locations) {
   if (m_valid && module_list.GetSize()) {
     UnloadModuleSections(module_list);
+    if (m_process_sp)
+      m_process_sp->ModulesDidUnload(module_list);
     m_breakpoint_list.UpdateBreakpoints(module_list, false, delete_locations);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, false,
                                                  delete_locations);
@@ -3498,6 +3500,11 @@ static PropertyDefinition g_properties[] = {
                        "support."},
     {"non-stop-mode", OptionValue::eTypeBoolean, false, 0, nullptr, nullptr,
      "Disable lock-step debugging, instead control threads independently."},
+    {"breakpoint-conditions-in-target", OptionValue::eTypeBoolean, false, false,
+     nullptr, nullptr, "If true, simple breakpoint conditions are compiled and "
+                       "handed to debug servers which can evaluate them, so "
+                       "that hits where the condition is false don't stop "
+                       "the process."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
 enum {
@@ -3543,6 +3550,7 @@ enum {
   ePropertyTrapHandlerNames,
   ePropertyDisplayRuntimeSupportValues,
   ePropertyNonStopModeEnabled,
+  ePropertyBreakpointConditionsInTarget,
   ePropertyExperimental
 };
 
@@ -4110,6 +4118,12 @@ void TargetProperties::SetNonStopModeEnabled(bool b) {
   m_collection_sp->SetPropertyAtIndexAsBoolean(nullptr, idx, b);
 }
 
+bool TargetProperties::GetBreakpointConditionsInTarget() const {
+  const uint32_t idx = ePropertyBreakpointConditionsInTarget;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 const ProcessLaunchInfo &TargetProperties::GetProcessLaunchInfo() {
   m_launch_info.SetArg0(GetArg0()); // FIXME: Arg0 callback doesn't work
   return m_launch_info;
@@ -1612,6 +1612,19 @@ StackFrameListSP Thread::GetStackFrameList() {
   return frame_list_sp;
 }
 
+void Thread::UnwindConcreteFrames(uint32_t num_frames) {
+  std::lock_guard<std::recursive_mutex> guard(m_frame_mutex);
+  Unwind *unwinder = GetUnwinder();
+  if (!unwinder || num_frames == 0)
+    return;
+  if (num_frames == UINT32_MAX) {
+    unwinder->GetFrameCount();
+  } else {
+    lldb::addr_t cfa, pc;
+    unwinder->GetFrameInfoAtIndex(num_frames - 1, cfa, pc);
+  }
+}
+
 void Thread::ClearStackFrames() {
   std::lock_guard<std::recursive_mutex> guard(m_frame_mutex);
 
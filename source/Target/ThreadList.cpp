@@ -16,6 +16,7 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/State.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Thread.h"
@@ -480,6 +481,35 @@ void ThreadList::DiscardThreadPlans() {
     (*pos)->DiscardThreadPlans(true);
 }
 
+void ThreadList::UnwindAllThreads(uint32_t num_frames) {
+  if (!m_process->GetParallelUnwind() ||
+      !StateIsStoppedState(m_process->GetState(), true))
+    return;
+
+  // Threads an OS plugin provides may be unwound through the script
+  // interpreter, which can't be entered from several threads at once.
+  if (m_process->GetOperatingSystem())
+    return;
+
+  collection threads;
+  {
+    std::lock_guard<std::recursive_mutex> guard(GetMutex());
+    m_process->UpdateThreadListIfNeeded();
+    threads = m_threads;
+  }
+  if (threads.size() < 2)
+    return;
+
+  // The process creates these lazily, so do that here rather than racing
+  // to do it from the tasks.
+  m_process->GetABI();
+  m_process->GetDynamicLoader();
+
+  TaskMapOverInt(0, threads.size(), [&](size_t idx) {
+    threads[idx]->UnwindConcreteFrames(num_frames);
+  });
+}
+
 bool ThreadList::WillResume() {
   // Run through the threads and perform their momentary actions.
   // But we only do this for threads that are running, user suspended
@@ -302,6 +302,12 @@ bool ThreadPlanStepRange::SetNextBranchBreakpoint() {
   if (!m_use_fast_step)
     return false;
 
+  // If the process can step through the whole range in one resume, that
+  // is cheaper than running to the next branch and stepping over it.
+  ProcessSP process_sp(m_thread.GetProcess());
+  if (process_sp && process_sp->SupportsRangeStepping())
+    return false;
+
   lldb::addr_t cur_addr = GetThread().GetRegisterContext()->GetPC();
   // Find the current address in our address ranges, and fetch the disassembly
   // if we haven't already:
@@ -412,6 +418,26 @@ StateType ThreadPlanStepRange::GetPlanRunState() {
     return eStateStepping;
 }
 
+bool ThreadPlanStepRange::GetSteppingRange(lldb::addr_t &start,
+                                           lldb::addr_t &end) {
+  // When running to the next branch breakpoint we aren't stepping.
+  if (m_next_branch_bp_sp)
+    return false;
+
+  Target *target = m_thread.CalculateTarget().get();
+  lldb::addr_t pc_load_addr = m_thread.GetRegisterContext()->GetPC();
+  for (const AddressRange &range : m_address_ranges) {
+    if (!range.ContainsLoadAddress(pc_load_addr, target))
+      continue;
+    start = range.GetBaseAddress().GetLoadAddress(target);
+    if (start == LLDB_INVALID_ADDRESS)
+      return false;
+    end = start + range.GetByteSize();
+    return true;
+  }
+  return false;
+}
+
 bool ThreadPlanStepRange::MischiefManaged() {
   // If we have pushed some plans between ShouldStop & MischiefManaged, then
   // we're not done...
@@ -0,0 +1,322 @@
+//===-- AgentExpression.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/AgentExpression.h"
+
+#include <inttypes.h> // for PRIx64
+#include <string.h>   // for memcpy
+
+#include <utility>
+
+using namespace lldb_private;
+
+namespace {
+// Keeps a malformed expression from running away with the server.
+enum { kMaxStackSize = 100, kMaxSteps = 10000 };
+} // namespace
+
+void AgentExpression::AppendBigEndian(uint64_t value, size_t size) {
+  for (size_t i = size; i > 0; --i)
+    m_bytecode.push_back(static_cast<uint8_t>(value >> ((i - 1) * 8)));
+}
+
+void AgentExpression::AppendConstant(uint64_t value) {
+  if (value <= UINT8_MAX) {
+    AppendOpcode(eOpConst8);
+    AppendBigEndian(value, 1);
+  } else if (value <= UINT16_MAX) {
+    AppendOpcode(eOpConst16);
+    AppendBigEndian(value, 2);
+  } else if (value <= UINT32_MAX) {
+    AppendOpcode(eOpConst32);
+    AppendBigEndian(value, 4);
+  } else {
+    AppendOpcode(eOpConst64);
+    AppendBigEndian(value, 8);
+  }
+}
+
+void AgentExpression::AppendRegister(uint32_t reg_num) {
+  AppendOpcode(eOpReg);
+  AppendBigEndian(reg_num, 2);
+}
+
+void AgentExpression::AppendExtend(uint8_t bits, bool is_signed) {
+  AppendOpcode(is_signed ? eOpExt : eOpZeroExt);
+  AppendBigEndian(bits, 1);
+}
+
+Status AgentExpression::Evaluate(ReadRegisterCallback read_register,
+                                 ReadMemoryCallback read_memory,
+                                 uint64_t &result) const {
+  uint64_t stack[kMaxStackSize];
+  size_t depth = 0;
+  size_t pc = 0;
+  const size_t end = m_bytecode.size();
+
+  // Reads a big endian operand of the current opcode.
+  auto get_operand = [&](size_t size, uint64_t &value) {
+    if (pc + size > end)
+      return false;
+    value = 0;
+    for (size_t i = 0; i < size; ++i)
+      value = (value << 8) | m_bytecode[pc++];
+    return true;
+  };
+
+  for (uint32_t steps = 0; steps < kMaxSteps; ++steps) {
+    if (pc >= end)
+      return Status("agent expression ends without an end opcode");
+
+    const size_t opcode_offset = pc;
+    const uint8_t opcode = m_bytecode[pc++];
+
+    // Check the stack for the opcodes that pop values.
+    size_t num_popped = 0;
+    switch (opcode) {
+    case eOpAdd:
+    case eOpSub:
+    case eOpMul:
+    case eOpDivSigned:
+    case eOpDivUnsigned:
+    case eOpRemSigned:
+    case eOpRemUnsigned:
+    case eOpLsh:
+    case eOpRshSigned:
+    case eOpRshUnsigned:
+    case eOpBitAnd:
+    case eOpBitOr:
+    case eOpBitXor:
+    case eOpEqual:
+    case eOpLessSigned:
+    case eOpLessUnsigned:
+    case eOpSwap:
+      num_popped = 2;
+      break;
+    case eOpLogNot:
+    case eOpBitNot:
+    case eOpExt:
+    case eOpZeroExt:
+    case eOpRef8:
+    case eOpRef16:
+    case eOpRef32:
+    case eOpRef64:
+    case eOpIfGoto:
+    case eOpEnd:
+    case eOpDup:
+    case eOpPop:
+      num_popped = 1;
+      break;
+    }
+    if (depth < num_popped)
+      return Status("agent expression stack underflow at offset %zu",
+                    opcode_offset);
+    if (depth == kMaxStackSize &&
+        (opcode == eOpDup || opcode == eOpReg ||
+         (opcode >= eOpConst8 && opcode <= eOpConst64)))
+      return Status("agent expression stack overflow at offset %zu",
+                    opcode_offset);
+
+    uint64_t *top = depth > 0 ? &stack[depth - 1] : nullptr;
+    switch (opcode) {
+    case eOpAdd:
+    case eOpSub:
+    case eOpMul:
+    case eOpDivSigned:
+    case eOpDivUnsigned:
+    case eOpRemSigned:
+    case eOpRemUnsigned:
+    case eOpLsh:
+    case eOpRshSigned:
+    case eOpRshUnsigned:
+    case eOpBitAnd:
+    case eOpBitOr:
+    case eOpBitXor:
+    case eOpEqual:
+    case eOpLessSigned:
+    case eOpLessUnsigned: {
+      // The value pushed first is the left hand side.
+      const uint64_t b = stack[--depth];
+      uint64_t &a = stack[depth - 1];
+      const int64_t sa = static_cast<int64_t>(a);
+      const int64_t sb = static_cast<int64_t>(b);
+      if (b == 0 && (opcode == eOpDivSigned || opcode == eOpDivUnsigned ||
+                     opcode == eOpRemSigned || opcode == eOpRemUnsigned))
+        return Status("agent expression divides by zero at offset %zu",
+                      opcode_offset);
+      switch (opcode) {
+      case eOpAdd:
+        a += b;
+        break;
+      case eOpSub:
+        a -= b;
+        break;
+      case eOpMul:
+        a *= b;
+        break;
+      case eOpDivSigned:
+        a = (sa == INT64_MIN && sb == -1) ? a : sa / sb;
+        break;
+      case eOpDivUnsigned:
+        a /= b;
+        break;
+      case eOpRemSigned:
+        a = sb == -1 ? 0 : sa % sb;
+        break;
+      case eOpRemUnsigned:
+        a %= b;
+        break;
+      case eOpLsh:
+        a = b < 64 ? a << b : 0;
+        break;
+      case eOpRshSigned:
+        a = sa >> (b < 64 ? b : 63);
+        break;
+      case eOpRshUnsigned:
+        a = b < 64 ? a >> b : 0;
+        break;
+      case eOpBitAnd:
+        a &= b;
+        break;
+      case eOpBitOr:
+        a |= b;
+        break;
+      case eOpBitXor:
+        a ^= b;
+        break;
+      case eOpEqual:
+        a = a == b;
+        break;
+      case eOpLessSigned:
+        a = sa < sb;
+        break;
+      case eOpLessUnsigned:
+        a = a < b;
+        break;
+      }
+      break;
+    }
+
+    case eOpLogNot:
+      *top = !*top;
+      break;
+
+    case eOpBitNot:
+      *top = ~*top;
+      break;
+
+    case eOpExt:
+    case eOpZeroExt: {
+      uint64_t bits;
+      if (!get_operand(1, bits))
+        return Status("agent expression is truncated at offset %zu",
+                      opcode_offset);
+      if (bits == 0 || bits >= 64)
+        break;
+      if (opcode == eOpExt)
+        *top = static_cast<int64_t>(*top << (64 - bits)) >> (64 - bits);
+      else
+        *top &= (UINT64_C(1) << bits) - 1;
+      break;
+    }
+
+    case eOpRef8:
+    case eOpRef16:
+    case eOpRef32:
+    case eOpRef64: {
+      const size_t size = size_t(1) << (opcode - eOpRef8);
+      uint8_t buf[8];
+      if (!read_memory(*top, buf, size))
+        return Status("agent expression failed to read %zu bytes at "
+                      "0x%" PRIx64,
+                      size, *top);
+      switch (size) {
+      case 1:
+        *top = buf[0];
+        break;
+      case 2: {
+        uint16_t value;
+        memcpy(&value, buf, sizeof(value));
+        *top = value;
+        break;
+      }
+      case 4: {
+        uint32_t value;
+        memcpy(&value, buf, sizeof(value));
+        *top = value;
+        break;
+      }
+      default:
+        memcpy(top, buf, sizeof(*top));
+        break;
+      }
+      break;
+    }
+
+    case eOpIfGoto:
+    case eOpGoto: {
+      uint64_t target;
+      if (!get_operand(2, target))
+        return Status("agent expression is truncated at offset %zu",
+                      opcode_offset);
+      if (opcode == eOpGoto || stack[--depth] != 0)
+        pc = target;
+      break;
+    }
+
+    case eOpConst8:
+    case eOpConst16:
+    case eOpConst32:
+    case eOpConst64: {
+      uint64_t value;
+      if (!get_operand(size_t(1) << (opcode - eOpConst8), value))
+        return Status("agent expression is truncated at offset %zu",
+                      opcode_offset);
+      stack[depth++] = value;
+      break;
+    }
+
+    case eOpReg: {
+      uint64_t reg_num;
+      if (!get_operand(2, reg_num))
+        return Status("agent expression is truncated at offset %zu",
+                      opcode_offset);
+      uint64_t value;
+      if (!read_register(reg_num, value))
+        return Status("agent expression failed to read register %" PRIu64,
+                      reg_num);
+      stack[depth++] = value;
+      break;
+    }
+
+    case eOpEnd:
+      result = *top;
+      return Status();
+
+    case eOpDup:
+      stack[depth] = *top;
+      ++depth;
+      break;
+
+    case eOpPop:
+      --depth;
+      break;
+
+    case eOpSwap:
+      std::swap(*top, stack[depth - 2]);
+      break;
+
+    default:
+      return Status("unsupported agent expression opcode 0x%2.2x at offset %zu",
+                    opcode, opcode_offset);
+    }
+  }
+
+  return Status("agent expression did not finish in %u steps", kMaxSteps);
+}
@@ -16,12 +16,15 @@
 #include "llvm/ADT/iterator.h"            // for iterator_facade_base
 #include "llvm/Support/Allocator.h"       // for BumpPtrAllocator
 #include "llvm/Support/FormatProviders.h" // for format_provider
-#include "llvm/Support/RWMutex.h"
 #include "llvm/Support/Threading.h"
 
 #include <algorithm> // for min
 #include <array>
+#include <atomic>
+#include <memory> // for unique_ptr
+#include <mutex>
 #include <utility> // for make_pair, pair
+#include <vector>
 
 #include <inttypes.h> // for PRIu64
 #include <stdint.h>   // for uint8_t, uint32_t, uint64_t
@@ -31,9 +34,9 @@ using namespace lldb_private;
 
 class Pool {
 public:
-  typedef const char *StringPoolValueType;
-  typedef llvm::StringMap<StringPoolValueType, llvm::BumpPtrAllocator>
-      StringPool;
+  // The mangled counterpart is set without holding any lock, so it is
+  // atomic.
+  typedef std::atomic<const char *> StringPoolValueType;
   typedef llvm::StringMapEntry<StringPoolValueType> StringPoolEntryType;
 
   static StringPoolEntryType &
@@ -51,27 +54,19 @@ public:
     return 0;
   }
 
-  StringPoolValueType GetMangledCounterpart(const char *ccstr) const {
-    if (ccstr != nullptr) {
-      const uint8_t h = hash(llvm::StringRef(ccstr));
-      llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-      return GetStringMapEntryFromKeyData(ccstr).getValue();
-    }
+  const char *GetMangledCounterpart(const char *ccstr) const {
+    if (ccstr != nullptr)
+      return GetStringMapEntryFromKeyData(ccstr).getValue().load(
+          std::memory_order_acquire);
     return nullptr;
   }
 
   bool SetMangledCounterparts(const char *key_ccstr, const char *value_ccstr) {
     if (key_ccstr != nullptr && value_ccstr != nullptr) {
-      {
-        const uint8_t h = hash(llvm::StringRef(key_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-        GetStringMapEntryFromKeyData(key_ccstr).setValue(value_ccstr);
-      }
-      {
-        const uint8_t h = hash(llvm::StringRef(value_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-        GetStringMapEntryFromKeyData(value_ccstr).setValue(key_ccstr);
-      }
+      GetStringMapEntryFromKeyData(key_ccstr).getValue().store(
+          value_ccstr, std::memory_order_release);
+      GetStringMapEntryFromKeyData(value_ccstr).getValue().store(
+          key_ccstr, std::memory_order_release);
       return true;
     }
     return false;
@@ -91,21 +86,15 @@ public:
 
   const char *GetConstCStringWithStringRef(const llvm::StringRef &string_ref) {
     if (string_ref.data()) {
-      const uint8_t h = hash(string_ref);
+      const uint32_t h = llvm::HashString(string_ref);
+      PoolEntry &pool = m_string_pools[ShardIndex(h)];
+      pool.m_num_lookups.fetch_add(1, std::memory_order_relaxed);
 
-      {
-        llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-        auto it = m_string_pools[h].m_string_map.find(string_ref);
-        if (it != m_string_pools[h].m_string_map.end())
-          return it->getKeyData();
+      if (StringPoolEntryType *entry = pool.Find(string_ref, h)) {
+        pool.m_num_lock_free_hits.fetch_add(1, std::memory_order_relaxed);
+        return entry->getKeyData();
       }
-
-      llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-      StringPoolEntryType &entry =
-          *m_string_pools[h]
-               .m_string_map.insert(std::make_pair(string_ref, nullptr))
-               .first;
-      return entry.getKeyData();
+      return pool.Insert(string_ref, h, nullptr).getKeyData();
     }
     return nullptr;
   }
@@ -114,30 +103,18 @@ public:
   GetConstCStringAndSetMangledCounterPart(const char *demangled_cstr,
                                           const char *mangled_ccstr) {
     if (demangled_cstr != nullptr) {
-      const char *demangled_ccstr = nullptr;
-
-      {
-        llvm::StringRef string_ref(demangled_cstr);
-        const uint8_t h = hash(string_ref);
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-
-        // Make string pool entry with the mangled counterpart already set
-        StringPoolEntryType &entry =
-            *m_string_pools[h]
-                 .m_string_map.insert(std::make_pair(string_ref, mangled_ccstr))
-                 .first;
-
-        // Extract the const version of the demangled_cstr
-        demangled_ccstr = entry.getKeyData();
-      }
-
-      {
-        // Now assign the demangled const string as the counterpart of the
-        // mangled const string...
-        const uint8_t h = hash(llvm::StringRef(mangled_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-        GetStringMapEntryFromKeyData(mangled_ccstr).setValue(demangled_ccstr);
-      }
+      // Make string pool entry with the mangled counterpart already set
+      llvm::StringRef string_ref(demangled_cstr);
+      const uint32_t h = llvm::HashString(string_ref);
+      const char *demangled_ccstr =
+          m_string_pools[ShardIndex(h)]
+              .Insert(string_ref, h, mangled_ccstr)
+              .getKeyData();
+
+      // Now assign the demangled const string as the counterpart of the
+      // mangled const string...
+      GetStringMapEntryFromKeyData(mangled_ccstr).getValue().store(
+          demangled_ccstr, std::memory_order_release);
 
       // Return the constant demangled C string
       return demangled_ccstr;
@@ -159,25 +136,141 @@ public:
   // collection of uniqued strings + data count values takes in
   // memory.
   //------------------------------------------------------------------
-  size_t MemorySize() const {
-    size_t mem_size = sizeof(Pool);
+  size_t MemorySize() const { return sizeof(Pool) + GetStats().memory_size; }
+
+  ConstString::Stats GetStats() const {
+    ConstString::Stats stats;
     for (const auto &pool : m_string_pools) {
-      llvm::sys::SmartScopedReader<false> rlock(pool.m_mutex);
-      for (const auto &entry : pool.m_string_map)
-        mem_size += sizeof(StringPoolEntryType) + entry.getKey().size();
+      {
+        std::lock_guard<std::mutex> guard(pool.m_mutex);
+        stats.num_strings += pool.m_num_entries;
+        stats.string_bytes += pool.m_string_bytes;
+        stats.memory_size +=
+            pool.m_num_entries * sizeof(StringPoolEntryType) +
+            pool.m_string_bytes + pool.m_table_bytes;
+      }
+      stats.num_lookups += pool.m_num_lookups.load(std::memory_order_relaxed);
+      stats.num_lock_free_hits +=
+          pool.m_num_lock_free_hits.load(std::memory_order_relaxed);
+      stats.num_lock_contentions +=
+          pool.m_num_lock_contentions.load(std::memory_order_relaxed);
     }
-    return mem_size;
+    return stats;
   }
 
 protected:
-  uint8_t hash(const llvm::StringRef &s) const {
-    uint32_t h = llvm::HashString(s);
+  static uint8_t ShardIndex(uint32_t h) {
     return ((h >> 24) ^ (h >> 16) ^ (h >> 8) ^ h) & 0xff;
   }
 
+  //------------------------------------------------------------------
+  // Every thread allocates the entries it inserts from its own bump
+  // allocator so that the insertions into different shards never share
+  // an allocator. The strings live as long as the pool, which is never
+  // destroyed, so the allocators are leaked when their threads exit.
+  //------------------------------------------------------------------
+  static llvm::BumpPtrAllocator &GetThreadAllocator() {
+    static thread_local llvm::BumpPtrAllocator *g_allocator = nullptr;
+    if (g_allocator == nullptr)
+      g_allocator = new llvm::BumpPtrAllocator();
+    return *g_allocator;
+  }
+
+  //------------------------------------------------------------------
+  // An open addressing hash table of the entries in a shard. Buckets are
+  // only ever filled in, and a table that is outgrown is retired but not
+  // freed, so readers can search a table without holding any lock.
+  //------------------------------------------------------------------
+  struct Bucket {
+    std::atomic<uint32_t> hash{0};
+    std::atomic<StringPoolEntryType *> entry{nullptr};
+  };
+
+  struct Table {
+    explicit Table(size_t num_buckets)
+        : mask(num_buckets - 1), buckets(new Bucket[num_buckets]) {}
+
+    StringPoolEntryType *Find(llvm::StringRef s, uint32_t h) const {
+      for (size_t i = h & mask;; i = (i + 1) & mask) {
+        StringPoolEntryType *entry =
+            buckets[i].entry.load(std::memory_order_acquire);
+        if (entry == nullptr)
+          return nullptr;
+        if (buckets[i].hash.load(std::memory_order_relaxed) == h &&
+            entry->getKey() == s)
+          return entry;
+      }
+    }
+
+    // The caller holds the shard lock and the table is never full.
+    void Add(StringPoolEntryType *entry, uint32_t h) {
+      size_t i = h & mask;
+      while (buckets[i].entry.load(std::memory_order_relaxed) != nullptr)
+        i = (i + 1) & mask;
+      buckets[i].hash.store(h, std::memory_order_relaxed);
+      buckets[i].entry.store(entry, std::memory_order_release);
+    }
+
+    const size_t mask;
+    std::unique_ptr<Bucket[]> buckets;
+  };
+
   struct PoolEntry {
-    mutable llvm::sys::SmartRWMutex<false> m_mutex;
-    StringPool m_string_map;
+    StringPoolEntryType *Find(llvm::StringRef s, uint32_t h) const {
+      const Table *table = m_table.load(std::memory_order_acquire);
+      return table ? table->Find(s, h) : nullptr;
+    }
+
+    StringPoolEntryType &Insert(llvm::StringRef s, uint32_t h,
+                                const char *value) {
+      std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+      if (!lock.owns_lock()) {
+        m_num_lock_contentions.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+      }
+
+      // Another thread may have added the string since it was looked up.
+      if (StringPoolEntryType *entry = Find(s, h))
+        return *entry;
+
+      Table *table = m_table.load(std::memory_order_relaxed);
+      // Keep the tables at most half full so probes stay short.
+      if (table == nullptr || (m_num_entries + 1) * 2 > table->mask + 1) {
+        const size_t num_buckets = table ? (table->mask + 1) * 2 : 64;
+        std::unique_ptr<Table> new_table(new Table(num_buckets));
+        if (table) {
+          for (size_t i = 0; i <= table->mask; ++i) {
+            if (StringPoolEntryType *entry = table->buckets[i].entry.load(
+                    std::memory_order_relaxed))
+              new_table->Add(entry,
+                             table->buckets[i].hash.load(
+                                 std::memory_order_relaxed));
+          }
+        }
+        table = new_table.get();
+        m_tables.push_back(std::move(new_table));
+        m_table_bytes += num_buckets * sizeof(Bucket);
+        m_table.store(table, std::memory_order_release);
+      }
+
+      StringPoolEntryType *entry =
+          StringPoolEntryType::Create(s, GetThreadAllocator(), value);
+      table->Add(entry, h);
+      ++m_num_entries;
+      m_string_bytes += s.size() + 1;
+      return *entry;
+    }
+
+    mutable std::mutex m_mutex;
+    std::atomic<Table *> m_table{nullptr};
+    // All the tables this shard has used, the last one is m_table.
+    std::vector<std::unique_ptr<Table>> m_tables;
+    size_t m_num_entries = 0;
+    size_t m_string_bytes = 0;
+    size_t m_table_bytes = 0;
+    std::atomic<uint64_t> m_num_lookups{0};
+    std::atomic<uint64_t> m_num_lock_free_hits{0};
+    std::atomic<uint64_t> m_num_lock_contentions{0};
   };
 
   std::array<PoolEntry, 256> m_string_pools;
@@ -333,6 +426,8 @@ size_t ConstString::StaticMemorySize() {
   return StringPool().MemorySize();
 }
 
+ConstString::Stats ConstString::GetStats() { return StringPool().GetStats(); }
+
 void llvm::format_provider<ConstString>::format(const ConstString &CS,
                                                 llvm::raw_ostream &OS,
                                                 llvm::StringRef Options) {
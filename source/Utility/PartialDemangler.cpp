@@ -0,0 +1,546 @@
+//===-- PartialDemangler.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/PartialDemangler.h"
+
+#include <ctype.h>  // for isdigit, isupper
+#include <string.h> // for memcpy
+
+using namespace lldb_private;
+
+PartialDemangler::PartialDemangler()
+    : m_pos(nullptr), m_end(nullptr), m_size(0), m_num_substitutions(0),
+      m_basename(), m_context(), m_template_args(), m_qualifiers(),
+      m_qualifier_flags(0), m_is_ctor_or_dtor(false) {}
+
+bool PartialDemangler::Parse(llvm::StringRef mangled_name) {
+  m_pos = mangled_name.begin();
+  m_end = mangled_name.end();
+  m_size = 0;
+  m_num_substitutions = 0;
+  m_basename = m_context = m_template_args = m_qualifiers = Range();
+  m_qualifier_flags = 0;
+  m_is_ctor_or_dtor = false;
+
+  // Clones like "foo.cold.1" carry a suffix the full demangler rejects.
+  if (Consume("_Z") && mangled_name.find('.') == llvm::StringRef::npos &&
+      ParseEncoding()) {
+    const size_t qualifiers_begin = m_size;
+    static const struct {
+      unsigned flag;
+      const char *name;
+    } g_qualifier_names[] = {{eQualifierConst, "const"},
+                             {eQualifierVolatile, "volatile"},
+                             {eQualifierRestrict, "restrict"},
+                             {eQualifierLValueRef, "&"},
+                             {eQualifierRValueRef, "&&"}};
+    bool success = true;
+    for (const auto &qualifier : g_qualifier_names) {
+      if ((m_qualifier_flags & qualifier.flag) == 0)
+        continue;
+      if (m_size != qualifiers_begin)
+        success = success && Append(" ");
+      success = success && Append(qualifier.name);
+    }
+    if (success) {
+      m_qualifiers = {uint16_t(qualifiers_begin), uint16_t(m_size)};
+      return true;
+    }
+  }
+  m_basename = m_context = m_template_args = m_qualifiers = Range();
+  return false;
+}
+
+bool PartialDemangler::Consume(char c) {
+  if (m_pos == m_end || *m_pos != c)
+    return false;
+  ++m_pos;
+  return true;
+}
+
+bool PartialDemangler::Consume(llvm::StringRef prefix) {
+  if (!llvm::StringRef(m_pos, m_end - m_pos).startswith(prefix))
+    return false;
+  m_pos += prefix.size();
+  return true;
+}
+
+bool PartialDemangler::Append(llvm::StringRef text) {
+  if (m_size + text.size() > kBufferSize)
+    return false;
+  memcpy(m_buffer + m_size, text.data(), text.size());
+  m_size += text.size();
+  return true;
+}
+
+bool PartialDemangler::AppendRange(Range range) {
+  // The range was rendered earlier, so it never overlaps the destination.
+  return Append(GetRange(range));
+}
+
+bool PartialDemangler::AddSubstitution(size_t begin) {
+  if (m_num_substitutions == kMaxSubstitutions)
+    return false;
+  m_substitutions[m_num_substitutions++] = {uint16_t(begin), uint16_t(m_size)};
+  return true;
+}
+
+unsigned PartialDemangler::ParseCVQualifiers() {
+  // <CV-qualifiers> ::= [r] [V] [K]
+  unsigned qualifiers = 0;
+  if (Consume('r'))
+    qualifiers |= eQualifierRestrict;
+  if (Consume('V'))
+    qualifiers |= eQualifierVolatile;
+  if (Consume('K'))
+    qualifiers |= eQualifierConst;
+  return qualifiers;
+}
+
+bool PartialDemangler::AppendCVQualifiers(unsigned qualifiers) {
+  if ((qualifiers & eQualifierConst) && !Append(" const"))
+    return false;
+  if ((qualifiers & eQualifierVolatile) && !Append(" volatile"))
+    return false;
+  if ((qualifiers & eQualifierRestrict) && !Append(" restrict"))
+    return false;
+  return true;
+}
+
+bool PartialDemangler::ParseNumber(size_t &value) {
+  const char *start = m_pos;
+  value = 0;
+  while (m_pos != m_end && isdigit(*m_pos)) {
+    value = value * 10 + (*m_pos++ - '0');
+    if (value > kBufferSize)
+      return false;
+  }
+  return m_pos != start;
+}
+
+bool PartialDemangler::ParseSeqID(size_t &index) {
+  // S_ is the first substitution, S<seq-id>_ is the one after seq-id,
+  // where seq-id is a base 36 number using digits and upper case letters.
+  if (Consume('_')) {
+    index = 0;
+    return true;
+  }
+  const char *start = m_pos;
+  size_t seq_id = 0;
+  for (; m_pos != m_end && *m_pos != '_'; ++m_pos) {
+    if (isdigit(*m_pos))
+      seq_id = seq_id * 36 + (*m_pos - '0');
+    else if (isupper(*m_pos))
+      seq_id = seq_id * 36 + (*m_pos - 'A' + 10);
+    else
+      return false;
+    if (seq_id >= kMaxSubstitutions)
+      return false;
+  }
+  if (m_pos == start || !Consume('_'))
+    return false;
+  index = seq_id + 1;
+  return true;
+}
+
+bool PartialDemangler::ParseEncoding() {
+  // <encoding> ::= <function name> <bare-function-type>
+  bool success;
+  if (m_pos != m_end && *m_pos == 'N')
+    success = ParseNestedName(false);
+  else
+    success = ParseUnscopedName(false);
+  // Only functions are described, and their parameter types are not
+  // needed, but data names have none.
+  return success && m_pos != m_end;
+}
+
+bool PartialDemangler::ParseNestedName(bool is_type) {
+  // <nested-name> ::= N [<CV-qualifiers>] [<ref-qualifier>] <prefix>
+  //                   <unqualified-name> E
+  //               ::= N [<CV-qualifiers>] [<ref-qualifier>]
+  //                   <template-prefix> <template-args> E
+  if (!Consume('N'))
+    return false;
+  unsigned qualifiers = ParseCVQualifiers();
+  if (Consume('R'))
+    qualifiers |= eQualifierLValueRef;
+  else if (Consume('O'))
+    qualifiers |= eQualifierRValueRef;
+  if (is_type && qualifiers)
+    return false;
+
+  const size_t name_begin = m_size;
+  // The start of the last component, its source name (for constructors
+  // and destructors) and its template arguments.
+  size_t component_begin = m_size;
+  Range source_name = Range();
+  Range template_args = Range();
+  bool is_ctor_or_dtor = false;
+  // Every prefix of the name is a substitution candidate, but the name
+  // itself only is if it names a type, which the caller takes care of.
+  bool is_candidate = false;
+  while (!Consume('E')) {
+    if (m_pos == m_end)
+      return false;
+    if (is_candidate && !AddSubstitution(name_begin))
+      return false;
+    is_candidate = true;
+
+    if (*m_pos == 'I') {
+      if (m_size == name_begin)
+        return false;
+      const size_t args_begin = m_size;
+      if (!ParseTemplateArgs())
+        return false;
+      template_args = {uint16_t(args_begin), uint16_t(m_size)};
+      continue;
+    }
+    template_args = Range();
+
+    if (*m_pos == 'S') {
+      // A substitution can only start the prefix, and is a candidate
+      // already.
+      if (m_size != name_begin)
+        return false;
+      is_candidate = false;
+      if (Consume("St")) {
+        if (!Append("std"))
+          return false;
+      } else if (!ParseSubstitution()) {
+        return false;
+      }
+      component_begin = m_size;
+      source_name = Range();
+      continue;
+    }
+
+    if (m_size != name_begin && !Append("::"))
+      return false;
+    component_begin = m_size;
+    if (*m_pos == 'C' || *m_pos == 'D') {
+      if (!ParseCtorDtorName(source_name))
+        return false;
+      is_ctor_or_dtor = true;
+    } else if (!ParseUnqualifiedName(source_name)) {
+      return false;
+    }
+  }
+  if (component_begin == m_size)
+    return false;
+  if (is_type)
+    return true;
+
+  m_qualifier_flags = qualifiers;
+  m_context = {uint16_t(name_begin),
+               uint16_t(component_begin == name_begin ? name_begin
+                                                      : component_begin - 2)};
+  m_basename = {uint16_t(component_begin), uint16_t(m_size)};
+  m_template_args = template_args;
+  m_is_ctor_or_dtor = is_ctor_or_dtor;
+  return true;
+}
+
+bool PartialDemangler::ParseUnscopedName(bool is_type) {
+  // <unscoped-name> ::= [St] <unqualified-name>
+  // <unscoped-template-name> ::= <unscoped-name>
+  const size_t name_begin = m_size;
+  if (Consume("St") && !Append("std::"))
+    return false;
+  const size_t component_begin = m_size;
+  Range source_name;
+  if (!ParseUnqualifiedName(source_name))
+    return false;
+
+  Range template_args = Range();
+  if (m_pos != m_end && *m_pos == 'I') {
+    // The template name is a candidate, the caller adds the whole name
+    // if it names a type.
+    if (!AddSubstitution(name_begin))
+      return false;
+    const size_t args_begin = m_size;
+    if (!ParseTemplateArgs())
+      return false;
+    template_args = {uint16_t(args_begin), uint16_t(m_size)};
+  }
+  if (is_type)
+    return true;
+
+  m_context = {uint16_t(name_begin),
+               uint16_t(component_begin == name_begin ? name_begin
+                                                      : component_begin - 2)};
+  m_basename = {uint16_t(component_begin), uint16_t(m_size)};
+  m_template_args = template_args;
+  return true;
+}
+
+bool PartialDemangler::ParseUnqualifiedName(Range &source_name) {
+  // Internal linkage names are mangled with an L that is not rendered.
+  Consume('L');
+  // Operators, unnamed types and the like are left to the full demangler.
+  if (m_pos == m_end || !isdigit(*m_pos))
+    return false;
+  if (!ParseSourceName(source_name))
+    return false;
+  // So are ABI tags.
+  return m_pos == m_end || *m_pos != 'B';
+}
+
+bool PartialDemangler::ParseSourceName(Range &source_name) {
+  // <source-name> ::= <positive length number> <identifier>
+  size_t length;
+  if (!ParseNumber(length) || length == 0 ||
+      length > size_t(m_end - m_pos))
+    return false;
+  const llvm::StringRef identifier(m_pos, length);
+  m_pos += length;
+
+  const size_t begin = m_size;
+  if (identifier.startswith("_GLOBAL__N")) {
+    if (!Append("(anonymous namespace)"))
+      return false;
+  } else if (!Append(identifier)) {
+    return false;
+  }
+  source_name = {uint16_t(begin), uint16_t(m_size)};
+  return true;
+}
+
+bool PartialDemangler::ParseCtorDtorName(Range class_name) {
+  // <ctor-dtor-name> ::= C1 | C2 | C3 | D0 | D1 | D2, plus the unified
+  // C4, C5, D4 and D5 that gcc emits. They are rendered as the name of
+  // the class, which has to be known.
+  if (class_name.begin == class_name.end || m_end - m_pos < 2)
+    return false;
+  const char kind = *m_pos++;
+  const char variant = *m_pos++;
+  if (kind == 'C' && variant >= '1' && variant <= '5')
+    return AppendRange(class_name);
+  if (kind == 'D' && variant >= '0' && variant <= '5')
+    return Append("~") && AppendRange(class_name);
+  return false;
+}
+
+bool PartialDemangler::ParseSubstitution() {
+  // <substitution> ::= S_ | S <seq-id> _ | Sa | Sb
+  // The other abbreviations are rendered specially by the full demangler
+  // depending on where they are used.
+  if (!Consume('S'))
+    return false;
+  if (Consume('a'))
+    return Append("std::allocator");
+  if (Consume('b'))
+    return Append("std::basic_string");
+  size_t index;
+  if (!ParseSeqID(index) || index >= m_num_substitutions)
+    return false;
+  return AppendRange(m_substitutions[index]);
+}
+
+bool PartialDemangler::ParseTemplateArgs() {
+  // <template-args> ::= I <template-arg>+ E
+  if (!Consume('I') || !Append("<"))
+    return false;
+  bool is_first = true;
+  while (!Consume('E')) {
+    if (m_pos == m_end)
+      return false;
+    if (!is_first && !Append(", "))
+      return false;
+    is_first = false;
+    if (!ParseTemplateArg())
+      return false;
+  }
+  if (is_first)
+    return false;
+  // Nested argument lists are closed with "> >".
+  return Append(m_buffer[m_size - 1] == '>' ? " >" : ">");
+}
+
+bool PartialDemangler::ParseTemplateArg() {
+  // <template-arg> ::= <type> | <expr-primary>
+  if (m_pos != m_end && *m_pos == 'L')
+    return ParseLiteral();
+  return ParseType();
+}
+
+bool PartialDemangler::ParseLiteral() {
+  // <expr-primary> ::= L <type> [n] <value number> E
+  if (!Consume('L') || m_pos == m_end)
+    return false;
+  const char type = *m_pos++;
+  const bool is_negative = Consume('n');
+  const char *digits = m_pos;
+  while (m_pos != m_end && isdigit(*m_pos))
+    ++m_pos;
+  const llvm::StringRef value(digits, m_pos - digits);
+  if (value.empty() || !Consume('E'))
+    return false;
+
+  const char *suffix;
+  switch (type) {
+  case 'b':
+    if (is_negative || (value != "0" && value != "1"))
+      return false;
+    return Append(value == "1" ? "true" : "false");
+  case 'i':
+    suffix = "";
+    break;
+  case 'j':
+    suffix = "u";
+    break;
+  case 'l':
+    suffix = "l";
+    break;
+  case 'm':
+    suffix = "ul";
+    break;
+  case 'x':
+    suffix = "ll";
+    break;
+  case 'y':
+    suffix = "ull";
+    break;
+  default:
+    return false;
+  }
+  return (!is_negative || Append("-")) && Append(value) && Append(suffix);
+}
+
+bool PartialDemangler::ParseType() {
+  if (m_pos == m_end)
+    return false;
+  const size_t type_begin = m_size;
+  switch (*m_pos) {
+  case 'r':
+  case 'V':
+  case 'K': {
+    const unsigned qualifiers = ParseCVQualifiers();
+    if (!ParseType() || !AppendCVQualifiers(qualifiers))
+      return false;
+    break;
+  }
+  case 'P':
+    ++m_pos;
+    if (!ParseType() || !Append("*"))
+      return false;
+    break;
+  case 'R':
+    ++m_pos;
+    if (!ParseType() || !Append("&"))
+      return false;
+    break;
+  case 'O':
+    ++m_pos;
+    if (!ParseType() || !Append("&&"))
+      return false;
+    break;
+  case 'N':
+    if (!ParseNestedName(true))
+      return false;
+    break;
+  case 'S':
+    if (m_pos + 1 != m_end && m_pos[1] == 't') {
+      if (!ParseUnscopedName(true))
+        return false;
+      break;
+    }
+    if (!ParseSubstitution())
+      return false;
+    // A substitution is not a new candidate unless it is a template that
+    // gets arguments here.
+    if (m_pos == m_end || *m_pos != 'I')
+      return true;
+    if (!ParseTemplateArgs())
+      return false;
+    break;
+  default:
+    if (!isdigit(*m_pos))
+      return ParseBuiltinType();
+    if (!ParseUnscopedName(true))
+      return false;
+    break;
+  }
+  return AddSubstitution(type_begin);
+}
+
+bool PartialDemangler::ParseBuiltinType() {
+  // Builtin types are not substitution candidates. Vendor extended and
+  // the "D" types are left to the full demangler.
+  const char *name;
+  switch (*m_pos) {
+  case 'v':
+    name = "void";
+    break;
+  case 'w':
+    name = "wchar_t";
+    break;
+  case 'b':
+    name = "bool";
+    break;
+  case 'c':
+    name = "char";
+    break;
+  case 'a':
+    name = "signed char";
+    break;
+  case 'h':
+    name = "unsigned char";
+    break;
+  case 's':
+    name = "short";
+    break;
+  case 't':
+    name = "unsigned short";
+    break;
+  case 'i':
+    name = "int";
+    break;
+  case 'j':
+    name = "unsigned int";
+    break;
+  case 'l':
+    name = "long";
+    break;
+  case 'm':
+    name = "unsigned long";
+    break;
+  case 'x':
+    name = "long long";
+    break;
+  case 'y':
+    name = "unsigned long long";
+    break;
+  case 'n':
+    name = "__int128";
+    break;
+  case 'o':
+    name = "unsigned __int128";
+    break;
+  case 'f':
+    name = "float";
+    break;
+  case 'd':
+    name = "double";
+    break;
+  case 'e':
+    name = "long double";
+    break;
+  case 'g':
+    name = "__float128";
+    break;
+  case 'z':
+    name = "...";
+    break;
+  default:
+    return false;
+  }
+  ++m_pos;
+  return Append(name);
+}
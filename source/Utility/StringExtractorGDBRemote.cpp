@@ -96,10 +96,17 @@ StringExtractorGDBRemote::GetServerPacketType() const {
         return eServerPacketType_QEnvironment;
       if (PACKET_STARTS_WITH("QEnvironmentHexEncoded:"))
         return eServerPacketType_QEnvironmentHexEncoded;
+      if (PACKET_STARTS_WITH("QEnableCompression:"))
+        return eServerPacketType_QEnableCompression;
       if (PACKET_STARTS_WITH("QEnableErrorStrings"))
         return eServerPacketType_QEnableErrorStrings;
       break;
 
+    case 'N':
+      if (PACKET_STARTS_WITH("QNonStop:"))
+        return eServerPacketType_QNonStop;
+      break;
+
     case 'P':
       if (PACKET_STARTS_WITH("QPassSignals:"))
         return eServerPacketType_QPassSignals;
@@ -288,6 +295,10 @@ StringExtractorGDBRemote::GetServerPacketType() const {
     case 'X':
       if (PACKET_STARTS_WITH("qXfer:auxv:read::"))
         return eServerPacketType_qXfer_auxv_read;
+      if (PACKET_STARTS_WITH("qXfer:features:read:"))
+        return eServerPacketType_qXfer_features_read;
+      if (PACKET_STARTS_WITH("qXfer:libraries-svr4:read::"))
+        return eServerPacketType_qXfer_libraries_svr4_read;
       break;
     }
     break;
@@ -349,6 +360,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
         return eServerPacketType_vCont;
       if (PACKET_MATCHES("vCont?"))
         return eServerPacketType_vCont_actions;
+      if (PACKET_MATCHES("vStopped"))
+        return eServerPacketType_vStopped;
     }
     break;
   case '_':
@@ -400,6 +413,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
     return eServerPacketType_m;
 
   case 'M':
+    if (PACKET_STARTS_WITH("MultiMemRead:"))
+      return eServerPacketType_MultiMemRead;
     return eServerPacketType_M;
 
   case 'p':
@@ -73,6 +73,7 @@ public:
     eServerPacketType_qGetWorkingDir,
     eServerPacketType_qFileLoadAddress,
     eServerPacketType_QEnvironment,
+    eServerPacketType_QEnableCompression,
     eServerPacketType_QEnableErrorStrings,
     eServerPacketType_QLaunchArch,
     eServerPacketType_QSetDisableASLR,
@@ -99,6 +100,7 @@ public:
     // debug server packages
     eServerPacketType_QEnvironmentHexEncoded,
     eServerPacketType_QListThreadsInStopReply,
+    eServerPacketType_QNonStop,
     eServerPacketType_QPassSignals,
     eServerPacketType_QRestoreRegisterState,
     eServerPacketType_QSaveRegisterState,
@@ -130,6 +132,8 @@ public:
     eServerPacketType_qWatchpointSupportInfo,
     eServerPacketType_qWatchpointSupportInfoSupported,
     eServerPacketType_qXfer_auxv_read,
+    eServerPacketType_qXfer_features_read,
+    eServerPacketType_qXfer_libraries_svr4_read,
 
     eServerPacketType_jSignalsInfo,
     eServerPacketType_jModulesInfo,
@@ -140,6 +144,7 @@ public:
     eServerPacketType_vAttachName,
     eServerPacketType_vCont,
     eServerPacketType_vCont_actions, // vCont?
+    eServerPacketType_vStopped,
 
     eServerPacketType_stop_reason, // '?'
 
@@ -153,6 +158,7 @@ public:
     eServerPacketType_k,
     eServerPacketType_m,
     eServerPacketType_M,
+    eServerPacketType_MultiMemRead,
     eServerPacketType_p,
     eServerPacketType_P,
     eServerPacketType_s,
@@ -15,8 +15,9 @@
 #include <utility> // for pair
 #include <vector>
 
-#include <assert.h> // for assert
-#include <stdarg.h> // for va_end, va_list, va_start
+#include <assert.h>   // for assert
+#include <inttypes.h> // for PRIu64
+#include <stdarg.h>   // for va_end, va_list, va_start
 #include <stdio.h>
 
 using namespace lldb_private;
@@ -42,6 +43,7 @@ static TimerStack &GetTimerStackForCurrentThread() {
 
 Timer::Category::Category(const char *cat) : m_name(cat) {
   m_nanos.store(0, std::memory_order_release);
+  m_items.store(0, std::memory_order_release);
   Category *expected = g_categories;
   do {
     m_next = expected;
@@ -102,16 +104,22 @@ void Timer::SetDisplayDepth(uint32_t depth) { g_display_depth = depth; }
  * - returns whether a person is less than another person
  */
 
-typedef std::pair<const char *, uint64_t> TimerEntry;
+struct TimerEntry {
+  const char *name;
+  uint64_t nanos;
+  uint64_t items;
+};
 
 static bool CategoryMapIteratorSortCriterion(const TimerEntry &lhs,
                                              const TimerEntry &rhs) {
-  return lhs.second > rhs.second;
+  return lhs.nanos > rhs.nanos;
 }
 
 void Timer::ResetCategoryTimes() {
-  for (Category *i = g_categories; i; i = i->m_next)
+  for (Category *i = g_categories; i; i = i->m_next) {
     i->m_nanos.store(0, std::memory_order_release);
+    i->m_items.store(0, std::memory_order_release);
+  }
 }
 
 void Timer::DumpCategoryTimes(Stream *s) {
@@ -119,7 +127,8 @@ void Timer::DumpCategoryTimes(Stream *s) {
   for (Category *i = g_categories; i; i = i->m_next) {
     uint64_t nanos = i->m_nanos.load(std::memory_order_acquire);
     if (nanos)
-      sorted.push_back(std::make_pair(i->m_name, nanos));
+      sorted.push_back(
+          {i->m_name, nanos, i->m_items.load(std::memory_order_acquire)});
   }
   if (sorted.empty())
     return; // Later code will break without any elements.
@@ -127,6 +136,12 @@ void Timer::DumpCategoryTimes(Stream *s) {
   // Sort by time
   std::sort(sorted.begin(), sorted.end(), CategoryMapIteratorSortCriterion);
 
-  for (const auto &timer : sorted)
-    s->Printf("%.9f sec for %s\n", timer.second / 1000000000., timer.first);
+  for (const auto &timer : sorted) {
+    const double seconds = timer.nanos / 1000000000.;
+    if (timer.items)
+      s->Printf("%.9f sec for %s (%" PRIu64 " items, %.0f items/sec)\n",
+                seconds, timer.name, timer.items, timer.items / seconds);
+    else
+      s->Printf("%.9f sec for %s\n", seconds, timer.name);
+  }
 }
@@ -35,6 +35,7 @@
 #include "lldb/Host/StringConvert.h"
 #include "lldb/Host/common/NativeProcessProtocol.h"
 #include "lldb/Utility/Status.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Errno.h"
 
@@ -106,6 +107,8 @@ static struct option g_long_options[] = {
            // than llgs listening for a connection from address on port.
     {"setsid", no_argument, NULL,
      'S'}, // Call setsid() to make llgs run in its own session.
+    {"expedited-stack-size", required_argument, NULL,
+     'E'}, // Bytes of stack memory to send with each stopped thread.
     {NULL, 0, NULL, 0}};
 
 //----------------------------------------------------------------------
@@ -135,6 +138,7 @@ static void display_usage(const char *progname, const char *subcommand) {
                   "[--named-pipe named-pipe-path] "
                   "[--native-regs] "
                   "[--attach pid] "
+                  "[--expedited-stack-size bytes] "
                   "[[HOST]:PORT] "
                   "[-- PROGRAM ARG1 ARG2 ...]\n",
           progname, subcommand);
@@ -364,6 +368,7 @@ int main_gdbserver(int argc, char *argv[]) {
       log_channels; // e.g. "lldb process threads:gdb-remote default:linux all"
   int unnamed_pipe_fd = -1;
   bool reverse_connect = false;
+  uint32_t expedited_stack_size = UINT32_MAX;
 
   // ProcessLaunchInfo launch_info;
   ProcessAttachInfo attach_info;
@@ -413,6 +418,14 @@ int main_gdbserver(int argc, char *argv[]) {
       reverse_connect = true;
       break;
 
+    case 'E': // expedited stack size
+      if (!llvm::to_integer(optarg, expedited_stack_size)) {
+        llvm::errs() << "error: invalid expedited stack size " << optarg
+                     << "\n";
+        option_error = 1;
+      }
+      break;
+
 #ifndef _WIN32
     case 'S':
       // Put llgs into a new session. Terminals group processes
@@ -479,6 +492,8 @@ int main_gdbserver(int argc, char *argv[]) {
 
   NativeProcessFactory factory;
   GDBRemoteCommunicationServerLLGS gdb_server(mainloop, factory);
+  if (expedited_stack_size != UINT32_MAX)
+    gdb_server.SetExpeditedStackSize(expedited_stack_size);
 
   const char *const host_and_port = argv[0];
   argc -= 1;
@@ -0,0 +1,262 @@
+//===-- AgentExpressionCompilerTest.cpp -------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Expression/AgentExpressionCompiler.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Thread.h"
+
+using namespace lldb_private;
+using namespace lldb_private::platform_linux;
+using namespace lldb;
+
+namespace {
+// The registers the conditions below can name, with their debug server
+// numbers: a 64-bit and a 32-bit integer register, a floating point
+// register and one the debug server doesn't know.
+const uint32_t kInvalid = LLDB_INVALID_REGNUM;
+const RegisterInfo kRegisterInfos[] = {
+    {"r0", "arg1", 8, 0, eEncodingUint, eFormatHex,
+     {kInvalid, kInvalid, kInvalid, 0, 0}, nullptr, nullptr, nullptr, 0},
+    {"w1", nullptr, 4, 8, eEncodingUint, eFormatHex,
+     {kInvalid, kInvalid, kInvalid, 1, 1}, nullptr, nullptr, nullptr, 0},
+    {"f0", nullptr, 8, 12, eEncodingIEEE754, eFormatFloat,
+     {kInvalid, kInvalid, kInvalid, 2, 2}, nullptr, nullptr, nullptr, 0},
+    {"nr", nullptr, 8, 20, eEncodingUint, eFormatHex,
+     {kInvalid, kInvalid, kInvalid, kInvalid, 3}, nullptr, nullptr, nullptr,
+     0}};
+// The values of the registers, indexed by debug server number.
+const uint64_t kRegisterValues[] = {0x1234, 0xffffffff};
+
+class DummyProcess : public Process {
+public:
+  DummyProcess(TargetSP target_sp, ListenerSP listener_sp)
+      : Process(target_sp, listener_sp) {}
+
+  bool CanDebug(TargetSP target, bool plugin_specified_by_name) override {
+    return false;
+  }
+  Status DoDestroy() override { return Status(); }
+  void RefreshStateAfterStop() override {}
+  size_t DoReadMemory(addr_t vm_addr, void *buf, size_t size,
+                      Status &error) override {
+    return 0;
+  }
+  bool UpdateThreadList(ThreadList &old_thread_list,
+                        ThreadList &new_thread_list) override {
+    return false;
+  }
+  ConstString GetPluginName() override { return ConstString("dummy"); }
+  uint32_t GetPluginVersion() override { return 1; }
+};
+
+class DummyThread : public Thread {
+public:
+  DummyThread(Process &process) : Thread(process, 1) {}
+
+  ~DummyThread() override { DestroyThread(); }
+
+  void RefreshStateAfterStop() override {}
+  RegisterContextSP GetRegisterContext() override { return nullptr; }
+  RegisterContextSP CreateRegisterContextForFrame(StackFrame *frame) override {
+    return nullptr;
+  }
+  bool CalculateStopInfo() override { return false; }
+};
+
+class DummyRegisterContext : public RegisterContext {
+public:
+  DummyRegisterContext(Thread &thread) : RegisterContext(thread, 0) {}
+
+  void InvalidateAllRegisters() override {}
+  size_t GetRegisterCount() override {
+    return llvm::array_lengthof(kRegisterInfos);
+  }
+  const RegisterInfo *GetRegisterInfoAtIndex(size_t reg) override {
+    return reg < GetRegisterCount() ? &kRegisterInfos[reg] : nullptr;
+  }
+  size_t GetRegisterSetCount() override { return 0; }
+  const RegisterSet *GetRegisterSet(size_t reg_set) override {
+    return nullptr;
+  }
+  bool ReadRegister(const RegisterInfo *reg_info,
+                    RegisterValue &reg_value) override {
+    return false;
+  }
+  bool WriteRegister(const RegisterInfo *reg_info,
+                     const RegisterValue &reg_value) override {
+    return false;
+  }
+  uint32_t ConvertRegisterKindToRegisterNumber(RegisterKind kind,
+                                               uint32_t num) override {
+    for (size_t reg = 0; reg < GetRegisterCount(); ++reg) {
+      if (kRegisterInfos[reg].kinds[kind] == num)
+        return reg;
+    }
+    return LLDB_INVALID_REGNUM;
+  }
+};
+
+class AgentExpressionCompilerTest : public testing::Test {
+public:
+  static void SetUpTestCase() {
+    HostInfo::Initialize();
+    PlatformLinux::Initialize();
+  }
+
+  static void TearDownTestCase() {
+    PlatformLinux::Terminate();
+    HostInfo::Terminate();
+  }
+
+  void SetUp() override {
+    ArchSpec arch("x86_64-pc-linux");
+    PlatformSP platform_sp = PlatformLinux::CreateInstance(true, &arch);
+    Platform::SetHostPlatform(platform_sp);
+    m_debugger_sp = Debugger::CreateInstance();
+    ASSERT_TRUE(m_debugger_sp);
+    m_debugger_sp->GetTargetList().CreateTarget(*m_debugger_sp, "", arch,
+                                                false, platform_sp,
+                                                m_target_sp);
+    ASSERT_TRUE(m_target_sp);
+    m_process_sp = std::make_shared<DummyProcess>(
+        m_target_sp, m_debugger_sp->GetListener());
+    m_thread_sp = std::make_shared<DummyThread>(*m_process_sp);
+    m_reg_ctx_sp = std::make_shared<DummyRegisterContext>(*m_thread_sp);
+  }
+
+  void TearDown() override {
+    m_reg_ctx_sp.reset();
+    m_thread_sp.reset();
+    m_process_sp.reset();
+    m_debugger_sp->GetTargetList().DeleteTarget(m_target_sp);
+    m_target_sp.reset();
+    Debugger::Destroy(m_debugger_sp);
+  }
+
+protected:
+  // Compiles the condition for a breakpoint outside of any module and
+  // evaluates it against kRegisterValues.
+  llvm::Expected<uint64_t> CompileAndEvaluate(llvm::StringRef condition) {
+    AgentExpressionCompiler compiler(*m_target_sp, Address(), *m_reg_ctx_sp);
+    AgentExpression expr;
+    Status error = compiler.Compile(condition, expr);
+    if (error.Fail())
+      return error.ToError();
+
+    uint64_t result;
+    error = expr.Evaluate(
+        [](uint32_t reg_num, uint64_t &value) {
+          if (reg_num >= llvm::array_lengthof(kRegisterValues))
+            return false;
+          value = kRegisterValues[reg_num];
+          return true;
+        },
+        [](addr_t addr, void *buf, size_t size) { return false; }, result);
+    if (error.Fail())
+      return error.ToError();
+    return result;
+  }
+
+  // The value of a condition which must compile and evaluate.
+  uint64_t Value(llvm::StringRef condition) {
+    llvm::Expected<uint64_t> result = CompileAndEvaluate(condition);
+    EXPECT_TRUE(bool(result)) << condition.str() << ": "
+                              << llvm::toString(result.takeError());
+    return result ? *result : UINT64_MAX;
+  }
+
+  // Whether a condition fails to compile or evaluate.
+  bool Fails(llvm::StringRef condition) {
+    llvm::Expected<uint64_t> result = CompileAndEvaluate(condition);
+    if (result)
+      return false;
+    llvm::consumeError(result.takeError());
+    return true;
+  }
+
+  DebuggerSP m_debugger_sp;
+  TargetSP m_target_sp;
+  ProcessSP m_process_sp;
+  ThreadSP m_thread_sp;
+  RegisterContextSP m_reg_ctx_sp;
+};
+} // namespace
+
+TEST_F(AgentExpressionCompilerTest, Literals) {
+  EXPECT_EQ(42u, Value("42"));
+  EXPECT_EQ(0x10u, Value("0x10"));
+  EXPECT_EQ(8u, Value("010"));
+  EXPECT_EQ(1u, Value("true"));
+  EXPECT_EQ(0u, Value("false"));
+  EXPECT_TRUE(Fails("12abc"));
+  EXPECT_TRUE(Fails("1lll"));
+}
+
+TEST_F(AgentExpressionCompilerTest, Precedence) {
+  EXPECT_EQ(7u, Value("1 + 2 * 3"));
+  EXPECT_EQ(9u, Value("(1 + 2) * 3"));
+  EXPECT_EQ(1u, Value("1 + 2 * 3 == 7"));
+  EXPECT_EQ(1u, Value("1 < 2 && 3 > 2"));
+  EXPECT_EQ(1u, Value("0 || 2 == 2"));
+  EXPECT_EQ(2u, Value("6 & 3"));
+  EXPECT_EQ(1u, Value("(6 & 3) == 2"));
+  EXPECT_EQ(16u, Value("1 << 2 + 2"));
+  EXPECT_EQ(0u, Value("!5"));
+  EXPECT_EQ(1u, Value("!!5"));
+  EXPECT_EQ(uint64_t(-3), Value("-3"));
+  EXPECT_EQ(uint64_t(-8), Value("~7"));
+}
+
+TEST_F(AgentExpressionCompilerTest, IntegerConversions) {
+  // Signed ints compare and divide as signed.
+  EXPECT_EQ(1u, Value("-1 < 0"));
+  EXPECT_EQ(uint64_t(-3), Value("-7 / 2"));
+  // An int converted to unsigned int is 0xffffffff, not 2^64 - 1.
+  EXPECT_EQ(0u, Value("-1 < 0u"));
+  EXPECT_EQ(0xffffffffu, Value("-1 + 0u"));
+  EXPECT_EQ(1u, Value("-1 == 0xffffffff"));
+  // Unsigned int arithmetic wraps at 32 bits.
+  EXPECT_EQ(0u, Value("0xffffffff + 1"));
+  EXPECT_EQ(0x100000000u, Value("0xffffffffl + 1"));
+  // A long keeps an int's sign.
+  EXPECT_EQ(1u, Value("-1 < 0l"));
+  EXPECT_EQ(0u, Value("-1 < 0ul"));
+}
+
+TEST_F(AgentExpressionCompilerTest, Registers) {
+  EXPECT_EQ(0x1234u, Value("$r0"));
+  EXPECT_EQ(1u, Value("$arg1 == 0x1234"));
+  EXPECT_EQ(4u, Value("$R0 & 0x4"));
+  // A 32-bit register is an unsigned int.
+  EXPECT_EQ(0u, Value("$w1 + 1"));
+  EXPECT_EQ(0u, Value("$w1 < 0"));
+  EXPECT_EQ(1u, Value("$w1 == -1"));
+  EXPECT_TRUE(Fails("$f0 == 0"));
+  EXPECT_TRUE(Fails("$nr == 0"));
+  EXPECT_TRUE(Fails("$x9 == 0"));
+}
+
+TEST_F(AgentExpressionCompilerTest, Unsupported) {
+  // Conditions left to the expression parser.
+  EXPECT_TRUE(Fails(""));
+  EXPECT_TRUE(Fails("(1 + 2"));
+  EXPECT_TRUE(Fails("1 2"));
+  EXPECT_TRUE(Fails("1.5 > 1"));
+  EXPECT_TRUE(Fails("\"a\" == 0"));
+  EXPECT_TRUE(Fails("foo(1)"));
+  EXPECT_TRUE(Fails("no_such_variable == 1"));
+  EXPECT_TRUE(Fails("1 / 0"));
+}
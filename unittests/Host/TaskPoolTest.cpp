@@ -2,6 +2,8 @@
 
 #include "lldb/Host/TaskPool.h"
 
+#include <thread>
+
 TEST(TaskPoolTest, AddTask) {
   auto fn = [](int x) { return x * x + 1; };
 
@@ -41,3 +43,17 @@ TEST(TaskPoolTest, TaskMap) {
   ASSERT_EQ(data[2], 4);
   ASSERT_EQ(data[3], 9);
 }
+
+TEST(TaskPoolTest, NestedTaskMap) {
+  // More outer items than workers, each of which waits for an inner map.
+  const size_t num_outer =
+      4 * std::max(1u, std::thread::hardware_concurrency());
+  std::vector<int> data(num_outer * 4);
+  TaskMapOverInt(0, num_outer, [&data](size_t x) {
+    TaskMapOverInt(0, 4, [&data, x](size_t y) { data[x * 4 + y] = x + y; });
+  });
+
+  for (size_t x = 0; x < num_outer; ++x)
+    for (size_t y = 0; y < 4; ++y)
+      ASSERT_EQ(int(x + y), data[x * 4 + y]);
+}
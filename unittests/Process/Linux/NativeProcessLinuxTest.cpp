@@ -0,0 +1,167 @@
+//===-- NativeProcessLinuxTest.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "NativeProcessLinux.h"
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+#include "lldb/Core/State.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Host/MainLoop.h"
+
+// C Includes
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// C++ Includes
+#include <chrono>
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace process_linux;
+
+namespace {
+class NativeProcessLinuxTest : public testing::Test {
+public:
+  static void SetUpTestCase() {
+    HostInfo::Initialize();
+    ObjectFileELF::Initialize();
+  }
+
+  static void TearDownTestCase() {
+    ObjectFileELF::Terminate();
+    HostInfo::Terminate();
+  }
+};
+
+// Stops the main loop whenever the process is not running anymore.
+class StopDelegate : public NativeProcessProtocol::NativeDelegate {
+public:
+  explicit StopDelegate(MainLoop &loop) : m_loop(loop) {}
+
+  void InitializeDelegate(NativeProcessProtocol *process) override {}
+
+  void ProcessStateChanged(NativeProcessProtocol *process,
+                           StateType state) override {
+    m_state = state;
+    if (!StateIsRunningState(state))
+      m_loop.RequestTermination();
+  }
+
+  void DidExec(NativeProcessProtocol *process) override {}
+
+  void ThreadStopped(NativeProcessProtocol *process,
+                     lldb::tid_t tid) override {}
+
+  StateType GetState() const { return m_state; }
+
+private:
+  MainLoop &m_loop;
+  StateType m_state = eStateInvalid;
+};
+
+void *IdleThread(void *) {
+  while (true)
+    pause();
+  return nullptr;
+}
+
+// Forks a child which starts num_threads - 1 threads and waits until they
+// are all running.
+::pid_t ForkWithThreads(size_t num_threads) {
+  int fds[2];
+  if (pipe(fds) != 0)
+    return -1;
+
+  ::pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    for (size_t i = 1; i < num_threads; ++i) {
+      pthread_t thread;
+      if (pthread_create(&thread, nullptr, IdleThread, nullptr) != 0)
+        _exit(1);
+    }
+    char c = 'x';
+    if (write(fds[1], &c, 1) != 1)
+      _exit(1);
+    IdleThread(nullptr);
+  }
+
+  close(fds[1]);
+  char c;
+  if (pid > 0 && read(fds[0], &c, 1) != 1) {
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    pid = -1;
+  }
+  close(fds[0]);
+  return pid;
+}
+
+// Resumes and interrupts a child with num_threads threads num_iterations
+// times, and records the average latency of each.
+void StopResumeLatency(size_t num_threads, uint32_t num_iterations) {
+  ::pid_t pid = ForkWithThreads(num_threads);
+  ASSERT_GT(pid, 0);
+
+  MainLoop loop;
+  StopDelegate delegate(loop);
+  auto process_or = NativeProcessLinux::Factory().Attach(pid, delegate, loop);
+  if (!process_or) {
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+  }
+  ASSERT_TRUE(bool(process_or)) << llvm::toString(process_or.takeError());
+  std::unique_ptr<NativeProcessProtocol> process = std::move(*process_or);
+  EXPECT_EQ(num_threads, process->UpdateThreads());
+
+  std::chrono::steady_clock::duration resume_elapsed(0);
+  std::chrono::steady_clock::duration stop_elapsed(0);
+  for (uint32_t iteration = 0; iteration < num_iterations; ++iteration) {
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(process->Resume(ResumeActionList(eStateRunning, 0)).Success());
+    auto resumed = std::chrono::steady_clock::now();
+    ASSERT_TRUE(process->Interrupt().Success());
+    ASSERT_TRUE(loop.Run().Success());
+    auto stopped = std::chrono::steady_clock::now();
+    ASSERT_EQ(eStateStopped, delegate.GetState());
+
+    resume_elapsed += resumed - start;
+    stop_elapsed += stopped - resumed;
+  }
+
+  for (uint32_t i = 0; i < process->UpdateThreads(); ++i)
+    EXPECT_TRUE(StateIsStoppedState(
+        process->GetThreadAtIndex(i)->GetState(), false));
+
+  ASSERT_TRUE(process->Kill().Success());
+  ASSERT_TRUE(loop.Run().Success());
+  EXPECT_EQ(eStateExited, delegate.GetState());
+
+  testing::Test::RecordProperty("Threads", static_cast<int>(num_threads));
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  const auto average = [&](std::chrono::steady_clock::duration elapsed) {
+    return static_cast<int>(duration_cast<microseconds>(elapsed).count() /
+                            num_iterations);
+  };
+  testing::Test::RecordProperty("ResumeMicroseconds", average(resume_elapsed));
+  testing::Test::RecordProperty("StopMicroseconds", average(stop_elapsed));
+}
+} // namespace
+
+TEST_F(NativeProcessLinuxTest, StopResume) { StopResumeLatency(16, 2); }
+
+// Forking a thousand threads takes too long for the normal test run, use
+// --gtest_also_run_disabled_tests to run this one.
+TEST_F(NativeProcessLinuxTest, DISABLED_StopResumeLatencyBenchmark) {
+  StopResumeLatency(1000, 10);
+}
@@ -11,7 +11,9 @@
 #include "GDBRemoteTestUtils.h"
 
 #include "Plugins/Process/gdb-remote/GDBRemoteCommunicationClient.h"
+#include "Plugins/Process/gdb-remote/GDBRemoteCommunicationServerCommon.h"
 #include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/Config.h"
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Utility/DataBuffer.h"
 #include "lldb/Utility/StructuredData.h"
@@ -31,6 +33,8 @@ typedef GDBRemoteCommunication::PacketResult PacketResult;
 
 struct TestClient : public GDBRemoteCommunicationClient {
   TestClient() { m_send_acks = false; }
+
+  using GDBRemoteCommunicationClient::CompressionIsEnabled;
 };
 
 void Handle_QThreadSuffixSupported(MockServer &server, bool supported) {
@@ -56,6 +60,39 @@ std::string all_registers_hex = "404142434445464748494a4b4c4d4e4f";
 uint8_t one_register[] = {'A', 'B', 'C', 'D'};
 std::string one_register_hex = "41424344";
 
+// A server with the packet handlers that every lldb-server has, such as the
+// one for QEnableCompression.
+struct CommonServer : public GDBRemoteCommunicationServerCommon {
+  CommonServer()
+      : GDBRemoteCommunicationServerCommon("common-server",
+                                           "common-server.listener") {
+    m_send_acks = false;
+  }
+
+  Status LaunchProcess() override {
+    return Status("launching is not supported");
+  }
+
+  PacketResult SendPacket(llvm::StringRef payload) {
+    return SendPacketNoLock(payload);
+  }
+
+  PacketResult GetPacket(StringExtractorGDBRemote &response) {
+    const bool sync_on_timeout = false;
+    return WaitForPacketNoLock(response, std::chrono::seconds(1),
+                               sync_on_timeout);
+  }
+
+  // Answer the next packet with the handler registered for it.
+  PacketResult HandleNextPacket() {
+    Status error;
+    bool interrupt = false;
+    bool quit = false;
+    return GetPacketAndSendResponse(std::chrono::seconds(1), error, interrupt,
+                                    quit);
+  }
+};
+
 } // end anonymous namespace
 
 class GDBRemoteCommunicationClientTest : public GDBRemoteTest {
@@ -65,6 +102,49 @@ public:
   }
 
 protected:
+  // Let a server with its real QEnableCompression handler agree on
+  // compression with a client, and check the replies that follow.
+  void TestCompression(StringRef name) {
+    TestClient compression_client;
+    CommonServer compression_server;
+    ASSERT_THAT_ERROR(Connect(compression_client, compression_server),
+                      llvm::Succeeded());
+
+    std::future<void> qsupported_result = std::async(
+        std::launch::async, [&] { compression_client.GetRemoteQSupported(); });
+    StringExtractorGDBRemote request;
+    ASSERT_EQ(PacketResult::Success, compression_server.GetPacket(request));
+    ASSERT_TRUE(request.GetStringRef().find("qSupported") == 0);
+    ASSERT_EQ(PacketResult::Success,
+              compression_server.SendPacket(
+                  "PacketSize=20000;SupportedCompressions=" + name.str()));
+    // The server's own QEnableCompression handler answers. The client only
+    // decompresses what it receives once it sees a plain OK, so the reply
+    // must go out before the server starts compressing.
+    ASSERT_EQ(PacketResult::Success, compression_server.HandleNextPacket());
+    qsupported_result.get();
+    ASSERT_TRUE(compression_client.CompressionIsEnabled());
+
+    // Replies below the minimum size go out uncompressed, larger ones are
+    // compressed and escaped.
+    std::string large_reply;
+    for (int i = 0; i < 256; ++i)
+      large_reply += "0123456789abcdef$#}*" + std::to_string(i);
+    for (const std::string &reply : {std::string("OK"), large_reply}) {
+      std::future<std::string> result = std::async(std::launch::async, [&] {
+        StringExtractorGDBRemote response;
+        if (compression_client.SendPacketAndWaitForResponse(
+                "qTest", response, false) != PacketResult::Success)
+          return std::string();
+        return response.GetStringRef();
+      });
+      ASSERT_EQ(PacketResult::Success, compression_server.GetPacket(request));
+      ASSERT_EQ("qTest", request.GetStringRef());
+      ASSERT_EQ(PacketResult::Success, compression_server.SendPacket(reply));
+      EXPECT_EQ(reply, result.get());
+    }
+  }
+
   TestClient client;
   MockServer server;
 };
@@ -506,3 +586,15 @@ TEST_F(GDBRemoteCommunicationClientTest, SendGetTraceConfigPacket) {
       incorrect_custom_params2);
   ASSERT_FALSE(result4.get().Success());
 }
+
+#if defined(HAVE_LIBZ)
+TEST_F(GDBRemoteCommunicationClientTest, ZlibDeflateCompression) {
+  TestCompression("zlib-deflate");
+}
+#endif
+
+#if defined(HAVE_LIBLZ4)
+TEST_F(GDBRemoteCommunicationClientTest, LZ4Compression) {
+  TestCompression("lz4");
+}
+#endif
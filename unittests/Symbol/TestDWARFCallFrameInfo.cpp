@@ -39,7 +39,8 @@ public:
   }
 
 protected:
-  void TestBasic(DWARFCallFrameInfo::Type type, llvm::StringRef symbol);
+  void TestBasic(DWARFCallFrameInfo::Type type, llvm::StringRef symbol,
+                 llvm::StringRef input = "basic-call-frame-info.yaml");
 };
 
 #define ASSERT_NO_ERROR(x)                                                     \
@@ -88,8 +89,9 @@ static UnwindPlan::Row GetExpectedRow2() {
 }
 
 void DWARFCallFrameInfoTest::TestBasic(DWARFCallFrameInfo::Type type,
-                                       llvm::StringRef symbol) {
-  std::string yaml = GetInputFilePath("basic-call-frame-info.yaml");
+                                       llvm::StringRef symbol,
+                                       llvm::StringRef input) {
+  std::string yaml = GetInputFilePath(input);
   llvm::SmallString<128> obj;
 
   ASSERT_NO_ERROR(llvm::sys::fs::createTemporaryFile(
@@ -141,3 +143,7 @@ TEST_F(DWARFCallFrameInfoTest, Basic_dwarf4) {
 TEST_F(DWARFCallFrameInfoTest, Basic_eh) {
   TestBasic(DWARFCallFrameInfo::EH, "eh_frame");
 }
+
+TEST_F(DWARFCallFrameInfoTest, Basic_eh_frame_hdr) {
+  TestBasic(DWARFCallFrameInfo::EH, "eh_frame", "eh-frame-hdr.yaml");
+}
@@ -0,0 +1,46 @@
+//===-- TestSymtab.cpp ------------------------------------------*- C++ -*-===//
+//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Symbol/Symbol.h"
+#include "lldb/Symbol/Symtab.h"
+#include "lldb/Utility/ConstString.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+std::vector<uint32_t> FindSymbols(Symtab &symtab, const char *name) {
+  std::vector<uint32_t> indexes;
+  symtab.AppendSymbolIndexesWithName(ConstString(name), indexes);
+  return indexes;
+}
+} // namespace
+
+TEST(SymtabTest, FindFunctionsByName) {
+  // The partial demangler takes the first name apart, which leaves
+  // demangling it until it is looked up. It doesn't handle operators, so the
+  // second name is demangled while the names are indexed.
+  const char *mangled_names[] = {"_ZN2ns3fooEi", "_ZN2ns1AplERKS0_"};
+  Symtab symtab(nullptr);
+  for (uint32_t i = 0; i < 2; ++i)
+    symtab.AddSymbol(Symbol(i, mangled_names[i], true, eSymbolTypeCode, true,
+                            false, false, false, SectionSP(), 0x1000 + i * 0x10,
+                            0x10, true, false, 0));
+
+  EXPECT_EQ(std::vector<uint32_t>{0}, FindSymbols(symtab, "_ZN2ns3fooEi"));
+  EXPECT_EQ(std::vector<uint32_t>{1},
+            FindSymbols(symtab, "ns::A::operator+(ns::A const&)"));
+  EXPECT_EQ(std::vector<uint32_t>{0}, FindSymbols(symtab, "ns::foo(int)"));
+  // Looking it up again doesn't index it twice.
+  EXPECT_EQ(std::vector<uint32_t>{0}, FindSymbols(symtab, "ns::foo(int)"));
+  EXPECT_TRUE(FindSymbols(symtab, "ns::foo").empty());
+}
@@ -9,6 +9,9 @@
 
 #include "gtest/gtest.h"
 
+#include <chrono>
+#include <functional>
+
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolData.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolExe.h"
@@ -16,6 +19,13 @@
 #include "llvm/Support/Path.h"
 
 #include "Plugins/ObjectFile/PECOFF/ObjectFilePECOFF.h"
+#include "Plugins/SymbolFile/DWARF/DWARFCompileUnit.h"
+#include "Plugins/SymbolFile/DWARF/DWARFDebugAranges.h"
+#include "Plugins/SymbolFile/DWARF/DWARFDebugInfo.h"
+#include "Plugins/SymbolFile/DWARF/DWARFDebugLine.h"
+#include "Plugins/SymbolFile/DWARF/DWARFDebugNames.h"
+#include "Plugins/SymbolFile/DWARF/DWARFGdbIndex.h"
+#include "Plugins/SymbolFile/DWARF/NameToDIE.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
 #include "Plugins/SymbolFile/PDB/SymbolFilePDB.h"
 #include "lldb/Core/Address.h"
@@ -27,7 +37,10 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/LineTable.h"
 #include "lldb/Symbol/SymbolVendor.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/FileSpec.h"
+#include "lldb/Utility/RegularExpression.h"
+#include "lldb/Utility/StreamString.h"
 #include "unittests/Utility/Helpers/TestUtilities.h"
 
 using namespace lldb_private;
@@ -74,3 +87,310 @@ TEST_F(SymbolFileDWARFTests, TestAbilitiesForDWARF) {
   uint32_t expected_abilities = SymbolFile::kAllAbilities;
   EXPECT_EQ(expected_abilities, symfile->CalculateAbilities());
 }
+
+TEST_F(SymbolFileDWARFTests, TestNameToDIEEncodeDecode) {
+  NameToDIE index;
+  index.Insert(ConstString("main"), DIERef(0x0b, 0x2d));
+  index.Insert(ConstString("foo"), DIERef(0x0b, 0x51));
+  index.Insert(ConstString("foo"), DIERef(0x80, 0xa4));
+  index.Finalize();
+
+  StreamString strm(Stream::eBinary, 4, lldb::eByteOrderLittle);
+  index.Encode(strm);
+
+  DataExtractor data(strm.GetData(), strm.GetSize(), lldb::eByteOrderLittle,
+                     4);
+  lldb::offset_t offset = 0;
+  NameToDIE decoded;
+  ASSERT_TRUE(decoded.Decode(data, &offset));
+  decoded.Finalize();
+  EXPECT_EQ(strm.GetSize(), offset);
+
+  DIEArray die_refs;
+  EXPECT_EQ(2u, decoded.Find(ConstString("foo"), die_refs));
+  die_refs.clear();
+  ASSERT_EQ(1u, decoded.Find(ConstString("main"), die_refs));
+  EXPECT_EQ(0x0bu, die_refs[0].cu_offset);
+  EXPECT_EQ(0x2du, die_refs[0].die_offset);
+
+  // A truncated entry must be rejected.
+  DataExtractor truncated(strm.GetData(), strm.GetSize() - 1,
+                          lldb::eByteOrderLittle, 4);
+  offset = 0;
+  NameToDIE partial;
+  EXPECT_FALSE(partial.Decode(truncated, &offset));
+}
+
+TEST_F(SymbolFileDWARFTests, TestDebugNamesLookup) {
+  const char debug_str[] = "\0main\0Foo\0";
+
+  // A single name index describing one compile unit at offset 0 with a
+  // function "main" and a structure "Foo".
+  StreamString body(Stream::eBinary, 4, lldb::eByteOrderLittle);
+  body.PutHex16(5); // version
+  body.PutHex16(0); // padding
+  body.PutHex32(1); // comp_unit_count
+  body.PutHex32(0); // local_type_unit_count
+  body.PutHex32(0); // foreign_type_unit_count
+  body.PutHex32(1); // bucket_count
+  body.PutHex32(2); // name_count
+  body.PutHex32(13); // abbrev_table_size
+  body.PutHex32(0); // augmentation_string_size
+  body.PutHex32(0); // CU list
+  body.PutHex32(1); // buckets
+  body.PutHex32(DWARFDebugNames::HashName("main"));
+  body.PutHex32(DWARFDebugNames::HashName("Foo"));
+  body.PutHex32(1); // string offsets
+  body.PutHex32(6);
+  body.PutHex32(0); // entry offsets
+  body.PutHex32(6);
+  const uint8_t abbrevs[] = {1, DW_TAG_subprogram,     3, DW_FORM_ref4, 0, 0,
+                             2, DW_TAG_structure_type, 3, DW_FORM_ref4, 0, 0,
+                             0};
+  body.PutRawBytes(abbrevs, sizeof(abbrevs));
+  body.PutHex8(1); // "main" entries
+  body.PutHex32(0x2d);
+  body.PutHex8(0);
+  body.PutHex8(2); // "Foo" entries
+  body.PutHex32(0x40);
+  body.PutHex8(0);
+
+  StreamString section(Stream::eBinary, 4, lldb::eByteOrderLittle);
+  section.PutHex32(body.GetSize());
+  section.PutRawBytes(body.GetData(), body.GetSize());
+
+  DWARFDataExtractor names_data;
+  names_data.SetData(section.GetData(), section.GetSize(),
+                     lldb::eByteOrderLittle);
+  DWARFDataExtractor str_data;
+  str_data.SetData(debug_str, sizeof(debug_str), lldb::eByteOrderLittle);
+
+  DWARFDebugNames debug_names(names_data, str_data);
+  ASSERT_TRUE(debug_names.IsValid());
+
+  DIEArray die_offsets;
+  ASSERT_EQ(1u, debug_names.FindByName("main", die_offsets));
+  EXPECT_EQ(0u, die_offsets[0].cu_offset);
+  EXPECT_EQ(0x2du, die_offsets[0].die_offset);
+
+  die_offsets.clear();
+  const dw_tag_t type_tags[] = {DW_TAG_structure_type};
+  EXPECT_EQ(0u, debug_names.FindByName("main", die_offsets, type_tags));
+  ASSERT_EQ(1u, debug_names.FindByName("Foo", die_offsets, type_tags));
+  EXPECT_EQ(0x40u, die_offsets[0].die_offset);
+
+  // "foo" hashes like "Foo" but must not match it.
+  die_offsets.clear();
+  EXPECT_EQ(0u, debug_names.FindByName("foo", die_offsets));
+
+  EXPECT_EQ(1u, debug_names.AppendAllDIEsThatMatchingRegex(
+                    RegularExpression(llvm::StringRef("^ma")), die_offsets));
+}
+
+TEST_F(SymbolFileDWARFTests, TestGdbIndexLookup) {
+  // Two compile units at 0x0 and 0x30. "bar" is a variable in the first
+  // one, "ns::foo" a function in the second one.
+  const uint32_t num_slots = 4;
+  std::vector<std::pair<uint32_t, uint32_t>> slots(num_slots);
+  auto insert = [&](llvm::StringRef name, uint32_t name_offset,
+                    uint32_t cu_vector_offset) {
+    const uint32_t hash = DWARFGdbIndex::HashName(name);
+    const uint32_t step = ((hash * 17) & (num_slots - 1)) | 1;
+    uint32_t slot = hash & (num_slots - 1);
+    while (slots[slot].first != 0)
+      slot = (slot + step) & (num_slots - 1);
+    slots[slot] = std::make_pair(name_offset, cu_vector_offset);
+  };
+  insert("ns::foo", 16, 0);
+  insert("bar", 24, 8);
+
+  StreamString section(Stream::eBinary, 4, lldb::eByteOrderLittle);
+  section.PutHex32(7);   // version
+  section.PutHex32(24);  // CU list
+  section.PutHex32(56);  // TU list
+  section.PutHex32(56);  // address area
+  section.PutHex32(76);  // symbol table
+  section.PutHex32(108); // constant pool
+  section.PutHex64(0);
+  section.PutHex64(0x30);
+  section.PutHex64(0x30);
+  section.PutHex64(0x40);
+  section.PutHex64(0x1000);
+  section.PutHex64(0x1100);
+  section.PutHex32(1);
+  for (const auto &slot : slots) {
+    section.PutHex32(slot.first);
+    section.PutHex32(slot.second);
+  }
+  section.PutHex32(1); // CU vector of "ns::foo"
+  section.PutHex32((DWARFGdbIndex::eSymbolKindFunction << 28) | 1);
+  section.PutHex32(1); // CU vector of "bar"
+  section.PutHex32((DWARFGdbIndex::eSymbolKindVariable << 28) | 0);
+  section.PutCString("ns::foo");
+  section.PutCString("bar");
+
+  DWARFDataExtractor data;
+  data.SetData(section.GetData(), section.GetSize(), lldb::eByteOrderLittle);
+  DWARFGdbIndex gdb_index(data);
+  ASSERT_TRUE(gdb_index.IsValid());
+  EXPECT_EQ(2u, gdb_index.GetNumCompileUnits());
+  EXPECT_TRUE(gdb_index.ContainsCompileUnit(0x30));
+  EXPECT_FALSE(gdb_index.ContainsCompileUnit(0x70));
+
+  std::vector<dw_offset_t> cu_offsets;
+  ASSERT_EQ(1u, gdb_index.FindCompileUnits(
+                    "ns::foo", DWARFGdbIndex::eSymbolKindNone, cu_offsets));
+  EXPECT_EQ(0x30u, cu_offsets[0]);
+
+  // Base names match every qualified symbol.
+  cu_offsets.clear();
+  ASSERT_EQ(1u, gdb_index.FindCompileUnits(
+                    "foo", DWARFGdbIndex::eSymbolKindFunction, cu_offsets));
+  EXPECT_EQ(0x30u, cu_offsets[0]);
+  EXPECT_EQ(0u, gdb_index.FindCompileUnits(
+                    "foo", DWARFGdbIndex::eSymbolKindVariable, cu_offsets));
+  cu_offsets.clear();
+  ASSERT_EQ(1u, gdb_index.FindCompileUnits(
+                    "other::bar", DWARFGdbIndex::eSymbolKindNone, cu_offsets));
+  EXPECT_EQ(0u, cu_offsets[0]);
+
+  DWARFDebugAranges aranges;
+  std::set<dw_offset_t> cus_with_data;
+  gdb_index.AppendAddressRanges(aranges, cus_with_data);
+  aranges.Sort(true);
+  EXPECT_EQ(0x30u, aranges.FindAddress(0x1080));
+  EXPECT_EQ(1u, cus_with_data.count(0x30));
+}
+
+TEST_F(SymbolFileDWARFTests, TestLineSequenceIndex) {
+  // A version 2 line table with two sequences, [0x1000, 0x1020) and
+  // [0x2000, 0x2020).
+  StreamString section(Stream::eBinary, 8, lldb::eByteOrderLittle);
+  section.PutHex32(71);   // unit_length
+  section.PutHex16(2);    // version
+  section.PutHex32(26);   // header_length
+  section.PutHex8(1);     // minimum_instruction_length
+  section.PutHex8(1);     // default_is_stmt
+  section.PutHex8(0xfb);  // line_base
+  section.PutHex8(14);    // line_range
+  section.PutHex8(13);    // opcode_base
+  for (uint8_t length : {0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1})
+    section.PutHex8(length);
+  section.PutHex8(0); // include_directories
+  section.PutCString("a.c");
+  section.PutHex8(0);
+  section.PutHex8(0);
+  section.PutHex8(0);
+  section.PutHex8(0); // file_names
+  auto set_address = [&](uint64_t address) {
+    section.PutHex8(0);
+    section.PutHex8(9);
+    section.PutHex8(DW_LNE_set_address);
+    section.PutHex64(address);
+  };
+  auto end_sequence = [&]() {
+    section.PutHex8(0);
+    section.PutHex8(1);
+    section.PutHex8(DW_LNE_end_sequence);
+  };
+  set_address(0x1000);
+  section.PutHex8(DW_LNS_copy);
+  section.PutHex8(DW_LNS_advance_pc);
+  section.PutHex8(0x10);
+  section.PutHex8(DW_LNS_advance_line);
+  section.PutHex8(2);
+  section.PutHex8(DW_LNS_copy);
+  section.PutHex8(DW_LNS_advance_pc);
+  section.PutHex8(0x10);
+  end_sequence();
+  set_address(0x2000);
+  section.PutHex8(DW_LNS_copy);
+  section.PutHex8(DW_LNS_advance_pc);
+  section.PutHex8(0x20);
+  end_sequence();
+  ASSERT_EQ(75u, section.GetSize());
+
+  DWARFDataExtractor data;
+  data.SetData(section.GetData(), section.GetSize(), lldb::eByteOrderLittle);
+  data.SetAddressByteSize(8);
+  DWARFDebugLine::SequenceIndex sequences;
+  ASSERT_TRUE(DWARFDebugLine::ParseSequenceIndex(data, 0, sequences));
+  ASSERT_EQ(2u, sequences.size());
+  EXPECT_EQ(0x1000u, sequences[0].low_pc);
+  EXPECT_EQ(0x1020u, sequences[0].high_pc);
+  EXPECT_EQ(0x2000u, sequences[1].low_pc);
+  EXPECT_EQ(0x2020u, sequences[1].high_pc);
+  EXPECT_EQ(58u, sequences[1].offset);
+
+  EXPECT_EQ(&sequences[0], DWARFDebugLine::FindSequence(sequences, 0x101f));
+  EXPECT_EQ(&sequences[1], DWARFDebugLine::FindSequence(sequences, 0x2000));
+  EXPECT_EQ(nullptr, DWARFDebugLine::FindSequence(sequences, 0x1020));
+  EXPECT_EQ(nullptr, DWARFDebugLine::FindSequence(sequences, 0xfff));
+
+  // Decoding a single sequence only produces its rows.
+  std::vector<dw_addr_t> addresses;
+  lldb::offset_t offset = 0;
+  ASSERT_TRUE(DWARFDebugLine::ParseStatementTable(
+      data, &offset,
+      [](dw_offset_t, const DWARFDebugLine::State &state, void *baton) {
+        if (state.row > 0)
+          static_cast<std::vector<dw_addr_t> *>(baton)->push_back(
+              state.address);
+      },
+      &addresses, sequences[1].offset));
+  ASSERT_EQ(2u, addresses.size());
+  EXPECT_EQ(0x2000u, addresses[0]);
+  EXPECT_EQ(0x2020u, addresses[1]);
+}
+
+TEST_F(SymbolFileDWARFTests, TestDIEExtractionThroughput) {
+  FileSpec fspec(m_dwarf_test_exe, false);
+  ArchSpec aspec("i686-pc-windows");
+  lldb::ModuleSP module = std::make_shared<Module>(fspec, aspec);
+  SymbolFile *symfile = module->GetSymbolVendor()->GetSymbolFile();
+  ASSERT_NE(nullptr, symfile);
+  DWARFDebugInfo *debug_info =
+      static_cast<SymbolFileDWARF *>(symfile)->DebugInfo();
+  ASSERT_NE(nullptr, debug_info);
+  const size_t num_cus = debug_info->GetNumCompileUnits();
+  ASSERT_LT(0u, num_cus);
+
+  // Attribute values found through the precomputed attribute offsets must
+  // match the ones found by walking the abbreviation.
+  std::function<void(const DWARFDIE &)> check_die = [&](const DWARFDIE &die) {
+    for (DWARFDIE child = die; child; child = child.GetSibling()) {
+      DWARFAttributes attributes;
+      child.GetAttributes(attributes);
+      DWARFFormValue form_value;
+      const uint32_t name_idx = attributes.FindAttributeIndex(DW_AT_name);
+      if (name_idx != UINT32_MAX &&
+          attributes.ExtractFormValueAtIndex(name_idx, form_value))
+        EXPECT_STREQ(form_value.AsCString(), child.GetName());
+      else
+        EXPECT_EQ(nullptr, child.GetName());
+      EXPECT_EQ(attributes.FormValueAsUnsigned(DW_AT_low_pc, UINT64_MAX),
+                child.GetAttributeValueAsAddress(DW_AT_low_pc, UINT64_MAX));
+      check_die(child.GetFirstChild());
+    }
+  };
+  for (size_t i = 0; i < num_cus; ++i)
+    check_die(debug_info->GetCompileUnitAtIndex(i)->DIE());
+
+  const uint32_t num_iterations = 200;
+  uint64_t num_dies = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (uint32_t iteration = 0; iteration < num_iterations; ++iteration) {
+    for (size_t i = 0; i < num_cus; ++i) {
+      DWARFCompileUnit *cu = debug_info->GetCompileUnitAtIndex(i);
+      cu->ClearDIEs(false);
+      num_dies += cu->ExtractDIEsIfNeeded(false);
+    }
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  EXPECT_LT(0u, num_dies);
+  EXPECT_EQ(0u, num_dies % num_iterations);
+  if (elapsed.count() > 0)
+    RecordProperty("DIEsPerSecond",
+                   static_cast<int>(num_dies / elapsed.count()));
+}
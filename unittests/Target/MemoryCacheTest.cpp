@@ -0,0 +1,366 @@
+//===-- MemoryCacheTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Target/MemoryRegionInfo.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+
+using namespace lldb_private;
+using namespace lldb_private::platform_linux;
+using namespace lldb;
+
+namespace {
+const addr_t kBaseAddress = 0x10000;
+const size_t kMemorySize = 1024 * 1024;
+
+// A process with kMemorySize bytes of memory at kBaseAddress, which counts
+// how often it is read and can run a hook while a read is in flight.
+class DummyProcess : public Process {
+public:
+  DummyProcess(TargetSP target_sp, ListenerSP listener_sp)
+      : Process(target_sp, listener_sp), m_memory(kMemorySize) {
+    for (size_t i = 0; i < m_memory.size(); ++i)
+      m_memory[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+  }
+
+  bool CanDebug(TargetSP target, bool plugin_specified_by_name) override {
+    return false;
+  }
+  Status DoDestroy() override { return Status(); }
+  void RefreshStateAfterStop() override {}
+  bool UpdateThreadList(ThreadList &old_thread_list,
+                        ThreadList &new_thread_list) override {
+    return false;
+  }
+  ConstString GetPluginName() override { return ConstString("dummy"); }
+  uint32_t GetPluginVersion() override { return 1; }
+
+  size_t DoReadMemory(addr_t vm_addr, void *buf, size_t size,
+                      Status &error) override {
+    ++m_num_reads;
+    if (vm_addr < kBaseAddress || vm_addr >= kBaseAddress + kMemorySize) {
+      error.SetErrorString("unmapped memory");
+      return 0;
+    }
+    size = std::min<size_t>(size, kBaseAddress + kMemorySize - vm_addr);
+    memcpy(buf, m_memory.data() + (vm_addr - kBaseAddress), size);
+    if (m_read_hook) {
+      std::function<void()> hook;
+      std::swap(hook, m_read_hook);
+      hook();
+    }
+    return size;
+  }
+
+  // The first m_read_only_size bytes of the memory are mapped read-only.
+  Status GetMemoryRegionInfo(addr_t load_addr,
+                             MemoryRegionInfo &range_info) override {
+    if (load_addr < kBaseAddress || load_addr >= kBaseAddress + kMemorySize)
+      return Status("unmapped memory");
+    const addr_t read_only_end = kBaseAddress + m_read_only_size;
+    const bool read_only = load_addr < read_only_end;
+    range_info.GetRange().SetRangeBase(read_only ? kBaseAddress
+                                                 : read_only_end);
+    range_info.GetRange().SetRangeEnd(read_only ? read_only_end
+                                                : kBaseAddress + kMemorySize);
+    range_info.SetReadable(MemoryRegionInfo::eYes);
+    range_info.SetWritable(read_only ? MemoryRegionInfo::eNo
+                                     : MemoryRegionInfo::eYes);
+    return Status();
+  }
+
+  size_t DoWriteMemory(addr_t vm_addr, const void *buf, size_t size,
+                       Status &error) override {
+    if (vm_addr < kBaseAddress ||
+        vm_addr + size > kBaseAddress + kMemorySize) {
+      error.SetErrorString("unmapped memory");
+      return 0;
+    }
+    memcpy(m_memory.data() + (vm_addr - kBaseAddress), buf, size);
+    return size;
+  }
+
+  // What a stop does to the memory cache.
+  void ClearMemoryCache() { m_memory_cache.Clear(); }
+
+  // Change the memory behind the cache's back, as a resumed inferior would.
+  void ChangeMemory(addr_t vm_addr, size_t size) {
+    for (size_t i = 0; i < size; ++i)
+      ++m_memory[vm_addr - kBaseAddress + i];
+  }
+
+  const uint8_t *GetMemory(addr_t vm_addr) const {
+    return m_memory.data() + (vm_addr - kBaseAddress);
+  }
+
+  std::atomic<size_t> m_num_reads{0};
+  addr_t m_read_only_size = 0;
+  // Run once by the next DoReadMemory, after it copied the memory.
+  std::function<void()> m_read_hook;
+
+private:
+  std::vector<uint8_t> m_memory;
+};
+
+class MemoryCacheTest : public testing::Test {
+public:
+  static void SetUpTestCase() {
+    HostInfo::Initialize();
+    PlatformLinux::Initialize();
+  }
+
+  static void TearDownTestCase() {
+    PlatformLinux::Terminate();
+    HostInfo::Terminate();
+  }
+
+  void SetUp() override {
+    ArchSpec arch("x86_64-pc-linux");
+    PlatformSP platform_sp = PlatformLinux::CreateInstance(true, &arch);
+    Platform::SetHostPlatform(platform_sp);
+    m_debugger_sp = Debugger::CreateInstance();
+    ASSERT_TRUE(m_debugger_sp);
+    m_debugger_sp->GetTargetList().CreateTarget(*m_debugger_sp, "", arch,
+                                                false, platform_sp,
+                                                m_target_sp);
+    ASSERT_TRUE(m_target_sp);
+    m_process_sp = std::make_shared<DummyProcess>(
+        m_target_sp, m_debugger_sp->GetListener());
+  }
+
+  void TearDown() override {
+    m_process_sp.reset();
+    m_debugger_sp->GetTargetList().DeleteTarget(m_target_sp);
+    m_target_sp.reset();
+    Debugger::Destroy(m_debugger_sp);
+  }
+
+  // Read size bytes at addr and check them against the process memory.
+  void CheckRead(addr_t addr, size_t size) {
+    uint8_t buf[64];
+    ASSERT_LE(size, sizeof(buf));
+    Status error;
+    ASSERT_EQ(size, m_process_sp->ReadMemory(addr, buf, size, error))
+        << error.AsCString();
+    ASSERT_EQ(0, memcmp(buf, m_process_sp->GetMemory(addr), size))
+        << "at " << addr;
+  }
+
+protected:
+  DebuggerSP m_debugger_sp;
+  TargetSP m_target_sp;
+  std::shared_ptr<DummyProcess> m_process_sp;
+};
+
+// The addresses of count small reads which are either spread over the whole
+// memory at random or follow each other.
+std::vector<addr_t> GetReadAddresses(size_t count, size_t read_size,
+                                     bool sequential) {
+  std::vector<addr_t> addrs;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<addr_t> distribution(
+      kBaseAddress, kBaseAddress + kMemorySize - read_size);
+  for (size_t i = 0; i < count; ++i)
+    addrs.push_back(sequential
+                        ? kBaseAddress + (i * read_size) % kMemorySize
+                        : distribution(generator));
+  return addrs;
+}
+} // namespace
+
+TEST_F(MemoryCacheTest, ReadsMatchMemory) {
+  for (addr_t addr : GetReadAddresses(10000, 16, false))
+    CheckRead(addr, 16);
+  // Reads which straddle cache lines.
+  const uint32_t line_size = m_process_sp->GetMemoryCacheLineSize();
+  for (addr_t addr = kBaseAddress + line_size - 8;
+       addr < kBaseAddress + 64 * line_size; addr += line_size)
+    CheckRead(addr, 16);
+}
+
+TEST_F(MemoryCacheTest, ReadsAtTheEndOfMemory) {
+  uint8_t buf[16];
+  Status error;
+  EXPECT_EQ(8u, m_process_sp->ReadMemory(kBaseAddress + kMemorySize - 8, buf,
+                                         sizeof(buf), error));
+  EXPECT_EQ(0, memcmp(buf, m_process_sp->GetMemory(kBaseAddress + kMemorySize -
+                                                   8),
+                      8));
+  EXPECT_EQ(0u, m_process_sp->ReadMemory(kBaseAddress + kMemorySize, buf,
+                                         sizeof(buf), error));
+  EXPECT_TRUE(error.Fail());
+}
+
+TEST_F(MemoryCacheTest, SequentialReadsReadAhead) {
+  const size_t num_reads = 4096;
+  for (addr_t addr : GetReadAddresses(num_reads, 8, true))
+    CheckRead(addr, 8);
+  // Without reading ahead each line would be read on its own.
+  const size_t num_lines =
+      num_reads * 8 / m_process_sp->GetMemoryCacheLineSize();
+  EXPECT_LT(m_process_sp->m_num_reads, num_lines / 2);
+  EXPECT_GT(m_process_sp->GetMemoryCacheStats().read_ahead_lines, 0u);
+}
+
+TEST_F(MemoryCacheTest, WritesAndStopsInvalidate) {
+  CheckRead(kBaseAddress + 100, 4);
+  const size_t num_reads = m_process_sp->m_num_reads;
+  CheckRead(kBaseAddress + 104, 4);
+  EXPECT_EQ(num_reads, m_process_sp->m_num_reads);
+
+  const uint8_t value[4] = {1, 2, 3, 4};
+  Status error;
+  ASSERT_EQ(sizeof(value), m_process_sp->WriteMemory(kBaseAddress + 102, value,
+                                                     sizeof(value), error));
+  CheckRead(kBaseAddress + 100, 8);
+  EXPECT_EQ(num_reads + 1, m_process_sp->m_num_reads);
+
+  m_process_sp->ClearMemoryCache();
+  CheckRead(kBaseAddress + 100, 8);
+  EXPECT_EQ(num_reads + 2, m_process_sp->m_num_reads);
+}
+
+TEST_F(MemoryCacheTest, ReadOnlyRegionsDontSurviveResumes) {
+  m_process_sp->m_read_only_size = kMemorySize / 2;
+  CheckRead(kBaseAddress + 100, 8);
+  EXPECT_EQ(1u, m_process_sp->GetMemoryCacheStats().read_only_lines);
+
+  // Only the process knows about this memory, and it may remap it while it
+  // runs.
+  m_process_sp->ClearMemoryCache();
+  EXPECT_EQ(0u, m_process_sp->GetMemoryCacheStats().read_only_lines);
+  const size_t num_reads = m_process_sp->m_num_reads;
+  CheckRead(kBaseAddress + 100, 8);
+  EXPECT_EQ(num_reads + 1, m_process_sp->m_num_reads);
+}
+
+TEST_F(MemoryCacheTest, ReadOnlySectionsSurviveResumes) {
+  const uint32_t line_size = m_process_sp->GetMemoryCacheLineSize();
+  ModuleSP module_sp = std::make_shared<Module>(ModuleSpec());
+  SectionSP section_sp = std::make_shared<Section>(
+      module_sp, nullptr, 1, ConstString(".rodata"), eSectionTypeData, 0,
+      4 * line_size, 0, 4 * line_size, 0, 0);
+  section_sp->SetPermissions(ePermissionsReadable);
+  m_target_sp->SetSectionLoadAddress(section_sp, kBaseAddress);
+
+  CheckRead(kBaseAddress + 100, 8);
+  CheckRead(kBaseAddress + 4 * line_size + 100, 8);
+  m_process_sp->ClearMemoryCache();
+  const size_t num_reads = m_process_sp->m_num_reads;
+  CheckRead(kBaseAddress + 100, 8);
+  EXPECT_EQ(num_reads, m_process_sp->m_num_reads);
+  EXPECT_EQ(1u, m_process_sp->GetMemoryCacheStats().read_only_hits);
+
+  // The memory after the section is writable.
+  CheckRead(kBaseAddress + 4 * line_size + 100, 8);
+  EXPECT_EQ(num_reads + 1, m_process_sp->m_num_reads);
+
+  // Writes and unloading the module drop the section's lines.
+  const uint8_t value[4] = {1, 2, 3, 4};
+  Status error;
+  ASSERT_EQ(sizeof(value), m_process_sp->WriteMemory(kBaseAddress + 102, value,
+                                                     sizeof(value), error));
+  CheckRead(kBaseAddress + 100, 8);
+  EXPECT_EQ(num_reads + 2, m_process_sp->m_num_reads);
+  ModuleList module_list;
+  module_list.Append(module_sp);
+  m_process_sp->ModulesDidUnload(module_list);
+  EXPECT_EQ(0u, m_process_sp->GetMemoryCacheStats().read_only_lines);
+}
+
+// Timing reads tells little in the normal test run, use
+// --gtest_also_run_disabled_tests to run this one.
+TEST_F(MemoryCacheTest, DISABLED_RandomVsSequentialReadsBenchmark) {
+  const size_t num_reads = 200000;
+  for (bool sequential : {false, true}) {
+    const std::vector<addr_t> addrs =
+        GetReadAddresses(num_reads, 8, sequential);
+    m_process_sp->ClearMemoryCache();
+    m_process_sp->m_num_reads = 0;
+
+    uint8_t buf[8];
+    Status error;
+    auto start = std::chrono::steady_clock::now();
+    for (addr_t addr : addrs)
+      m_process_sp->ReadMemory(addr, buf, sizeof(buf), error);
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    const std::string name = sequential ? "Sequential" : "Random";
+    testing::Test::RecordProperty(
+        name + "ReadNanoseconds",
+        static_cast<int>(elapsed.count() * 1000 / num_reads));
+    testing::Test::RecordProperty(
+        name + "ProcessReads", static_cast<int>(m_process_sp->m_num_reads));
+  }
+}
+
+TEST_F(MemoryCacheTest, StopDuringReadIsNotCached) {
+  const uint32_t line_size = m_process_sp->GetMemoryCacheLineSize();
+  // Small reads go through the cache lines, reads bigger than a line
+  // through the L1 cache.
+  for (size_t size : {size_t(16), size_t(line_size * 2)}) {
+    const addr_t addr = kBaseAddress + 16 * line_size;
+    m_process_sp->ClearMemoryCache();
+    std::vector<uint8_t> before(m_process_sp->GetMemory(addr),
+                                m_process_sp->GetMemory(addr) + size);
+    // The inferior runs and stops on another thread while the cache reads
+    // from it. That thread must not wait for the read to finish.
+    m_process_sp->m_read_hook = [&] {
+      std::thread other([&] {
+        m_process_sp->ChangeMemory(addr, size);
+        m_process_sp->ClearMemoryCache();
+      });
+      other.join();
+    };
+
+    std::vector<uint8_t> buf(size);
+    Status error;
+    ASSERT_EQ(size, m_process_sp->ReadMemory(addr, buf.data(), size, error));
+    EXPECT_EQ(before, buf);
+    // What the read returned predates the stop, so it must not be cached.
+    ASSERT_EQ(size, m_process_sp->ReadMemory(addr, buf.data(), size, error));
+    EXPECT_EQ(0, memcmp(buf.data(), m_process_sp->GetMemory(addr), size))
+        << "size " << size;
+  }
+}
+
+TEST_F(MemoryCacheTest, ConcurrentReadsAndStops) {
+  std::atomic<bool> done(false);
+  std::thread stopper([&] {
+    while (!done)
+      m_process_sp->ClearMemoryCache();
+  });
+  std::vector<std::thread> readers;
+  for (bool sequential : {false, true, false, true}) {
+    readers.emplace_back([this, sequential] {
+      for (addr_t addr : GetReadAddresses(20000, 16, sequential))
+        CheckRead(addr, 16);
+    });
+  }
+  for (std::thread &reader : readers)
+    reader.join();
+  done = true;
+  stopper.join();
+}
@@ -0,0 +1,158 @@
+//===-- AgentExpressionTest.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/AgentExpression.h"
+
+#include <string.h>
+
+using namespace lldb_private;
+
+namespace {
+const uint64_t kRegisters[] = {0x1234, UINT64_MAX, 7};
+const uint32_t kMemoryAddress = 0x1000;
+const uint8_t kMemory[] = {0xff, 0xff, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+
+bool ReadRegister(uint32_t reg_num, uint64_t &value) {
+  if (reg_num >= llvm::array_lengthof(kRegisters))
+    return false;
+  value = kRegisters[reg_num];
+  return true;
+}
+
+bool ReadMemory(lldb::addr_t addr, void *buf, size_t size) {
+  if (addr < kMemoryAddress || addr + size > kMemoryAddress + sizeof(kMemory))
+    return false;
+  memcpy(buf, kMemory + (addr - kMemoryAddress), size);
+  return true;
+}
+
+llvm::Expected<uint64_t> Evaluate(const AgentExpression &expr) {
+  uint64_t result;
+  Status error = expr.Evaluate(ReadRegister, ReadMemory, result);
+  if (error.Fail())
+    return error.ToError();
+  return result;
+}
+
+uint64_t EvaluateBinary(uint64_t a, AgentExpression::Opcode opcode,
+                        uint64_t b) {
+  AgentExpression expr;
+  expr.AppendConstant(a);
+  expr.AppendConstant(b);
+  expr.AppendOpcode(opcode);
+  expr.AppendOpcode(AgentExpression::eOpEnd);
+  llvm::Expected<uint64_t> result = Evaluate(expr);
+  EXPECT_TRUE(bool(result)) << llvm::toString(result.takeError());
+  return result ? *result : 0;
+}
+} // namespace
+
+TEST(AgentExpressionTest, Constants) {
+  for (uint64_t value : {UINT64_C(0), UINT64_C(0xff), UINT64_C(0x100),
+                         UINT64_C(0x12345678), UINT64_MAX}) {
+    AgentExpression expr;
+    expr.AppendConstant(value);
+    expr.AppendOpcode(AgentExpression::eOpEnd);
+    llvm::Expected<uint64_t> result = Evaluate(expr);
+    ASSERT_TRUE(bool(result)) << llvm::toString(result.takeError());
+    EXPECT_EQ(value, *result);
+  }
+
+  // Constants are encoded big endian in the fewest bytes.
+  AgentExpression expr;
+  expr.AppendConstant(0x1234);
+  EXPECT_EQ((std::vector<uint8_t>{0x23, 0x12, 0x34}), expr.GetBytecode());
+}
+
+TEST(AgentExpressionTest, Arithmetic) {
+  using AE = AgentExpression;
+  EXPECT_EQ(5u, EvaluateBinary(2, AE::eOpAdd, 3));
+  EXPECT_EQ(uint64_t(-1), EvaluateBinary(2, AE::eOpSub, 3));
+  EXPECT_EQ(6u, EvaluateBinary(2, AE::eOpMul, 3));
+  EXPECT_EQ(uint64_t(-3), EvaluateBinary(uint64_t(-7), AE::eOpDivSigned, 2));
+  EXPECT_EQ(3u, EvaluateBinary(7, AE::eOpDivUnsigned, 2));
+  EXPECT_EQ(uint64_t(-1), EvaluateBinary(uint64_t(-7), AE::eOpRemSigned, 2));
+  EXPECT_EQ(1u, EvaluateBinary(7, AE::eOpRemUnsigned, 2));
+  EXPECT_EQ(8u, EvaluateBinary(1, AE::eOpLsh, 3));
+  EXPECT_EQ(uint64_t(-1), EvaluateBinary(uint64_t(-2), AE::eOpRshSigned, 1));
+  EXPECT_EQ(UINT64_MAX >> 1, EvaluateBinary(UINT64_MAX, AE::eOpRshUnsigned, 1));
+  EXPECT_EQ(2u, EvaluateBinary(6, AE::eOpBitAnd, 3));
+  EXPECT_EQ(7u, EvaluateBinary(6, AE::eOpBitOr, 3));
+  EXPECT_EQ(5u, EvaluateBinary(6, AE::eOpBitXor, 3));
+}
+
+TEST(AgentExpressionTest, Comparisons) {
+  using AE = AgentExpression;
+  EXPECT_EQ(1u, EvaluateBinary(3, AE::eOpEqual, 3));
+  EXPECT_EQ(0u, EvaluateBinary(3, AE::eOpEqual, 4));
+  EXPECT_EQ(1u, EvaluateBinary(uint64_t(-1), AE::eOpLessSigned, 0));
+  EXPECT_EQ(0u, EvaluateBinary(uint64_t(-1), AE::eOpLessUnsigned, 0));
+  EXPECT_EQ(1u, EvaluateBinary(2, AE::eOpLessUnsigned, 3));
+}
+
+TEST(AgentExpressionTest, RegistersAndMemory) {
+  // *(int16_t *)(0x1000) + $r2 == 6, the same in either byte order.
+  AgentExpression expr;
+  expr.AppendConstant(kMemoryAddress);
+  expr.AppendOpcode(AgentExpression::eOpRef16);
+  expr.AppendExtend(16, true);
+  expr.AppendRegister(2);
+  expr.AppendOpcode(AgentExpression::eOpAdd);
+  expr.AppendConstant(6);
+  expr.AppendOpcode(AgentExpression::eOpEqual);
+  expr.AppendOpcode(AgentExpression::eOpEnd);
+  llvm::Expected<uint64_t> result = Evaluate(expr);
+  ASSERT_TRUE(bool(result)) << llvm::toString(result.takeError());
+  EXPECT_EQ(1u, *result);
+
+  // The low byte of $r1, zero extended.
+  expr.Clear();
+  expr.AppendRegister(1);
+  expr.AppendExtend(8, false);
+  expr.AppendOpcode(AgentExpression::eOpEnd);
+  result = Evaluate(expr);
+  ASSERT_TRUE(bool(result)) << llvm::toString(result.takeError());
+  EXPECT_EQ(0xffu, *result);
+}
+
+TEST(AgentExpressionTest, Goto) {
+  // $r0 != 0 ? 10 : 20
+  AgentExpression expr(std::vector<uint8_t>{
+      AgentExpression::eOpReg, 0, 0, AgentExpression::eOpIfGoto, 0, 9,
+      AgentExpression::eOpConst8, 20, AgentExpression::eOpEnd,
+      AgentExpression::eOpConst8, 10, AgentExpression::eOpEnd});
+  llvm::Expected<uint64_t> result = Evaluate(expr);
+  ASSERT_TRUE(bool(result)) << llvm::toString(result.takeError());
+  EXPECT_EQ(10u, *result);
+}
+
+TEST(AgentExpressionTest, Errors) {
+  auto fails = [](std::vector<uint8_t> bytecode) {
+    llvm::Expected<uint64_t> result = Evaluate(AgentExpression(bytecode));
+    if (result)
+      return false;
+    llvm::consumeError(result.takeError());
+    return true;
+  };
+
+  using AE = AgentExpression;
+  EXPECT_TRUE(fails({}));
+  EXPECT_TRUE(fails({AE::eOpConst8, 1}));                     // no end
+  EXPECT_TRUE(fails({AE::eOpEnd}));                           // empty stack
+  EXPECT_TRUE(fails({AE::eOpConst8, 1, AE::eOpAdd, AE::eOpEnd}));
+  EXPECT_TRUE(fails({AE::eOpConst16, 1}));                    // truncated
+  EXPECT_TRUE(fails({AE::eOpConst8, 1, AE::eOpConst8, 0, AE::eOpDivSigned,
+                     AE::eOpEnd}));
+  EXPECT_TRUE(fails({AE::eOpReg, 0, 9, AE::eOpEnd}));         // no register
+  EXPECT_TRUE(fails({AE::eOpConst8, 1, AE::eOpRef32, AE::eOpEnd}));
+  EXPECT_TRUE(fails({0x01, AE::eOpEnd}));                     // float
+  EXPECT_TRUE(fails({AE::eOpGoto, 0, 0}));                    // endless
+}
@@ -11,8 +11,69 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "gtest/gtest.h"
 
+#include <string>
+#include <thread>
+#include <vector>
+
 using namespace lldb_private;
 
 TEST(ConstStringTest, format_provider) {
   EXPECT_EQ("foo", llvm::formatv("{0}", ConstString("foo")).str());
 }
+
+TEST(ConstStringTest, MangledCounterpart) {
+  ConstString mangled("_ZN3Foo3barEv");
+  ConstString demangled;
+  demangled.SetCStringWithMangledCounterpart("Foo::bar()", mangled);
+  EXPECT_EQ("Foo::bar()", demangled.GetStringRef());
+
+  ConstString counterpart;
+  EXPECT_TRUE(mangled.GetMangledCounterpart(counterpart));
+  EXPECT_EQ(demangled, counterpart);
+  EXPECT_TRUE(demangled.GetMangledCounterpart(counterpart));
+  EXPECT_EQ(mangled, counterpart);
+}
+
+TEST(ConstStringTest, ConcurrentInterning) {
+  // Threads interning the same strings concurrently must agree on their
+  // unique pointers.
+  const unsigned num_threads = 8;
+  const unsigned num_strings = 2000;
+  std::vector<std::vector<const char *>> results(num_threads);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < num_threads; ++t) {
+    threads.emplace_back([t, &results]() {
+      for (unsigned i = 0; i < num_strings; ++i) {
+        const std::string s =
+            "ConcurrentInterning" + std::to_string((i * (t + 1)) % num_strings);
+        results[t].push_back(ConstString(s).GetCString());
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+
+  for (unsigned t = 0; t < num_threads; ++t) {
+    for (unsigned i = 0; i < num_strings; ++i) {
+      const std::string s =
+          "ConcurrentInterning" + std::to_string((i * (t + 1)) % num_strings);
+      EXPECT_EQ(ConstString(s).GetCString(), results[t][i]);
+      EXPECT_EQ(s, results[t][i]);
+    }
+  }
+}
+
+TEST(ConstStringTest, Stats) {
+  const ConstString::Stats before = ConstString::GetStats();
+  ConstString first("ConstStringTest::Stats");
+  ConstString second("ConstStringTest::Stats");
+  EXPECT_EQ(first, second);
+  const ConstString::Stats after = ConstString::GetStats();
+
+  EXPECT_EQ(before.num_strings + 1, after.num_strings);
+  EXPECT_EQ(before.string_bytes + sizeof("ConstStringTest::Stats"),
+            after.string_bytes);
+  EXPECT_LT(before.memory_size, after.memory_size);
+  EXPECT_EQ(before.num_lookups + 2, after.num_lookups);
+  EXPECT_EQ(before.num_lock_free_hits + 1, after.num_lock_free_hits);
+}
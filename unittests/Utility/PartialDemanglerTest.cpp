@@ -0,0 +1,169 @@
+//===-- PartialDemanglerTest.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/PartialDemangler.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Demangle/Demangle.h"
+
+#include <chrono>
+#include <stdlib.h>
+
+using namespace lldb_private;
+
+namespace {
+// Function symbols taken from libstdc++ and LLVM builds.
+const char *const kCorpus[] = {
+    "_ZN4llvm11NamedMDNodeC1ERKNS_5TwineE",
+    "_ZN4llvm17SwingSchedulerDAG8Circuits7unblockEi",
+    "_ZN4llvm10SCCPSolver23isStructLatticeConstantEPNS_8FunctionEPNS_"
+    "10StructTypeE",
+    "_ZN4llvm4yaml12ScalarTraitsIlvE6outputERKlPvRNS_11raw_ostreamE",
+    "_ZN4llvm10TimerGroup17PrintQueuedTimersERNS_11raw_ostreamE",
+    "_ZN4llvm10MCStreamer13emitCFIDefCfaEll",
+    "_ZNSt18condition_variable10notify_allEv",
+    "_ZNK4llvm6object15XCOFFObjectFile18getSymbolValueImplENS0_11DataRefImplE",
+    "_ZN4llvm17DominatorTreeBaseINS_10BasicBlockELb1EE8root_endEv",
+    "_Z18getDwarfOpForBinOpN4llvm11Instruction9BinaryOpsE",
+    "_ZN4llvm11MachineLoop14getBottomBlockEv",
+    "_ZN4llvm10ConstantFP3getEPNS_4TypeENS_9StringRefE",
+    "_ZN4llvm10DataLayout14parseSpecifierENS_9StringRefE",
+    "_ZNK4llvm17SCEVWrapPredicate7getExprEv",
+    "_ZNSt7__cxx1119basic_ostringstreamIwSt11char_traitsIwESaIwEEC1ESt13_Ios_"
+    "Openmode",
+    "_ZNK4llvm8DWARFDie17getSubroutineNameENS_10DINameKindE",
+    "_ZN4llvm8codeview15TypeDumpVisitor16visitKnownRecordERNS0_"
+    "8CVRecordINS0_12TypeLeafKindEEERNS0_11ArrayRecordE",
+    "_ZN4llvm10ReturnInstC1ERKS0_",
+    "_ZN4llvm11promoteCallERNS_8CallBaseEPNS_8FunctionEPPNS_8CastInstE",
+    "_ZN4llvm12MachineInstr16removeFromParentEv",
+    "_ZN4llvm4json5parseENS_9StringRefE",
+    "_ZNSt6vectorIPKcSaIS1_EE12emplace_backIJS1_EEEvDpOT_",
+    "_ZN4llvm14BlockFrequencymIES0_",
+    "_ZNSt3mapIiiSt4lessIiESaISt4pairIKiiEEE5clearEv",
+};
+} // namespace
+
+TEST(PartialDemanglerTest, Names) {
+  struct TestCase {
+    const char *mangled;
+    const char *context, *basename, *template_args, *qualifiers;
+    bool is_ctor_or_dtor;
+  };
+
+  TestCase test_cases[] = {
+      {"_Z4mainiPPc", "", "main", "", "", false},
+      {"_ZL9helper_fni", "", "helper_fn", "", "", false},
+      {"_ZSt9terminatev", "std", "terminate", "", "", false},
+      {"_ZNK4lldb8SBTarget20GetBreakpointAtIndexEj", "lldb::SBTarget",
+       "GetBreakpointAtIndex", "", "const", false},
+      {"_ZNKR4llvm8OptionalIiE3getEv", "llvm::Optional<int>", "get", "",
+       "const &", false},
+      {"_ZNO3Foo4takeEv", "Foo", "take", "", "&&", false},
+      {"_ZN12_GLOBAL__N_14Impl3runEv", "(anonymous namespace)::Impl", "run",
+       "", "", false},
+      {"_ZN4llvm3sys4path8filenameENS_9StringRefENS1_5StyleE",
+       "llvm::sys::path", "filename", "", "", false},
+      {"_ZNSt6vectorIiSaIiEE9push_backERKi",
+       "std::vector<int, std::allocator<int> >", "push_back", "", "", false},
+      {"_ZNSt6vectorIiSaIiEEC2Ev", "std::vector<int, std::allocator<int> >",
+       "vector", "", "", true},
+      {"_ZNSt6vectorIiSaIiEED1Ev", "std::vector<int, std::allocator<int> >",
+       "~vector", "", "", true},
+      {"_ZNSt3mapIiiSt4lessIiESaISt4pairIKiiEEE5clearEv",
+       "std::map<int, int, std::less<int>, "
+       "std::allocator<std::pair<int const, int> > >",
+       "clear", "", "", false},
+      {"_ZNSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEE6appendEPKc",
+       "std::__cxx11::basic_string<char, std::char_traits<char>, "
+       "std::allocator<char> >",
+       "append", "", "", false},
+      {"_ZN9__gnu_cxx13new_allocatorIcE8allocateEmPKv",
+       "__gnu_cxx::new_allocator<char>", "allocate", "", "", false},
+      {"_ZN4llvm3getILb1EEEvv", "llvm", "get<true>", "<true>", "", false},
+      {"_ZSt3getILm0EJiiEERNSt13tuple_elementIXT_ESt5tupleIJDpT0_EEE4typeERS4_",
+       "", "", "", "", false},
+  };
+
+  PartialDemangler demangler;
+  for (const auto &test : test_cases) {
+    if (test.basename[0] == '\0') {
+      EXPECT_FALSE(demangler.Parse(test.mangled)) << test.mangled;
+      continue;
+    }
+    ASSERT_TRUE(demangler.Parse(test.mangled)) << test.mangled;
+    EXPECT_EQ(test.context, demangler.GetContext().str());
+    EXPECT_EQ(test.basename, demangler.GetBasename().str());
+    EXPECT_EQ(test.template_args, demangler.GetTemplateArguments().str());
+    EXPECT_EQ(test.qualifiers, demangler.GetQualifiers().str());
+    EXPECT_EQ(test.is_ctor_or_dtor, demangler.IsCtorOrDtor());
+  }
+}
+
+TEST(PartialDemanglerTest, Unsupported) {
+  PartialDemangler demangler;
+  EXPECT_FALSE(demangler.Parse(""));
+  EXPECT_FALSE(demangler.Parse("main"));
+  EXPECT_FALSE(demangler.Parse("_ZN3FooplERKS_"));        // operator+
+  EXPECT_FALSE(demangler.Parse("_ZZ4mainE1x"));           // local entity
+  EXPECT_FALSE(demangler.Parse("_Z3foov.cold"));          // clone suffix
+  EXPECT_FALSE(demangler.Parse("_ZN3Foo3barB5cxx11Ev"));  // ABI tag
+  EXPECT_FALSE(demangler.Parse("_ZN3Foo5countE"));        // not a function
+  EXPECT_FALSE(demangler.Parse("_ZN3Foo3barIS9_EEvv"));   // bad substitution
+  EXPECT_FALSE(demangler.Parse("_ZN3Foo20bar"));          // truncated
+  EXPECT_TRUE(demangler.GetBasename().empty());
+}
+
+TEST(PartialDemanglerTest, Corpus) {
+  // Every name that is understood must be a prefix of the full demangling.
+  PartialDemangler demangler;
+  for (const char *mangled : kCorpus) {
+    if (!demangler.Parse(mangled))
+      continue;
+    char *demangled = llvm::itaniumDemangle(mangled, nullptr, nullptr, nullptr);
+    ASSERT_NE(nullptr, demangled) << mangled;
+    std::string name = demangler.GetContext().str();
+    if (!name.empty())
+      name += "::";
+    name += demangler.GetBasename().str();
+    EXPECT_EQ(0u, llvm::StringRef(demangled).find(name + "(")) << mangled;
+    free(demangled);
+  }
+}
+
+TEST(PartialDemanglerTest, Throughput) {
+  const uint32_t num_iterations = 2000;
+  const size_t num_names = llvm::array_lengthof(kCorpus) * num_iterations;
+
+  PartialDemangler demangler;
+  size_t num_parsed = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t iteration = 0; iteration < num_iterations; ++iteration)
+    for (const char *mangled : kCorpus)
+      num_parsed += demangler.Parse(mangled);
+  const std::chrono::duration<double> partial_elapsed =
+      std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(0u, num_parsed % num_iterations);
+  EXPECT_LT(num_names / 2, num_parsed);
+
+  start = std::chrono::steady_clock::now();
+  for (uint32_t iteration = 0; iteration < num_iterations; ++iteration)
+    for (const char *mangled : kCorpus)
+      free(llvm::itaniumDemangle(mangled, nullptr, nullptr, nullptr));
+  const std::chrono::duration<double> full_elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  if (partial_elapsed.count() > 0 && full_elapsed.count() > 0) {
+    RecordProperty("NamesPerSecond",
+                   static_cast<int>(num_names / partial_elapsed.count()));
+    RecordProperty("FullDemanglerNamesPerSecond",
+                   static_cast<int>(num_names / full_elapsed.count()));
+  }
+}
@@ -70,3 +70,24 @@ TEST(TimerTest, CategoryTimes2) {
   EXPECT_LT(0.001, seconds2);
   EXPECT_GT(0.1, seconds2);
 }
+
+TEST(TimerTest, CategoryItems) {
+  Timer::ResetCategoryTimes();
+  {
+    static Timer::Category tcat("CAT1");
+    Timer t(tcat, "");
+    tcat.AddItems(1000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  StreamString ss;
+  Timer::DumpCategoryTimes(&ss);
+  double seconds, rate;
+  unsigned items;
+  ASSERT_EQ(3, sscanf(ss.GetData(),
+                      "%lf sec for CAT1 (%u items, %lf items/sec)", &seconds,
+                      &items, &rate))
+      << "String: " << ss.GetData();
+  EXPECT_EQ(1000u, items);
+  EXPECT_LT(1000 / 0.1, rate);
+  EXPECT_GT(1000 / 0.001, rate);
+}